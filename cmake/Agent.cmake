@@ -55,6 +55,15 @@ target_link_libraries(stats
   Folly::folly
 )
 
+add_library(update_tracer
+  fboss/agent/UpdateTracer.cpp
+)
+
+target_link_libraries(update_tracer
+  duration_histograms
+  Folly::folly
+)
+
 add_library(fboss_types
   fboss/agent/types.cpp
 )
@@ -64,6 +73,7 @@ target_link_libraries(fboss_types
 )
 
 add_library(core
+  fboss/agent/AclPriorityAllocator.cpp
   fboss/agent/ApplyThriftConfig.cpp
   fboss/agent/ArpCache.cpp
   fboss/agent/ArpHandler.cpp
@@ -96,6 +106,9 @@ add_library(core
   fboss/agent/RestartTimeTracker.cpp
   fboss/agent/RouteUpdateLogger.cpp
   fboss/agent/RouteUpdateLoggingPrefixTracker.cpp
+  fboss/agent/RxPacketDispatcher.cpp
+  fboss/agent/RxPacketHeaders.cpp
+  fboss/agent/RxPacketPolicer.cpp
   fboss/agent/StandaloneRibConversions.cpp
   fboss/agent/SwSwitch.cpp
   fboss/agent/ThreadHeartbeat.cpp
@@ -110,6 +123,7 @@ target_link_libraries(core
   agent_config_cpp2
   stats
   utils
+  update_tracer
   fb303::fb303
   capture
   hardware_stats_cpp2
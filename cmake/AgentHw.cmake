@@ -34,6 +34,17 @@ add_library(buffer_stats
   fboss/agent/hw/BufferStatsLogger.cpp
 )
 
+add_library(hw_phase_scheduler
+  fboss/agent/hw/HwPhaseScheduler.cpp
+)
+
+target_link_libraries(hw_phase_scheduler
+  error
+  update_tracer
+  fb303::fb303
+  Folly::folly
+)
+
 target_link_libraries(hw_switch_warmboot_helper
   utils
   Folly::folly
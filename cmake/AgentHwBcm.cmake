@@ -58,6 +58,7 @@ add_library(bcm
   fboss/agent/hw/bcm/BcmSflowExporter.cpp
   fboss/agent/hw/bcm/BcmRxPacket.cpp
   fboss/agent/hw/bcm/BcmStats.cpp
+  fboss/agent/hw/bcm/BcmPrbsStats.cpp
   fboss/agent/hw/bcm/BcmStatUpdater.cpp
   fboss/agent/hw/bcm/BcmSwitch.cpp
   fboss/agent/hw/bcm/BcmSwitchEventCallback.cpp
@@ -89,11 +90,13 @@ add_library(bcm
 
 target_link_libraries(bcm
   hw_switch_warmboot_helper
+  hw_phase_scheduler
   bcm_types
   buffer_stats
   handler
   core
   counter_utils
+  sflow_structs
   Folly::folly
   ${OPENNSA}
 )
@@ -46,11 +46,13 @@ add_executable(bcm_test
   fboss/agent/hw/bcm/tests/BcmPortQueueManagerTests.cpp
   fboss/agent/hw/bcm/tests/BcmPortTests.cpp
   fboss/agent/hw/bcm/tests/BcmPortStressTests.cpp
+  fboss/agent/hw/bcm/tests/BcmPrbsStatsTests.cpp
   fboss/agent/hw/bcm/tests/BcmQosPolicyTests.cpp
   fboss/agent/hw/bcm/tests/BcmQosMapTests.cpp
   fboss/agent/hw/bcm/tests/BcmQueueStatCollectionTests.cpp
   fboss/agent/hw/bcm/tests/BcmRtag7Test.cpp
   fboss/agent/hw/bcm/tests/BcmRouteTests.cpp
+  fboss/agent/hw/bcm/tests/BcmSflowExporterTests.cpp
   fboss/agent/hw/bcm/tests/BcmStateDeltaTests.cpp
   fboss/agent/hw/bcm/tests/BcmSwitchStateReplayTest.cpp
   fboss/agent/hw/bcm/tests/BcmTestRouteUtils.cpp
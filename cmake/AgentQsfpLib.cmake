@@ -13,10 +13,12 @@ target_link_libraries(qsfp_service_client
 
 add_library(qsfp_cache
     fboss/qsfp_service/lib/QsfpCache.cpp
+    fboss/qsfp_service/lib/TransceiverShm.cpp
 )
 
 target_link_libraries(qsfp_cache
     qsfp_service_client
     ctrl_cpp2
     transceiver_cpp2
+    rt
 )
@@ -11,6 +11,7 @@ add_library(standalone_rib
   fboss/agent/rib/RouteNextHopsMulti.cpp
   fboss/agent/rib/RouteTypes.cpp
   fboss/agent/rib/RouteUpdater.cpp
+  fboss/agent/rib/RouteUpdateQueue.cpp
   fboss/agent/rib/RoutingInformationBase.cpp
 )
 
@@ -23,6 +24,7 @@ target_link_libraries(standalone_rib
   ctrl_cpp2
   label_forwarding_action
   state_utils
+  update_tracer
   Folly::folly
 )
 
@@ -43,5 +45,6 @@ target_link_libraries(fib_updater
   standalone_rib
   fboss_types
   state
+  update_tracer
   Folly::folly
 )
@@ -33,6 +33,15 @@ add_library(tuple_utils
 
 set_target_properties(tuple_utils PROPERTIES LINKER_LANGUAGE CXX)
 
+add_library(duration_histograms
+  fboss/lib/DurationHistograms.cpp
+)
+
+target_link_libraries(duration_histograms
+  fb303::fb303
+  Folly::folly
+)
+
 add_library(exponential_back_off
   fboss/lib/ExponentialBackoff.cpp
 )
@@ -0,0 +1,201 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/AclPriorityAllocator.h"
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/state/AclEntry.h"
+#include "fboss/agent/state/AclMap.h"
+
+#include <algorithm>
+
+namespace facebook::fboss {
+
+AclPriorityAllocator::AclPriorityAllocator(
+    int minPriority,
+    int maxPriority,
+    const std::shared_ptr<AclMap>& existingAcls,
+    int gap)
+    : minPriority_(minPriority), maxPriority_(maxPriority), gap_(gap) {
+  CHECK_LE(minPriority_, maxPriority_);
+  CHECK_GT(gap_, 0);
+  if (!existingAcls) {
+    return;
+  }
+  for (const auto& acl : *existingAcls) {
+    existingPriorities_.emplace(acl->getID(), acl->getPriority());
+    existingNames_.emplace(acl->getPriority(), acl->getID());
+  }
+}
+
+bool AclPriorityAllocator::isTaken(int priority, const std::string& name)
+    const {
+  auto iter = existingNames_.find(priority);
+  return iter != existingNames_.end() && iter->second != name;
+}
+
+std::vector<int> AclPriorityAllocator::allocate(
+    const std::vector<std::string>& names) const {
+  const auto numAcls = names.size();
+  std::vector<int> priorities(numAcls);
+  std::vector<bool> kept(numAcls, false);
+
+  // Keep the priorities of the longest subsequence of existing ACLs whose
+  // priorities are still increasing, i.e. of all the existing ACLs that did
+  // not move relative to each other.
+  std::vector<size_t> tails;
+  std::vector<size_t> prev(numAcls, numAcls);
+  for (size_t i = 0; i < numAcls; ++i) {
+    auto iter = existingPriorities_.find(names[i]);
+    if (iter == existingPriorities_.end() || iter->second < minPriority_ ||
+        iter->second > maxPriority_) {
+      continue;
+    }
+    priorities[i] = iter->second;
+    auto tail = std::lower_bound(
+        tails.begin(), tails.end(), iter->second, [&](size_t idx, int prio) {
+          return priorities[idx] < prio;
+        });
+    if (tail != tails.begin()) {
+      prev[i] = *(tail - 1);
+    }
+    if (tail == tails.end()) {
+      tails.push_back(i);
+    } else {
+      *tail = i;
+    }
+  }
+  for (auto i = tails.empty() ? numAcls : tails.back(); i != numAcls;
+       i = prev[i]) {
+    kept[i] = true;
+  }
+
+  // Fills [begin, end), leaving priorities untouched if it doesn't fit
+  auto tryFill = [&](size_t begin, size_t end) {
+    std::vector<int> saved(
+        priorities.begin() + begin, priorities.begin() + end);
+    if (fill(names, begin, end, &priorities)) {
+      return true;
+    }
+    std::copy(saved.begin(), saved.end(), priorities.begin() + begin);
+    return false;
+  };
+
+  // Fill in the runs of ACLs in between the ones we keep, widening the window
+  // around a run whenever it does not fit.
+  size_t i = 0;
+  while (i < numAcls) {
+    if (kept[i]) {
+      ++i;
+      continue;
+    }
+    size_t runEnd = i;
+    while (runEnd < numAcls && !kept[runEnd]) {
+      ++runEnd;
+    }
+    const size_t runBegin = i;
+    size_t begin = runBegin;
+    size_t end = runEnd;
+    size_t downBegin = begin;
+    size_t upEnd = end;
+    size_t widen = std::max<size_t>(1, (end - begin) / 2);
+    while (!tryFill(begin, end)) {
+      if (downBegin == 0 && upEnd == numAcls) {
+        throw FbossError(
+            "Cannot fit ",
+            numAcls,
+            " ACLs in priority range [",
+            minPriority_,
+            ", ",
+            maxPriority_,
+            "]");
+      }
+      // Double the window each time, so that repeated inserts at the same
+      // spot renumber O(log n) ACLs amortized rather than O(n). Try growing
+      // it on one side only first: ACLs that are packed on the other side,
+      // e.g. still numbered consecutively by an older agent, then keep their
+      // priorities.
+      downBegin -= std::min(downBegin, widen);
+      upEnd += std::min(numAcls - upEnd, widen);
+      while (upEnd < numAcls && !kept[upEnd]) {
+        ++upEnd;
+      }
+      widen *= 2;
+      if (upEnd != runEnd && tryFill(runBegin, upEnd)) {
+        end = upEnd;
+        break;
+      }
+      if (downBegin != runBegin && tryFill(downBegin, runEnd)) {
+        end = runEnd;
+        break;
+      }
+      begin = downBegin;
+      end = upEnd;
+    }
+    i = end;
+  }
+  return priorities;
+}
+
+bool AclPriorityAllocator::fill(
+    const std::vector<std::string>& names,
+    size_t begin,
+    size_t end,
+    std::vector<int>* priorities) const {
+  const int64_t count = end - begin;
+  const bool head = begin == 0;
+  const bool tail = end == names.size();
+  // Exclusive bounds of the priorities this run can use
+  const int64_t lower =
+      head ? int64_t(minPriority_) - 1 : (*priorities)[begin - 1];
+  const int64_t upper = tail ? int64_t(maxPriority_) + 1 : (*priorities)[end];
+  if (upper - lower - 1 < count) {
+    return false;
+  }
+
+  int64_t base;
+  int64_t step;
+  if (tail) {
+    // Appending, leave a full gap after every ACL. The very first ACL goes
+    // right at the start of the range.
+    base = head ? int64_t(minPriority_) - gap_ : lower;
+    step = gap_;
+    if (base + step * count >= upper) {
+      base = lower;
+      step = (upper - lower - 1) / count;
+    }
+  } else {
+    // Inserting, spread evenly to leave as much room as possible on both
+    // sides for further inserts.
+    base = lower;
+    step = (upper - lower) / (count + 1);
+  }
+  if (step < 1) {
+    return false;
+  }
+
+  // Skip over priorities other existing ACLs still hold, e.g. a block of
+  // consecutive ones, as long as the rest of the run still fits after it
+  int64_t last = lower;
+  for (int64_t j = 0; j < count; ++j) {
+    auto limit = upper - (count - 1 - j);
+    auto priority = std::max(base + step * (j + 1), last + 1);
+    while (priority < limit && isTaken(priority, names[begin + j])) {
+      ++priority;
+    }
+    if (priority >= limit) {
+      return false;
+    }
+    (*priorities)[begin + j] = priority;
+    last = priority;
+  }
+  return true;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/container/F14Map.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace facebook::fboss {
+
+class AclMap;
+
+/*
+ * Assigns priorities to an ordered list of ACLs, trying hard to keep the
+ * priority of ACLs that already exist.
+ *
+ * Priorities are handed out kGap apart, so an ACL inserted in between two
+ * others can usually be given a priority in between theirs without touching
+ * any other ACL. Every ACL whose priority changes has to be removed and
+ * re-added in hardware, so the allocator:
+ *  - keeps the priorities of the largest set of existing ACLs that are still
+ *    in the same relative order,
+ *  - spreads the remaining ACLs in the gaps around them,
+ *  - only when a gap is too small, renumbers the ACLs right around it,
+ *    doubling the window around it until everything fits, and growing it
+ *    towards the side that has room first.
+ *
+ * ACLs numbered consecutively by an older agent keep their priorities, only
+ * the new ACLs (and those that have to make room for them) get spread out.
+ *
+ * A priority held by some other ACL in the existing state is never handed
+ * out, even if that ACL goes away, so that added and removed ACLs can be
+ * programmed in any order.
+ */
+class AclPriorityAllocator {
+ public:
+  static constexpr int kGap = 16;
+
+  // Priorities are allocated in [minPriority, maxPriority]
+  AclPriorityAllocator(
+      int minPriority,
+      int maxPriority,
+      const std::shared_ptr<AclMap>& existingAcls,
+      int gap = kGap);
+
+  /*
+   * Returns the priority for each of the given ACLs, in the same order.
+   * Priorities are strictly increasing. Throws FbossError if the ACLs don't
+   * fit in the priority range.
+   */
+  std::vector<int> allocate(const std::vector<std::string>& names) const;
+
+ private:
+  bool fill(
+      const std::vector<std::string>& names,
+      size_t begin,
+      size_t end,
+      std::vector<int>* priorities) const;
+  bool isTaken(int priority, const std::string& name) const;
+
+  const int minPriority_;
+  const int maxPriority_;
+  const int gap_;
+  folly::F14FastMap<std::string, int> existingPriorities_;
+  folly::F14FastMap<int, std::string> existingNames_;
+};
+
+} // namespace facebook::fboss
@@ -11,8 +11,10 @@
 
 #include <folly/FileUtil.h>
 #include <folly/gen/Base.h>
+#include <folly/hash/SpookyHashV2.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
+#include "fboss/agent/AclPriorityAllocator.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/LacpTypes.h"
 #include "fboss/agent/LoadBalancerConfigApplier.h"
@@ -50,6 +52,8 @@
 #include <folly/Range.h>
 #include <algorithm>
 #include <cmath>
+#include <map>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -73,8 +77,12 @@ using std::shared_ptr;
 namespace {
 
 const uint8_t kV6LinkLocalAddrMask{64};
-// Needed until CoPP is removed from code and put into config
+// Needed until CoPP is removed from code and put into config. CoPP ACLs get
+// the priorities below kAclStartPriority, everything else the ones above.
+const int kAclCpuStartPriority = 1;
 const int kAclStartPriority = 100000;
+// Priorities are turned into hw priorities as (1e6 - priority)
+const int kAclMaxPriority = 999999;
 
 void updateFibFromConfig(
     facebook::fboss::RouterID vrf,
@@ -90,6 +98,77 @@ void updateFibFromConfig(
   fibUpdater(*nextStatePtr);
 }
 
+/*
+ * Hashes the serialized form of (parts of) the config. Used to tell whether
+ * a config section changed since it was last applied.
+ */
+class ConfigHasher {
+ public:
+  ConfigHasher() {
+    hasher_.Init(0, 0);
+  }
+
+  template <typename ThriftT>
+  ConfigHasher& add(const ThriftT& obj) {
+    serialized_.clear();
+    apache::thrift::CompactSerializer::serialize(obj, &serialized_);
+    addBytes(serialized_.data(), serialized_.size());
+    return *this;
+  }
+
+  template <typename T>
+  ConfigHasher& add(const std::vector<T>& objs) {
+    addSize(objs.size());
+    for (const auto& obj : objs) {
+      add(obj);
+    }
+    return *this;
+  }
+
+  template <typename K, typename V>
+  ConfigHasher& add(const std::map<K, V>& objs) {
+    addSize(objs.size());
+    for (const auto& obj : objs) {
+      add(obj.first);
+      add(obj.second);
+    }
+    return *this;
+  }
+
+  template <typename T>
+  ConfigHasher& add(apache::thrift::optional_field_ref<T> ref) {
+    addSize(ref.has_value() ? 1 : 0);
+    if (ref) {
+      add(*ref);
+    }
+    return *this;
+  }
+
+  ConfigHasher& add(const std::string& str) {
+    addSize(str.size());
+    addBytes(str.data(), str.size());
+    return *this;
+  }
+
+  uint64_t hash() {
+    uint64_t hash1;
+    uint64_t hash2;
+    hasher_.Final(&hash1, &hash2);
+    return hash1;
+  }
+
+ private:
+  void addSize(size_t size) {
+    addBytes(&size, sizeof(size));
+  }
+  void addBytes(const void* data, size_t len) {
+    hasher_.Update(data, len);
+  }
+
+  folly::hash::SpookyHashV2 hasher_;
+  std::string serialized_;
+};
+
 } // anonymous namespace
 
 namespace facebook::fboss {
@@ -107,8 +186,13 @@ class ThriftConfigApplier {
       const std::shared_ptr<SwitchState>& orig,
       const cfg::SwitchConfig* config,
       const Platform* platform,
-      rib::RoutingInformationBase* rib)
-      : orig_(orig), cfg_(config), platform_(platform), rib_(rib) {}
+      rib::RoutingInformationBase* rib,
+      AppliedConfigCache* cache)
+      : orig_(orig),
+        cfg_(config),
+        platform_(platform),
+        rib_(rib),
+        cache_(cache) {}
 
   std::shared_ptr<SwitchState> run();
 
@@ -226,6 +310,11 @@ class ThriftConfigApplier {
       const MatchAction* action = nullptr);
   // check the acl provided by config is valid
   void checkAcl(const cfg::AclEntry* config) const;
+  bool isAclUnchanged(
+      const std::shared_ptr<AclEntry>& origAcl,
+      uint64_t hash,
+      int priority,
+      const MatchAction* action) const;
   std::shared_ptr<QosPolicyMap> updateQosPolicies();
   std::shared_ptr<QosPolicy> updateQosPolicy(
       cfg::QosPolicy& qosPolicy,
@@ -274,6 +363,26 @@ class ThriftConfigApplier {
   const Platform* platform_{nullptr};
   rib::RoutingInformationBase* rib_{nullptr};
 
+  /*
+   * Returns true if the config section with the given hash was last applied
+   * to exactly the node the state still has, so there is nothing to update.
+   */
+  bool isSectionUnchanged(
+      const std::string& section,
+      uint64_t hash,
+      const NodeBase* origNode) const;
+  void recordSection(
+      const std::string& section,
+      uint64_t hash,
+      std::shared_ptr<const NodeBase> node);
+  void updateCache();
+
+  AppliedConfigCache* cache_{nullptr};
+  // What to put in cache_ once the config was applied successfully
+  folly::F14FastMap<std::string, AppliedConfigCache::Entry> newSections_;
+  folly::F14FastMap<std::string, AppliedConfigCache::Entry> newAcls_;
+  bool aclsProcessed_{false};
+
   struct VlanIpInfo {
     VlanIpInfo(uint8_t mask, MacAddress mac, InterfaceID intf)
         : mask(mask), mac(mac), interfaceID(intf) {}
@@ -322,46 +431,91 @@ shared_ptr<SwitchState> ThriftConfigApplier::run() {
 
   processVlanPorts();
 
+  // Sections below are skipped if neither their config nor their part of
+  // the state changed since they were last applied, see AppliedConfigCache.
   {
-    auto newPorts = updatePorts();
-    if (newPorts) {
-      new_->resetPorts(std::move(newPorts));
-      changed = true;
+    auto hash = ConfigHasher()
+                    .add(cfg_->ports)
+                    .add(cfg_->vlanPorts)
+                    .add(cfg_->portQueueConfigs)
+                    .add(cfg_->defaultPortQueues)
+                    .add(cfg_->qosPolicies)
+                    .add(cfg_->dataPlaneTrafficPolicy_ref())
+                    .hash();
+    if (!isSectionUnchanged("ports", hash, orig_->getPorts().get())) {
+      auto newPorts = updatePorts();
+      if (newPorts) {
+        new_->resetPorts(std::move(newPorts));
+        changed = true;
+      }
     }
+    recordSection("ports", hash, new_->getPorts());
   }
 
   {
-    auto newAggPorts = updateAggregatePorts();
-    if (newAggPorts) {
-      new_->resetAggregatePorts(std::move(newAggPorts));
-      changed = true;
+    auto hash = ConfigHasher()
+                    .add(cfg_->aggregatePorts)
+                    .add(cfg_->lacp_ref())
+                    .hash();
+    if (!isSectionUnchanged(
+            "aggregatePorts", hash, orig_->getAggregatePorts().get())) {
+      auto newAggPorts = updateAggregatePorts();
+      if (newAggPorts) {
+        new_->resetAggregatePorts(std::move(newAggPorts));
+        changed = true;
+      }
     }
+    recordSection("aggregatePorts", hash, new_->getAggregatePorts());
   }
 
   // updateMirrors must be called after updatePorts, mirror needs ports!
   {
-    auto newMirrors = updateMirrors();
-    if (newMirrors) {
-      new_->resetMirrors(std::move(newMirrors));
-      changed = true;
+    auto hash =
+        ConfigHasher().add(cfg_->mirrors).add(cfg_->interfaces).hash();
+    if (new_->getPorts() != orig_->getPorts() ||
+        !isSectionUnchanged("mirrors", hash, orig_->getMirrors().get())) {
+      auto newMirrors = updateMirrors();
+      if (newMirrors) {
+        new_->resetMirrors(std::move(newMirrors));
+        changed = true;
+      }
     }
+    recordSection("mirrors", hash, new_->getMirrors());
   }
 
   // updateAcls must be called after updateMirrors, acls may need mirror!
   {
-    auto newAcls = updateAcls();
-    if (newAcls) {
-      new_->resetAcls(std::move(newAcls));
-      changed = true;
+    auto hash = ConfigHasher()
+                    .add(cfg_->acls)
+                    .add(cfg_->cpuTrafficPolicy_ref())
+                    .add(cfg_->dataPlaneTrafficPolicy_ref())
+                    .add(cfg_->trafficCounters)
+                    .hash();
+    if (new_->getMirrors() != orig_->getMirrors() ||
+        !isSectionUnchanged("acls", hash, orig_->getAcls().get())) {
+      auto newAcls = updateAcls();
+      if (newAcls) {
+        new_->resetAcls(std::move(newAcls));
+        changed = true;
+      }
     }
+    recordSection("acls", hash, new_->getAcls());
   }
 
   {
-    auto newQosPolicies = updateQosPolicies();
-    if (newQosPolicies) {
-      new_->resetQosPolicies(std::move(newQosPolicies));
-      changed = true;
+    auto hash = ConfigHasher()
+                    .add(cfg_->qosPolicies)
+                    .add(cfg_->dataPlaneTrafficPolicy_ref())
+                    .hash();
+    if (!isSectionUnchanged(
+            "qosPolicies", hash, orig_->getQosPolicies().get())) {
+      auto newQosPolicies = updateQosPolicies();
+      if (newQosPolicies) {
+        new_->resetQosPolicies(std::move(newQosPolicies));
+        changed = true;
+      }
     }
+    recordSection("qosPolicies", hash, new_->getQosPolicies());
   }
 
   // reset the default qos policy
@@ -530,29 +684,78 @@ shared_ptr<SwitchState> ThriftConfigApplier::run() {
 
   // Add sFlow collectors
   {
-    auto newCollectors = updateSflowCollectors();
-    if (newCollectors) {
-      new_->resetSflowCollectors(std::move(newCollectors));
-      changed = true;
+    auto hash = ConfigHasher().add(cfg_->sFlowCollectors).hash();
+    if (!isSectionUnchanged(
+            "sFlowCollectors", hash, orig_->getSflowCollectors().get())) {
+      auto newCollectors = updateSflowCollectors();
+      if (newCollectors) {
+        new_->resetSflowCollectors(std::move(newCollectors));
+        changed = true;
+      }
     }
+    recordSection("sFlowCollectors", hash, new_->getSflowCollectors());
   }
 
   {
-    LoadBalancerConfigApplier loadBalancerConfigApplier(
-        orig_->getLoadBalancers(), cfg_->get_loadBalancers(), platform_);
-    auto newLoadBalancers = loadBalancerConfigApplier.updateLoadBalancers();
-    if (newLoadBalancers) {
-      new_->resetLoadBalancers(std::move(newLoadBalancers));
-      changed = true;
+    auto hash = ConfigHasher().add(cfg_->loadBalancers).hash();
+    if (!isSectionUnchanged(
+            "loadBalancers", hash, orig_->getLoadBalancers().get())) {
+      LoadBalancerConfigApplier loadBalancerConfigApplier(
+          orig_->getLoadBalancers(), cfg_->get_loadBalancers(), platform_);
+      auto newLoadBalancers = loadBalancerConfigApplier.updateLoadBalancers();
+      if (newLoadBalancers) {
+        new_->resetLoadBalancers(std::move(newLoadBalancers));
+        changed = true;
+      }
     }
+    recordSection("loadBalancers", hash, new_->getLoadBalancers());
   }
 
+  updateCache();
+
   if (!changed) {
     return nullptr;
   }
   return new_;
 }
 
+bool ThriftConfigApplier::isSectionUnchanged(
+    const std::string& section,
+    uint64_t hash,
+    const NodeBase* origNode) const {
+  if (!cache_) {
+    return false;
+  }
+  auto it = cache_->sections_.find(section);
+  if (it == cache_->sections_.end() || it->second.hash != hash ||
+      it->second.node.lock().get() != origNode) {
+    return false;
+  }
+  XLOG(DBG2) << "Config section " << section << " unchanged, skipping";
+  return true;
+}
+
+void ThriftConfigApplier::recordSection(
+    const std::string& section,
+    uint64_t hash,
+    std::shared_ptr<const NodeBase> node) {
+  if (cache_) {
+    newSections_[section] = AppliedConfigCache::Entry{hash, std::move(node)};
+  }
+}
+
+void ThriftConfigApplier::updateCache() {
+  if (!cache_) {
+    return;
+  }
+  cache_->sections_ = std::move(newSections_);
+  // The ACL entries are only looked at if the ACL section changed, keep
+  // whatever we had otherwise.
+  if (aclsProcessed_) {
+    cache_->acls_ = std::move(newAcls_);
+  }
+}
+
 void ThriftConfigApplier::processVlanPorts() {
   // Build the Port --> Vlan mappings
   //
@@ -1404,23 +1607,25 @@ shared_ptr<QosPolicy> ThriftConfigApplier::createQosPolicy(
 }
 
 std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls() {
+  aclsProcessed_ = true;
   AclMap::NodeContainer newAcls;
   bool changed = false;
   int numExistingProcessed = 0;
-  int priority = kAclStartPriority;
-  int cpuPriority = 1;
+
+  // ACLs in the order they are to be matched, together with the action they
+  // get from the traffic policy. Priorities are only assigned once we know
+  // the full order, see AclPriorityAllocator.
+  using PendingAcl =
+      std::pair<const cfg::AclEntry*, std::optional<MatchAction>>;
+  std::vector<PendingAcl> dataPlaneAcls;
+  std::vector<PendingAcl> cpuAcls;
 
   // Start with the DROP acls, these should have highest priority
-  auto acls = folly::gen::from(cfg_->acls) |
-      folly::gen::filter([](const cfg::AclEntry& entry) {
-                return entry.actionType == cfg::AclActionType::DENY;
-              }) |
-      folly::gen::map([&](const cfg::AclEntry& entry) {
-                auto acl = updateAcl(
-                    entry, priority++, &numExistingProcessed, &changed);
-                return std::make_pair(acl->getID(), acl);
-              }) |
-      folly::gen::appendTo(newAcls);
+  for (const auto& entry : cfg_->acls) {
+    if (entry.actionType == cfg::AclActionType::DENY) {
+      dataPlaneAcls.emplace_back(&entry, std::nullopt);
+    }
+  }
 
   // Let's get a map of acls to name so we don't have to search the acl list
   // for every new use
@@ -1438,9 +1643,8 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls() {
 
   // Generates new acls from template
   auto addToAcls = [&](const cfg::TrafficPolicyConfig& policy,
-                       bool isCoppAcl = false)
-      -> const std::vector<std::pair<std::string, std::shared_ptr<AclEntry>>> {
-    std::vector<std::pair<std::string, std::shared_ptr<AclEntry>>> entries;
+                       std::vector<PendingAcl>* acls,
+                       bool isCoppAcl = false) {
     for (const auto& mta : policy.matchToAction) {
       auto a = aclByName.find(mta.matcher);
       if (a == aclByName.end()) {
@@ -1448,10 +1652,10 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls() {
             "Invalid config: No acl named ", mta.matcher, " found.");
       }
 
-      auto aclCfg = *(a->second);
+      const auto* aclCfg = a->second;
 
       // We've already added any DENY acls
-      if (aclCfg.actionType == cfg::AclActionType::DENY) {
+      if (aclCfg->actionType == cfg::AclActionType::DENY) {
         continue;
       }
 
@@ -1479,13 +1683,41 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls() {
       if (auto egressMirror = mta.action.egressMirror_ref()) {
         matchAction.setEgressMirror(*egressMirror);
       }
+      acls->emplace_back(aclCfg, std::move(matchAction));
+    }
+  };
+
+  // Add controlPlane traffic acls
+  if (cfg_->cpuTrafficPolicy_ref() &&
+      cfg_->cpuTrafficPolicy_ref()->trafficPolicy_ref()) {
+    addToAcls(
+        *cfg_->cpuTrafficPolicy_ref()->trafficPolicy_ref(), &cpuAcls, true);
+  }
 
+  // Add dataPlane traffic acls
+  if (auto dataPlaneTrafficPolicy = cfg_->dataPlaneTrafficPolicy_ref()) {
+    addToAcls(*dataPlaneTrafficPolicy, &dataPlaneAcls);
+  }
+
+  auto processAcls = [&](const std::vector<PendingAcl>& acls,
+                         int minPriority,
+                         int maxPriority) {
+    std::vector<std::string> names;
+    names.reserve(acls.size());
+    for (const auto& pendingAcl : acls) {
+      names.push_back(pendingAcl.first->name);
+    }
+    auto priorities =
+        AclPriorityAllocator(minPriority, maxPriority, orig_->getAcls())
+            .allocate(names);
+    for (size_t i = 0; i < acls.size(); ++i) {
+      const auto& action = acls[i].second;
       auto acl = updateAcl(
-          aclCfg,
-          isCoppAcl ? cpuPriority++ : priority++,
+          *acls[i].first,
+          priorities[i],
           &numExistingProcessed,
           &changed,
-          &matchAction);
+          action ? &action.value() : nullptr);
 
       if (acl->getAclAction().has_value()) {
         const auto& inMirror = acl->getAclAction().value().getIngressMirror();
@@ -1499,24 +1731,12 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls() {
           throw FbossError("Mirror ", egMirror.value(), " is undefined");
         }
       }
-      entries.push_back(std::make_pair(acl->getID(), acl));
+      newAcls.emplace(acl->getID(), acl);
     }
-    return entries;
   };
+  processAcls(cpuAcls, kAclCpuStartPriority, kAclStartPriority - 1);
+  processAcls(dataPlaneAcls, kAclStartPriority, kAclMaxPriority);
 
-  // Add controlPlane traffic acls
-  if (cfg_->cpuTrafficPolicy_ref() &&
-      cfg_->cpuTrafficPolicy_ref()->trafficPolicy_ref()) {
-    folly::gen::from(
-        addToAcls(*cfg_->cpuTrafficPolicy_ref()->trafficPolicy_ref(), true)) |
-        folly::gen::appendTo(newAcls);
-  }
-
-  // Add dataPlane traffic acls
-  if (auto dataPlaneTrafficPolicy = cfg_->dataPlaneTrafficPolicy_ref()) {
-    folly::gen::from(addToAcls(*dataPlaneTrafficPolicy)) |
-        folly::gen::appendTo(newAcls);
-  }
   if (numExistingProcessed != orig_->getAcls()->size()) {
     // Some existing ACLs were removed.
     changed = true;
@@ -1535,15 +1755,47 @@ std::shared_ptr<AclEntry> ThriftConfigApplier::updateAcl(
     bool* changed,
     const MatchAction* action) {
   auto origAcl = orig_->getAcls()->getEntryIf(acl.name);
-  auto newAcl = createAcl(&acl, priority, action);
-  if (origAcl) {
-    ++(*numExistingProcessed);
-    if (*origAcl == *newAcl) {
+  uint64_t hash = cache_ ? ConfigHasher().add(acl).hash() : 0;
+  auto result = [&]() {
+    if (origAcl) {
+      ++(*numExistingProcessed);
+      if (isAclUnchanged(origAcl, hash, priority, action)) {
+        return origAcl;
+      }
+    }
+    auto newAcl = createAcl(&acl, priority, action);
+    if (origAcl && *origAcl == *newAcl) {
       return origAcl;
     }
+    *changed = true;
+    return newAcl;
+  }();
+  if (cache_) {
+    newAcls_[acl.name] = AppliedConfigCache::Entry{hash, result};
   }
-  *changed = true;
-  return newAcl;
+  return result;
+}
+
+bool ThriftConfigApplier::isAclUnchanged(
+    const std::shared_ptr<AclEntry>& origAcl,
+    uint64_t hash,
+    int priority,
+    const MatchAction* action) const {
+  // The ACL is fully determined by its config, priority and action. If all
+  // of those are the same as when the existing entry was created, there is
+  // no need to build a new entry to compare against.
+  if (!cache_ || origAcl->getPriority() != priority) {
+    return false;
+  }
+  const auto& origAction = origAcl->getAclAction();
+  bool sameAction =
+      action ? origAction && *origAction == *action : !origAction.has_value();
+  if (!sameAction) {
+    return false;
+  }
+  auto it = cache_->acls_.find(origAcl->getID());
+  return it != cache_->acls_.end() && it->second.hash == hash &&
+      it->second.node.lock() == origAcl;
 }
 
 void ThriftConfigApplier::checkAcl(const cfg::AclEntry* config) const {
@@ -1826,12 +2078,14 @@ shared_ptr<RouteTableMap> ThriftConfigApplier::updateInterfaceRoutes() {
  * existing static routes in SwitchState and "reconcile" with that in
  * config.  I.e., add, delete, modify, or leave unchanged, as necessary.
  *
- * The second approach, the one we adopt here, not very intuitive but a lot
- * cleaner to code, is to simply delete all static routes in current state,
- * and to add back static routes from config file.  This works because the
- * "delete" in this step does not take immediate effect.  It is only the
- * state delta, after all processing is done, that is sent to the hardware
- * switch.
+ * The second approach is to simply delete all static routes in current
+ * state, and to add back static routes from config file.  This is what we
+ * used to do. It works because the "delete" does not take immediate effect,
+ * but it clones every route in the table even if no static route changed.
+ *
+ * So we now reconcile: static routes whose entry is already what the config
+ * asks for are left alone, and only the routes that are gone, new or
+ * different are touched.
  *
  * As a side note, there is a third (incorrect) approach that was tried, but
  * does not work.  The old approach was to compute the delta between old and
@@ -1849,24 +2103,23 @@ std::shared_ptr<RouteTableMap> ThriftConfigApplier::syncStaticRoutes(
   RouteUpdater updater(routes);
   auto staticClientId = ClientID::STATIC_ROUTE;
   auto staticAdminDistance = AdminDistance::STATIC_ROUTE;
-  updater.removeAllRoutesForClient(RouterID(0), staticClientId);
 
+  // Static routes from config. Later entries for the same prefix win, same
+  // as when they were all added one after the other.
+  flat_map<std::pair<RouterID, folly::CIDRNetwork>, RouteNextHopEntry>
+      configRoutes;
   for (const auto& route : *cfg_->staticRoutesToNull_ref()) {
-    auto prefix = folly::IPAddress::createNetwork(route.prefix);
-    updater.addRoute(
-        RouterID(route.routerID),
-        prefix.first,
-        prefix.second,
-        staticClientId,
+    configRoutes.insert_or_assign(
+        std::make_pair(
+            RouterID(route.routerID),
+            folly::IPAddress::createNetwork(route.prefix)),
         RouteNextHopEntry(RouteForwardAction::DROP, staticAdminDistance));
   }
   for (const auto& route : *cfg_->staticRoutesToCPU_ref()) {
-    auto prefix = folly::IPAddress::createNetwork(route.prefix);
-    updater.addRoute(
-        RouterID(route.routerID),
-        prefix.first,
-        prefix.second,
-        staticClientId,
+    configRoutes.insert_or_assign(
+        std::make_pair(
+            RouterID(route.routerID),
+            folly::IPAddress::createNetwork(route.prefix)),
         RouteNextHopEntry(RouteForwardAction::TO_CPU, staticAdminDistance));
   }
   for (const auto& route : *cfg_->staticRoutesWithNhops_ref()) {
@@ -1882,13 +2135,53 @@ std::shared_ptr<RouteTableMap> ThriftConfigApplier::syncStaticRoutes(
       nhops.emplace(
           UnresolvedNextHop(folly::IPAddress(nhopStr), UCMP_DEFAULT_WEIGHT));
     }
-    updater.addRoute(
-        RouterID(route.routerID),
-        prefix.first,
-        prefix.second,
-        staticClientId,
+    configRoutes.insert_or_assign(
+        std::make_pair(RouterID(route.routerID), prefix),
         RouteNextHopEntry(std::move(nhops), staticAdminDistance));
   }
+
+  // Remove the static routes that are no longer in config
+  if (auto table = routes->getRouteTableIf(RouterID(0))) {
+    auto delStaleRoutes = [&](const auto& rib) {
+      for (const auto& route : *rib->routes()) {
+        if (!route->getEntryForClient(staticClientId)) {
+          continue;
+        }
+        const auto& prefix = route->prefix();
+        folly::CIDRNetwork network(prefix.network, prefix.mask);
+        if (configRoutes.find(std::make_pair(RouterID(0), network)) ==
+            configRoutes.end()) {
+          updater.delRoute(
+              RouterID(0), network.first, network.second, staticClientId);
+        }
+      }
+    };
+    delStaleRoutes(table->getRibV4());
+    delStaleRoutes(table->getRibV6());
+  }
+
+  // Add the ones that are new or changed
+  for (const auto& configRoute : configRoutes) {
+    auto vrf = configRoute.first.first;
+    const auto& network = configRoute.first.second;
+    const RouteNextHopEntry* existing = nullptr;
+    if (auto table = routes->getRouteTableIf(vrf)) {
+      if (network.first.isV4()) {
+        auto route = table->getRibV4()->exactMatch(
+            RoutePrefixV4{network.first.asV4(), network.second});
+        existing = route ? route->getEntryForClient(staticClientId) : nullptr;
+      } else {
+        auto route = table->getRibV6()->exactMatch(
+            RoutePrefixV6{network.first.asV6(), network.second});
+        existing = route ? route->getEntryForClient(staticClientId) : nullptr;
+      }
+    }
+    if (existing && *existing == configRoute.second) {
+      continue;
+    }
+    updater.addRoute(
+        vrf, network.first, network.second, staticClientId, configRoute.second);
+  }
   return updater.updateDone();
 }
 
@@ -2466,9 +2759,10 @@ shared_ptr<SwitchState> applyThriftConfig(
     const shared_ptr<SwitchState>& state,
     const cfg::SwitchConfig* config,
     const Platform* platform,
-    rib::RoutingInformationBase* rib) {
+    rib::RoutingInformationBase* rib,
+    AppliedConfigCache* cache) {
   cfg::SwitchConfig emptyConfig;
-  return ThriftConfigApplier(state, config, platform, rib).run();
+  return ThriftConfigApplier(state, config, platform, rib, cache).run();
 }
 
 } // namespace facebook::fboss
@@ -10,7 +10,11 @@
 #pragma once
 
 #include <folly/Range.h>
+#include <folly/container/F14Map.h>
+
+#include <cstdint>
 #include <memory>
+#include <string>
 
 namespace facebook::fboss {
 
@@ -22,19 +26,53 @@ namespace cfg {
 class SwitchConfig;
 }
 
+class NodeBase;
 class Platform;
 class SwitchState;
 
+/*
+ * Remembers what the last config applied through applyThriftConfig() turned
+ * into, so that config sections that have not changed since can be skipped.
+ *
+ * For each section (and for each ACL) we keep a hash of the config it was
+ * built from together with the SwitchState node it resulted in. A section is
+ * only skipped if both its config hash and its node in the state being
+ * updated are the same as last time. Anything else that modifies the state
+ * in between therefore just causes that section to be rebuilt.
+ */
+class AppliedConfigCache {
+ public:
+  struct Entry {
+    uint64_t hash{0};
+    std::weak_ptr<const NodeBase> node;
+  };
+
+  void clear() {
+    sections_.clear();
+    acls_.clear();
+  }
+
+ private:
+  friend class ThriftConfigApplier;
+
+  folly::F14FastMap<std::string, Entry> sections_;
+  folly::F14FastMap<std::string, Entry> acls_;
+};
+
 /*
  * Apply a thrift config structure to a SwitchState object.
  *
  * Returns a new SwitchState object with the resulting state, or null if
  * the config file results in no changes.
+ *
+ * If a cache is passed in, config sections that did not change since the
+ * config last applied with that cache are not processed again.
  */
 std::shared_ptr<SwitchState> applyThriftConfig(
     const std::shared_ptr<SwitchState>& state,
     const cfg::SwitchConfig* config,
     const Platform* platform,
-    rib::RoutingInformationBase* rib = nullptr);
+    rib::RoutingInformationBase* rib = nullptr,
+    AppliedConfigCache* cache = nullptr);
 
 } // namespace facebook::fboss
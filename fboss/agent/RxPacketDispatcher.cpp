@@ -0,0 +1,182 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/RxPacketDispatcher.h"
+
+#include "fboss/agent/ArpHandler.h"
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/LacpTypes.h"
+#include "fboss/agent/LldpManager.h"
+#include "fboss/agent/RxPacket.h"
+#include "fboss/agent/RxPacketHeaders.h"
+
+#include <fb303/ServiceData.h>
+#include <folly/Conv.h>
+#include <folly/String.h>
+#include <folly/logging/xlog.h>
+#include <folly/system/ThreadName.h>
+
+#include <algorithm>
+
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+constexpr uint16_t kBgpPort = 179;
+} // namespace
+
+namespace facebook::fboss {
+
+RxPacketDispatcher::ClassConfig RxPacketDispatcher::defaultConfig(
+    PacketClass cls) {
+  switch (cls) {
+    case PacketClass::CONTROL:
+      return {1024, DropPolicy::DROP_NEWEST, 0};
+    case PacketClass::ROUTING:
+      return {4096, DropPolicy::DROP_NEWEST, 0};
+    case PacketClass::NEIGHBOR:
+      // A newer ARP/ND packet carries fresher information than the ones
+      // still waiting, so keep the newest under a storm.
+      return {4096, DropPolicy::DROP_OLDEST, 5};
+    case PacketClass::DEFAULT:
+      return {4096, DropPolicy::DROP_NEWEST, 5};
+  }
+  throw FbossError("Unknown packet class ", static_cast<int>(cls));
+}
+
+RxPacketDispatcher::RxPacketDispatcher(Handler handler)
+    : RxPacketDispatcher(
+          std::move(handler),
+          {defaultConfig(PacketClass::CONTROL),
+           defaultConfig(PacketClass::ROUTING),
+           defaultConfig(PacketClass::NEIGHBOR),
+           defaultConfig(PacketClass::DEFAULT)}) {}
+
+RxPacketDispatcher::RxPacketDispatcher(
+    Handler handler,
+    const std::array<ClassConfig, kNumClasses>& configs)
+    : handler_(std::move(handler)) {
+  for (size_t i = 0; i < kNumClasses; ++i) {
+    queues_[i] = std::make_unique<PacketQueue>(configs[i]);
+  }
+  for (size_t i = 0; i < kNumClasses; ++i) {
+    auto cls = static_cast<PacketClass>(i);
+    queues_[i]->worker = std::thread([this, cls]() { run(cls); });
+  }
+}
+
+RxPacketDispatcher::~RxPacketDispatcher() {
+  // Workers handle everything queued before the stop marker
+  for (auto& queue : queues_) {
+    queue->queue.blockingWrite(nullptr);
+  }
+  for (auto& queue : queues_) {
+    queue->worker.join();
+  }
+}
+
+void RxPacketDispatcher::run(PacketClass cls) {
+  folly::setThreadName(folly::to<std::string>("fbossRx", className(cls)));
+  auto& queue = queueFor(cls);
+  if (queue.config.niceness &&
+      setpriority(
+          PRIO_PROCESS, syscall(SYS_gettid), queue.config.niceness) != 0) {
+    XLOG(WARNING) << "Failed to set priority of " << className(cls)
+                  << " packet worker: " << folly::errnoStr(errno);
+  }
+  while (true) {
+    std::unique_ptr<RxPacket> pkt;
+    queue.queue.blockingRead(pkt);
+    if (!pkt) {
+      return;
+    }
+    handler_(std::move(pkt));
+  }
+}
+
+void RxPacketDispatcher::dispatch(std::unique_ptr<RxPacket> pkt) noexcept {
+  auto cls = classify(pkt.get());
+  auto& queue = queueFor(cls);
+  // write() leaves pkt alone when the queue is full
+  while (!queue.queue.write(std::move(pkt))) {
+    if (queue.config.dropPolicy == DropPolicy::DROP_NEWEST) {
+      ++queue.drops;
+      return;
+    }
+    std::unique_ptr<RxPacket> oldest;
+    if (queue.queue.read(oldest)) {
+      ++queue.drops;
+    }
+  }
+  auto depth = this->depth(cls);
+  auto maxDepth = queue.maxDepth.load(std::memory_order_relaxed);
+  while (depth > maxDepth &&
+         !queue.maxDepth.compare_exchange_weak(
+             maxDepth, depth, std::memory_order_relaxed)) {
+  }
+}
+
+RxPacketDispatcher::PacketClass RxPacketDispatcher::classify(
+    const RxPacket* pkt) {
+  auto headers = RxPacketHeaders::parse(pkt);
+  switch (headers.ethertype) {
+    case LACPDU::EtherType::SLOW_PROTOCOLS:
+    case LldpManager::ETHERTYPE_LLDP:
+      return PacketClass::CONTROL;
+    case ArpHandler::ETHERTYPE_ARP:
+      return PacketClass::NEIGHBOR;
+    default:
+      break;
+  }
+  if (headers.isNdp()) {
+    return PacketClass::NEIGHBOR;
+  }
+  if (headers.isTcp() &&
+      (headers.srcPort == kBgpPort || headers.dstPort == kBgpPort)) {
+    return PacketClass::ROUTING;
+  }
+  return PacketClass::DEFAULT;
+}
+
+folly::StringPiece RxPacketDispatcher::className(PacketClass cls) {
+  switch (cls) {
+    case PacketClass::CONTROL:
+      return "control";
+    case PacketClass::ROUTING:
+      return "routing";
+    case PacketClass::NEIGHBOR:
+      return "neighbor";
+    case PacketClass::DEFAULT:
+      return "default";
+  }
+  return "unknown";
+}
+
+uint64_t RxPacketDispatcher::drops(PacketClass cls) const {
+  return queueFor(cls).drops.load();
+}
+
+size_t RxPacketDispatcher::depth(PacketClass cls) const {
+  return std::max<ssize_t>(queueFor(cls).queue.sizeGuess(), 0);
+}
+
+void RxPacketDispatcher::exportStats() {
+  for (size_t i = 0; i < kNumClasses; ++i) {
+    auto cls = static_cast<PacketClass>(i);
+    auto prefix = folly::to<std::string>("rx_dispatch.", className(cls));
+    auto& queue = queueFor(cls);
+    fb303::fbData->setCounter(prefix + ".depth", depth(cls));
+    fb303::fbData->setCounter(
+        prefix + ".max_depth", queue.maxDepth.exchange(0));
+    fb303::fbData->setCounter(prefix + ".drops", queue.drops.load());
+  }
+}
+
+} // namespace facebook::fboss
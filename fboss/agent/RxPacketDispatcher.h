@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/MPMCQueue.h>
+#include <folly/Range.h>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace facebook::fboss {
+
+class RxPacket;
+
+/*
+ * RxPacketDispatcher moves the handling of trapped packets off the thread
+ * that received them from the hardware.
+ *
+ * Every packet is classified by peeking at its ethertype and, for IP, its
+ * protocol and ports, and is put on the bounded queue of its class. Each
+ * class has its own worker thread, queue size and drop policy, so a storm of
+ * e.g. ND packets fills up and drops from the NEIGHBOR queue only, while
+ * LACP and LLDP (CONTROL) and BGP (ROUTING) packets keep being handled
+ * right away. Packets of the same class are handled in the order they were
+ * received.
+ *
+ * Queue depth, high watermark and drops of each class are exported as fb303
+ * counters "rx_dispatch.<class>.{depth,max_depth,drops}" by exportStats().
+ */
+class RxPacketDispatcher {
+ public:
+  using Handler = std::function<void(std::unique_ptr<RxPacket>)>;
+
+  enum class PacketClass : uint8_t {
+    CONTROL, // LACP, LLDP
+    ROUTING, // BGP
+    NEIGHBOR, // ARP, NDP
+    DEFAULT, // Everything else
+  };
+  static constexpr size_t kNumClasses = 4;
+
+  enum class DropPolicy {
+    // Drop the packet being enqueued
+    DROP_NEWEST,
+    // Drop the oldest queued packet to make room for the new one, for
+    // protocols where the latest packet supersedes the earlier ones
+    DROP_OLDEST,
+  };
+
+  struct ClassConfig {
+    size_t capacity;
+    DropPolicy dropPolicy;
+    // Scheduling priority of the worker thread, as a nice(2) value
+    int niceness;
+  };
+
+  static ClassConfig defaultConfig(PacketClass cls);
+
+  explicit RxPacketDispatcher(Handler handler);
+  RxPacketDispatcher(
+      Handler handler,
+      const std::array<ClassConfig, kNumClasses>& configs);
+  ~RxPacketDispatcher();
+
+  /*
+   * Queue the packet to the worker of its class. Never blocks: if the
+   * queue is full a packet is dropped according to the drop policy of the
+   * class.
+   */
+  void dispatch(std::unique_ptr<RxPacket> pkt) noexcept;
+
+  static PacketClass classify(const RxPacket* pkt);
+  static folly::StringPiece className(PacketClass cls);
+
+  uint64_t drops(PacketClass cls) const;
+  size_t depth(PacketClass cls) const;
+
+  // Export the per class counters, and reset the high watermarks
+  void exportStats();
+
+ private:
+  // A null packet tells the worker to stop
+  using Queue = folly::MPMCQueue<std::unique_ptr<RxPacket>>;
+
+  struct PacketQueue {
+    explicit PacketQueue(const ClassConfig& config)
+        : config(config), queue(config.capacity) {}
+
+    const ClassConfig config;
+    Queue queue;
+    std::atomic<uint64_t> drops{0};
+    std::atomic<size_t> maxDepth{0};
+    std::thread worker;
+  };
+
+  void run(PacketClass cls);
+  PacketQueue& queueFor(PacketClass cls) const {
+    return *queues_[static_cast<size_t>(cls)];
+  }
+
+  Handler handler_;
+  std::array<std::unique_ptr<PacketQueue>, kNumClasses> queues_;
+};
+
+} // namespace facebook::fboss
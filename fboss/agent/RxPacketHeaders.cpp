@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/RxPacketHeaders.h"
+
+#include "fboss/agent/IPv4Handler.h"
+#include "fboss/agent/IPv6Handler.h"
+#include "fboss/agent/RxPacket.h"
+#include "fboss/agent/packet/PktUtil.h"
+
+#include <folly/io/Cursor.h>
+
+#include <stdexcept>
+
+namespace {
+constexpr uint16_t kEthertypeVlan = 0x8100;
+constexpr size_t kIPv6HeaderLen = 40;
+constexpr size_t kIPv6NextHeaderOffset = 6;
+constexpr size_t kIPv4ProtocolOffset = 9;
+} // namespace
+
+namespace facebook::fboss {
+
+RxPacketHeaders RxPacketHeaders::parse(const RxPacket* pkt) {
+  RxPacketHeaders headers;
+  folly::io::Cursor c(pkt->buf());
+  try {
+    c += folly::MacAddress::SIZE;
+    headers.srcMac = PktUtil::readMac(&c);
+    auto ethertype = c.readBE<uint16_t>();
+    if (ethertype == kEthertypeVlan) {
+      c += 2;
+      ethertype = c.readBE<uint16_t>();
+    }
+    headers.ethertype = ethertype;
+
+    folly::io::Cursor payload(c);
+    if (ethertype == IPv4Handler::ETHERTYPE_IPV4) {
+      auto headerLen = (folly::io::Cursor(c).read<uint8_t>() & 0x0f) * 4;
+      headers.ipProto =
+          static_cast<IP_PROTO>((c + kIPv4ProtocolOffset).read<uint8_t>());
+      payload = c + headerLen;
+    } else if (ethertype == IPv6Handler::ETHERTYPE_IPV6) {
+      headers.ipProto =
+          static_cast<IP_PROTO>((c + kIPv6NextHeaderOffset).read<uint8_t>());
+      payload = c + kIPv6HeaderLen;
+    } else {
+      return headers;
+    }
+
+    if (headers.isTcp() || headers.isUdp()) {
+      auto srcPort = payload.readBE<uint16_t>();
+      auto dstPort = payload.readBE<uint16_t>();
+      headers.srcPort = srcPort;
+      headers.dstPort = dstPort;
+    } else if (
+        ethertype == IPv6Handler::ETHERTYPE_IPV6 &&
+        headers.ipProto == IP_PROTO::IP_PROTO_IPV6_ICMP) {
+      headers.icmpv6Type = static_cast<ICMPv6Type>(payload.read<uint8_t>());
+    }
+  } catch (const std::out_of_range&) {
+  }
+  return headers;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/packet/ICMPHdr.h"
+#include "fboss/agent/packet/IPProto.h"
+
+#include <folly/MacAddress.h>
+
+#include <cstdint>
+#include <optional>
+
+namespace facebook::fboss {
+
+class RxPacket;
+
+/*
+ * The few header fields of a trapped packet that RxPacketDispatcher and
+ * RxPacketPolicer classify it by, read in place without parsing the whole
+ * packet. Fields the packet is too short to hold are left unset, and such
+ * packets are left for the handlers to drop as bogus.
+ */
+struct RxPacketHeaders {
+  folly::MacAddress srcMac;
+  // After the VLAN tag, if any
+  uint16_t ethertype{0};
+  // IPv4 protocol or IPv6 next header
+  std::optional<IP_PROTO> ipProto;
+  // TCP and UDP only, 0 if not read as no packet uses port 0
+  uint16_t srcPort{0};
+  uint16_t dstPort{0};
+  std::optional<ICMPv6Type> icmpv6Type;
+
+  static RxPacketHeaders parse(const RxPacket* pkt);
+
+  bool isNdp() const {
+    return icmpv6Type &&
+        *icmpv6Type >= ICMPv6Type::ICMPV6_TYPE_NDP_ROUTER_SOLICITATION &&
+        *icmpv6Type <= ICMPv6Type::ICMPV6_TYPE_NDP_REDIRECT_MESSAGE;
+  }
+  bool isTcp() const {
+    return ipProto == IP_PROTO::IP_PROTO_TCP;
+  }
+  bool isUdp() const {
+    return ipProto == IP_PROTO::IP_PROTO_UDP;
+  }
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/RxPacketPolicer.h"
+
+#include "fboss/agent/ArpHandler.h"
+#include "fboss/agent/DHCPv4Handler.h"
+#include "fboss/agent/IPv4Handler.h"
+#include "fboss/agent/RxPacket.h"
+#include "fboss/agent/RxPacketHeaders.h"
+#include "fboss/agent/packet/DHCPv6Packet.h"
+
+#include <fb303/ServiceData.h>
+#include <folly/Conv.h>
+#include <folly/hash/Hash.h>
+
+namespace facebook::fboss {
+
+size_t RxPacketPolicer::BucketKeyHash::operator()(const BucketKey& key) const {
+  return folly::hash::hash_combine(
+      static_cast<uint32_t>(key.port),
+      static_cast<uint8_t>(key.cls),
+      key.srcMac.u64NBO());
+}
+
+RxPacketPolicer::RxPacketPolicer(
+    const std::array<Rate, kNumClasses>& rates,
+    size_t maxBuckets)
+    : rates_(rates), maxBuckets_(maxBuckets) {}
+
+std::optional<RxPacketPolicer::PacketClass> RxPacketPolicer::classify(
+    const RxPacket* pkt,
+    folly::MacAddress* srcMac) {
+  auto headers = RxPacketHeaders::parse(pkt);
+  *srcMac = headers.srcMac;
+  if (headers.ethertype == ArpHandler::ETHERTYPE_ARP) {
+    return PacketClass::ARP;
+  }
+  if (headers.isNdp()) {
+    return PacketClass::NDP;
+  }
+  if (!headers.isUdp()) {
+    return std::nullopt;
+  }
+  auto port = headers.dstPort;
+  bool isDhcp = headers.ethertype == IPv4Handler::ETHERTYPE_IPV4
+      ? port == DHCPv4Handler::kBootPSPort || port == DHCPv4Handler::kBootPCPort
+      : port == DHCPv6Packet::DHCP6_CLIENT_UDPPORT ||
+          port == DHCPv6Packet::DHCP6_SERVERAGENT_UDPPORT;
+  return isDhcp ? std::optional<PacketClass>(PacketClass::DHCP) : std::nullopt;
+}
+
+folly::StringPiece RxPacketPolicer::className(PacketClass cls) {
+  switch (cls) {
+    case PacketClass::ARP:
+      return "arp";
+    case PacketClass::NDP:
+      return "ndp";
+    case PacketClass::DHCP:
+      return "dhcp";
+  }
+  return "unknown";
+}
+
+bool RxPacketPolicer::consume(
+    const Bucket& bucket,
+    PacketClass cls,
+    double now) const {
+  const auto& r = rate(cls);
+  if (bucket.tokens.consume(1, r.packetsPerSec, r.burst, now)) {
+    return true;
+  }
+  ++bucket.drops;
+  return false;
+}
+
+bool RxPacketPolicer::admit(const RxPacket* pkt, double nowInSeconds) {
+  folly::MacAddress srcMac;
+  auto cls = classify(pkt, &srcMac);
+  if (!cls || rate(*cls).packetsPerSec <= 0) {
+    return true;
+  }
+  BucketKey key{pkt->getSrcPort(), *cls, srcMac};
+  {
+    auto buckets = buckets_.rlock();
+    auto it = buckets->find(key);
+    if (it == buckets->end() && buckets->size() >= maxBuckets_) {
+      // Too many sources: once the shared bucket of the port exists, new
+      // sources don't need the write lock either, e.g. under a spoofed
+      // source MAC storm
+      key.srcMac = folly::MacAddress();
+      it = buckets->find(key);
+    }
+    if (it != buckets->end()) {
+      return consume(it->second, *cls, nowInSeconds);
+    }
+  }
+  auto buckets = buckets_.wlock();
+  // Too many sources, share the bucket of the port
+  key.srcMac = buckets->size() >= maxBuckets_ ? folly::MacAddress() : srcMac;
+  // A new bucket starts out full
+  const auto& r = rate(*cls);
+  auto it = buckets
+                ->try_emplace(key, nowInSeconds - r.burst / r.packetsPerSec)
+                .first;
+  return consume(it->second, *cls, nowInSeconds);
+}
+
+uint64_t RxPacketPolicer::drops(PortID port, PacketClass cls) const {
+  uint64_t total = 0;
+  auto buckets = buckets_.rlock();
+  for (const auto& [key, bucket] : *buckets) {
+    if (key.port == port && key.cls == cls) {
+      total += bucket.drops.load();
+    }
+  }
+  auto retired = retiredDrops_.rlock();
+  auto it = retired->find(PortAndClass(port, cls));
+  return it == retired->end() ? total : total + it->second;
+}
+
+size_t RxPacketPolicer::numBuckets() const {
+  return buckets_.rlock()->size();
+}
+
+void RxPacketPolicer::exportStats(double nowInSeconds) {
+  std::map<PortAndClass, uint64_t> drops;
+  {
+    auto buckets = buckets_.wlock();
+    auto retired = retiredDrops_.wlock();
+    for (auto it = buckets->begin(); it != buckets->end();) {
+      const auto& [key, bucket] = *it;
+      PortAndClass portAndClass(key.port, key.cls);
+      const auto& r = rate(key.cls);
+      if (bucket.tokens.available(r.packetsPerSec, r.burst, nowInSeconds) <
+          r.burst) {
+        drops[portAndClass] += bucket.drops.load();
+        ++it;
+        continue;
+      }
+      (*retired)[portAndClass] += bucket.drops.load();
+      it = buckets->erase(it);
+    }
+    for (const auto& [portAndClass, retiredDrops] : *retired) {
+      drops[portAndClass] += retiredDrops;
+    }
+    fb303::fbData->setCounter("rx_policer.buckets", buckets->size());
+  }
+
+  std::array<uint64_t, kNumClasses> classDrops{};
+  for (const auto& [portAndClass, count] : drops) {
+    auto [port, cls] = portAndClass;
+    classDrops[static_cast<size_t>(cls)] += count;
+    fb303::fbData->setCounter(
+        folly::to<std::string>(
+            "rx_policer.", className(cls), ".port", port, ".drops"),
+        count);
+  }
+  for (size_t i = 0; i < kNumClasses; ++i) {
+    fb303::fbData->setCounter(
+        folly::to<std::string>(
+            "rx_policer.", className(static_cast<PacketClass>(i)), ".drops"),
+        classDrops[i]);
+  }
+}
+
+} // namespace facebook::fboss
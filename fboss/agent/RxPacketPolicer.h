@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/types.h"
+
+#include <folly/MacAddress.h>
+#include <folly/Synchronized.h>
+#include <folly/TokenBucket.h>
+#include <folly/container/F14Map.h>
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <optional>
+#include <utility>
+
+namespace facebook::fboss {
+
+class RxPacket;
+
+/*
+ * Software policer for trapped packets that create work in the agent, on
+ * top of the CoPP policers in hardware.
+ *
+ * Packets are metered by a token bucket per (ingress port, packet class,
+ * source MAC), so a single misbehaving host can't starve the others on the
+ * same port. Once kMaxBuckets sources are tracked, packets from new sources
+ * share a bucket per (port, class). Buckets that are idle, i.e. full again,
+ * are forgotten by exportStats().
+ *
+ * Packets of other classes are always admitted.
+ */
+class RxPacketPolicer {
+ public:
+  enum class PacketClass : uint8_t {
+    ARP,
+    NDP,
+    DHCP,
+  };
+  static constexpr size_t kNumClasses = 3;
+  static constexpr size_t kMaxBuckets = 16384;
+
+  // A rate of 0 packets per second leaves the class unpoliced
+  struct Rate {
+    double packetsPerSec;
+    double burst;
+  };
+
+  explicit RxPacketPolicer(
+      const std::array<Rate, kNumClasses>& rates,
+      size_t maxBuckets = kMaxBuckets);
+
+  /*
+   * Returns whether the packet should be handled. Dropped packets are
+   * accounted to their bucket.
+   */
+  bool admit(const RxPacket* pkt) {
+    return admit(pkt, folly::DynamicTokenBucket::defaultClockNow());
+  }
+  bool admit(const RxPacket* pkt, double nowInSeconds);
+
+  static std::optional<PacketClass> classify(
+      const RxPacket* pkt,
+      folly::MacAddress* srcMac);
+  static folly::StringPiece className(PacketClass cls);
+
+  uint64_t drops(PortID port, PacketClass cls) const;
+  size_t numBuckets() const;
+
+  /*
+   * Export per port and per class drops as fb303 counters
+   * "rx_policer.<class>.port<port>.drops" and "rx_policer.<class>.drops",
+   * and forget idle buckets.
+   */
+  void exportStats() {
+    exportStats(folly::DynamicTokenBucket::defaultClockNow());
+  }
+  void exportStats(double nowInSeconds);
+
+ private:
+  struct BucketKey {
+    PortID port;
+    PacketClass cls;
+    folly::MacAddress srcMac;
+
+    bool operator==(const BucketKey& other) const {
+      return port == other.port && cls == other.cls &&
+          srcMac == other.srcMac;
+    }
+  };
+  struct BucketKeyHash {
+    size_t operator()(const BucketKey& key) const;
+  };
+  struct Bucket {
+    explicit Bucket(double zeroTime) : tokens(zeroTime) {}
+
+    // Metered with just the read lock held on the bucket map
+    mutable folly::DynamicTokenBucket tokens;
+    mutable std::atomic<uint64_t> drops{0};
+  };
+  using PortAndClass = std::pair<PortID, PacketClass>;
+
+  bool consume(const Bucket& bucket, PacketClass cls, double now) const;
+  const Rate& rate(PacketClass cls) const {
+    return rates_[static_cast<size_t>(cls)];
+  }
+
+  const std::array<Rate, kNumClasses> rates_;
+  const size_t maxBuckets_;
+  // Buckets are only inserted or erased with the write lock held. Metering
+  // and drop accounting take the read lock, as both are atomic.
+  folly::Synchronized<folly::F14NodeMap<BucketKey, Bucket, BucketKeyHash>>
+      buckets_;
+  // Drops of buckets already forgotten
+  folly::Synchronized<std::map<PortAndClass, uint64_t>> retiredDrops_;
+};
+
+} // namespace facebook::fboss
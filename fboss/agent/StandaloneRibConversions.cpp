@@ -36,15 +36,15 @@ std::shared_ptr<RouteTableMap> standaloneToSwitchStateRib(
   return RouteTableMap::fromFollyDynamic(serialized);
 }
 
-static void dynamicFibUpdate(
-    facebook::fboss::RouterID vrf,
-    const facebook::fboss::rib::IPv4NetworkToRouteMap& v4NetworkToRoute,
-    const facebook::fboss::rib::IPv6NetworkToRouteMap& v6NetworkToRoute,
+void dynamicFibUpdate(
+    RouterID vrf,
+    const rib::IPv4NetworkToRouteMap& v4NetworkToRoute,
+    const rib::IPv6NetworkToRouteMap& v6NetworkToRoute,
     void* cookie) {
   rib::ForwardingInformationBaseUpdater fibUpdater(
       vrf, v4NetworkToRoute, v6NetworkToRoute);
 
-  auto sw = static_cast<facebook::fboss::SwSwitch*>(cookie);
+  auto sw = static_cast<SwSwitch*>(cookie);
   sw->updateStateBlocking("", std::move(fibUpdater));
 }
 
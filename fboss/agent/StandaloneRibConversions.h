@@ -24,6 +24,16 @@ rib::RoutingInformationBase switchStateToStandaloneRib(
 std::shared_ptr<RouteTableMap> standaloneToSwitchStateRib(
     const rib::RoutingInformationBase& standaloneRib);
 
+/*
+ * FibUpdateFunction for a standalone RIB driving a SwSwitch: the cookie is
+ * the SwSwitch, which the routes of vrf are programmed on.
+ */
+void dynamicFibUpdate(
+    RouterID vrf,
+    const rib::IPv4NetworkToRouteMap& v4NetworkToRoute,
+    const rib::IPv6NetworkToRouteMap& v6NetworkToRoute,
+    void* cookie);
+
 void syncFibWithStandaloneRib(
     rib::RoutingInformationBase& standaloneRib,
     SwSwitch* swSwitch);
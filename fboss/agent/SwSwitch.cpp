@@ -35,10 +35,14 @@
 #include "fboss/agent/RestartTimeTracker.h"
 #include "fboss/agent/RouteUpdateLogger.h"
 #include "fboss/agent/RxPacket.h"
+#include "fboss/agent/RxPacketDispatcher.h"
+#include "fboss/agent/RxPacketPolicer.h"
+#include "fboss/agent/StandaloneRibConversions.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/ThriftHandler.h"
 #include "fboss/agent/TunManager.h"
 #include "fboss/agent/TxPacket.h"
+#include "fboss/agent/UpdateTracer.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/capture/PcapPkt.h"
 #include "fboss/agent/capture/PktCaptureManager.h"
@@ -71,6 +75,7 @@
 #include <chrono>
 #include <condition_variable>
 #include <exception>
+#include <optional>
 #include <tuple>
 
 using folly::EventBase;
@@ -104,6 +109,48 @@ DEFINE_bool(
     false,
     "Flag to turn on logging of all updates to the FIB");
 
+DEFINE_int32(
+    state_memory_stats_interval_s,
+    0,
+    "Interval at which to export switch state memory usage counters (s), "
+    "0 to disable. Each export walks the whole state, "
+    "getSwitchStateMemoryUsage computes the usage on demand instead");
+
+DEFINE_bool(
+    enable_pipelined_hw_programming,
+    false,
+    "Program the hardware on a dedicated thread, so that the update thread "
+    "can prepare the next state update while the previous one is being "
+    "programmed. State observers are then notified from that thread");
+
+DEFINE_bool(
+    enable_rx_dispatch,
+    false,
+    "Handle trapped packets on per class worker threads instead of the "
+    "thread that received them, so that a flood of one kind of packets "
+    "doesn't delay the others");
+
+DEFINE_bool(
+    enable_rx_policer,
+    false,
+    "Police trapped ARP, NDP and DHCP packets per port and source MAC "
+    "before handling them");
+DEFINE_int32(
+    rx_policer_arp_pps,
+    100,
+    "ARP packets per second allowed per port and source MAC, with a burst "
+    "of one second worth of packets. 0 to not police ARP");
+DEFINE_int32(
+    rx_policer_ndp_pps,
+    100,
+    "NDP packets per second allowed per port and source MAC, with a burst "
+    "of one second worth of packets. 0 to not police NDP");
+DEFINE_int32(
+    rx_policer_dhcp_pps,
+    50,
+    "DHCP packets per second allowed per port and source MAC, with a burst "
+    "of one second worth of packets. 0 to not police DHCP");
+
 namespace {
 
 /**
@@ -144,6 +191,23 @@ facebook::fboss::PortStatus fillInPortStatus(
   }
   return status;
 }
+
+std::unique_ptr<facebook::fboss::RxPacketPolicer> makeRxPolicer() {
+  using facebook::fboss::RxPacketPolicer;
+  if (!FLAGS_enable_rx_policer) {
+    return nullptr;
+  }
+  auto rate = [](int32_t pps) {
+    return RxPacketPolicer::Rate{
+        static_cast<double>(pps), static_cast<double>(pps)};
+  };
+  return std::make_unique<RxPacketPolicer>(
+      std::array<RxPacketPolicer::Rate, RxPacketPolicer::kNumClasses>{
+          rate(FLAGS_rx_policer_arp_pps),
+          rate(FLAGS_rx_policer_ndp_pps),
+          rate(FLAGS_rx_policer_dhcp_pps)});
+}
+
 } // anonymous namespace
 
 namespace facebook::fboss {
@@ -151,11 +215,20 @@ namespace facebook::fboss {
 SwSwitch::SwSwitch(std::unique_ptr<Platform> platform)
     : hw_(platform->getHwSwitch()),
       platform_(std::move(platform)),
+      pipelinedHwProgramming_(FLAGS_enable_pipelined_hw_programming),
       arp_(new ArpHandler(this)),
       ipv4_(new IPv4Handler(this)),
       ipv6_(new IPv6Handler(this)),
       nUpdater_(new NeighborUpdater(this)),
       pcapMgr_(new PktCaptureManager(this)),
+      rxDispatcher_(
+          FLAGS_enable_rx_dispatch
+              ? std::make_unique<RxPacketDispatcher>(
+                    [this](std::unique_ptr<RxPacket> pkt) {
+                      handlePacketNoThrow(std::move(pkt));
+                    })
+              : nullptr),
+      rxPolicer_(makeRxPolicer()),
       mirrorManager_(new MirrorManager(this)),
       routeUpdateLogger_(new RouteUpdateLogger(this)),
       resolvedNexthopMonitor_(new ResolvedNexthopMonitor(this)),
@@ -177,6 +250,12 @@ SwSwitch::~SwSwitch() {
 }
 
 void SwSwitch::stop() {
+  // Queued route batches are programmed through updateStateBlocking(), so
+  // drop the ones still pending while the update thread can still finish
+  // the one being applied.
+  if (routeUpdateQueue_) {
+    routeUpdateQueue_->stop();
+  }
   setSwitchRunState(SwitchRunState::EXITING);
 
   XLOG(INFO) << "Stopping SwSwitch...";
@@ -186,6 +265,10 @@ void SwSwitch::stop() {
   // while we are destroying ourselves
   hw_->unregisterCallbacks();
 
+  // Packets still queued are dropped by handlePacket(), as we are exiting.
+  // Stop the workers before the packet handlers go away.
+  rxDispatcher_.reset();
+
   // Stop tunMgr so we don't get any packets to process
   // in software that were sent to the switch ip or were
   // routed from kernel to the front panel tunnel interface.
@@ -226,6 +309,8 @@ void SwSwitch::stop() {
   packetTxThreadHeartbeat_.reset();
   lacpThreadHeartbeat_.reset();
   neighborCacheThreadHeartbeat_.reset();
+  // The queue is stopped already, but still points at the RIB
+  routeUpdateQueue_.reset();
   rib_.reset();
 
   lookupClassUpdater_.reset();
@@ -331,6 +416,13 @@ void SwSwitch::getProductInfo(ProductInfo& productInfo) const {
 void SwSwitch::updateStats() {
   updateRouteStats();
   updatePortInfo();
+  updateStateMemoryStats();
+  if (rxDispatcher_) {
+    rxDispatcher_->exportStats();
+  }
+  if (rxPolicer_) {
+    rxPolicer_->exportStats();
+  }
   try {
     getHw()->updateStats(stats());
   } catch (const std::exception& ex) {
@@ -339,6 +431,62 @@ void SwSwitch::updateStats() {
   }
 }
 
+StateMemoryUsage SwSwitch::getStateMemoryUsage() const {
+  auto appliedState = getAppliedState();
+  return StateMemoryUsage::compute(getDesiredState(), appliedState);
+}
+
+void SwSwitch::updateStateMemoryStats() {
+  // Walking the whole state is too expensive to do every stats interval
+  if (FLAGS_state_memory_stats_interval_s <= 0) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  if (now - lastStateMemoryStats_ <
+      std::chrono::seconds(FLAGS_state_memory_stats_interval_s)) {
+    return;
+  }
+  lastStateMemoryStats_ = now;
+
+  auto state = getDesiredState();
+  auto usage = StateMemoryUsage::compute(state, getAppliedState());
+  auto exportUsage = [](folly::StringPiece name,
+                        const NodeMemoryUsage& nodeUsage) {
+    auto prefix = folly::to<std::string>("switch_state.memory.", name);
+    fb303::fbData->setCounter(prefix + ".nodes", nodeUsage.nodes);
+    fb303::fbData->setCounter(prefix + ".bytes", nodeUsage.bytes);
+    fb303::fbData->setCounter(prefix + ".shared_bytes", nodeUsage.sharedBytes);
+    fb303::fbData->setCounter(
+        prefix + ".unique_bytes", nodeUsage.uniqueBytes());
+  };
+  exportUsage("total", usage.getTotal());
+  // Counters have fixed names, rather than the type names usage is keyed on
+  const std::pair<folly::StringPiece, const NodeBase*> subtrees[] = {
+      {"ports", state->getPorts().get()},
+      {"aggregate_ports", state->getAggregatePorts().get()},
+      {"vlans", state->getVlans().get()},
+      {"interfaces", state->getInterfaces().get()},
+      {"route_tables", state->getRouteTables().get()},
+      {"acls", state->getAcls().get()},
+      {"sflow_collectors", state->getSflowCollectors().get()},
+      {"qos_policies", state->getQosPolicies().get()},
+      {"control_plane", state->getControlPlane().get()},
+      {"load_balancers", state->getLoadBalancers().get()},
+      {"mirrors", state->getMirrors().get()},
+      {"fibs", state->getFibs().get()},
+      {"label_fib", state->getLabelForwardingInformationBase().get()},
+      {"switch_settings", state->getSwitchSettings().get()},
+  };
+  const auto& bySubtree = usage.getBySubtree();
+  for (const auto& [name, node] : subtrees) {
+    if (!node) {
+      continue;
+    }
+    auto it = bySubtree.find(StateMemoryUsage::nodeTypeName(node));
+    exportUsage(name, it == bySubtree.end() ? NodeMemoryUsage() : it->second);
+  }
+}
+
 void SwSwitch::registerNeighborListener(
     std::function<void(
         const std::vector<std::string>& added,
@@ -425,8 +573,25 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
   }
   platform_->onHwInitialized(this);
 
+  if (flags & SwitchFlags::ENABLE_STANDALONE_RIB) {
+    routeUpdateQueue_ = std::make_unique<rib::RouteUpdateQueue>(
+        rib_.get(),
+        &dynamicFibUpdate,
+        static_cast<void*>(this),
+        [this](const rib::RoutingInformationBase::UpdateStatistics& ribStats) {
+          stats()->addRoutesV4(ribStats.v4RoutesAdded);
+          stats()->addRoutesV6(ribStats.v6RoutesAdded);
+          stats()->delRoutesV4(ribStats.v4RoutesDeleted);
+          stats()->delRoutesV6(ribStats.v6RoutesDeleted);
+          stats()->routeUpdate(
+              ribStats.duration,
+              ribStats.v4RoutesAdded + ribStats.v6RoutesAdded +
+                  ribStats.v4RoutesDeleted + ribStats.v6RoutesDeleted);
+        });
+  }
+
   // Notify the state observers of the initial state
-  updateEventBase_.runInEventBaseThread([initialStateDesired, this]() {
+  getObserverEvb()->runInEventBaseThread([initialStateDesired, this]() {
     notifyStateObservers(
         StateDelta(std::make_shared<SwitchState>(), initialStateDesired));
   });
@@ -585,22 +750,22 @@ void SwSwitch::registerStateObserver(
     StateObserver* observer,
     const string name) {
   XLOG(DBG2) << "Registering state observer: " << name;
-  updateEventBase_.runImmediatelyOrRunInEventBaseThreadAndWait(
+  getObserverEvb()->runImmediatelyOrRunInEventBaseThreadAndWait(
       [=]() { addStateObserver(observer, name); });
 }
 
 void SwSwitch::unregisterStateObserver(StateObserver* observer) {
-  updateEventBase_.runImmediatelyOrRunInEventBaseThreadAndWait(
+  getObserverEvb()->runImmediatelyOrRunInEventBaseThreadAndWait(
       [=]() { removeStateObserver(observer); });
 }
 
 bool SwSwitch::stateObserverRegistered(StateObserver* observer) {
-  DCHECK(updateEventBase_.isInEventBaseThread());
+  DCHECK(getObserverEvb()->isInEventBaseThread());
   return stateObservers_.find(observer) != stateObservers_.end();
 }
 
 void SwSwitch::removeStateObserver(StateObserver* observer) {
-  DCHECK(updateEventBase_.isInEventBaseThread());
+  DCHECK(getObserverEvb()->isInEventBaseThread());
   auto nErased = stateObservers_.erase(observer);
   if (!nErased) {
     throw FbossError("State observer remove failed: observer does not exist");
@@ -608,7 +773,7 @@ void SwSwitch::removeStateObserver(StateObserver* observer) {
 }
 
 void SwSwitch::addStateObserver(StateObserver* observer, const string& name) {
-  DCHECK(updateEventBase_.isInEventBaseThread());
+  DCHECK(getObserverEvb()->isInEventBaseThread());
   if (stateObserverRegistered(observer)) {
     throw FbossError("State observer add failed: ", name, " already exists");
   }
@@ -616,7 +781,7 @@ void SwSwitch::addStateObserver(StateObserver* observer, const string& name) {
 }
 
 void SwSwitch::notifyStateObservers(const StateDelta& delta) {
-  CHECK(updateEventBase_.inRunningEventBaseThread());
+  CHECK(getObserverEvb()->inRunningEventBaseThread());
   if (isExiting()) {
     // Make sure the SwSwitch is not already being destroyed
     return;
@@ -634,6 +799,10 @@ void SwSwitch::notifyStateObservers(const StateDelta& delta) {
 }
 
 void SwSwitch::updateState(unique_ptr<StateUpdate> update) {
+  if (!UpdateTracer::currentTraces().empty()) {
+    update->traces_ = UpdateTracer::currentTraces();
+    update->enqueueTime_ = std::chrono::steady_clock::now();
+  }
   {
     folly::SpinLockGuard guard(pendingUpdatesLock_);
     pendingUpdates_.push_back(*update.release());
@@ -728,6 +897,23 @@ void SwSwitch::handlePendingUpdates() {
   // not initialized yet
   DCHECK(isInitialized());
 
+  // Carry over the traces of the updates being applied, so the rest of the
+  // processing on this thread is attributed to them.
+  UpdateTraces traces;
+  auto dequeueTime = std::chrono::steady_clock::now();
+  for (const auto& update : updates) {
+    for (const auto& trace : update.traces_) {
+      trace->addSpan(
+          "state_update_queue_wait", update.enqueueTime_, dequeueTime);
+      UpdateTracer::get()->recordStage(
+          "state_update_queue_wait", dequeueTime - update.enqueueTime_);
+      traces.push_back(trace);
+    }
+  }
+  ScopedTraceContext traceContext(std::move(traces));
+  std::optional<ScopedTraceSpan> updateFnSpan;
+  updateFnSpan.emplace("state_update_fn");
+
   std::shared_ptr<SwitchState> oldAppliedState;
   std::shared_ptr<SwitchState> oldDesiredState;
   // Call all of the update functions to prepare the new SwitchState
@@ -737,7 +923,13 @@ void SwSwitch::handlePendingUpdates() {
   // oldDesiredState. This is the one we always enqueue at the front of the
   // queue whenever applied and desired states diverge. After that, other
   // supplied state updates are applied (that were spliced above).
-  auto newDesiredState = oldAppliedState;
+  //
+  // When hw programming is pipelined the applied state may lag behind while a
+  // previous update is still being programmed, so we build on top of the
+  // desired state instead. Any divergence is reconciled by the hw
+  // programming thread.
+  auto newDesiredState =
+      pipelinedHwProgramming_ ? oldDesiredState : oldAppliedState;
   auto iter = updates.begin();
   while (iter != updates.end()) {
     StateUpdate* update = &(*iter);
@@ -767,6 +959,15 @@ void SwSwitch::handlePendingUpdates() {
     }
   }
 
+  updateFnSpan.reset();
+
+  if (pipelinedHwProgramming_) {
+    // Hand the new state off to the hw programming thread. The updates are
+    // notified of success from there, once the hardware has caught up.
+    applyUpdatePipelined(oldDesiredState, newDesiredState, &updates);
+    return;
+  }
+
   // Now apply the update and notify subscribers
   if (newDesiredState != oldAppliedState) {
     // There was some change during these state updates
@@ -815,6 +1016,13 @@ void SwSwitch::setStateInternal(
   desiredStateDontUseDirectly_.swap(newDesiredState);
 }
 
+void SwSwitch::setAppliedState(std::shared_ptr<SwitchState> newAppliedState) {
+  CHECK(bool(newAppliedState));
+  CHECK(newAppliedState->isPublished());
+  folly::SpinLockGuard guard(stateLock_);
+  appliedStateDontUseDirectly_.swap(newAppliedState);
+}
+
 void SwSwitch::setDesiredState(std::shared_ptr<SwitchState> newDesiredState) {
   CHECK(bool(newDesiredState));
   CHECK(newDesiredState->isPublished());
@@ -833,15 +1041,17 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
              << " new_gen=" << newState->getGeneration();
   DCHECK_GT(newState->getGeneration(), oldState->getGeneration());
 
+  ScopedTraceSpan applyUpdateSpan("apply_update");
+  std::optional<ScopedTraceSpan> deltaSpan;
+  deltaSpan.emplace("state_delta");
   StateDelta delta(oldState, newState);
+  deltaSpan.reset();
 
   // If we are already exiting, abort the update
   if (isExiting()) {
     return oldState;
   }
 
-  std::shared_ptr<SwitchState> newAppliedState;
-
   // Inform the HwSwitch of the change.
   //
   // Note that at this point we have already updated the state pointer and
@@ -854,7 +1064,31 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
   // take a non-trivial amount of time, and blocking other users seems
   // undesirable.  So far I don't think this brief discrepancy should cause
   // major issues.
+  auto newAppliedState = programHw(delta);
+
+  setStateInternal(newAppliedState, newState);
+
+  // Notifies all observers of the current state update. We notify them that
+  // the state changed to "desired state", even if the whole state might not
+  // have been applied yet. If an observer wants to know the applied state,
+  // they can query the SwSwitch about it.
+  {
+    ScopedTraceSpan observerSpan("observer_notification");
+    notifyStateObservers(delta);
+  }
+
+  auto end = std::chrono::steady_clock::now();
+  auto duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+  stats()->stateUpdate(duration);
+  XLOG(DBG0) << "Update state took " << duration.count() << "us";
+  return newAppliedState;
+}
+
+std::shared_ptr<SwitchState> SwSwitch::programHw(const StateDelta& delta) {
+  std::shared_ptr<SwitchState> newAppliedState;
   try {
+    ScopedTraceSpan hwSpan("hw_state_changed");
     newAppliedState = hw_->stateChanged(delta);
   } catch (const std::exception& ex) {
     // Notify the hw_ of the crash so it can execute any device specific
@@ -863,26 +1097,126 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
     // Another thing we could try here is rolling back to the old state.
     hw_->exitFatal();
 
-    dumpBadStateUpdate(oldState, newState);
+    dumpBadStateUpdate(delta.oldState(), delta.newState());
 
     XLOG(FATAL) << "error applying state change to hardware: "
                 << folly::exceptionStr(ex);
   }
+  return newAppliedState;
+}
 
-  setStateInternal(newAppliedState, newState);
+void SwSwitch::applyUpdatePipelined(
+    const shared_ptr<SwitchState>& oldDesiredState,
+    const shared_ptr<SwitchState>& newDesiredState,
+    StateUpdateList* updates) {
+  if (newDesiredState != oldDesiredState && !isExiting()) {
+    XLOG(INFO) << "Updating desired state: old_gen="
+               << oldDesiredState->getGeneration()
+               << " new_gen=" << newDesiredState->getGeneration();
+    setDesiredState(newDesiredState);
+  }
 
-  // Notifies all observers of the current state update. We notify them that
-  // the state changed to "desired state", even if the whole state might not
-  // have been applied yet. If an observer wants to know the applied state,
-  // they can query the SwSwitch about it.
-  notifyStateObservers(delta);
+  // Updates that did not change the desired state are still handed over, so
+  // that they complete in order with the ones ahead of them, i.e. a blocking
+  // update only returns once everything before it has been programmed.
+  bool allowsCoalescing = true;
+  for (const auto& update : *updates) {
+    allowsCoalescing = allowsCoalescing && update.allowsCoalescing();
+  }
+  {
+    folly::SpinLockGuard guard(pendingHwProgrammingLock_);
+    pendingHwStates_.emplace_back();
+    auto& pending = pendingHwStates_.back();
+    pending.state = newDesiredState;
+    pending.updates.splice(pending.updates.end(), *updates);
+    pending.allowsCoalescing = allowsCoalescing;
+  }
+  hwProgrammingEventBase_.runInEventBaseThread(
+      handlePendingHwProgrammingHelper, this);
+}
 
-  auto end = std::chrono::steady_clock::now();
-  auto duration =
-      std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-  stats()->stateUpdate(duration);
-  XLOG(DBG0) << "Update state took " << duration.count() << "us";
-  return newAppliedState;
+void SwSwitch::handlePendingHwProgrammingHelper(SwSwitch* sw) {
+  sw->handlePendingHwProgramming();
+}
+
+void SwSwitch::handlePendingHwProgramming() {
+  std::list<PendingHwState> pending;
+  {
+    folly::SpinLockGuard guard(pendingHwProgrammingLock_);
+    pending.splice(pending.end(), pendingHwStates_);
+  }
+
+  // If the update thread got ahead of us the intermediate states are
+  // coalesced into a single delta, up to a state that doesn't allow it, the
+  // same way handlePendingUpdates() stops at updates that don't. E.g. a port
+  // flapping down and back up must not reach the hardware as no change.
+  while (!pending.empty()) {
+    auto last = pending.begin();
+    while (last->allowsCoalescing && std::next(last) != pending.end()) {
+      ++last;
+    }
+    ++last;
+    StateUpdateList updates;
+    for (auto it = pending.begin(); it != last; ++it) {
+      updates.splice(updates.end(), it->updates);
+    }
+    auto newState = std::prev(last)->state;
+    pending.erase(pending.begin(), last);
+    programPendingHwState(newState, &updates);
+  }
+}
+
+void SwSwitch::programPendingHwState(
+    const shared_ptr<SwitchState>& newState,
+    StateUpdateList* updates) {
+  UpdateTraces traces;
+  for (const auto& update : *updates) {
+    traces.insert(traces.end(), update.traces_.begin(), update.traces_.end());
+  }
+  ScopedTraceContext traceContext(std::move(traces));
+
+  // The delta is always computed against what is actually in the hardware,
+  // so anything a previous programming attempt failed to apply is retried.
+  auto oldAppliedState = getAppliedState();
+  if (newState != oldAppliedState && !isExiting()) {
+    auto start = std::chrono::steady_clock::now();
+    XLOG(INFO) << "Programming state: old_gen="
+               << oldAppliedState->getGeneration()
+               << " new_gen=" << newState->getGeneration();
+    StateDelta delta(oldAppliedState, newState);
+    auto newAppliedState = programHw(delta);
+    setAppliedState(newAppliedState);
+
+    bool newOutOfSync = (newAppliedState != newState);
+    fb303::fbData->setCounter("hw_out_of_sync", newOutOfSync);
+    if (newOutOfSync) {
+      // Same as in the non pipelined case, wait for the next state update to
+      // try again. By then the desired state is what we build on top of, so
+      // a fresh copy of it is enough to trigger another attempt.
+      queueStateUpdateForGettingHwInSync(
+          "state update for failed hardware application",
+          [](const std::shared_ptr<SwitchState>& state) {
+            return state->clone();
+          });
+    }
+
+    // Observers are only told about what made it to the hardware
+    if (newAppliedState != oldAppliedState) {
+      ScopedTraceSpan observerSpan("observer_notification");
+      notifyStateObservers(StateDelta(oldAppliedState, newAppliedState));
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    stats()->stateUpdate(duration);
+    XLOG(DBG0) << "Programming state took " << duration.count() << "us";
+  }
+
+  while (!updates->empty()) {
+    unique_ptr<StateUpdate> update(&updates->front());
+    updates->pop_front();
+    update->onSuccess();
+  }
 }
 
 void SwSwitch::dumpBadStateUpdate(
@@ -957,6 +1291,18 @@ void SwSwitch::setPortStatusCounter(PortID port, bool up) {
 }
 
 void SwSwitch::packetReceived(std::unique_ptr<RxPacket> pkt) noexcept {
+  if (rxPolicer_ && !rxPolicer_->admit(pkt.get())) {
+    portStats(pkt->getSrcPort())->pktDropped();
+    return;
+  }
+  if (rxDispatcher_) {
+    rxDispatcher_->dispatch(std::move(pkt));
+    return;
+  }
+  handlePacketNoThrow(std::move(pkt));
+}
+
+void SwSwitch::handlePacketNoThrow(std::unique_ptr<RxPacket> pkt) noexcept {
   PortID port = pkt->getSrcPort();
   try {
     handlePacket(std::move(pkt));
@@ -1102,6 +1448,11 @@ void SwSwitch::startThreads() {
   neighborCacheThread_.reset(new std::thread([=] {
     this->threadLoop("fbossNeighborCacheThread", &neighborCacheEventBase_);
   }));
+  if (pipelinedHwProgramming_) {
+    hwProgrammingThread_.reset(new std::thread([=] {
+      this->threadLoop("fbossHwProgrammingThread", &hwProgrammingEventBase_);
+    }));
+  }
 }
 
 void SwSwitch::stopThreads() {
@@ -1141,6 +1492,13 @@ void SwSwitch::stopThreads() {
   if (updateThread_) {
     updateThread_->join();
   }
+  // Only stopped once the update thread is done, so that whatever it handed
+  // over still gets to run (and its blocking updates get released).
+  if (hwProgrammingThread_) {
+    hwProgrammingEventBase_.runInEventBaseThread(
+        [this] { hwProgrammingEventBase_.terminateLoopSoon(); });
+    hwProgrammingThread_->join();
+  }
   if (packetTxThread_) {
     packetTxThread_->join();
   }
@@ -1461,7 +1819,8 @@ void SwSwitch::applyConfig(const std::string& reason, bool reload) {
             &newConfig,
             getPlatform(),
             (getFlags() & SwitchFlags::ENABLE_STANDALONE_RIB) ? getRib()
-                                                              : nullptr);
+                                                              : nullptr,
+            &appliedConfigCache_);
 
         if (newState && !isValidStateUpdate(StateDelta(state, newState))) {
           throw FbossError("Invalid config passed in, skipping");
@@ -9,12 +9,15 @@
  */
 #pragma once
 
+#include "fboss/agent/ApplyThriftConfig.h"
 #include "fboss/agent/HwSwitch.h"
 #include "fboss/agent/ThreadHeartbeat.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
+#include "fboss/agent/rib/RouteUpdateQueue.h"
 #include "fboss/agent/rib/RoutingInformationBase.h"
+#include "fboss/agent/state/StateMemoryUsage.h"
 #include "fboss/agent/state/StateUpdate.h"
 #include "fboss/agent/types.h"
 
@@ -26,6 +29,7 @@
 #include <optional>
 
 #include <atomic>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -58,6 +62,8 @@ class LookupClassRouteUpdater;
 class MacTableManager;
 class ResolvedNexthopMonitor;
 class ResolvedNexthopProbeScheduler;
+class RxPacketDispatcher;
+class RxPacketPolicer;
 
 enum class SwitchFlags : int {
   DEFAULT = 0,
@@ -179,6 +185,12 @@ class SwSwitch : public HwSwitch::Callback {
 
   void updateStats();
 
+  /*
+   * Estimated memory footprint of the desired state. Nodes also referenced
+   * by the applied state are reported as shared.
+   */
+  StateMemoryUsage getStateMemoryUsage() const;
+
   /*
    * Get a pointer to the current switch state.
    *
@@ -571,6 +583,15 @@ class SwSwitch : public HwSwitch::Callback {
     return rib_.get();
   }
 
+  /*
+   * Queue used by the pipelined route update thrift APIs. Only available
+   * when the standalone RIB is enabled.
+   */
+  rib::RouteUpdateQueue* getRouteUpdateQueue() {
+    DCHECK(isStandaloneRibEnabled());
+    return routeUpdateQueue_.get();
+  }
+
   /*
    * Gets the flags the SwSwitch was initialized with.
    */
@@ -705,20 +726,50 @@ class SwSwitch : public HwSwitch::Callback {
       std::shared_ptr<SwitchState> newDesiredState);
 
   void setDesiredState(std::shared_ptr<SwitchState> newDesiredState);
+  void setAppliedState(std::shared_ptr<SwitchState> newAppliedState);
 
   void publishInitTimes(std::string name, const float& time);
   void updatePortInfo();
   void updateRouteStats();
+  void updateStateMemoryStats();
   void publishSwitchInfo(struct HwInitResult hwInitRet);
   void setSwitchRunState(SwitchRunState desiredState);
   SwitchStats* createSwitchStats();
   void handlePacket(std::unique_ptr<RxPacket> pkt);
+  void handlePacketNoThrow(std::unique_ptr<RxPacket> pkt) noexcept;
 
   static void handlePendingUpdatesHelper(SwSwitch* sw);
   void handlePendingUpdates();
   std::shared_ptr<SwitchState> applyUpdate(
       const std::shared_ptr<SwitchState>& oldState,
       const std::shared_ptr<SwitchState>& newState);
+  std::shared_ptr<SwitchState> programHw(const StateDelta& delta);
+
+  /*
+   * Used instead of applyUpdate() with --enable_pipelined_hw_programming.
+   * Publishes the new desired state and hands it off to the hw programming
+   * thread, which takes ownership of the updates and completes them once the
+   * hardware has been programmed.
+   */
+  void applyUpdatePipelined(
+      const std::shared_ptr<SwitchState>& oldDesiredState,
+      const std::shared_ptr<SwitchState>& newDesiredState,
+      StateUpdateList* updates);
+  static void handlePendingHwProgrammingHelper(SwSwitch* sw);
+  void handlePendingHwProgramming();
+  void programPendingHwState(
+      const std::shared_ptr<SwitchState>& newState,
+      StateUpdateList* updates);
+
+  /*
+   * The thread state observers are registered and notified on: the update
+   * thread, or the hw programming thread when hw programming is pipelined,
+   * since observers are notified of what got programmed.
+   */
+  folly::EventBase* getObserverEvb() {
+    return pipelinedHwProgramming_ ? &hwProgrammingEventBase_
+                                   : &updateEventBase_;
+  }
 
   void startThreads();
   void stopThreads();
@@ -762,6 +813,8 @@ class SwSwitch : public HwSwitch::Callback {
 
   std::string curConfigStr_;
   cfg::SwitchConfig curConfig_;
+  // Only accessed from applyConfig(), on the update thread
+  AppliedConfigCache appliedConfigCache_;
 
   // The HwSwitch object.  This object is owned by the Platform.
   HwSwitch* hw_;
@@ -849,6 +902,29 @@ class SwSwitch : public HwSwitch::Callback {
   folly::EventBase neighborCacheEventBase_;
   std::unique_ptr<ThreadHeartbeat> neighborCacheThreadHeartbeat_;
 
+  /*
+   * A desired state handed to the hw programming thread, with the updates
+   * waiting for it to be programmed. allowsCoalescing is false if one of
+   * the updates doesn't allow coalescing, in which case the state is
+   * programmed in a delta of its own.
+   */
+  struct PendingHwState {
+    std::shared_ptr<SwitchState> state;
+    StateUpdateList updates;
+    bool allowsCoalescing{true};
+  };
+
+  /*
+   * A thread programming the hardware, only used when hw programming is
+   * pipelined with the update thread. pendingHwStates_ are the desired
+   * states not yet picked up by this thread, oldest first.
+   */
+  const bool pipelinedHwProgramming_;
+  std::unique_ptr<std::thread> hwProgrammingThread_;
+  folly::EventBase hwProgrammingEventBase_;
+  folly::SpinLock pendingHwProgrammingLock_;
+  std::list<PendingHwState> pendingHwStates_;
+
   /*
    * A callback for listening to neighbors coming and going.
    */
@@ -870,12 +946,19 @@ class SwSwitch : public HwSwitch::Callback {
   std::unique_ptr<IPv6Handler> ipv6_;
   std::unique_ptr<NeighborUpdater> nUpdater_;
   std::unique_ptr<PktCaptureManager> pcapMgr_;
+  // Hands trapped packets to per class workers, null to handle them on the
+  // thread they are received on
+  std::unique_ptr<RxPacketDispatcher> rxDispatcher_;
+  // Drops excess ARP, NDP and DHCP packets before they are handled, null
+  // when disabled
+  std::unique_ptr<RxPacketPolicer> rxPolicer_;
   std::unique_ptr<MirrorManager> mirrorManager_;
   std::unique_ptr<RouteUpdateLogger> routeUpdateLogger_;
   std::unique_ptr<LinkAggregationManager> lagManager_;
   std::unique_ptr<ResolvedNexthopMonitor> resolvedNexthopMonitor_;
   std::unique_ptr<ResolvedNexthopProbeScheduler> resolvedNexthopProbeScheduler_;
   std::unique_ptr<rib::RoutingInformationBase> rib_{nullptr};
+  std::unique_ptr<rib::RouteUpdateQueue> routeUpdateQueue_{nullptr};
 
   BootType bootType_{BootType::UNINITIALIZED};
   std::unique_ptr<LldpManager> lldpManager_;
@@ -885,6 +968,9 @@ class SwSwitch : public HwSwitch::Callback {
   std::unique_ptr<LookupClassUpdater> lookupClassUpdater_;
   std::unique_ptr<LookupClassRouteUpdater> lookupClassRouteUpdater_;
   std::unique_ptr<MacTableManager> macTableManager_;
+
+  // Only accessed from the background thread, in updateStats()
+  std::chrono::steady_clock::time_point lastStateMemoryStats_;
 };
 
 } // namespace facebook::fboss
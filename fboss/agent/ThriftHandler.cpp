@@ -17,15 +17,16 @@
 #include "fboss/agent/LldpManager.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/RouteUpdateLogger.h"
+#include "fboss/agent/StandaloneRibConversions.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/TxPacket.h"
+#include "fboss/agent/UpdateTracer.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/capture/PktCapture.h"
 #include "fboss/agent/capture/PktCaptureManager.h"
 #include "fboss/agent/hw/mock/MockRxPacket.h"
 #include "fboss/agent/if/gen-cpp2/NeighborListenerClient.h"
-#include "fboss/agent/rib/ForwardingInformationBaseUpdater.h"
 #include "fboss/agent/rib/NetworkToRouteMap.h"
 #include "fboss/agent/state/AclMap.h"
 #include "fboss/agent/state/AggregatePort.h"
@@ -55,6 +56,7 @@
 #include <folly/MoveWrapper.h>
 #include <folly/Range.h>
 #include <folly/container/F14Map.h>
+#include <folly/executors/InlineExecutor.h>
 #include <folly/functional/Partial.h>
 #include <folly/io/Cursor.h>
 #include <folly/io/IOBuf.h>
@@ -134,18 +136,6 @@ std::vector<NextHopThrift> thriftNextHopsFromAddresses(
 
 namespace {
 
-void dynamicFibUpdate(
-    facebook::fboss::RouterID vrf,
-    const facebook::fboss::rib::IPv4NetworkToRouteMap& v4NetworkToRoute,
-    const facebook::fboss::rib::IPv6NetworkToRouteMap& v6NetworkToRoute,
-    void* cookie) {
-  facebook::fboss::rib::ForwardingInformationBaseUpdater fibUpdater(
-      vrf, v4NetworkToRoute, v6NetworkToRoute);
-
-  auto sw = static_cast<facebook::fboss::SwSwitch*>(cookie);
-  sw->updateStateBlocking("", std::move(fibUpdater));
-}
-
 void fillPortStats(PortInfoThrift& portInfo, int numPortQs) {
   auto portId = *portInfo.portId_ref();
   auto statMap = facebook::fb303::fbData->getStatMap();
@@ -608,6 +598,7 @@ void ThriftHandler::deleteUnicastRoutesInVrf(
   auto log = LOG_THRIFT_CALL(DBG1);
   ensureConfigured(__func__);
   ensureFibSynced(__func__);
+  ScopedUpdateTrace trace("deleteUnicastRoutesInVrf");
 
   if (sw_->isStandaloneRibEnabled()) {
     auto routerID = RouterID(vrf);
@@ -701,6 +692,7 @@ void ThriftHandler::updateUnicastRoutesImpl(
     const std::unique_ptr<std::vector<UnicastRoute>>& routes,
     const std::string& updType,
     bool sync) {
+  ScopedUpdateTrace trace(updType);
   if (sw_->isStandaloneRibEnabled()) {
     auto routerID = RouterID(vrf);
     auto clientID = ClientID(client);
@@ -791,6 +783,98 @@ void ThriftHandler::updateUnicastRoutesImpl(
   sw_->updateStateBlocking(updType, updateFn);
 }
 
+int64_t ThriftHandler::enqueueUnicastRouteUpdatesInVrf(
+    int16_t client,
+    std::unique_ptr<std::vector<UnicastRoute>> toAdd,
+    std::unique_ptr<std::vector<IpPrefix>> toDelete,
+    int32_t vrf) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  ensureFibSynced(__func__);
+  return enqueueUnicastRoutesImpl(
+      vrf, client, std::move(*toAdd), std::move(*toDelete), false);
+}
+
+int64_t ThriftHandler::enqueueSyncFibInVrf(
+    int16_t client,
+    std::unique_ptr<std::vector<UnicastRoute>> routes,
+    int32_t vrf) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  auto seqNum =
+      enqueueUnicastRoutesImpl(vrf, client, std::move(*routes), {}, true);
+  if (!sw_->isFibSynced()) {
+    // Unlike syncFib(), the FIB is not yet programmed at this point. Only
+    // mark it synced once the first sync is applied, so that routes from
+    // other clients are not accepted against a partially programmed FIB.
+    // The caller tracks the sync with waitForUnicastRouteUpdates().
+    sw_->getRouteUpdateQueue()
+        ->waitFor(ClientID(client), seqNum)
+        .via(&folly::InlineExecutor::instance())
+        .thenValue([sw = sw_](folly::Unit) {
+          if (!sw->isFibSynced()) {
+            sw->fibSynced();
+          }
+        });
+  }
+  return seqNum;
+}
+
+void ThriftHandler::async_tm_waitForUnicastRouteUpdates(
+    ThriftCallback<void> callback,
+    int16_t client,
+    int64_t seqNum) {
+  try {
+    ensureConfigured(__func__);
+    if (!sw_->isStandaloneRibEnabled()) {
+      throw FbossError("Queued route updates require Stand-Alone RIB");
+    }
+  } catch (const std::exception& ex) {
+    fail(callback, ex);
+    return;
+  }
+  sw_->getRouteUpdateQueue()
+      ->waitFor(ClientID(client), seqNum)
+      .via(&folly::InlineExecutor::instance())
+      .thenTry([callback = std::move(callback)](folly::Try<folly::Unit>&& t) {
+        if (t.hasException()) {
+          callback->exception(FbossError(t.exception().what()));
+        } else {
+          callback->done();
+        }
+      });
+}
+
+int64_t ThriftHandler::getLastCompletedUnicastRouteUpdate(int16_t client) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  if (!sw_->isStandaloneRibEnabled()) {
+    throw FbossError("Queued route updates require Stand-Alone RIB");
+  }
+  return sw_->getRouteUpdateQueue()->getLastCompleted(ClientID(client));
+}
+
+int64_t ThriftHandler::enqueueUnicastRoutesImpl(
+    int32_t vrf,
+    int16_t client,
+    std::vector<UnicastRoute> toAdd,
+    std::vector<IpPrefix> toDelete,
+    bool sync) {
+  if (!sw_->isStandaloneRibEnabled()) {
+    throw FbossError("Queued route updates require Stand-Alone RIB");
+  }
+  auto ticket = sw_->getRouteUpdateQueue()->enqueue(
+      RouterID(vrf),
+      ClientID(client),
+      sw_->clientIdToAdminDistance(client),
+      std::move(toAdd),
+      std::move(toDelete),
+      sync);
+  XLOG(DBG2) << "Queued route update " << ticket.seqNum << " for client "
+             << client << " in vrf " << vrf;
+  return ticket.seqNum;
+}
+
 static void populateInterfaceDetail(
     InterfaceDetail& interfaceDetail,
     const std::shared_ptr<Interface> intf) {
@@ -972,6 +1056,36 @@ void ThriftHandler::getRunningConfig(std::string& configStr) {
   configStr = sw_->getConfigStr();
 }
 
+void ThriftHandler::getUpdateTraces(std::string& ret) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  if (!UpdateTracer::get()->enabled()) {
+    throw FbossError(
+        "Update tracing is not enabled, see --enable_update_tracing");
+  }
+  ret = UpdateTracer::get()->dumpChromeTrace();
+}
+
+void ThriftHandler::getSwitchStateMemoryUsage(SwitchStateMemoryUsage& ret) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  auto toThrift = [](const NodeMemoryUsage& usage) {
+    NodeMemoryUsageThrift thriftUsage;
+    *thriftUsage.nodes_ref() = usage.nodes;
+    *thriftUsage.bytes_ref() = usage.bytes;
+    *thriftUsage.sharedNodes_ref() = usage.sharedNodes;
+    *thriftUsage.sharedBytes_ref() = usage.sharedBytes;
+    return thriftUsage;
+  };
+  auto usage = sw_->getStateMemoryUsage();
+  *ret.total_ref() = toThrift(usage.getTotal());
+  for (const auto& subtree : usage.getBySubtree()) {
+    ret.bySubtree_ref()->emplace(subtree.first, toThrift(subtree.second));
+  }
+  for (const auto& nodeType : usage.getByNodeType()) {
+    ret.byNodeType_ref()->emplace(nodeType.first, toThrift(nodeType.second));
+  }
+}
+
 void ThriftHandler::getCurrentStateJSON(
     std::string& ret,
     std::unique_ptr<std::string> jsonPointerStr) {
@@ -97,6 +97,22 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
       std::unique_ptr<std::vector<UnicastRoute>> routes,
       int32_t vrf) override;
 
+  /* Pipelined route updates, see RouteUpdateQueue */
+  int64_t enqueueUnicastRouteUpdatesInVrf(
+      int16_t client,
+      std::unique_ptr<std::vector<UnicastRoute>> toAdd,
+      std::unique_ptr<std::vector<IpPrefix>> toDelete,
+      int32_t vrf) override;
+  int64_t enqueueSyncFibInVrf(
+      int16_t client,
+      std::unique_ptr<std::vector<UnicastRoute>> routes,
+      int32_t vrf) override;
+  void async_tm_waitForUnicastRouteUpdates(
+      ThriftCallback<void> callback,
+      int16_t client,
+      int64_t seqNum) override;
+  int64_t getLastCompletedUnicastRouteUpdate(int16_t client) override;
+
   /* MPLS routes */
   void addMplsRoutes(
       int16_t clientId,
@@ -290,6 +306,14 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
   void getCurrentStateJSON(std::string& ret, std::unique_ptr<std::string>)
       override;
 
+  /**
+   * Dump the most recent route/state update traces in Chrome trace event
+   * format. Requires --enable_update_tracing.
+   */
+  void getUpdateTraces(std::string& ret) override;
+
+  void getSwitchStateMemoryUsage(SwitchStateMemoryUsage& ret) override;
+
   /**
    * Patch live running switch state at path pointed by jsonPointer using the
    * JSON merge patch supplied in jsonPatch
@@ -360,6 +384,12 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
       const std::unique_ptr<std::vector<UnicastRoute>>& routes,
       const std::string& updType,
       bool sync);
+  int64_t enqueueUnicastRoutesImpl(
+      int32_t vrf,
+      int16_t client,
+      std::vector<UnicastRoute> toAdd,
+      std::vector<IpPrefix> toDelete,
+      bool sync);
 
   void fillPortStats(PortInfoThrift& portInfo, int numPortQs = 0);
 
@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/UpdateTracer.h"
+
+#include <folly/json.h>
+#include <folly/system/ThreadId.h>
+
+#include <atomic>
+
+DEFINE_bool(
+    enable_update_tracing,
+    false,
+    "Trace route/state updates stage by stage from the thrift call to "
+    "hardware programming");
+DEFINE_int32(
+    update_trace_history,
+    100,
+    "Number of completed update traces to keep for dumping");
+
+namespace {
+constexpr auto kTracePrefix = "update_trace.";
+
+thread_local facebook::fboss::UpdateTraces tlsCurrentTraces;
+std::atomic<uint64_t> nextTraceId{1};
+
+int64_t toUsecs(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+      .count();
+}
+} // namespace
+
+namespace facebook::fboss {
+
+UpdateTrace::UpdateTrace(folly::StringPiece name)
+    : name_(name.str()), id_(nextTraceId++), start_(Clock::now()) {}
+
+void UpdateTrace::addSpan(
+    folly::StringPiece stage,
+    Clock::time_point start,
+    Clock::time_point end) {
+  spans_.wlock()->push_back(
+      Span{stage.str(), start, end, folly::getCurrentThreadID()});
+}
+
+std::vector<UpdateTrace::Span> UpdateTrace::getSpans() const {
+  return *spans_.rlock();
+}
+
+UpdateTracer* UpdateTracer::get() {
+  static UpdateTracer tracer;
+  return &tracer;
+}
+
+std::shared_ptr<UpdateTrace> UpdateTracer::startTrace(folly::StringPiece name) {
+  if (!enabled()) {
+    return nullptr;
+  }
+  return std::make_shared<UpdateTrace>(name);
+}
+
+void UpdateTracer::finishTrace(const std::shared_ptr<UpdateTrace>& trace) {
+  if (!trace) {
+    return;
+  }
+  recordStage("total", UpdateTrace::Clock::now() - trace->getStartTime());
+  auto history = history_.wlock();
+  history->push_back(trace);
+  auto maxHistory =
+      static_cast<size_t>(std::max(FLAGS_update_trace_history, 0));
+  while (history->size() > maxHistory) {
+    history->pop_front();
+  }
+}
+
+void UpdateTracer::recordStage(
+    folly::StringPiece stage,
+    std::chrono::steady_clock::duration duration) {
+  stageHistograms_.addValue(
+      folly::to<std::string>(kTracePrefix, stage, ".us"),
+      std::chrono::duration_cast<std::chrono::microseconds>(duration));
+}
+
+std::string UpdateTracer::dumpChromeTrace() const {
+  // Chrome trace event format, with one complete ("X") event per span.
+  // Timestamps are relative to the oldest trace we still have.
+  folly::dynamic events = folly::dynamic::array;
+  auto history = history_.rlock();
+  if (!history->empty()) {
+    auto epoch = history->front()->getStartTime();
+    for (const auto& trace : *history) {
+      for (const auto& span : trace->getSpans()) {
+        events.push_back(folly::dynamic::object("name", span.stage)(
+            "cat", trace->getName())("ph", "X")(
+            "ts", toUsecs(span.start - epoch))(
+            "dur", toUsecs(span.end - span.start))(
+            "pid", static_cast<int64_t>(trace->getId()))(
+            "tid", static_cast<int64_t>(span.threadId))(
+            "args", folly::dynamic::object("update", trace->getName())));
+      }
+    }
+  }
+  return folly::toJson(folly::dynamic::object("traceEvents", events)(
+      "displayTimeUnit", "ms"));
+}
+
+const UpdateTraces& UpdateTracer::currentTraces() {
+  return tlsCurrentTraces;
+}
+
+ScopedTraceContext::ScopedTraceContext(UpdateTraces traces)
+    : saved_(std::move(tlsCurrentTraces)) {
+  tlsCurrentTraces = std::move(traces);
+}
+
+ScopedTraceContext::~ScopedTraceContext() {
+  tlsCurrentTraces = std::move(saved_);
+}
+
+ScopedTraceSpan::ScopedTraceSpan(folly::StringPiece stage)
+    : stage_(stage), active_(!tlsCurrentTraces.empty()) {
+  if (active_) {
+    start_ = UpdateTrace::Clock::now();
+  }
+}
+
+ScopedTraceSpan::~ScopedTraceSpan() {
+  if (!active_) {
+    return;
+  }
+  auto end = UpdateTrace::Clock::now();
+  for (const auto& trace : tlsCurrentTraces) {
+    trace->addSpan(stage_, start_, end);
+  }
+  UpdateTracer::get()->recordStage(stage_, end - start_);
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/lib/DurationHistograms.h"
+
+#include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <gflags/gflags.h>
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+DECLARE_bool(enable_update_tracing);
+DECLARE_int32(update_trace_history);
+
+namespace facebook::fboss {
+
+/*
+ * A trace of a single route/state update as it makes its way from the thrift
+ * RPC to the hardware.  Every stage the update goes through (RIB mutation,
+ * resolution, FIB conversion, state update queue wait, applyUpdate, HwSwitch
+ * programming of each object type, observer notification) is recorded as a
+ * span.
+ *
+ * Spans may be added from any thread, since a single update is handled by
+ * the thrift thread and then the update thread.
+ */
+class UpdateTrace {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Span {
+    std::string stage;
+    Clock::time_point start;
+    Clock::time_point end;
+    uint64_t threadId;
+  };
+
+  explicit UpdateTrace(folly::StringPiece name);
+
+  void addSpan(
+      folly::StringPiece stage,
+      Clock::time_point start,
+      Clock::time_point end);
+
+  const std::string& getName() const {
+    return name_;
+  }
+  uint64_t getId() const {
+    return id_;
+  }
+  Clock::time_point getStartTime() const {
+    return start_;
+  }
+  std::vector<Span> getSpans() const;
+
+ private:
+  std::string name_;
+  uint64_t id_;
+  Clock::time_point start_;
+  folly::Synchronized<std::vector<Span>> spans_;
+};
+
+using UpdateTraces = std::vector<std::shared_ptr<UpdateTrace>>;
+
+/*
+ * Process wide collector of UpdateTraces.
+ *
+ * Tracing is opt-in (--enable_update_tracing). When enabled, the duration of
+ * every stage is fed into an fb303 histogram named
+ * "update_trace.<stage>.us" exporting p50/p95/p99, and the last
+ * --update_trace_history completed traces are kept around so they can be
+ * dumped in Chrome trace event format (load in chrome://tracing or Perfetto)
+ * for offline analysis.
+ */
+class UpdateTracer {
+ public:
+  static UpdateTracer* get();
+
+  bool enabled() const {
+    return FLAGS_enable_update_tracing;
+  }
+
+  /*
+   * Start a new trace. Returns nullptr if tracing is disabled, all other
+   * tracing APIs accept and ignore null traces.
+   */
+  std::shared_ptr<UpdateTrace> startTrace(folly::StringPiece name);
+
+  /*
+   * Mark a trace as complete and add it to the history of traces.
+   */
+  void finishTrace(const std::shared_ptr<UpdateTrace>& trace);
+
+  void recordStage(
+      folly::StringPiece stage,
+      std::chrono::steady_clock::duration duration);
+
+  std::string dumpChromeTrace() const;
+
+  /*
+   * The traces active on the calling thread. Spans recorded on this thread
+   * go to all of them.
+   */
+  static const UpdateTraces& currentTraces();
+
+ private:
+  folly::Synchronized<std::deque<std::shared_ptr<UpdateTrace>>> history_;
+  DurationHistograms stageHistograms_;
+};
+
+/*
+ * Makes traces current on this thread for the lifetime of the object, e.g.
+ * while the update thread applies a StateUpdate that was created with a
+ * trace active on the thrift thread.
+ */
+class ScopedTraceContext {
+ public:
+  explicit ScopedTraceContext(UpdateTraces traces);
+  explicit ScopedTraceContext(std::shared_ptr<UpdateTrace> trace)
+      : ScopedTraceContext(
+            trace ? UpdateTraces{std::move(trace)} : UpdateTraces{}) {}
+  ~ScopedTraceContext();
+
+ private:
+  ScopedTraceContext(ScopedTraceContext const&) = delete;
+  ScopedTraceContext& operator=(ScopedTraceContext const&) = delete;
+
+  UpdateTraces saved_;
+};
+
+/*
+ * Starts a trace, makes it current on this thread and finishes it when going
+ * out of scope. A no-op if tracing is disabled.
+ */
+class ScopedUpdateTrace {
+ public:
+  explicit ScopedUpdateTrace(folly::StringPiece name)
+      : trace_(UpdateTracer::get()->startTrace(name)), context_(trace_) {}
+  ~ScopedUpdateTrace() {
+    UpdateTracer::get()->finishTrace(trace_);
+  }
+
+ private:
+  std::shared_ptr<UpdateTrace> trace_;
+  ScopedTraceContext context_;
+};
+
+/*
+ * Records a span for stage in every trace current on this thread. Cheap when
+ * no trace is active.
+ */
+class ScopedTraceSpan {
+ public:
+  explicit ScopedTraceSpan(folly::StringPiece stage);
+  ~ScopedTraceSpan();
+
+ private:
+  ScopedTraceSpan(ScopedTraceSpan const&) = delete;
+  ScopedTraceSpan& operator=(ScopedTraceSpan const&) = delete;
+
+  folly::StringPiece stage_;
+  bool active_;
+  UpdateTrace::Clock::time_point start_;
+};
+
+} // namespace facebook::fboss
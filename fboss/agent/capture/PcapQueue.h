@@ -9,22 +9,29 @@
  */
 #pragma once
 
-#include <condition_variable>
-#include <mutex>
+#include "fboss/agent/capture/PcapPkt.h"
+
+#include <folly/MPMCQueue.h>
+
+#include <atomic>
 #include <vector>
 
 namespace facebook::fboss {
 
 class RxPacket;
 class TxPacket;
-class PcapPkt;
 
 /*
  * PcapQueue stores a queue of PcapPkt objects, for transferring packets
  * from an asynchronous capture thread to a blocking thread that will process
  * the packets.  (For instance, writing them to disk using blocking I/O.)
  *
- * There can only be a single reader.
+ * Adding packets never blocks or takes a lock, so it is cheap enough to do
+ * on the packet RX and TX paths: the queue is a bounded lock-free ring, and
+ * packets are dropped (and counted) when it is full.
+ *
+ * Packets may be added from any number of threads. There can only be a
+ * single reader.
  */
 class PcapQueue {
  public:
@@ -32,25 +39,11 @@ class PcapQueue {
   virtual ~PcapQueue();
 
   uint32_t getPktCapacity() const {
-    // pktCapacity_ is const, so no need for locking
     return pktCapacity_;
   }
 
-  /*
-   * Get the mutex protecting this PcapQueue.
-   *
-   * This is exposed to allow callers to also protect their own data
-   * with the same mutex if desired.  Callers should call addPktLocked()
-   * instead of addPkt() when they are already holding the PcapQueue mutex.
-   */
-  std::mutex& mutex() const {
-    return mutex_;
-  }
-
   void addPkt(const RxPacket* pkt);
-  void addPktLocked(const RxPacket* pkt);
   void addPkt(const TxPacket* pkt);
-  void addPktLocked(const TxPacket* pkt);
 
   /*
    * finish() signals that no more packets will be added to the queue.
@@ -71,10 +64,11 @@ class PcapQueue {
   uint64_t numDropped() const;
 
   /*
-   * Wait for new packets from the queue.
+   * Wait for new packets from the queue, and return all of those queued, up
+   * to the capacity of the queue.
    *
    * Note: for best performance, the writer should re-use the same vector
-   * for multiple wait() calls.  On subsequent calls the queue will already
+   * for multiple wait() calls.  On subsequent calls the vector will already
    * have the desired capacity, and will not need to reallocate memory.
    */
   bool wait(std::vector<PcapPkt>* swapQueue);
@@ -87,15 +81,15 @@ class PcapQueue {
   template <typename PktType>
   void addPktInternal(const PktType* pkt);
 
-  mutable std::mutex mutex_;
-  std::condition_variable cv_;
-
-  bool finished_{false};
   const uint32_t pktCapacity_{0};
-  uint64_t bytesCapacity_{0};
-  uint64_t bytesInQueue_{0};
-  uint64_t pktsDropped_{0};
-  std::vector<PcapPkt> queue_;
+  const uint64_t bytesCapacity_{0};
+  std::atomic<uint64_t> bytesInQueue_{0};
+  std::atomic<uint64_t> pktsDropped_{0};
+  std::atomic<bool> finished_{false};
+  // Only accessed by the reader, set once it has seen the end of the queue
+  bool readerDone_{false};
+  // An uninitialized PcapPkt marks the end of the queue
+  folly::MPMCQueue<PcapPkt> queue_;
 };
 
 } // namespace facebook::fboss
@@ -43,23 +43,30 @@ void PktCapture::stop() {
   XLOG(INFO) << "Stopped packet capture " << toString(true);
 }
 
+template <typename PktType>
+bool PktCapture::addPkt(const PktType* pkt, std::atomic<uint64_t>* counter) {
+  auto numPackets = numPackets_.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (numPackets > maxPackets_) {
+    return false;
+  }
+  counter->fetch_add(1, std::memory_order_relaxed);
+  writer_.addPkt(pkt);
+  return numPackets < maxPackets_;
+}
+
 bool PktCapture::packetReceived(const RxPacket* pkt) {
-  std::lock_guard<std::mutex> guard(writer_.mutex());
   if (direction_ != CaptureDirection::CAPTURE_ONLY_TX &&
       true == packetFilter_.passes(pkt)) {
-    ++numPacketsReceived_;
-    writer_.addPktLocked(pkt);
+    return addPkt(pkt, &numPacketsReceived_);
   }
-  return (numPacketsSent_ + numPacketsReceived_) < maxPackets_;
+  return numPackets_.load(std::memory_order_relaxed) < maxPackets_;
 }
 
 bool PktCapture::packetSent(const TxPacket* pkt) {
-  std::lock_guard<std::mutex> guard(writer_.mutex());
   if (direction_ != CaptureDirection::CAPTURE_ONLY_RX) {
-    ++numPacketsSent_;
-    writer_.addPktLocked(pkt);
+    return addPkt(pkt, &numPacketsSent_);
   }
-  return (numPacketsSent_ + numPacketsReceived_) < maxPackets_;
+  return numPackets_.load(std::memory_order_relaxed) < maxPackets_;
 }
 
 std::string PktCapture::toString(bool withStats) const {
@@ -70,8 +77,9 @@ std::string PktCapture::toString(bool withStats) const {
              : ((direction_ == CaptureDirection::CAPTURE_ONLY_RX) ? "RX only"
                                                                   : "TX only"));
   if (withStats) {
-    ss << ", Packet received:" << numPacketsReceived_
-       << ", Packet sent:" << numPacketsSent_;
+    ss << ", Packet received:" << numPacketsReceived_.load()
+       << ", Packet sent:" << numPacketsSent_.load()
+       << ", Packet dropped:" << writer_.numDropped();
   }
   return ss.str();
 }
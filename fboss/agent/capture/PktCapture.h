@@ -14,6 +14,7 @@
 
 #include <boost/container/flat_set.hpp>
 #include <folly/Range.h>
+#include <atomic>
 #include <string>
 #include "fboss/agent/RxPacket.h"
 #include "fboss/agent/TxPacket.h"
@@ -42,7 +43,7 @@ class PacketFilter {
   explicit PacketFilter(const CaptureFilter& captureFilter)
       : rxPacketFilter_(captureFilter.get_rxCaptureFilter()) {}
 
-  bool passes(const RxPacket* pkt) {
+  bool passes(const RxPacket* pkt) const {
     return rxPacketFilter_.passes(pkt);
   }
 
@@ -52,6 +53,9 @@ class PacketFilter {
 
 /*
  * A packet capture job.
+ *
+ * packetReceived() and packetSent() may be called concurrently from any
+ * thread.
  */
 class PktCapture {
  public:
@@ -82,15 +86,18 @@ class PktCapture {
   PktCapture(PktCapture const&) = delete;
   PktCapture& operator=(PktCapture const&) = delete;
 
+  template <typename PktType>
+  bool addPkt(const PktType* pkt, std::atomic<uint64_t>* counter);
+
   const std::string name_;
 
-  // Note: the rest of the state in this class is protcted by
-  // the PcapWriter's mutex.
   PcapWriter writer_;
-  uint64_t maxPackets_{0};
-  uint64_t numPacketsReceived_{0};
-  uint64_t numPacketsSent_{0};
-  CaptureDirection direction_{CaptureDirection::CAPTURE_TX_RX};
-  PacketFilter packetFilter_;
+  const uint64_t maxPackets_{0};
+  // Packets captured in both directions, checked against maxPackets_
+  std::atomic<uint64_t> numPackets_{0};
+  std::atomic<uint64_t> numPacketsReceived_{0};
+  std::atomic<uint64_t> numPacketsSent_{0};
+  const CaptureDirection direction_{CaptureDirection::CAPTURE_TX_RX};
+  const PacketFilter packetFilter_;
 };
 } // namespace facebook::fboss
@@ -17,6 +17,7 @@
 
 #include <folly/String.h>
 #include <folly/logging/xlog.h>
+#include <folly/synchronization/Rcu.h>
 
 using folly::StringPiece;
 using std::string;
@@ -30,7 +31,10 @@ PktCaptureManager::PktCaptureManager(SwSwitch* sw) {
   utilCreateDir(captureDir_);
 }
 
-PktCaptureManager::~PktCaptureManager() {}
+PktCaptureManager::~PktCaptureManager() {
+  folly::synchronize_rcu();
+  delete activeCaptureList_.load();
+}
 
 void PktCaptureManager::startCapture(unique_ptr<PktCapture> capture) {
   checkCaptureName(capture->name());
@@ -46,44 +50,58 @@ void PktCaptureManager::startCapture(unique_ptr<PktCapture> capture) {
   }
 
   capture->start(path);
-  capturesRunning_.store(true, std::memory_order_release);
   activeCaptures_[name] = std::move(capture);
+  publishActiveCapturesLocked();
 }
 
 void PktCaptureManager::stopCapture(StringPiece name) {
-  std::lock_guard<std::mutex> g(mutex_);
-
   auto nameStr = name.str();
-  auto it = activeCaptures_.find(nameStr);
-  if (it == activeCaptures_.end()) {
-    throw FbossError("no active capture found with name \"", name, "\"");
+  std::unique_ptr<PktCapture> capture;
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    auto it = activeCaptures_.find(nameStr);
+    if (it == activeCaptures_.end()) {
+      throw FbossError("no active capture found with name \"", name, "\"");
+    }
+    capture = std::move(it->second);
+    activeCaptures_.erase(it);
+    publishActiveCapturesLocked();
   }
-  it->second->stop();
-  inactiveCaptures_[nameStr] = std::move(it->second);
-  activeCaptures_.erase(it);
-  capturesRunning_.store(!activeCaptures_.empty(), std::memory_order_release);
+  // Let packets being added finish before closing the capture
+  folly::synchronize_rcu();
+  capture->stop();
+
+  std::lock_guard<std::mutex> g(mutex_);
+  inactiveCaptures_[nameStr] = std::move(capture);
 }
 
 unique_ptr<PktCapture> PktCaptureManager::forgetCapture(StringPiece name) {
-  std::lock_guard<std::mutex> g(mutex_);
   auto nameStr = name.str();
-  auto activeIt = activeCaptures_.find(nameStr);
-  if (activeIt != activeCaptures_.end()) {
-    std::unique_ptr<PktCapture> capture = std::move(activeIt->second);
-    activeCaptures_.erase(activeIt);
-    capturesRunning_.store(!activeCaptures_.empty(), std::memory_order_release);
-    capture->stop();
-    return capture;
+  std::unique_ptr<PktCapture> capture;
+  bool wasActive = false;
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    auto activeIt = activeCaptures_.find(nameStr);
+    auto inactiveIt = inactiveCaptures_.find(nameStr);
+    if (activeIt != activeCaptures_.end()) {
+      capture = std::move(activeIt->second);
+      activeCaptures_.erase(activeIt);
+      publishActiveCapturesLocked();
+      wasActive = true;
+    } else if (inactiveIt != inactiveCaptures_.end()) {
+      capture = std::move(inactiveIt->second);
+      inactiveCaptures_.erase(inactiveIt);
+    } else {
+      throw FbossError("no capture found with name \"", name, "\"");
+    }
   }
-
-  auto inactiveIt = inactiveCaptures_.find(nameStr);
-  if (inactiveIt != inactiveCaptures_.end()) {
-    std::unique_ptr<PktCapture> capture = std::move(inactiveIt->second);
-    inactiveCaptures_.erase(inactiveIt);
-    return capture;
+  // Captures that stopped themselves may still be in use by the packet
+  // paths too, until they are done with the previous list
+  folly::synchronize_rcu();
+  if (wasActive) {
+    capture->stop();
   }
-
-  throw FbossError("no capture found with name \"", name, "\"");
+  return capture;
 }
 
 void PktCaptureManager::stopAllCaptures() {
@@ -100,40 +118,68 @@ void PktCaptureManager::forgetAllCaptures() {
 
 template <typename Fn>
 void PktCaptureManager::invokeCaptures(const Fn& fn) {
-  std::lock_guard<std::mutex> g(mutex_);
-
-  for (auto it = activeCaptures_.begin(); it != activeCaptures_.end();
-       /* increment in loop */) {
-    // Increment the iterator now, in case this capture deactivates itself and
-    // we need to remove it from the active captures.
-    auto thisIt = it;
-    ++it;
-    PktCapture* capture = thisIt->second.get();
-    bool stillActive = false;
-    try {
-      stillActive = fn(capture);
-    } catch (const std::exception& ex) {
-      XLOG(ERR) << "error when processing packet for capture "
-                << capture->name() << " : " << folly::exceptionStr(ex);
-      stillActive = false;
+  CaptureList finished;
+  {
+    folly::rcu_reader guard;
+    auto captures = activeCaptureList_.load(std::memory_order_acquire);
+    if (!captures) {
+      return;
     }
-
-    if (!stillActive) {
-      XLOG(INFO) << "auto-stopping packet capture \"" << capture->name()
-                 << "\"";
+    for (auto capture : *captures) {
+      bool stillActive = false;
       try {
-        inactiveCaptures_[capture->name()] = std::move(thisIt->second);
+        stillActive = fn(capture);
       } catch (const std::exception& ex) {
-        XLOG(ERR) << "error adding capture " << capture->name()
-                  << " to the inactive list";
-        // Can't do much else here.  Just continue and forget the capture.
+        XLOG(ERR) << "error when processing packet for capture "
+                  << capture->name() << " : " << folly::exceptionStr(ex);
+        stillActive = false;
+      }
+      if (!stillActive) {
+        finished.push_back(capture);
       }
-      activeCaptures_.erase(thisIt);
+    }
+    // Still in the read section, so that the captures stay alive
+    if (!finished.empty()) {
+      deactivateCaptures(finished);
     }
   }
+}
 
-  bool running = !activeCaptures_.empty();
-  capturesRunning_.store(running, std::memory_order_release);
+void PktCaptureManager::deactivateCaptures(const CaptureList& captures) {
+  std::lock_guard<std::mutex> g(mutex_);
+  for (auto capture : captures) {
+    // Another thread may have stopped it already
+    auto it = activeCaptures_.find(capture->name());
+    if (it == activeCaptures_.end() || it->second.get() != capture) {
+      continue;
+    }
+    XLOG(INFO) << "auto-stopping packet capture \"" << capture->name()
+               << "\"";
+    try {
+      inactiveCaptures_[capture->name()] = std::move(it->second);
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "error adding capture " << capture->name()
+                << " to the inactive list";
+      // Can't do much else here.  Just continue and forget the capture.
+    }
+    activeCaptures_.erase(it);
+  }
+  publishActiveCapturesLocked();
+}
+
+void PktCaptureManager::publishActiveCapturesLocked() {
+  CaptureList* captures = nullptr;
+  if (!activeCaptures_.empty()) {
+    captures = new CaptureList();
+    for (const auto& entry : activeCaptures_) {
+      captures->push_back(entry.second.get());
+    }
+  }
+  auto old = activeCaptureList_.exchange(captures, std::memory_order_acq_rel);
+  capturesRunning_.store(captures != nullptr, std::memory_order_release);
+  if (old) {
+    folly::rcu_retire(old);
+  }
 }
 
 void PktCaptureManager::packetReceivedImpl(const RxPacket* pkt) {
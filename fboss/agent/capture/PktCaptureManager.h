@@ -16,6 +16,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -82,13 +83,24 @@ class PktCaptureManager {
   PktCaptureManager(PktCaptureManager const&) = delete;
   PktCaptureManager& operator=(PktCaptureManager const&) = delete;
 
+  using CaptureList = std::vector<PktCapture*>;
+
   template <typename Fn>
   void invokeCaptures(const Fn& fn);
   void packetReceivedImpl(const RxPacket* pkt);
   void packetSentImpl(const TxPacket* pkt);
+  void deactivateCaptures(const CaptureList& captures);
+  void publishActiveCapturesLocked();
 
   std::atomic<bool> capturesRunning_{false};
+  /*
+   * The active captures, as seen by the packet paths. These read it in an
+   * RCU read section without taking mutex_, so a capture that is no longer
+   * in the list may still be in use until synchronize_rcu() returns.
+   */
+  std::atomic<CaptureList*> activeCaptureList_{nullptr};
 
+  // Protects everything below
   std::mutex mutex_;
   std::string captureDir_;
   std::map<std::string, std::unique_ptr<PktCapture>> activeCaptures_;
@@ -71,3 +71,34 @@ TEST(PcapQueueTest, SimpleAdd) {
   ByteRange waitedPktData = waitedPktBufClone->coalesce();
   EXPECT_EQ(expectedPktData, waitedPktData);
 }
+
+TEST(PcapQueueTest, ConcurrentAddsAndDrops) {
+  PcapQueue queue(64);
+  std::vector<PcapPkt> waitedPkts;
+  std::thread waiter([&]() { pktWaitThread(&queue, &waitedPkts); });
+
+  auto pkt = MockRxPacket::fromHex("02 00 01 00 00 01  02 00 02 01 02 03");
+  pkt->padToLength(68);
+
+  // Adding packets never blocks, the ones that don't fit are dropped
+  constexpr int kThreads = 4;
+  constexpr int kPktsPerThread = 10000;
+  std::vector<std::thread> producers;
+  for (int i = 0; i < kThreads; ++i) {
+    producers.emplace_back([&]() {
+      for (int n = 0; n < kPktsPerThread; ++n) {
+        queue.addPkt(pkt.get());
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  queue.finish();
+  waiter.join();
+
+  EXPECT_EQ(kThreads * kPktsPerThread, waitedPkts.size() + queue.numDropped());
+  // Packets added after finish() are ignored
+  queue.addPkt(pkt.get());
+  EXPECT_EQ(kThreads * kPktsPerThread, waitedPkts.size() + queue.numDropped());
+}
@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/HwPhaseScheduler.h"
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/UpdateTracer.h"
+
+#include <fb303/ServiceData.h>
+#include <folly/Conv.h>
+#include <folly/Executor.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace facebook::fboss {
+
+void HwPhaseScheduler::addPhase(
+    folly::StringPiece name,
+    PhaseFn fn,
+    const std::vector<folly::StringPiece>& dependencies) {
+  auto index = phases_.size();
+  for (auto dependency : dependencies) {
+    auto it = std::find_if(
+        phases_.begin(), phases_.end(), [dependency](const Phase& phase) {
+          return phase.name == dependency;
+        });
+    if (it == phases_.end()) {
+      throw FbossError(
+          "Phase ", name, " depends on unknown phase ", dependency);
+    }
+    it->dependents.push_back(index);
+  }
+  Phase phase;
+  phase.name = name.str();
+  phase.stage = folly::to<std::string>("hw.", name);
+  phase.fn = std::move(fn);
+  phase.numDependencies = dependencies.size();
+  phases_.push_back(std::move(phase));
+}
+
+std::string HwPhaseScheduler::counterName(folly::StringPiece phase) {
+  return folly::to<std::string>(kCounterPrefix, phase, ".us");
+}
+
+void HwPhaseScheduler::run(folly::Executor* executor) {
+  if (executor) {
+    runParallel(executor);
+    return;
+  }
+  for (const auto& phase : phases_) {
+    runPhase(phase);
+  }
+}
+
+void HwPhaseScheduler::runPhase(const Phase& phase) const {
+  auto start = std::chrono::steady_clock::now();
+  {
+    ScopedTraceSpan span(phase.stage);
+    phase.fn();
+  }
+  auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  fb303::fbData->incrementCounter(counterName(phase.name), duration.count());
+}
+
+void HwPhaseScheduler::runParallel(folly::Executor* executor) {
+  std::mutex mutex;
+  std::condition_variable done;
+  std::vector<size_t> pending;
+  std::deque<size_t> ready;
+  for (size_t i = 0; i < phases_.size(); ++i) {
+    pending.push_back(phases_[i].numDependencies);
+    if (!phases_[i].numDependencies) {
+      ready.push_back(i);
+    }
+  }
+  size_t running = 0;
+  std::exception_ptr error;
+  // Spans recorded on the executor threads go to the traces of this update
+  const auto& traces = UpdateTracer::currentTraces();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    while (!error && !ready.empty()) {
+      auto index = ready.front();
+      ready.pop_front();
+      ++running;
+      executor->add([&, index]() {
+        std::exception_ptr phaseError;
+        try {
+          ScopedTraceContext context(traces);
+          runPhase(phases_[index]);
+        } catch (...) {
+          phaseError = std::current_exception();
+        }
+        std::lock_guard<std::mutex> g(mutex);
+        if (phaseError && !error) {
+          error = phaseError;
+        }
+        for (auto dependent : phases_[index].dependents) {
+          if (--pending[dependent] == 0) {
+            ready.push_back(dependent);
+          }
+        }
+        --running;
+        done.notify_one();
+      });
+    }
+    if (!running) {
+      break;
+    }
+    done.wait(lock);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,71 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Range.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace folly {
+class Executor;
+}
+
+namespace facebook::fboss {
+
+/*
+ * Runs the phases of a hardware state update, e.g. programming of routes,
+ * ACLs or neighbors, honoring the dependencies between them.
+ *
+ * A phase may only depend on phases added before it, so the order in which
+ * phases are added is always a valid order to run them in. Without an
+ * executor phases run in that order on the calling thread. With an executor,
+ * every phase whose dependencies are done is started right away, so phases
+ * that don't depend on each other run in parallel.
+ *
+ * Each phase is recorded as a "hw.<phase>" span of the update traces current
+ * on the calling thread, and its duration is added to the fb303 counter
+ * "hw_programming.<phase>.us".
+ *
+ * If a phase throws, phases not started yet are skipped and the first
+ * exception is rethrown from run() once the running phases are done.
+ */
+class HwPhaseScheduler {
+ public:
+  using PhaseFn = std::function<void()>;
+
+  static constexpr folly::StringPiece kCounterPrefix{"hw_programming."};
+
+  void addPhase(
+      folly::StringPiece name,
+      PhaseFn fn,
+      const std::vector<folly::StringPiece>& dependencies = {});
+
+  void run(folly::Executor* executor = nullptr);
+
+  static std::string counterName(folly::StringPiece phase);
+
+ private:
+  struct Phase {
+    std::string name;
+    std::string stage;
+    PhaseFn fn;
+    std::vector<size_t> dependents;
+    size_t numDependencies{0};
+  };
+
+  void runPhase(const Phase& phase) const;
+  void runParallel(folly::Executor* executor);
+
+  std::vector<Phase> phases_;
+};
+
+} // namespace facebook::fboss
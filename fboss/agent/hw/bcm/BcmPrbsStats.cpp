@@ -0,0 +1,174 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/bcm/BcmPrbsStats.h"
+
+#include "fboss/agent/FbossError.h"
+
+#include <fb303/ServiceData.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
+#include <folly/logging/xlog.h>
+#include <folly/synchronization/Rcu.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+
+DEFINE_int32(
+    prbs_stats_threads,
+    1,
+    "Number of threads collecting PRBS lane stats, 1 to collect them on "
+    "the stats thread. Only helps on SDKs that don't serialize "
+    "bcm_port_phy_control_get() per unit");
+
+namespace {
+
+constexpr auto kPrbsCollectionHistogram = "prbs_stats.collection_us";
+constexpr auto kPrbsLanesCounter = "prbs_stats.lanes";
+// Histogram buckets in usecs
+constexpr int64_t kPrbsBucketWidth = 5000;
+constexpr int64_t kPrbsMin = 0;
+constexpr int64_t kPrbsMax = 100000;
+
+} // namespace
+
+namespace facebook::fboss {
+
+BcmPrbsStats::BcmPrbsStats(LaneStatusReader readLaneStatus)
+    : readLaneStatus_(std::move(readLaneStatus)) {
+  fb303::fbData->addHistogram(
+      kPrbsCollectionHistogram, kPrbsBucketWidth, kPrbsMin, kPrbsMax);
+  fb303::fbData->exportHistogramPercentile(
+      kPrbsCollectionHistogram, 50, 95, 99);
+}
+
+BcmPrbsStats::~BcmPrbsStats() {
+  // Join the collectors before anything they use goes away
+  collectors_.reset();
+  delete snapshot_.exchange(nullptr);
+}
+
+void BcmPrbsStats::collect() {
+  auto start = steady_clock::now();
+  auto lockedPortLanes = portLanes_.wlock();
+  std::vector<LanePrbsStatsEntry*> lanes;
+  for (auto& entry : *lockedPortLanes) {
+    for (auto& lanePrbsStatsEntry : entry.second) {
+      lanes.push_back(&lanePrbsStatsEntry);
+    }
+  }
+  if (lanes.empty()) {
+    return;
+  }
+
+  auto numWorkers = std::min<size_t>(
+      std::max(FLAGS_prbs_stats_threads, 1), lanes.size());
+  if (numWorkers == 1) {
+    collectLanes(lanes, 0, lanes.size());
+  } else {
+    if (!collectors_) {
+      collectors_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+          FLAGS_prbs_stats_threads,
+          std::make_shared<folly::NamedThreadFactory>("PrbsStats"));
+    }
+    // Every worker gets consecutive lanes, so that the lanes of a port
+    // mostly stay together
+    auto lanesPerWorker = (lanes.size() + numWorkers - 1) / numWorkers;
+    std::vector<folly::Future<folly::Unit>> futures;
+    for (size_t begin = 0; begin < lanes.size(); begin += lanesPerWorker) {
+      auto end = std::min(begin + lanesPerWorker, lanes.size());
+      futures.push_back(
+          folly::via(collectors_.get(), [this, &lanes, begin, end]() {
+            collectLanes(lanes, begin, end);
+          }));
+    }
+    // Fail like the serial collection does if reading any lane failed,
+    // rather than publishing a partial snapshot
+    for (auto& result : folly::collectAll(std::move(futures)).get()) {
+      result.throwIfFailed();
+    }
+  }
+  publishLocked(*lockedPortLanes);
+
+  auto elapsed =
+      duration_cast<std::chrono::microseconds>(steady_clock::now() - start);
+  fb303::fbData->addHistogramValue(kPrbsCollectionHistogram, elapsed.count());
+  fb303::fbData->setCounter(kPrbsLanesCounter, lanes.size());
+}
+
+void BcmPrbsStats::collectLanes(
+    const std::vector<LanePrbsStatsEntry*>& lanes,
+    size_t begin,
+    size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    auto& lanePrbsStatsEntry = *lanes[i];
+    auto status = readLaneStatus_(lanePrbsStatsEntry.getGportId());
+    if ((int32_t)status == -1) {
+      lanePrbsStatsEntry.lossOfLock();
+    } else if ((int32_t)status == -2) {
+      lanePrbsStatsEntry.locked();
+    } else {
+      lanePrbsStatsEntry.updateLaneStats(status);
+    }
+  }
+}
+
+void BcmPrbsStats::setPortLanes(int32_t portId, LanePrbsStatsTable lanes) {
+  auto lockedPortLanes = portLanes_.wlock();
+  (*lockedPortLanes)[portId] = std::move(lanes);
+  publishLocked(*lockedPortLanes);
+}
+
+void BcmPrbsStats::removePort(int32_t portId) {
+  auto lockedPortLanes = portLanes_.wlock();
+  lockedPortLanes->erase(portId);
+  publishLocked(*lockedPortLanes);
+}
+
+void BcmPrbsStats::clearPort(int32_t portId) {
+  auto lockedPortLanes = portLanes_.wlock();
+  auto portLanesIter = lockedPortLanes->find(portId);
+  if (portLanesIter == lockedPortLanes->end()) {
+    XLOG(ERR) << "Asic prbs lane error map not initialized for port " << portId;
+    return;
+  }
+  for (auto& lanePrbsStats : portLanesIter->second) {
+    lanePrbsStats.clearLaneStats();
+  }
+  publishLocked(*lockedPortLanes);
+}
+
+std::vector<PrbsLaneStats> BcmPrbsStats::getPortStats(int32_t portId) const {
+  std::vector<PrbsLaneStats> prbsStats;
+  // Read the snapshot, so that we don't wait for a collection in progress
+  folly::rcu_reader guard;
+  auto snapshot = snapshot_.load(std::memory_order_acquire);
+  if (!snapshot || snapshot->find(portId) == snapshot->end()) {
+    throw FbossError(
+        "Asic prbs lane error map not initialized for port ", portId);
+  }
+  const auto& lanePrbsStatsTable = snapshot->find(portId)->second;
+  XLOG(DBG3) << "lanePrbsStatsMap size: " << lanePrbsStatsTable.size();
+
+  for (const auto& lanePrbsStats : lanePrbsStatsTable) {
+    prbsStats.push_back(lanePrbsStats.getPrbsLaneStats());
+  }
+  return prbsStats;
+}
+
+void BcmPrbsStats::publishLocked(const PortLanes& portLanes) {
+  auto old =
+      snapshot_.exchange(new PortLanes(portLanes), std::memory_order_acq_rel);
+  if (old) {
+    folly::rcu_retire(old);
+  }
+}
+
+} // namespace facebook::fboss
@@ -16,6 +16,7 @@ extern "C" {
 #include <folly/IPAddress.h>
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
+#include <folly/hash/Hash.h>
 #include <folly/logging/xlog.h>
 #include "fboss/agent/Constants.h"
 #include "fboss/agent/hw/bcm/BcmError.h"
@@ -29,6 +30,8 @@ extern "C" {
 
 #include "fboss/agent/state/RouteTypes.h"
 
+#include <cstring>
+
 namespace facebook::fboss {
 
 BcmRoute::BcmRoute(
@@ -268,34 +271,75 @@ BcmRoute::~BcmRoute() {
   }
 }
 
-bool BcmRouteTable::Key::operator<(const Key& k2) const {
-  if (vrf < k2.vrf) {
-    return true;
-  } else if (vrf > k2.vrf) {
-    return false;
-  }
-  if (mask < k2.mask) {
-    return true;
-  } else if (mask > k2.mask) {
-    return false;
+BcmRouteTable::BcmRouteTable(BcmSwitch* hw) : hw_(hw) {}
+
+BcmRouteTable::~BcmRouteTable() {}
+
+size_t BcmRouteTable::V6KeyHash::operator()(const V6Key& key) const {
+  return folly::hash::hash_combine(key.high, key.low, key.mask);
+}
+
+BcmRouteTable::V4Key BcmRouteTable::packKey(
+    const folly::IPAddressV4& network,
+    uint8_t mask) {
+  return (static_cast<uint64_t>(network.toLongHBO()) << 8) | mask;
+}
+
+BcmRouteTable::V6Key BcmRouteTable::packKey(
+    const folly::IPAddressV6& network,
+    uint8_t mask) {
+  V6Key key;
+  const auto& bytes = network.toByteArray();
+  std::memcpy(&key.high, bytes.data(), sizeof(key.high));
+  std::memcpy(&key.low, bytes.data() + sizeof(key.high), sizeof(key.low));
+  key.mask = mask;
+  return key;
+}
+
+template <typename AddrT>
+BcmRouteTable::Index<AddrT>& BcmRouteTable::getIndex(VrfRoutes& vrfRoutes) {
+  if constexpr (std::is_same_v<AddrT, folly::IPAddressV4>) {
+    return vrfRoutes.v4;
+  } else {
+    return vrfRoutes.v6;
   }
-  return network < k2.network;
 }
 
-BcmRouteTable::BcmRouteTable(BcmSwitch* hw) : hw_(hw) {}
+template <typename AddrT>
+const BcmRouteTable::Index<AddrT>& BcmRouteTable::getIndex(
+    const VrfRoutes& vrfRoutes) {
+  if constexpr (std::is_same_v<AddrT, folly::IPAddressV4>) {
+    return vrfRoutes.v4;
+  } else {
+    return vrfRoutes.v6;
+  }
+}
 
-BcmRouteTable::~BcmRouteTable() {}
+template <typename AddrT>
+BcmRoute* BcmRouteTable::findRoute(
+    bcm_vrf_t vrf,
+    const AddrT& network,
+    uint8_t mask) const {
+  auto vrfIter = fib_.find(vrf);
+  if (vrfIter == fib_.end()) {
+    return nullptr;
+  }
+  const auto& index = getIndex<AddrT>(vrfIter->second);
+  auto iter = index.find(packKey(network, mask));
+  if (iter == index.end()) {
+    return nullptr;
+  }
+  return iter->second.get();
+}
 
 BcmRoute* BcmRouteTable::getBcmRouteIf(
     bcm_vrf_t vrf,
     const folly::IPAddress& network,
     uint8_t mask) const {
-  Key key{network, mask, vrf};
-  auto iter = fib_.find(key);
-  if (iter == fib_.end()) {
-    return nullptr;
+  if (network.isV4()) {
+    return findRoute(vrf, network.asV4(), mask);
   }
-  return iter->second.get();
+  return findRoute(vrf, network.asV6(), mask);
 }
 
 BcmRoute* BcmRouteTable::getBcmRoute(
@@ -316,14 +360,16 @@ BcmRoute* BcmRouteTable::getBcmRoute(
 }
 
 template <typename RouteT>
-void BcmRouteTable::addRoute(bcm_vrf_t vrf, const RouteT* route) {
+void BcmRouteTable::programRoute(
+    Index<typename RouteT::Addr>& index,
+    bcm_vrf_t vrf,
+    const RouteT* route) {
   const auto& prefix = route->prefix();
 
-  Key key{folly::IPAddress(prefix.network), prefix.mask, vrf};
-  auto ret = fib_.emplace(key, nullptr);
+  auto ret = index.emplace(packKey(prefix.network, prefix.mask), nullptr);
   if (ret.second) {
     SCOPE_FAIL {
-      fib_.erase(ret.first);
+      index.erase(ret.first);
     };
     ret.first->second.reset(new BcmRoute(
         hw_,
@@ -340,20 +386,69 @@ void BcmRouteTable::addRoute(bcm_vrf_t vrf, const RouteT* route) {
   ret.first->second->program(fwd, route->getClassID());
 }
 
+template <typename RouteT>
+void BcmRouteTable::addRoute(bcm_vrf_t vrf, const RouteT* route) {
+  using AddrT = typename RouteT::Addr;
+  programRoute(getIndex<AddrT>(fib_[vrf]), vrf, route);
+}
+
+template <typename RouteT>
+void BcmRouteTable::addRoutes(
+    bcm_vrf_t vrf,
+    const std::vector<const RouteT*>& routes,
+    folly::FunctionRef<void(const RouteT*, const BcmError&)> onError) {
+  using AddrT = typename RouteT::Addr;
+  if (routes.empty()) {
+    return;
+  }
+  // Some of these may be updates of existing routes, so this may over
+  // reserve. That is still cheaper than rehashing repeatedly on cold boot.
+  auto& index = getIndex<AddrT>(fib_[vrf]);
+  index.reserve(index.size() + routes.size());
+  for (const auto* route : routes) {
+    try {
+      programRoute(index, vrf, route);
+    } catch (const BcmError& e) {
+      onError(route, e);
+    }
+  }
+}
+
 template <typename RouteT>
 void BcmRouteTable::deleteRoute(bcm_vrf_t vrf, const RouteT* route) {
+  using AddrT = typename RouteT::Addr;
   const auto& prefix = route->prefix();
-  Key key{folly::IPAddress(prefix.network), prefix.mask, vrf};
-  auto iter = fib_.find(key);
-  if (iter == fib_.end()) {
+  auto vrfIter = fib_.find(vrf);
+  if (vrfIter == fib_.end()) {
+    throw FbossError("Failed to delete a non-existing route ", route->str());
+  }
+  auto& index = getIndex<AddrT>(vrfIter->second);
+  auto iter = index.find(packKey(prefix.network, prefix.mask));
+  if (iter == index.end()) {
     throw FbossError("Failed to delete a non-existing route ", route->str());
   }
-  fib_.erase(iter);
+  index.erase(iter);
+}
+
+size_t BcmRouteTable::size() const {
+  size_t numRoutes = 0;
+  for (const auto& vrfRoutes : fib_) {
+    numRoutes += vrfRoutes.second.v4.size() + vrfRoutes.second.v6.size();
+  }
+  return numRoutes;
 }
 
 template void BcmRouteTable::addRoute(bcm_vrf_t, const RouteV4*);
 template void BcmRouteTable::addRoute(bcm_vrf_t, const RouteV6*);
 template void BcmRouteTable::deleteRoute(bcm_vrf_t, const RouteV4*);
 template void BcmRouteTable::deleteRoute(bcm_vrf_t, const RouteV6*);
+template void BcmRouteTable::addRoutes(
+    bcm_vrf_t,
+    const std::vector<const RouteV4*>&,
+    folly::FunctionRef<void(const RouteV4*, const BcmError&)>);
+template void BcmRouteTable::addRoutes(
+    bcm_vrf_t,
+    const std::vector<const RouteV6*>&,
+    folly::FunctionRef<void(const RouteV6*, const BcmError&)>);
 
 } // namespace facebook::fboss
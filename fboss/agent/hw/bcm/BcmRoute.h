@@ -14,16 +14,20 @@ extern "C" {
 #include <bcm/types.h>
 }
 
+#include <folly/Function.h>
 #include <folly/IPAddress.h>
+#include <folly/container/F14Map.h>
 #include <folly/dynamic.h>
 #include "fboss/agent/state/Route.h"
 #include "fboss/agent/state/RouteNextHopEntry.h"
 #include "fboss/agent/types.h"
 
-#include <boost/container/flat_map.hpp>
+#include <type_traits>
+#include <vector>
 
 namespace facebook::fboss {
 
+class BcmError;
 class BcmSwitch;
 class BcmHost;
 class BcmMultiPathNextHop;
@@ -119,17 +123,73 @@ class BcmRouteTable {
   template <typename RouteT>
   void deleteRoute(bcm_vrf_t vrf, const RouteT* route);
 
+  /*
+   * Add (or update) a batch of routes, e.g. all the routes added to a VRF by
+   * a state delta. The routes are still programmed one at a time, the gain
+   * is in the index: the VRF's index is looked up and grown once for the
+   * whole batch rather than rehashed over and over on cold boot.
+   *
+   * A route failing to program with a BcmError is reported to onError, which
+   * runs in the catch block and so may rethrow with "throw;". Otherwise the
+   * rest of the batch is still programmed. Any other error propagates.
+   */
+  template <typename RouteT>
+  void addRoutes(
+      bcm_vrf_t vrf,
+      const std::vector<const RouteT*>& routes,
+      folly::FunctionRef<void(const RouteT*, const BcmError&)> onError);
+
+  size_t size() const;
+
  private:
-  struct Key {
-    folly::IPAddress network;
+  /*
+   * Routes are indexed per VRF and per address family, keyed on the prefix
+   * packed into integers, so that adding and removing a route is O(1).
+   */
+  using V4Key = uint64_t;
+  struct V6Key {
+    uint64_t high;
+    uint64_t low;
     uint8_t mask;
-    bcm_vrf_t vrf;
-    bool operator<(const Key& k2) const;
+    bool operator==(const V6Key& other) const {
+      return high == other.high && low == other.low && mask == other.mask;
+    }
+  };
+  struct V6KeyHash {
+    size_t operator()(const V6Key& key) const;
+  };
+  using V4Index = folly::F14FastMap<V4Key, std::unique_ptr<BcmRoute>>;
+  using V6Index =
+      folly::F14FastMap<V6Key, std::unique_ptr<BcmRoute>, V6KeyHash>;
+  struct VrfRoutes {
+    V4Index v4;
+    V6Index v6;
   };
 
+  template <typename AddrT>
+  using Index = std::conditional_t<
+      std::is_same_v<AddrT, folly::IPAddressV4>,
+      V4Index,
+      V6Index>;
+
+  static V4Key packKey(const folly::IPAddressV4& network, uint8_t mask);
+  static V6Key packKey(const folly::IPAddressV6& network, uint8_t mask);
+
+  template <typename AddrT>
+  static Index<AddrT>& getIndex(VrfRoutes& vrfRoutes);
+  template <typename AddrT>
+  static const Index<AddrT>& getIndex(const VrfRoutes& vrfRoutes);
+  template <typename AddrT>
+  BcmRoute* findRoute(bcm_vrf_t vrf, const AddrT& network, uint8_t mask) const;
+  template <typename RouteT>
+  void programRoute(
+      Index<typename RouteT::Addr>& index,
+      bcm_vrf_t vrf,
+      const RouteT* route);
+
   BcmSwitch* hw_;
 
-  boost::container::flat_map<Key, std::unique_ptr<BcmRoute>> fib_;
+  folly::F14FastMap<bcm_vrf_t, VrfRoutes> fib_;
 };
 
 } // namespace facebook::fboss
@@ -9,25 +9,87 @@
  */
 #include "BcmSflowExporter.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <utility>
 #include <vector>
 
 #include <fcntl.h>
 #include <ifaddrs.h>
+#include <sys/socket.h>
 
+#include <fb303/ServiceData.h>
 #include <folly/Range.h>
+#include <folly/io/Cursor.h>
 #include <folly/logging/xlog.h>
+#include <folly/system/ThreadName.h>
 #include <glog/logging.h>
 #include <optional>
 
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/packet/SflowStructs.h"
 
 using namespace std;
 
+DEFINE_bool(
+    sflow_export_v5,
+    false,
+    "Export sFlow samples as sFlow v5 datagrams carrying several samples "
+    "each, instead of one thrift serialized sample per datagram");
+DEFINE_int32(
+    sflow_max_datagram_size,
+    1400,
+    "Maximum size in bytes of the sFlow v5 datagrams samples are "
+    "aggregated into");
+DEFINE_int32(
+    sflow_batch_size,
+    32,
+    "Number of sFlow datagrams to send to the collectors at once");
+DEFINE_int32(
+    sflow_flush_interval_ms,
+    100,
+    "Maximum time in milliseconds an sFlow sample is held before being "
+    "sent to the collectors, 0 to send every sample right away");
+
 namespace {
+// sFlow v5 flow sample and raw packet header record formats
+constexpr facebook::fboss::sflow::DataFormat kFlowSampleFormat = 1;
+constexpr facebook::fboss::sflow::DataFormat kRawHeaderFormat = 1;
+// Data format and length of a sample record
+constexpr size_t kSampleRecordHeaderSize = 8;
+// Version, sub agent, sequence number, uptime and sample count
+constexpr size_t kDatagramFixedSize = 20;
+// Flow sample fields up to and including the flow record count, plus the
+// flow record data format and length
+constexpr size_t kFlowSampleFixedSize = 40;
+// Protocol, frame length, stripped bytes and header length
+constexpr size_t kSampledHeaderFixedSize = 16;
+
+size_t xdrPadded(size_t len) {
+  size_t block = facebook::fboss::sflow::XDR_BASIC_BLOCK_SIZE;
+  return (len + block - 1) / block * block;
+}
+
+folly::IPAddress agentAddress(const folly::IPAddress& localIP) {
+  return localIP.empty() ? folly::IPAddress("::") : localIP;
+}
+
+/*
+ * Serialize obj into a string, given an upper bound of its serialized size.
+ */
+template <typename T>
+std::string serializeToString(const T& obj, size_t maxSize) {
+  std::string out(maxSize, '\0');
+  auto buf = folly::IOBuf::wrapBuffer(out.data(), out.size());
+  folly::io::RWPrivateCursor cursor(buf.get());
+  obj.serialize(&cursor);
+  out.resize(out.size() - cursor.length());
+  return out;
+}
+
 std::optional<folly::IPAddress> getLocalIPv6FromWhoAmI() {
   const std::string whoAmIFn = "/etc/fbwhoami";
   const std::string key = "DEVICE_PRIMARY_IPV6";
@@ -189,25 +251,110 @@ ssize_t BcmSflowExporter::sendUDPDatagram(iovec* vec, const size_t iovec_len) {
   return ret;
 }
 
+size_t BcmSflowExporter::sendUDPDatagrams(
+    const std::vector<std::string>& datagrams) {
+  sockaddr_storage addrStorage;
+  address_.getAddress(&addrStorage);
+
+  std::vector<iovec> vecs(datagrams.size());
+  std::vector<mmsghdr> msgs(datagrams.size());
+  for (size_t i = 0; i < datagrams.size(); ++i) {
+    vecs[i].iov_base = const_cast<char*>(datagrams[i].data());
+    vecs[i].iov_len = datagrams[i].size();
+    auto& msg = msgs[i].msg_hdr;
+    msg.msg_name = reinterpret_cast<void*>(&addrStorage);
+    msg.msg_namelen = address_.getActualSize();
+    msg.msg_iov = &vecs[i];
+    msg.msg_iovlen = 1;
+  }
+
+  size_t sent = 0;
+  while (sent < msgs.size()) {
+    auto ret = ::sendmmsg(socket_, msgs.data() + sent, msgs.size() - sent, 0);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // The socket is non-blocking, so give up on the rest when the socket
+      // buffer is full rather than holding up the RX thread
+      XLOG(DBG1) << "Failed sending " << msgs.size() - sent
+                 << " sFlow packets to " << address_.describe()
+                 << " reason: " << folly::errnoStr(errno);
+      break;
+    }
+    sent += ret;
+  }
+  XLOG(DBG4) << "Sent " << sent << " sFlow packets to "
+             << address_.describe();
+  return sent;
+}
+
 BcmSflowExporter::~BcmSflowExporter() {
   if (socket_ != -1) {
     close(socket_);
   }
 }
 
+BcmSflowExporterTable::BcmSflowExporterTable()
+    : BcmSflowExporterTable(ExportConfig{
+          FLAGS_sflow_export_v5,
+          static_cast<size_t>(std::max(FLAGS_sflow_max_datagram_size, 0)),
+          static_cast<size_t>(std::max(FLAGS_sflow_batch_size, 1)),
+          std::chrono::milliseconds(
+              std::max(FLAGS_sflow_flush_interval_ms, 0))}) {}
+
+BcmSflowExporterTable::BcmSflowExporterTable(const ExportConfig& config)
+    : config_(config), startTime_(std::chrono::steady_clock::now()) {
+  if (config_.flushInterval.count() > 0) {
+    flushThread_ = std::thread([this]() { flushThread(); });
+  }
+}
+
+BcmSflowExporterTable::~BcmSflowExporterTable() {
+  if (flushThread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> g(mutex_);
+      stopFlushThread_ = true;
+    }
+    flushCond_.notify_one();
+    flushThread_.join();
+  }
+  flush();
+}
+
+void BcmSflowExporterTable::flushThread() {
+  folly::setThreadName("SflowExport");
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopFlushThread_) {
+    flushCond_.wait_for(lock, config_.flushInterval);
+    if (stopFlushThread_) {
+      return;
+    }
+    finishDatagramLocked();
+    std::vector<std::shared_ptr<BcmSflowExporter>> exporters;
+    auto datagrams = takePendingLocked(&exporters);
+    lock.unlock();
+    send(datagrams, exporters);
+    lock.lock();
+  }
+}
+
 bool BcmSflowExporterTable::contains(
     const shared_ptr<SflowCollector>& c) const {
+  std::lock_guard<std::mutex> g(mutex_);
   auto iter = map_.find(c->getID());
   return iter != map_.end();
 }
 
 size_t BcmSflowExporterTable::size() const {
+  std::lock_guard<std::mutex> g(mutex_);
   return map_.size();
 }
 
 void BcmSflowExporterTable::addExporter(const shared_ptr<SflowCollector>& c) {
   try {
-    auto exporter = make_unique<BcmSflowExporter>(c->getAddress());
+    auto exporter = make_shared<BcmSflowExporter>(c->getAddress());
+    std::lock_guard<std::mutex> g(mutex_);
     map_.emplace(c->getID(), move(exporter));
   } catch (const fboss::thrift::FbossBaseError& ex) {
     XLOG(ERR) << "Could not add exporter: "
@@ -222,6 +369,7 @@ void BcmSflowExporterTable::addExporter(const shared_ptr<SflowCollector>& c) {
 
 void BcmSflowExporterTable::removeExporter(const std::string& id) {
   XLOG(INFO) << "Removed sFlow exporter " << id;
+  std::lock_guard<std::mutex> g(mutex_);
   map_.erase(id);
 }
 
@@ -229,43 +377,181 @@ void BcmSflowExporterTable::updateSamplingRates(
     PortID id,
     int64_t inRate,
     int64_t outRate) {
-  std::pair<int64_t, int64_t> rates(inRate, outRate);
-  auto it = port2samplingRates_.find(id);
-  if (it != port2samplingRates_.end()) {
-    it->second = rates;
-  } else {
-    port2samplingRates_.insert(std::make_pair(id, rates));
-  }
-
   // We piggyback the update of local IPv6
-  localIP_ = getLocalIPv6();
+  auto localIP = getLocalIPv6();
+
+  std::lock_guard<std::mutex> g(mutex_);
+  port2samplingRates_[id] = std::make_pair(inRate, outRate);
+  localIP_ = localIP;
 }
 
 void BcmSflowExporterTable::sendToAll(const SflowPacketInfo& info) {
-  if (map_.empty()) {
-    XLOG(DBG1)
-        << "zero sFlow collectors with sflow enabled, skipping sample export";
+  std::vector<std::shared_ptr<BcmSflowExporter>> exporters;
+  std::vector<std::string> datagrams;
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    if (map_.empty()) {
+      XLOG(DBG1)
+          << "zero sFlow collectors with sflow enabled, skipping sample export";
+      return;
+    }
+    if (config_.sflowV5) {
+      addFlowSampleLocked(encodeFlowSampleLocked(info));
+    } else {
+      string output;
+      apache::thrift::BinarySerializer::serialize(info, &output);
+      pending_.push_back(std::move(output));
+    }
+    if (config_.flushInterval.count() == 0) {
+      finishDatagramLocked();
+    }
+    if (config_.flushInterval.count() > 0 &&
+        pending_.size() < config_.batchSize) {
+      return;
+    }
+    datagrams = takePendingLocked(&exporters);
+  }
+  send(datagrams, exporters);
+}
+
+void BcmSflowExporterTable::flush() {
+  std::vector<std::shared_ptr<BcmSflowExporter>> exporters;
+  std::vector<std::string> datagrams;
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    finishDatagramLocked();
+    datagrams = takePendingLocked(&exporters);
+  }
+  send(datagrams, exporters);
+}
+
+std::string BcmSflowExporterTable::encodeFlowSampleLocked(
+    const SflowPacketInfo& info) {
+  // Leave room for the datagram header and the sample record header, so
+  // that every sample fits a datagram of its own
+  size_t overhead = kDatagramFixedSize +
+      sflow::sizeIP(agentAddress(localIP_)) + kSampleRecordHeaderSize +
+      kFlowSampleFixedSize + kSampledHeaderFixedSize;
+  auto maxHeaderLen = config_.maxDatagramSize > overhead
+      ? config_.maxDatagramSize - overhead
+      : 0;
+  maxHeaderLen -= maxHeaderLen % sflow::XDR_BASIC_BLOCK_SIZE;
+
+  sflow::SampledHeader header;
+  header.protocol = sflow::HeaderProtocol::ETHERNET_ISO88023;
+  header.frameLength = info.frameLength;
+  header.headerLength = std::min(info.packetData.size(), maxHeaderLen);
+  header.stripped = info.payloadRemoved;
+  header.header =
+      reinterpret_cast<const sflow::byte*>(info.packetData.data());
+  auto headerData = serializeToString(
+      header, kSampledHeaderFixedSize + xdrPadded(header.headerLength));
+
+  sflow::FlowRecord record;
+  record.flowFormat = kRawHeaderFormat;
+  record.flowDataLen = headerData.size();
+  record.flowData = reinterpret_cast<sflow::byte*>(headerData.data());
+
+  int64_t samplingRate = 0;
+  auto rates = port2samplingRates_.find(PortID(info.srcPort));
+  if (rates != port2samplingRates_.end()) {
+    samplingRate =
+        info.ingressSampled ? rates->second.first : rates->second.second;
+  }
+
+  sflow::FlowSample sample;
+  sample.sequenceNumber = ++sampleSequence_;
+  sample.sourceID = info.srcPort;
+  sample.samplingRate = samplingRate;
+  sample.samplePool = 0;
+  sample.drops = 0;
+  sample.input = info.srcPort;
+  sample.output = info.dstPort;
+  sample.flowRecordsCnt = 1;
+  sample.flowRecords = &record;
+  return serializeToString(sample, kFlowSampleFixedSize + headerData.size());
+}
+
+void BcmSflowExporterTable::addFlowSampleLocked(std::string sample) {
+  auto recordSize = kSampleRecordHeaderSize + sample.size();
+  if (!openSamples_.empty() &&
+      openSize_ + recordSize > config_.maxDatagramSize) {
+    finishDatagramLocked();
+  }
+  if (openSamples_.empty()) {
+    openSize_ = kDatagramFixedSize + sflow::sizeIP(agentAddress(localIP_));
+  }
+  openSize_ += recordSize;
+  openSamples_.push_back(std::move(sample));
+}
+
+void BcmSflowExporterTable::finishDatagramLocked() {
+  if (openSamples_.empty()) {
     return;
   }
-  // Serialize info to a string and wrap it in an IOBuf for sending
-  string output;
-  apache::thrift::BinarySerializer::serialize(info, &output);
-  auto buf = folly::IOBuf::wrapBuffer(output.data(), output.length());
-
-  // Map the IOBuf to a Linux iovec like a champ
-  iovec vec[16] = {};
-  size_t iovec_len = buf->fillIov(vec, sizeof(vec) / sizeof(vec[0])).numIovecs;
-  if (UNLIKELY(iovec_len == 0)) {
-    buf->coalesce();
-    vec[0].iov_base = const_cast<uint8_t*>(buf->data());
-    vec[0].iov_len = buf->length();
-    iovec_len = 1;
+  std::vector<sflow::SampleRecord> records(openSamples_.size());
+  for (size_t i = 0; i < openSamples_.size(); ++i) {
+    records[i].sampleType = kFlowSampleFormat;
+    records[i].sampleDataLen = openSamples_[i].size();
+    records[i].sampleData =
+        reinterpret_cast<sflow::byte*>(openSamples_[i].data());
   }
 
+  sflow::SampleDatagram datagram;
+  auto& datagramV5 = datagram.datagramV5;
+  datagramV5.agentAddress = agentAddress(localIP_);
+  datagramV5.subAgentID = 0;
+  datagramV5.sequenceNumber = ++datagramSequence_;
+  datagramV5.uptime = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - startTime_)
+                          .count();
+  datagramV5.samplesCnt = records.size();
+  datagramV5.samples = records.data();
+  pending_.push_back(serializeToString(datagram, openSize_));
+
+  openSamples_.clear();
+  openSize_ = 0;
+}
+
+std::vector<std::string> BcmSflowExporterTable::takePendingLocked(
+    std::vector<std::shared_ptr<BcmSflowExporter>>* exporters) {
+  exporters->reserve(map_.size());
   for (const auto& c : map_) {
-    // TODO: prob need to handle ret code?
-    c.second->sendUDPDatagram(vec, iovec_len);
+    exporters->push_back(c.second);
+  }
+  return std::exchange(pending_, {});
+}
+
+void BcmSflowExporterTable::send(
+    const std::vector<std::string>& datagrams,
+    const std::vector<std::shared_ptr<BcmSflowExporter>>& exporters) {
+  if (datagrams.empty()) {
+    return;
+  }
+  uint64_t sent = 0;
+  for (const auto& exporter : exporters) {
+    sent += exporter->sendUDPDatagrams(datagrams);
+  }
+  uint64_t dropped = datagrams.size() * exporters.size() - sent;
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    datagramsSent_ += sent;
+    datagramsDropped_ += dropped;
+  }
+  fb303::fbData->incrementCounter("sflow.datagrams_sent", sent);
+  if (dropped) {
+    fb303::fbData->incrementCounter("sflow.datagrams_dropped", dropped);
   }
 }
 
+uint64_t BcmSflowExporterTable::datagramsSent() const {
+  std::lock_guard<std::mutex> g(mutex_);
+  return datagramsSent_;
+}
+
+uint64_t BcmSflowExporterTable::datagramsDropped() const {
+  std::lock_guard<std::mutex> g(mutex_);
+  return datagramsDropped_;
+}
+
 } // namespace facebook::fboss
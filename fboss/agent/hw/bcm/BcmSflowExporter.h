@@ -9,7 +9,13 @@
  */
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include <folly/IPAddress.h>
 #include <folly/SocketAddress.h>
@@ -35,6 +41,12 @@ class BcmSflowExporter {
    */
   ssize_t sendUDPDatagram(iovec* vec, const size_t iovec_len);
 
+  /*
+   * Send out each of the datagrams with as few sendmmsg() calls as
+   * possible. Returns how many of them were sent.
+   */
+  size_t sendUDPDatagrams(const std::vector<std::string>& datagrams);
+
  private:
   // no copy or assignment
   BcmSflowExporter(BcmSflowExporter const&) = delete;
@@ -44,10 +56,31 @@ class BcmSflowExporter {
   int socket_{-1};
 };
 
+/*
+ * Exports sFlow samples to all the collectors.
+ *
+ * Samples are sent as thrift serialized SflowPacketInfo, one per datagram,
+ * unless sFlow v5 export is enabled, in which case samples are encoded as
+ * sFlow v5 flow samples and aggregated into datagrams of up to
+ * maxDatagramSize bytes.
+ *
+ * Finished datagrams are sent to all collectors with sendmmsg() once
+ * batchSize of them are pending, and by a background thread every
+ * flushInterval. A zero flushInterval sends every sample right away.
+ */
 class BcmSflowExporterTable {
  public:
-  BcmSflowExporterTable() = default;
-  ~BcmSflowExporterTable() = default;
+  struct ExportConfig {
+    bool sflowV5;
+    size_t maxDatagramSize;
+    size_t batchSize;
+    std::chrono::milliseconds flushInterval;
+  };
+
+  // Configured by the sflow_* flags
+  BcmSflowExporterTable();
+  explicit BcmSflowExporterTable(const ExportConfig& config);
+  ~BcmSflowExporterTable();
 
   bool contains(const std::shared_ptr<SflowCollector>& collector) const;
   size_t size() const;
@@ -58,17 +91,56 @@ class BcmSflowExporterTable {
 
   void sendToAll(const SflowPacketInfo& info);
 
+  // Send out everything exported so far
+  void flush();
+
+  uint64_t datagramsSent() const;
+  uint64_t datagramsDropped() const;
+
  private:
   // no copy or assignment
   BcmSflowExporterTable(BcmSflowExporterTable const&) = delete;
   BcmSflowExporterTable& operator=(BcmSflowExporterTable const&) = delete;
 
-  std::unordered_map<std::string, std::unique_ptr<BcmSflowExporter>> map_;
+  std::string encodeFlowSampleLocked(const SflowPacketInfo& info);
+  void addFlowSampleLocked(std::string sample);
+  void finishDatagramLocked();
+  /*
+   * Take the pending datagrams, along with the exporters to send them to,
+   * so that they can be sent without holding mutex_.
+   */
+  std::vector<std::string> takePendingLocked(
+      std::vector<std::shared_ptr<BcmSflowExporter>>* exporters);
+  void send(
+      const std::vector<std::string>& datagrams,
+      const std::vector<std::shared_ptr<BcmSflowExporter>>& exporters);
+  void flushThread();
+
+  const ExportConfig config_;
+  const std::chrono::steady_clock::time_point startTime_;
+
+  // Protects everything below. sendToAll() is called from the RX thread,
+  // while collectors and sampling rates are updated from the update thread.
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<BcmSflowExporter>> map_;
   std::unordered_map<
       PortID,
       std::pair<int64_t /* ingress rate */, int64_t /* egress rate */>>
       port2samplingRates_;
   folly::IPAddress localIP_;
+
+  // Flow samples of the sFlow v5 datagram being filled, and its size
+  std::vector<std::string> openSamples_;
+  size_t openSize_{0};
+  uint32_t datagramSequence_{0};
+  uint32_t sampleSequence_{0};
+  std::vector<std::string> pending_;
+  uint64_t datagramsSent_{0};
+  uint64_t datagramsDropped_{0};
+
+  std::condition_variable flushCond_;
+  bool stopFlushThread_{false};
+  std::thread flushThread_;
 };
 
 } // namespace facebook::fboss
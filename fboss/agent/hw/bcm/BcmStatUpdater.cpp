@@ -89,7 +89,13 @@ using facebook::fboss::bcmCheckError;
 BcmStatUpdater::BcmStatUpdater(BcmSwitch* hw, bool isAlpmEnabled)
     : hw_(hw),
       bcmTableStatsManager_(
-          std::make_unique<BcmHwTableStatManager>(hw, isAlpmEnabled)) {}
+          std::make_unique<BcmHwTableStatManager>(hw, isAlpmEnabled)),
+      prbsStats_([hw](bcm_gport_t gport) {
+        uint32 status;
+        bcm_port_phy_control_get(
+            hw->getUnit(), gport, BCM_PORT_PHY_CONTROL_PRBS_RX_STATUS, &status);
+        return status;
+      }) {}
 
 std::string BcmStatUpdater::counterTypeToString(cfg::CounterType type) {
   switch (type) {
@@ -145,24 +151,7 @@ void BcmStatUpdater::updateHwTableStats() {
 }
 
 void BcmStatUpdater::updatePrbsStats() {
-  uint32 status;
-  auto lockedAsicPrbsStats = portAsicPrbsStats_.wlock();
-  for (auto& entry : *lockedAsicPrbsStats) {
-    auto& lanePrbsStatsTable = entry.second;
-
-    for (auto& lanePrbsStatsEntry : lanePrbsStatsTable) {
-      bcm_gport_t gport = lanePrbsStatsEntry.getGportId();
-      bcm_port_phy_control_get(
-          hw_->getUnit(), gport, BCM_PORT_PHY_CONTROL_PRBS_RX_STATUS, &status);
-      if ((int32_t)status == -1) {
-        lanePrbsStatsEntry.lossOfLock();
-      } else if ((int32_t)status == -2) {
-        lanePrbsStatsEntry.locked();
-      } else {
-        lanePrbsStatsEntry.updateLaneStats(status);
-      }
-    }
-  }
+  prbsStats_.collect();
 }
 
 double BcmStatUpdater::calculateLaneRate(std::shared_ptr<Port> swPort) {
@@ -236,33 +225,11 @@ void BcmStatUpdater::clearPortStats(
 
 std::vector<PrbsLaneStats> BcmStatUpdater::getPortAsicPrbsStats(
     int32_t portId) {
-  std::vector<PrbsLaneStats> prbsStats;
-  auto lockedPortAsicPrbsStats = portAsicPrbsStats_.rlock();
-  auto portAsicPrbsStatIter = lockedPortAsicPrbsStats->find(portId);
-  if (portAsicPrbsStatIter == lockedPortAsicPrbsStats->end()) {
-    throw FbossError(
-        "Asic prbs lane error map not initialized for port ", portId);
-  }
-  auto lanePrbsStatsTable = portAsicPrbsStatIter->second;
-  XLOG(DBG3) << "lanePrbsStatsMap size: " << lanePrbsStatsTable.size();
-
-  for (const auto& lanePrbsStats : lanePrbsStatsTable) {
-    prbsStats.push_back(lanePrbsStats.getPrbsLaneStats());
-  }
-  return prbsStats;
+  return prbsStats_.getPortStats(portId);
 }
 
 void BcmStatUpdater::clearPortAsicPrbsStats(int32_t portId) {
-  auto lockedPortAsicPrbsStats = portAsicPrbsStats_.wlock();
-  auto portAsicPrbsStatIter = lockedPortAsicPrbsStats->find(portId);
-  if (portAsicPrbsStatIter == lockedPortAsicPrbsStats->end()) {
-    XLOG(ERR) << "Asic prbs lane error map not initialized for port " << portId;
-    return;
-  }
-  auto& lanePrbsStatsTable = portAsicPrbsStatIter->second;
-  for (auto& lanePrbsStats : lanePrbsStatsTable) {
-    lanePrbsStats.clearLaneStats();
-  }
+  prbsStats_.clearPort(portId);
 }
 
 void BcmStatUpdater::refreshHwTableStats(const StateDelta& delta) {
@@ -318,9 +285,8 @@ void BcmStatUpdater::refreshPrbsStats(const StateDelta& delta) {
           return;
         }
 
-        auto lockedPortAsicPrbsStats = portAsicPrbsStats_.wlock();
         if (!newPort->getAsicPrbs().enabled) {
-          lockedPortAsicPrbsStats->erase(oldPort->getID());
+          prbsStats_.removePort(oldPort->getID());
           return;
         }
 
@@ -372,8 +338,8 @@ void BcmStatUpdater::refreshPrbsStats(const StateDelta& delta) {
           lanePrbsStatsTable.push_back(
               LanePrbsStatsEntry(lane, gport, calculateLaneRate(newPort)));
         }
-        (*lockedPortAsicPrbsStats)[newPort->getID()] =
-            std::move(lanePrbsStatsTable);
+        prbsStats_.setPortLanes(
+            newPort->getID(), std::move(lanePrbsStatsTable));
       });
 }
 
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "common/stats/MonotonicCounter.h"
+#include "fboss/agent/hw/bcm/BcmPrbsStats.h"
 #include "fboss/agent/hw/bcm/BcmTableStats.h"
 #include "fboss/agent/hw/bcm/types.h"
 #include "fboss/agent/types.h"
@@ -26,129 +27,12 @@ extern "C" {
 namespace facebook::fboss {
 
 using facebook::stats::MonotonicCounter;
-using std::chrono::duration_cast;
-using std::chrono::milliseconds;
-using std::chrono::steady_clock;
 
 class BcmSwitch;
 class StateDelta;
 
 class BcmStatUpdater {
  public:
-  class LanePrbsStatsEntry {
-   public:
-    LanePrbsStatsEntry(int32_t laneId, int32_t gportId, double laneRate)
-        : laneId_(laneId), gportId_(gportId), laneRate_(laneRate) {
-      timeLastCleared_ = steady_clock::now();
-      timeLastLocked_ = steady_clock::time_point();
-    }
-
-    int32_t getLaneId() const {
-      return laneId_;
-    }
-
-    int32_t getGportId() const {
-      return gportId_;
-    }
-
-    double getLaneRate() const {
-      return laneRate_;
-    }
-
-    void lossOfLock() {
-      if (locked_) {
-        locked_ = false;
-        accuErrorCount_ = 0;
-        numLossOfLock_++;
-      }
-      timeLastCollect_ = steady_clock::now();
-    }
-
-    void locked() {
-      steady_clock::time_point now = steady_clock::now();
-      locked_ = true;
-      accuErrorCount_ = 0;
-      timeLastLocked_ = now;
-      timeLastCollect_ = now;
-    }
-
-    void updateLaneStats(uint32 status) {
-      if (!locked_) {
-        locked();
-        return;
-      }
-      steady_clock::time_point now = steady_clock::now();
-      accuErrorCount_ += status;
-
-      milliseconds duration =
-          std::chrono::duration_cast<std::chrono::milliseconds>(
-              now - timeLastCollect_);
-      // There shouldn't be a case where duration would be 0.
-      // But just add a check here to be safe.
-      if (duration.count() == 0) {
-        return;
-      }
-      double ber = (status * 1000) / (laneRate_ * duration.count());
-      if (ber > maxBer_) {
-        maxBer_ = ber;
-      }
-      timeLastCollect_ = now;
-    }
-
-    PrbsLaneStats getPrbsLaneStats() const {
-      PrbsLaneStats prbsLaneStats = PrbsLaneStats();
-      steady_clock::time_point now = steady_clock::now();
-      prbsLaneStats.laneId = laneId_;
-      if (!locked_) {
-        prbsLaneStats.ber = 0.;
-      } else {
-        milliseconds duration =
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                timeLastCollect_ - timeLastLocked_);
-        if (duration.count() == 0) {
-          prbsLaneStats.ber = 0.;
-        } else {
-          prbsLaneStats.ber =
-              (accuErrorCount_ * 1000) / (laneRate_ * duration.count());
-        }
-      }
-      prbsLaneStats.maxBer = maxBer_;
-      prbsLaneStats.numLossOfLock = numLossOfLock_;
-      prbsLaneStats.timeSinceLastLocked =
-          (timeLastLocked_ == steady_clock::time_point())
-          ? 0
-          : std::chrono::duration_cast<std::chrono::seconds>(
-                now - timeLastLocked_)
-                .count();
-      prbsLaneStats.timeSinceLastClear =
-          std::chrono::duration_cast<std::chrono::seconds>(
-              now - timeLastCleared_)
-              .count();
-      return prbsLaneStats;
-    }
-
-    void clearLaneStats() {
-      accuErrorCount_ = 0;
-      maxBer_ = -1.;
-      numLossOfLock_ = 0;
-      timeLastLocked_ = locked_ ? timeLastCollect_ : steady_clock::time_point();
-      timeLastCleared_ = steady_clock::now();
-    }
-
-   private:
-    const int32_t laneId_ = -1;
-    const int32_t gportId_ = -1;
-    const double laneRate_ = 0.;
-    bool locked_ = false;
-    int64_t accuErrorCount_ = 0;
-    double maxBer_ = -1.;
-    int32_t numLossOfLock_ = 0;
-    steady_clock::time_point timeLastLocked_;
-    steady_clock::time_point timeLastCleared_;
-    steady_clock::time_point timeLastCollect_;
-  };
-  using LanePrbsStatsTable = std::vector<LanePrbsStatsEntry>;
-
   explicit BcmStatUpdater(BcmSwitch* hw, bool isAlpmEnabled);
   ~BcmStatUpdater() {}
 
@@ -167,6 +51,9 @@ class BcmStatUpdater {
    *
    *  'refresh()' and 'updateStats()' are using folly::Synchronize to ensure
    *  thread safety.
+   *
+   *  PRBS lane stats are kept by BcmPrbsStats, which publishes a snapshot
+   *  for the thrift readers, so that they never wait for a collection.
    */
 
   MonotonicCounter* getCounterIf(
@@ -232,7 +119,7 @@ class BcmStatUpdater {
   folly::Synchronized<
       std::map<AclCounterDescriptor, std::unique_ptr<MonotonicCounter>>>
       aclStats_;
-  folly::Synchronized<std::map<int32_t, LanePrbsStatsTable>> portAsicPrbsStats_;
+  BcmPrbsStats prbsStats_;
 }; // namespace facebook::fboss
 
 } // namespace facebook::fboss
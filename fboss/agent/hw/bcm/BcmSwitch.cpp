@@ -19,6 +19,8 @@
 #include <folly/Conv.h>
 #include <folly/FileUtil.h>
 #include <folly/Memory.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <folly/hash/Hash.h>
 #include <folly/logging/xlog.h>
 
@@ -27,9 +29,11 @@
 #include "fboss/agent/LacpTypes.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwitchStats.h"
+#include "fboss/agent/UpdateTracer.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/agent/hw/BufferStatsLogger.h"
+#include "fboss/agent/hw/HwPhaseScheduler.h"
 #include "fboss/agent/hw/bcm/BcmAPI.h"
 #include "fboss/agent/hw/bcm/BcmAclEntry.h"
 #include "fboss/agent/hw/bcm/BcmAclTable.h"
@@ -195,6 +199,12 @@ DEFINE_int32(
 // Put lowest priority for this group among all i.e. lower than acl_g_pri,
 // ll_mcast_g_pri,
 DEFINE_int32(qcm_ifp_pri, -1, "Group priority for ACL field group");
+DEFINE_int32(
+    hw_programming_threads,
+    0,
+    "Number of threads used to program independent object types (port "
+    "queues alongside L3 objects) in parallel on state updates. 0 programs "
+    "all of them serially on the update thread");
 
 enum : uint8_t {
   kRxCallbackPriority = 1,
@@ -404,6 +414,11 @@ BcmSwitch::BcmSwitch(BcmPlatform* platform, uint32_t featuresDesired)
       switchSettings_(new BcmSwitchSettings(this)),
       macTable_(new BcmMacTable(this)),
       qcmManager_(new BcmQcmManager(this)) {
+  if (FLAGS_hw_programming_threads > 0) {
+    programmingExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        FLAGS_hw_programming_threads,
+        std::make_shared<folly::NamedThreadFactory>("BcmProgramming"));
+  }
   exportSdkVersion();
 }
 
@@ -694,8 +709,10 @@ std::shared_ptr<SwitchState> BcmSwitch::applyAndGetWarmBootSwitchState() {
   getPlatform()->preWarmbootStateApplied();
 
   warmBootState->publish();
+  // Programming the warm boot state consumes the warm boot cache, which is
+  // not safe to do from multiple threads
   return stateChangedImpl(
-      StateDelta(make_shared<SwitchState>(), warmBootState));
+      StateDelta(make_shared<SwitchState>(), warmBootState), nullptr);
 }
 
 void BcmSwitch::runBcmScript(const std::string& filename) const {
@@ -1036,13 +1053,14 @@ void BcmSwitch::processMacTableChanges(const StateDelta& stateDelta) {
 std::shared_ptr<SwitchState> BcmSwitch::stateChanged(const StateDelta& delta) {
   // Take the lock before modifying any objects
   std::lock_guard<std::mutex> g(lock_);
-  auto appliedState = stateChangedImpl(delta);
+  auto appliedState = stateChangedImpl(delta, programmingExecutor_.get());
   appliedState->publish();
   return appliedState;
 }
 
 std::shared_ptr<SwitchState> BcmSwitch::stateChangedImpl(
-    const StateDelta& delta) {
+    const StateDelta& delta,
+    folly::Executor* executor) {
   // Reconfigure port groups in case we are changing between using a port as
   // 1, 2 or 4 ports. Only do this if flexports are enabled
   // Calling reconfigure port group first to make sure the ports of SW state
@@ -1070,110 +1088,213 @@ std::shared_ptr<SwitchState> BcmSwitch::stateChangedImpl(
   // it, and move it out into a common helper class that can be shared by
   // many different HwSwitch implementations.
 
+  // Each object type is programmed in a phase, which runs once the phases it
+  // depends on are done. Without an executor the phases run in the order
+  // they are listed in, which is the order they always ran in.
+  //
+  // With an executor, port queue settings are split out of the ports phase
+  // and programmed alongside everything from neighbors to routes. That is
+  // the only phase that runs in parallel with others: it only touches the
+  // BcmPort's own queue manager and port stats, and cosq SDK calls, while
+  // the L3, ACL and sFlow phases share the warm boot cache, the stat
+  // updater and the host/egress tables, so they stay in a chain.
+  HwPhaseScheduler scheduler;
+
   // As the first step, disable ports that are now disabled.
   // This ensures that we immediately stop forwarding traffic on these ports.
-  processDisabledPorts(delta);
+  scheduler.addPhase(
+      "ports_disabled", [&]() { processDisabledPorts(delta); });
 
-  processSwitchSettingsChanged(delta);
+  scheduler.addPhase(
+      "switch_settings",
+      [&]() { processSwitchSettingsChanged(delta); },
+      {"ports_disabled"});
 
-  processMacTableChanges(delta);
+  scheduler.addPhase(
+      "mac_table",
+      [&]() { processMacTableChanges(delta); },
+      {"switch_settings"});
 
-  processLoadBalancerChanges(delta);
+  scheduler.addPhase(
+      "load_balancers",
+      [&]() { processLoadBalancerChanges(delta); },
+      {"mac_table"});
 
   CHECK(!bothStandAloneRibOrRouteTableRibUsed(delta));
 
   // remove all routes to be deleted
-  processRemovedRoutes(delta);
-  processRemovedFibRoutes(delta);
+  scheduler.addPhase(
+      "routes_removed",
+      [&]() {
+        processRemovedRoutes(delta);
+        processRemovedFibRoutes(delta);
+      },
+      {"load_balancers"});
 
   // delete all interface not existing anymore. that should stop
   // all traffic on that interface now
-  forEachRemoved(delta.getIntfsDelta(), &BcmSwitch::processRemovedIntf, this);
+  scheduler.addPhase(
+      "interfaces_removed",
+      [&]() {
+        forEachRemoved(
+            delta.getIntfsDelta(), &BcmSwitch::processRemovedIntf, this);
+      },
+      {"routes_removed"});
 
   // Add all new VLANs, and modify VLAN port memberships.
   // We don't actually delete removed VLANs at this point, we simply remove
   // all members from the VLAN.  This way any ports that ingress packets to this
   // VLAN will still use this VLAN until we get the new VLAN fully configured.
-  forEachChanged(
-      delta.getVlansDelta(),
-      &BcmSwitch::processChangedVlan,
-      &BcmSwitch::processAddedVlan,
-      &BcmSwitch::preprocessRemovedVlan,
-      this);
-
-  // Broadcom requires a default VLAN to always exist.
-  // This VLAN is used as the default ingress VLAN for ports that don't have a
-  // default ingress set.
-  //
-  // We always specify the ingress VLAN for all enabled ports, so this VLAN is
-  // never really used for us.  We instead always point the default VLAN.
-  if (delta.oldState()->getDefaultVlan() !=
-      delta.newState()->getDefaultVlan()) {
-    changeDefaultVlan(delta.newState()->getDefaultVlan());
-  }
-
-  // Update changed interfaces
-  forEachChanged(delta.getIntfsDelta(), &BcmSwitch::processChangedIntf, this);
-
-  // Remove deleted VLANs
-  forEachRemoved(delta.getVlansDelta(), &BcmSwitch::processRemovedVlan, this);
-
-  // Add all new interfaces
-  forEachAdded(delta.getIntfsDelta(), &BcmSwitch::processAddedIntf, this);
+  scheduler.addPhase(
+      "vlans",
+      [&]() {
+        forEachChanged(
+            delta.getVlansDelta(),
+            &BcmSwitch::processChangedVlan,
+            &BcmSwitch::processAddedVlan,
+            &BcmSwitch::preprocessRemovedVlan,
+            this);
+
+        // Broadcom requires a default VLAN to always exist.
+        // This VLAN is used as the default ingress VLAN for ports that don't
+        // have a default ingress set.
+        //
+        // We always specify the ingress VLAN for all enabled ports, so this
+        // VLAN is never really used for us.  We instead always point the
+        // default VLAN.
+        if (delta.oldState()->getDefaultVlan() !=
+            delta.newState()->getDefaultVlan()) {
+          changeDefaultVlan(delta.newState()->getDefaultVlan());
+        }
+      },
+      {"interfaces_removed"});
+
+  scheduler.addPhase(
+      "interfaces",
+      [&]() {
+        // Update changed interfaces
+        forEachChanged(
+            delta.getIntfsDelta(), &BcmSwitch::processChangedIntf, this);
+
+        // Remove deleted VLANs
+        forEachRemoved(
+            delta.getVlansDelta(), &BcmSwitch::processRemovedVlan, this);
+
+        // Add all new interfaces
+        forEachAdded(
+            delta.getIntfsDelta(), &BcmSwitch::processAddedIntf, this);
+      },
+      {"vlans"});
 
   // Any changes to the Qos maps
-  processQosChanges(delta);
+  scheduler.addPhase(
+      "qos", [&]() { processQosChanges(delta); }, {"interfaces"});
 
-  processControlPlaneChanges(delta);
+  scheduler.addPhase(
+      "control_plane", [&]() { processControlPlaneChanges(delta); }, {"qos"});
 
   // Any neighbor changes, and modify appliedState if some changes fail to apply
-  processNeighborChanges(delta, &appliedState);
+  scheduler.addPhase(
+      "neighbors",
+      [&]() { processNeighborChanges(delta, &appliedState); },
+      {"control_plane"});
+
+  if (executor) {
+    scheduler.addPhase(
+        "port_queues",
+        [&]() { processChangedPortQueues(delta); },
+        {"control_plane"});
+  }
 
   // process label forwarding changes after neighbor entries are updated
-  processChangedLabelForwardingInformationBase(delta);
+  scheduler.addPhase(
+      "label_fib",
+      [&]() { processChangedLabelForwardingInformationBase(delta); },
+      {"neighbors"});
 
   // Add/update mirrors before processing Acl and port changes
   // This is to ensure that port and acls can access latest mirrors
-  forEachAdded(
-      delta.getMirrorsDelta(),
-      &BcmMirrorTable::processAddedMirror,
-      writableBcmMirrorTable());
-  forEachChanged(
-      delta.getMirrorsDelta(),
-      &BcmMirrorTable::processChangedMirror,
-      writableBcmMirrorTable());
+  scheduler.addPhase(
+      "mirrors",
+      [&]() {
+        forEachAdded(
+            delta.getMirrorsDelta(),
+            &BcmMirrorTable::processAddedMirror,
+            writableBcmMirrorTable());
+        forEachChanged(
+            delta.getMirrorsDelta(),
+            &BcmMirrorTable::processChangedMirror,
+            writableBcmMirrorTable());
+      },
+      {"label_fib"});
 
   // Any ACL changes
-  processAclChanges(delta);
+  scheduler.addPhase(
+      "acls", [&]() { processAclChanges(delta); }, {"mirrors"});
 
-  // Any changes to the set of sFlow collectors
-  processSflowCollectorChanges(delta);
+  scheduler.addPhase(
+      "sflow",
+      [&]() {
+        // Any changes to the set of sFlow collectors
+        processSflowCollectorChanges(delta);
 
-  // Any changes to the sampling rate of sflow
-  processSflowSamplingRateChanges(delta);
+        // Any changes to the sampling rate of sflow
+        processSflowSamplingRateChanges(delta);
+      },
+      {"acls"});
 
   // Process any new routes or route changes
-  processAddedChangedRoutes(delta, &appliedState);
-  processAddedChangedFibRoutes(delta, &appliedState);
-
-  processAggregatePortChanges(delta);
-
-  processAddedPorts(delta);
-  processChangedPorts(delta);
+  scheduler.addPhase(
+      "routes_added_changed",
+      [&]() {
+        processAddedChangedRoutes(delta, &appliedState);
+        processAddedChangedFibRoutes(delta, &appliedState);
+      },
+      {"sflow"});
+
+  std::vector<folly::StringPiece> aggregatePortDeps{"routes_added_changed"};
+  if (executor) {
+    aggregatePortDeps.push_back("port_queues");
+  }
+  scheduler.addPhase(
+      "aggregate_ports",
+      [&]() { processAggregatePortChanges(delta); },
+      aggregatePortDeps);
+
+  scheduler.addPhase(
+      "ports",
+      [&]() {
+        processAddedPorts(delta);
+        // Port queues are programmed along with the rest of the port, unless
+        // they already were in their own phase
+        processChangedPorts(delta, !executor);
+      },
+      {"aggregate_ports"});
 
   // delete any removed mirrors after processing port and acl changes
-  forEachRemoved(
-      delta.getMirrorsDelta(),
-      &BcmMirrorTable::processRemovedMirror,
-      writableBcmMirrorTable());
+  scheduler.addPhase(
+      "mirrors_removed",
+      [&]() {
+        forEachRemoved(
+            delta.getMirrorsDelta(),
+            &BcmMirrorTable::processRemovedMirror,
+            writableBcmMirrorTable());
+      },
+      {"ports"});
 
-  pickupLinkStatusChanges(delta);
+  scheduler.addPhase(
+      "link_status",
+      [&]() { pickupLinkStatusChanges(delta); },
+      {"mirrors_removed"});
 
   // As the last step, enable newly enabled ports.  Doing this as the
   // last step ensures that we only start forwarding traffic once the
   // ports are correctly configured. Note that this will also set the
   // ingressVlan and speed correctly before enabling.
-  processEnabledPorts(delta);
+  scheduler.addPhase(
+      "ports_enabled", [&]() { processEnabledPorts(delta); }, {"link_status"});
+
+  scheduler.run(executor);
 
   bcmStatUpdater_->refreshPostBcmStateChange(delta);
 
@@ -1249,6 +1370,12 @@ void BcmSwitch::processEnabledPorts(const StateDelta& delta) {
 void BcmSwitch::processChangedPortQueues(
     const shared_ptr<Port>& oldPort,
     const shared_ptr<Port>& newPort) {
+  if (newPort->getPortQueues().size() != 0 &&
+      !platform_->getAsic()->isSupported(HwAsic::Feature::L3_QOS)) {
+    throw FbossError(
+        "Changing settings for cos queues not supported on this platform");
+  }
+
   auto id = newPort->getID();
   auto bcmPort = portTable_->getBcmPort(id);
 
@@ -1284,7 +1411,9 @@ void BcmSwitch::processAddedPorts(const StateDelta& delta) {
   });
 }
 
-void BcmSwitch::processChangedPorts(const StateDelta& delta) {
+void BcmSwitch::processChangedPorts(
+    const StateDelta& delta,
+    bool programQueues) {
   forEachChanged(
       delta.getPortsDelta(),
       [&](const shared_ptr<Port>& oldPort, const shared_ptr<Port>& newPort) {
@@ -1341,13 +1470,20 @@ void BcmSwitch::processChangedPorts(const StateDelta& delta) {
           bcmPort->program(newPort);
         }
 
-        if (newPort->getPortQueues().size() != 0 &&
-            !platform_->getAsic()->isSupported(HwAsic::Feature::L3_QOS)) {
-          throw FbossError(
-              "Changing settings for cos queues not supported on ",
-              "this platform");
+        if (programQueues) {
+          processChangedPortQueues(oldPort, newPort);
         }
+      });
+}
 
+void BcmSwitch::processChangedPortQueues(const StateDelta& delta) {
+  forEachChanged(
+      delta.getPortsDelta(),
+      [&](const shared_ptr<Port>& oldPort, const shared_ptr<Port>& newPort) {
+        if (!oldPort->isEnabled() && !newPort->isEnabled()) {
+          // Queues of disabled ports are set up when they get enabled
+          return;
+        }
         processChangedPortQueues(oldPort, newPort);
       });
 }
@@ -2050,19 +2186,25 @@ void BcmSwitch::processChangedRoute(
 }
 
 template <typename RouteT>
-void BcmSwitch::processAddedRoute(
+void BcmSwitch::processAddedRoutes(
     const RouterID& id,
-    const shared_ptr<RouteT>& route) {
-  std::string routeMessage;
-  folly::toAppend(
-      "adding route entry @ vrf ", id, " ", route->str(), &routeMessage);
-  XLOG(DBG3) << routeMessage;
-  // if the new route is not resolved, ignore it
-  if (!route->isResolved()) {
-    XLOG(DBG1) << "Non-resolved route HW programming is skipped";
-    return;
+    const std::vector<shared_ptr<RouteT>>& routes,
+    folly::FunctionRef<void(const RouteT*, const BcmError&)> onError) {
+  std::vector<const RouteT*> resolvedRoutes;
+  resolvedRoutes.reserve(routes.size());
+  for (const auto& route : routes) {
+    std::string routeMessage;
+    folly::toAppend(
+        "adding route entry @ vrf ", id, " ", route->str(), &routeMessage);
+    XLOG(DBG3) << routeMessage;
+    // if the new route is not resolved, ignore it
+    if (!route->isResolved()) {
+      XLOG(DBG1) << "Non-resolved route HW programming is skipped";
+      continue;
+    }
+    resolvedRoutes.push_back(route.get());
   }
-  routeTable_->addRoute(getBcmVrfId(id), route.get());
+  routeTable_->addRoutes(getBcmVrfId(id), resolvedRoutes, onError);
 }
 
 template <typename RouteT>
@@ -2147,6 +2289,12 @@ void BcmSwitch::processRouteTableDelta(
       continue;
     }
     RouterID id = rtDelta.getNew()->getID();
+    // Added routes are programmed as a single batch once the delta has been
+    // walked, on cold boot this can be the entire routing table. Added and
+    // changed routes are for different prefixes, and routes sharing next
+    // hops share them by reference count, so programming the added ones
+    // after all of the changed ones makes no difference to the hardware.
+    std::vector<shared_ptr<RouteT>> addedRoutes;
     forEachChanged(
         rtDelta.template getRoutesDelta<AddrT>(),
         [&](const shared_ptr<RouteT>& oldRoute,
@@ -2159,16 +2307,16 @@ void BcmSwitch::processRouteTableDelta(
           }
         },
         [&](const shared_ptr<RouteT>& addedRoute) {
-          try {
-            processAddedRoute(id, addedRoute);
-          } catch (const BcmError& e) {
-            rethrowIfHwNotFull(e);
-            discardedPrefixes[id].push_back(addedRoute->prefix());
-          }
+          addedRoutes.push_back(addedRoute);
         },
         [](const shared_ptr<RouteT>& /*deletedRoute*/) {
           // do nothing
         });
+    processAddedRoutes<RouteT>(
+        id, addedRoutes, [&](const RouteT* addedRoute, const BcmError& e) {
+          rethrowIfHwNotFull(e);
+          discardedPrefixes[id].push_back(addedRoute->prefix());
+        });
   }
 
   // discard  routes
@@ -2207,24 +2355,34 @@ void BcmSwitch::processAddedChangedFibRoutes(
     CHECK(newFib);
     RouterID vrf = newFib->getID();
 
-    forEachChanged(
-        fibDelta.getV4FibDelta(),
-        &BcmSwitch::processChangedRoute<RouteV4>,
-        &BcmSwitch::processAddedRoute<RouteV4>,
-        [&](BcmSwitch*, const RouterID&, const shared_ptr<RouteV4>&) {},
-        this,
-        vrf);
-
-    forEachChanged(
-        fibDelta.getV6FibDelta(),
-        &BcmSwitch::processChangedRoute<RouteV6>,
-        &BcmSwitch::processAddedRoute<RouteV6>,
-        [&](BcmSwitch*, const RouterID&, const shared_ptr<RouteV6>&) {},
-        this,
-        vrf);
+    processAddedChangedFibRoutes(vrf, fibDelta.getV4FibDelta());
+    processAddedChangedFibRoutes(vrf, fibDelta.getV6FibDelta());
   }
 }
 
+template <typename FibDeltaT>
+void BcmSwitch::processAddedChangedFibRoutes(
+    const RouterID& vrf,
+    const FibDeltaT& fibDelta) {
+  using RouteT = typename FibDeltaT::Node;
+  // As for the route table, added routes are programmed as one batch after
+  // the changed ones
+  std::vector<shared_ptr<RouteT>> addedRoutes;
+  forEachChanged(
+      fibDelta,
+      [&](const shared_ptr<RouteT>& oldRoute,
+          const shared_ptr<RouteT>& newRoute) {
+        processChangedRoute(vrf, oldRoute, newRoute);
+      },
+      [&](const shared_ptr<RouteT>& addedRoute) {
+        addedRoutes.push_back(addedRoute);
+      },
+      [](const shared_ptr<RouteT>& /*deletedRoute*/) {});
+  // Failures to program are not handled on this path, rethrow them
+  processAddedRoutes<RouteT>(
+      vrf, addedRoutes, [](const RouteT*, const BcmError&) { throw; });
+}
+
 void BcmSwitch::linkscanCallback(
     int unit,
     bcm_port_t bcmPort,
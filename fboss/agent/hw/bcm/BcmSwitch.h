@@ -9,6 +9,7 @@
  */
 #pragma once
 
+#include <folly/Function.h>
 #include <folly/dynamic.h>
 #include <folly/io/async/EventBase.h>
 #include <gtest/gtest_prod.h>
@@ -24,6 +25,11 @@
 #include <mutex>
 #include <thread>
 
+namespace folly {
+class CPUThreadPoolExecutor;
+class Executor;
+} // namespace folly
+
 extern "C" {
 #include <bcm/error.h>
 #include <bcm/l2.h>
@@ -42,6 +48,7 @@ class BcmControlPlane;
 class BcmCosManager;
 class BcmEgress;
 class BcmEgressManager;
+class BcmError;
 class BcmHostKey;
 class BcmHostTable;
 class BcmIntf;
@@ -571,7 +578,8 @@ class BcmSwitch : public BcmSwitchIf {
   void processDisabledPorts(const StateDelta& delta);
   void processEnabledPorts(const StateDelta& delta);
   void processAddedPorts(const StateDelta& delta);
-  void processChangedPorts(const StateDelta& delta);
+  void processChangedPorts(const StateDelta& delta, bool programQueues);
+  void processChangedPortQueues(const StateDelta& delta);
   void pickupLinkStatusChanges(const StateDelta& delta);
   void reconfigurePortGroups(const StateDelta& delta);
 
@@ -580,10 +588,15 @@ class BcmSwitch : public BcmSwitchIf {
       const RouterID& id,
       const std::shared_ptr<RouteT>& oldRoute,
       const std::shared_ptr<RouteT>& newRoute);
+  /*
+   * Programs the resolved routes among routes as one batch, see
+   * BcmRouteTable::addRoutes() for how failures are reported to onError.
+   */
   template <typename RouteT>
-  void processAddedRoute(
+  void processAddedRoutes(
       const RouterID& id,
-      const std::shared_ptr<RouteT>& route);
+      const std::vector<std::shared_ptr<RouteT>>& routes,
+      folly::FunctionRef<void(const RouteT*, const BcmError&)> onError);
   template <typename RouteT>
   void processRemovedRoute(
       const RouterID id,
@@ -602,6 +615,10 @@ class BcmSwitch : public BcmSwitchIf {
   void processAddedChangedFibRoutes(
       const StateDelta& delta,
       std::shared_ptr<SwitchState>* appliedState);
+  template <typename FibDeltaT>
+  void processAddedChangedFibRoutes(
+      const RouterID& vrf,
+      const FibDeltaT& fibDelta);
 
   void processQosChanges(const StateDelta& delta);
 
@@ -629,7 +646,13 @@ class BcmSwitch : public BcmSwitchIf {
   void processRemovedLoadBalancer(
       const std::shared_ptr<LoadBalancer>& loadBalancer);
 
-  std::shared_ptr<SwitchState> stateChangedImpl(const StateDelta& delta);
+  /*
+   * Programs delta. Independent object types are programmed in parallel on
+   * executor, or all serially on the calling thread if it is null.
+   */
+  std::shared_ptr<SwitchState> stateChangedImpl(
+      const StateDelta& delta,
+      folly::Executor* executor);
 
   void processSflowSamplingRateChanges(const StateDelta& delta);
   void processSflowCollectorChanges(const StateDelta& delta);
@@ -901,6 +924,9 @@ class BcmSwitch : public BcmSwitchIf {
   int64_t bstStatsUpdateTime_{0};
   std::unique_ptr<BcmQcmManager> qcmManager_;
 
+  // Runs independent phases of state updates, null if they run serially
+  std::unique_ptr<folly::CPUThreadPoolExecutor> programmingExecutor_;
+
   /*
    * Lock to synchronize access to all BCM* data structures
    */
@@ -10,13 +10,16 @@
 #include "fboss/agent/hw/bcm/BcmWarmBootCache.h"
 
 #include <algorithm>
+#include <chrono>
 #include <sstream>
 #include <string>
 #include <utility>
 
+#include <fb303/ServiceData.h>
 #include <folly/Conv.h>
 #include <folly/dynamic.h>
 #include <folly/json.h>
+#include <folly/lang/Bits.h>
 #include <folly/logging/xlog.h>
 
 #include "fboss/agent/Constants.h"
@@ -91,15 +94,34 @@ struct AddrTables {
   shared_ptr<facebook::fboss::NdpTable> ndpTable;
 };
 
-folly::IPAddress getFullMaskIPv4Address() {
-  return folly::IPAddress(folly::IPAddressV4(
-      folly::IPAddressV4::fetchMask(folly::IPAddressV4::bitCount())));
+uint8_t maskLength(const folly::IPAddress& mask) {
+  uint8_t length = 0;
+  for (size_t i = 0; i < mask.byteCount(); ++i) {
+    length += folly::popcount(static_cast<uint32_t>(mask.bytes()[i]));
+  }
+  return length;
 }
 
-folly::IPAddress getFullMaskIPv6Address() {
-  return folly::IPAddress(folly::IPAddressV6(
-      folly::IPAddressV6::fetchMask(folly::IPAddressV6::bitCount())));
-}
+/*
+ * Exports the time spent on one table of a warm boot stage (e.g. populating
+ * the cache, or dumping state on exit) as warm_boot.<stage>.<table>.us
+ */
+class TableTimer {
+ public:
+  TableTimer(folly::StringPiece stage, folly::StringPiece table)
+      : counter_(
+            folly::to<std::string>("warm_boot.", stage, ".", table, ".us")),
+        start_(std::chrono::steady_clock::now()) {}
+  ~TableTimer() {
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_);
+    facebook::fb303::fbData->setCounter(counter_, duration.count());
+  }
+
+ private:
+  std::string counter_;
+  std::chrono::steady_clock::time_point start_;
+};
 } // namespace
 
 namespace facebook::fboss {
@@ -113,13 +135,28 @@ BcmWarmBootCache::BcmWarmBootCache(const BcmSwitchIf* hw)
 folly::dynamic BcmWarmBootCache::getWarmBootStateFollyDynamic() const {
   folly::dynamic bcmWarmBootState = folly::dynamic::object;
 
-  bcmWarmBootState[kHostTable] = bcmWarmBootState_->hostTableToFollyDynamic();
-  bcmWarmBootState[kMplsNextHops] =
-      bcmWarmBootState_->mplsNextHopsToFollyDynamic();
-  bcmWarmBootState[kIntfTable] = bcmWarmBootState_->intfTableToFollyDynamic();
-  bcmWarmBootState[kWarmBootCache] = toFollyDynamic();
-  bcmWarmBootState[kQosPolicyTable] =
-      bcmWarmBootState_->qosTableToFollyDynamic();
+  {
+    TableTimer timer("exit", "host_table");
+    bcmWarmBootState[kHostTable] = bcmWarmBootState_->hostTableToFollyDynamic();
+  }
+  {
+    TableTimer timer("exit", "mpls_next_hops");
+    bcmWarmBootState[kMplsNextHops] =
+        bcmWarmBootState_->mplsNextHopsToFollyDynamic();
+  }
+  {
+    TableTimer timer("exit", "intf_table");
+    bcmWarmBootState[kIntfTable] = bcmWarmBootState_->intfTableToFollyDynamic();
+  }
+  {
+    TableTimer timer("exit", "warm_boot_cache");
+    bcmWarmBootState[kWarmBootCache] = toFollyDynamic();
+  }
+  {
+    TableTimer timer("exit", "qos_policy_table");
+    bcmWarmBootState[kQosPolicyTable] =
+        bcmWarmBootState_->qosTableToFollyDynamic();
+  }
 
   return bcmWarmBootState;
 }
@@ -386,11 +423,16 @@ BcmWarmBootCache::findEgressFromLabeledHostKey(const BcmLabeledHostKey& key) {
 }
 
 void BcmWarmBootCache::populate(std::optional<folly::dynamic> warmBootState) {
-  if (warmBootState) {
-    populateFromWarmBootState(*warmBootState);
-  } else {
-    populateFromWarmBootState(getWarmBootState());
+  {
+    TableTimer timer("populate", "warm_boot_file");
+    if (warmBootState) {
+      populateFromWarmBootState(*warmBootState);
+    } else {
+      populateFromWarmBootState(getWarmBootState());
+    }
   }
+  std::optional<TableTimer> timer;
+  timer.emplace("populate", "vlans");
   bcm_vlan_data_t* vlanList = nullptr;
   int vlanCount = 0;
   SCOPE_EXIT {
@@ -456,6 +498,12 @@ void BcmWarmBootCache::populate(std::optional<folly::dynamic> warmBootState) {
   bcm_l3_info_t l3Info;
   bcm_l3_info_t_init(&l3Info);
   bcm_l3_info(hw_->getUnit(), &l3Info);
+  // Size the indices up front rather than rehashing while traversing
+  vrfIp2Host_.reserve(std::max(0, l3Info.l3info_used_host));
+  vrfPrefix2Route_.reserve(std::max(0, l3Info.l3info_used_route));
+  egressId2Egress_.reserve(egressIdsInWarmBootFile_.size());
+
+  timer.emplace("populate", "hosts");
   // Traverse V4 hosts
   rv = bcm_l3_host_traverse(
       hw_->getUnit(),
@@ -475,6 +523,7 @@ void BcmWarmBootCache::populate(std::optional<folly::dynamic> warmBootState) {
       hostTraversalCallback,
       this);
   bcmCheckError(rv, "Failed to traverse v6 hosts");
+  timer.emplace("populate", "routes");
   // Traverse V4 routes
   rv = bcm_l3_route_traverse(
       hw_->getUnit(),
@@ -494,19 +543,23 @@ void BcmWarmBootCache::populate(std::optional<folly::dynamic> warmBootState) {
       routeTraversalCallback,
       this);
   bcmCheckError(rv, "Failed to traverse v6 routes");
+  timer.emplace("populate", "egress");
   // Get egress entries.
   rv = bcm_l3_egress_traverse(hw_->getUnit(), egressTraversalCallback, this);
   bcmCheckError(rv, "Failed to traverse egress");
+  timer.emplace("populate", "ecmp");
   // Traverse ecmp egress entries
   rv = bcm_l3_egress_ecmp_traverse(
       hw_->getUnit(), ecmpEgressTraversalCallback, this);
   bcmCheckError(rv, "Failed to traverse ecmp egress");
 
+  timer.emplace("populate", "acls");
   // populate acls, acl stats
   populateAcls(
       kACLFieldGroupID,
       this->aclEntry2AclStat_,
       this->priority2BcmAclEntryHandle_);
+  timer.reset();
 
   populateRtag7State();
   populateMirrors();
@@ -609,16 +662,16 @@ int BcmWarmBootCache::routeTraversalCallback(
   auto mask = isIPv6 ? IPAddress::fromBinary(ByteRange(
                            route->l3a_ip6_mask, sizeof(route->l3a_ip6_mask)))
                      : IPAddress::fromLongHBO(route->l3a_ip_mask);
+  auto maskLen = maskLength(mask);
   if (cache->getHw()->getPlatform()->canUseHostTableForHostRoutes() &&
-      ((isIPv6 && mask == getFullMaskIPv6Address()) ||
-       (!isIPv6 && mask == getFullMaskIPv4Address()))) {
+      maskLen == ip.bitCount()) {
     // This is a host route.
     cache->vrfAndIP2Route_[make_pair(route->l3a_vrf, ip)] = *route;
     XLOG(DBG3) << "Adding host route found in route table. vrf: "
                << route->l3a_vrf << " ip: " << ip << " mask: " << mask;
   } else {
     // Other routes that cannot be put into host table / CAM.
-    cache->vrfPrefix2Route_[make_tuple(route->l3a_vrf, ip, mask)] = *route;
+    cache->vrfPrefix2Route_[make_tuple(route->l3a_vrf, ip, maskLen)] = *route;
     XLOG(DBG3) << "In vrf : " << route->l3a_vrf << " adding route for : " << ip
                << " mask: " << mask;
   }
@@ -688,6 +741,7 @@ void BcmWarmBootCache::clear() {
   // since we want to delete entries only after there are no more
   // references to them.
   XLOG(DBG1) << "Warm boot: removing unreferenced entries";
+  TableTimer timer("clear", "unclaimed_entries");
   dumpedSwSwitchState_.reset();
   hwSwitchEcmp2EgressIds_.clear();
   // First delete routes (fully qualified and others).
@@ -698,7 +752,7 @@ void BcmWarmBootCache::clear() {
     XLOG(DBG1) << "Deleting unreferenced route in vrf:"
                << std::get<0>(vrfPfxAndRoute.first)
                << " for prefix : " << std::get<1>(vrfPfxAndRoute.first) << "/"
-               << std::get<2>(vrfPfxAndRoute.first);
+               << static_cast<int>(std::get<2>(vrfPfxAndRoute.first));
     auto rv = bcm_l3_route_delete(hw_->getUnit(), &(vrfPfxAndRoute.second));
     bcmLogFatal(
         rv,
@@ -708,7 +762,7 @@ void BcmWarmBootCache::clear() {
         " for prefix : ",
         std::get<1>(vrfPfxAndRoute.first),
         "/",
-        std::get<2>(vrfPfxAndRoute.first));
+        static_cast<int>(std::get<2>(vrfPfxAndRoute.first)));
   }
   vrfPrefix2Route_.clear();
   for (auto vrfIPAndRoute : vrfAndIP2Route_) {
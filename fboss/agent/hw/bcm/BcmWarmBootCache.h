@@ -21,6 +21,7 @@ extern "C" {
 #include <folly/MacAddress.h>
 #include <folly/container/F14Map.h>
 #include <folly/dynamic.h>
+#include <folly/hash/Hash.h>
 #include <folly/logging/xlog.h>
 #include <algorithm>
 #include <list>
@@ -111,14 +112,22 @@ class BcmWarmBootCache {
   using HostKey =
       std::tuple<bcm_vrf_t, folly::IPAddress, std::optional<bcm_if_t>>;
   /*
-   * VRF, IP, Mask
-   * TODO - Convert mask to mask len for efficient storage/lookup
+   * VRF, IP, Mask length. This is how routes are looked up when they are
+   * programmed, so no mask has to be built for each lookup.
    */
-  typedef std::tuple<bcm_vrf_t, folly::IPAddress, folly::IPAddress>
-      VrfAndPrefix;
+  typedef std::tuple<bcm_vrf_t, folly::IPAddress, uint8_t> VrfAndPrefix;
   typedef std::pair<bcm_vrf_t, folly::IPAddress> VrfAndIP;
+  struct EgressIdsHash {
+    size_t operator()(const EgressIds& egressIds) const {
+      return folly::hash::hash_range(egressIds.begin(), egressIds.end());
+    }
+  };
   /*
    * Cache containers
+   *
+   * The tables every route, host and ECMP group are reconciled against on
+   * warm boot are hashed, so that looking up and claiming an entry is O(1)
+   * rather than the O(n) erase of a flat_map.
    */
   typedef boost::container::flat_map<VlanID, VlanInfo> Vlan2VlanInfo;
   typedef boost::container::flat_map<VlanID, bcm_l2_station_t> Vlan2Station;
@@ -128,10 +137,11 @@ class BcmWarmBootCache {
 
   typedef folly::F14FastMap<VrfAndIP, bcm_l3_host_t> VrfAndIP2Host;
   typedef folly::F14FastMap<VrfAndPrefix, bcm_l3_route_t> VrfAndPrefix2Route;
-  typedef boost::container::flat_map<EgressIds, EcmpEgress> EgressIds2Ecmp;
-  using VrfAndIP2Route = boost::container::flat_map<VrfAndIP, bcm_l3_route_t>;
-  using EgressId2Egress = boost::container::flat_map<EgressId, Egress>;
-  using HostTableInWarmBootFile = boost::container::flat_map<HostKey, EgressId>;
+  typedef folly::F14FastMap<EgressIds, EcmpEgress, EgressIdsHash>
+      EgressIds2Ecmp;
+  using VrfAndIP2Route = folly::F14FastMap<VrfAndIP, bcm_l3_route_t>;
+  using EgressId2Egress = folly::F14FastMap<EgressId, Egress>;
+  using HostTableInWarmBootFile = folly::F14FastMap<HostKey, EgressId>;
   using MplsNextHop2EgressIdInWarmBootFile =
       boost::container::flat_map<BcmLabeledHostKey, EgressId>;
   using LabelStackKey =
@@ -372,20 +382,12 @@ class BcmWarmBootCache {
   }
   VrfAndPfx2RouteCitr
   findRoute(bcm_vrf_t vrf, const folly::IPAddress& ip, uint8_t mask) {
-    using folly::IPAddress;
-    using folly::IPAddressV4;
-    using folly::IPAddressV6;
-    if (ip.isV6()) {
-      return vrfPrefix2Route_.find(VrfAndPrefix(
-          vrf, ip, IPAddress(IPAddressV6(IPAddressV6::fetchMask(mask)))));
-    }
-    return vrfPrefix2Route_.find(VrfAndPrefix(
-        vrf, ip, IPAddress(IPAddressV4(IPAddressV4::fetchMask(mask)))));
+    return vrfPrefix2Route_.find(VrfAndPrefix(vrf, ip, mask));
   }
   void programmed(VrfAndPfx2RouteCitr vrpitr) {
     XLOG(DBG1) << "Programmed route in vrf : " << std::get<0>(vrpitr->first)
                << "  prefix: " << std::get<1>(vrpitr->first) << "/"
-               << std::get<2>(vrpitr->first)
+               << static_cast<int>(std::get<2>(vrpitr->first))
                << " removing from warm boot cache ";
     vrfPrefix2Route_.erase(vrpitr);
   }
@@ -19,6 +19,7 @@
 
 #include "fboss/agent/hw/test/ConfigFactory.h"
 
+#include <optional>
 #include <string>
 
 DECLARE_int32(acl_gid);
@@ -61,24 +62,29 @@ TEST_F(BcmAclPriorityTest, CheckAclPriorityOrder) {
     }
     int aPrio = getProgrammedState()->getAcl("A")->getPriority();
     int bPrio = getProgrammedState()->getAcl("B")->getPriority();
-    EXPECT_EQ(aPrio + 1, bPrio);
+    EXPECT_LT(aPrio, bPrio);
   };
   verifyAcrossWarmBoots(setup, verify);
 }
 
 TEST_F(BcmAclPriorityTest, CheckAclPriortyOrderInsertMiddle) {
-  auto setup = [this]() {
+  // Only known if setup() ran, i.e. not after a warm boot
+  std::optional<int> origAPrio;
+  std::optional<int> origBPrio;
+  auto setup = [&]() {
     auto newCfg = initialConfig();
     addDenyPortAcl(newCfg, "A");
     addDenyPortAcl(newCfg, "B");
     applyNewConfig(newCfg);
+    origAPrio = getProgrammedState()->getAcl("A")->getPriority();
+    origBPrio = getProgrammedState()->getAcl("B")->getPriority();
     newCfg.acls_ref()->pop_back();
     addDenyPortAcl(newCfg, "C");
     addDenyPortAcl(newCfg, "B");
     applyNewConfig(newCfg);
   };
 
-  auto verify = [=]() {
+  auto verify = [&]() {
     for (auto acl : {"A", "B", "C"}) {
       checkSwHwAclMatch(getHwSwitch(), getProgrammedState(), acl);
     }
@@ -86,8 +92,13 @@ TEST_F(BcmAclPriorityTest, CheckAclPriortyOrderInsertMiddle) {
     int bPrio = getProgrammedState()->getAcl("B")->getPriority();
     int cPrio = getProgrammedState()->getAcl("C")->getPriority();
     // Order should be A, C, B now
-    EXPECT_EQ(aPrio + 1, cPrio);
-    EXPECT_EQ(aPrio + 2, bPrio);
+    EXPECT_LT(aPrio, cPrio);
+    EXPECT_LT(cPrio, bPrio);
+    // C goes in the gap between A and B, without touching them
+    if (origAPrio && origBPrio) {
+      EXPECT_EQ(*origAPrio, aPrio);
+      EXPECT_EQ(*origBPrio, bPrio);
+    }
   };
   verifyAcrossWarmBoots(setup, verify);
 }
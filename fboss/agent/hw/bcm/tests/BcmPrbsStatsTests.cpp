@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/hw/bcm/BcmPrbsStats.h"
+
+#include <folly/synchronization/Baton.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+DECLARE_int32(prbs_stats_threads);
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr int32_t kPort = 1;
+constexpr int32_t kLossOfLock = -1;
+constexpr int32_t kLocked = -2;
+
+LanePrbsStatsTable makeLanes(int numLanes) {
+  LanePrbsStatsTable lanes;
+  for (int lane = 0; lane < numLanes; ++lane) {
+    lanes.emplace_back(lane, kPort * 100 + lane, 25.78125);
+  }
+  return lanes;
+}
+
+int32_t numLossOfLock(const BcmPrbsStats& stats, int32_t port = kPort) {
+  int32_t total = 0;
+  for (const auto& lane : stats.getPortStats(port)) {
+    total += lane.numLossOfLock;
+  }
+  return total;
+}
+
+} // namespace
+
+TEST(BcmPrbsStatsTest, PortsAddedAndRemoved) {
+  BcmPrbsStats stats([](bcm_gport_t) { return uint32(kLocked); });
+  EXPECT_THROW(stats.getPortStats(kPort), FbossError);
+
+  stats.setPortLanes(kPort, makeLanes(4));
+  auto lanes = stats.getPortStats(kPort);
+  ASSERT_EQ(4, lanes.size());
+  for (int lane = 0; lane < 4; ++lane) {
+    EXPECT_EQ(lane, lanes[lane].laneId);
+  }
+
+  stats.removePort(kPort);
+  EXPECT_THROW(stats.getPortStats(kPort), FbossError);
+}
+
+TEST(BcmPrbsStatsTest, CollectAndClearPublish) {
+  std::atomic<int32_t> status{kLocked};
+  BcmPrbsStats stats([&status](bcm_gport_t) { return uint32(status.load()); });
+  stats.setPortLanes(kPort, makeLanes(2));
+
+  stats.collect();
+  status = kLossOfLock;
+  EXPECT_EQ(0, numLossOfLock(stats));
+  stats.collect();
+  EXPECT_EQ(2, numLossOfLock(stats));
+
+  stats.clearPort(kPort);
+  EXPECT_EQ(0, numLossOfLock(stats));
+  // Clearing a port without PRBS stats is only logged
+  stats.clearPort(kPort + 1);
+}
+
+TEST(BcmPrbsStatsTest, ParallelCollection) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_prbs_stats_threads = 4;
+  std::atomic<int> lanesRead{0};
+  BcmPrbsStats stats([&lanesRead](bcm_gport_t) {
+    ++lanesRead;
+    return uint32(kLocked);
+  });
+  for (int32_t port = 1; port <= 8; ++port) {
+    stats.setPortLanes(port, makeLanes(4));
+  }
+
+  stats.collect();
+  EXPECT_EQ(32, lanesRead.load());
+}
+
+TEST(BcmPrbsStatsTest, ParallelCollectionFailure) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_prbs_stats_threads = 4;
+  std::atomic<bool> fail{false};
+  BcmPrbsStats stats([&fail](bcm_gport_t gport) {
+    if (fail && gport == kPort * 100 + 3) {
+      throw FbossError("failed to read lane ", gport);
+    }
+    return uint32(fail ? kLossOfLock : kLocked);
+  });
+  stats.setPortLanes(kPort, makeLanes(4));
+  stats.collect();
+
+  // Reading a lane failed, so nothing is published
+  fail = true;
+  EXPECT_THROW(stats.collect(), FbossError);
+  EXPECT_EQ(0, numLossOfLock(stats));
+}
+
+TEST(BcmPrbsStatsTest, ReadDuringCollection) {
+  folly::Baton<> collecting;
+  folly::Baton<> finishCollection;
+  std::atomic<int32_t> status{kLocked};
+  std::atomic<bool> block{false};
+  BcmPrbsStats stats([&](bcm_gport_t) {
+    if (block.exchange(false)) {
+      collecting.post();
+      finishCollection.wait();
+    }
+    return uint32(status.load());
+  });
+  stats.setPortLanes(kPort, makeLanes(1));
+  stats.collect();
+
+  status = kLossOfLock;
+  block = true;
+  std::thread collector([&stats] { stats.collect(); });
+  collecting.wait();
+  // Readers get the last snapshot without waiting for the collection
+  EXPECT_EQ(0, numLossOfLock(stats));
+  finishCollection.post();
+  collector.join();
+  EXPECT_EQ(1, numLossOfLock(stats));
+}
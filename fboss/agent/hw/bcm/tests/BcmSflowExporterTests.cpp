@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/bcm/BcmSflowExporter.h"
+
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace facebook::fboss;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr size_t kMaxDatagramSize = 1400;
+
+/*
+ * A UDP socket on the loopback standing in for an sFlow collector.
+ */
+class LocalCollector {
+ public:
+  LocalCollector() {
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    EXPECT_EQ(0, ::bind(fd_, reinterpret_cast<sockaddr*>(&addr), addrLen));
+    EXPECT_EQ(
+        0, getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &addrLen));
+    port_ = ntohs(addr.sin_port);
+    timeval timeout{1, 0};
+    setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  }
+  ~LocalCollector() {
+    ::close(fd_);
+  }
+
+  std::shared_ptr<SflowCollector> collector() const {
+    return std::make_shared<SflowCollector>("127.0.0.1", port_);
+  }
+
+  // Returns an empty string if nothing arrives within a second
+  std::string receive() {
+    std::string datagram(65536, '\0');
+    auto len = ::recv(fd_, datagram.data(), datagram.size(), 0);
+    datagram.resize(std::max<ssize_t>(len, 0));
+    return datagram;
+  }
+
+ private:
+  int fd_{-1};
+  uint16_t port_{0};
+};
+
+struct DatagramV5 {
+  uint32_t sequenceNumber;
+  uint32_t samplesCnt;
+};
+
+DatagramV5 parseDatagram(const std::string& datagram) {
+  auto buf = folly::IOBuf::wrapBuffer(datagram.data(), datagram.size());
+  folly::io::Cursor cursor(buf.get());
+  EXPECT_EQ(5, cursor.readBE<uint32_t>());
+  auto addressType = cursor.readBE<uint32_t>();
+  cursor += addressType == 1 ? 4 : 16;
+  cursor += 4; // sub agent
+  DatagramV5 result;
+  result.sequenceNumber = cursor.readBE<uint32_t>();
+  cursor += 4; // uptime
+  result.samplesCnt = cursor.readBE<uint32_t>();
+  for (uint32_t i = 0; i < result.samplesCnt; ++i) {
+    EXPECT_EQ(1, cursor.readBE<uint32_t>()); // flow sample
+    cursor += cursor.readBE<uint32_t>();
+  }
+  EXPECT_TRUE(cursor.isAtEnd());
+  return result;
+}
+
+SflowPacketInfo makeSample(int srcPort, size_t len = 128) {
+  SflowPacketInfo info;
+  info.ingressSampled = true;
+  info.srcPort = srcPort;
+  info.dstPort = 0;
+  info.frameLength = len;
+  info.packetData = std::string(len, '\x0f');
+  return info;
+}
+
+} // namespace
+
+TEST(BcmSflowExporterTest, ThriftSamplesSentInBatches) {
+  LocalCollector local;
+  BcmSflowExporterTable table({false, kMaxDatagramSize, 4, 1h});
+  table.addExporter(local.collector());
+  for (int port = 1; port <= 3; ++port) {
+    table.sendToAll(makeSample(port));
+  }
+  EXPECT_EQ(0, table.datagramsSent());
+
+  table.sendToAll(makeSample(4));
+  EXPECT_EQ(4, table.datagramsSent());
+  for (int port = 1; port <= 4; ++port) {
+    SflowPacketInfo info;
+    apache::thrift::BinarySerializer::deserialize(local.receive(), info);
+    EXPECT_EQ(port, info.srcPort);
+  }
+}
+
+TEST(BcmSflowExporterTest, V5SamplesAggregated) {
+  LocalCollector local;
+  BcmSflowExporterTable table({true, kMaxDatagramSize, 100, 1h});
+  table.addExporter(local.collector());
+  for (int i = 0; i < 40; ++i) {
+    table.sendToAll(makeSample(1));
+  }
+  table.flush();
+
+  uint32_t samples = 0;
+  uint32_t expectedSequence = 1;
+  while (samples < 40) {
+    auto datagram = local.receive();
+    ASSERT_FALSE(datagram.empty());
+    EXPECT_LE(datagram.size(), kMaxDatagramSize);
+    auto parsed = parseDatagram(datagram);
+    EXPECT_EQ(expectedSequence++, parsed.sequenceNumber);
+    EXPECT_GT(parsed.samplesCnt, 1);
+    samples += parsed.samplesCnt;
+  }
+  EXPECT_EQ(40, samples);
+  EXPECT_EQ(expectedSequence - 1, table.datagramsSent());
+  EXPECT_LT(table.datagramsSent(), 10);
+}
+
+TEST(BcmSflowExporterTest, OversizedSampleTruncated) {
+  LocalCollector local;
+  BcmSflowExporterTable table({true, 256, 100, 1h});
+  table.addExporter(local.collector());
+  table.sendToAll(makeSample(1, 1000));
+  table.flush();
+
+  auto datagram = local.receive();
+  EXPECT_LE(datagram.size(), 256);
+  EXPECT_EQ(1, parseDatagram(datagram).samplesCnt);
+}
+
+TEST(BcmSflowExporterTest, ZeroFlushIntervalSendsRightAway) {
+  LocalCollector local;
+  BcmSflowExporterTable table({true, kMaxDatagramSize, 32, 0ms});
+  table.addExporter(local.collector());
+  table.sendToAll(makeSample(1));
+  EXPECT_EQ(1, parseDatagram(local.receive()).samplesCnt);
+}
+
+TEST(BcmSflowExporterTest, FlushedOnTimer) {
+  LocalCollector local;
+  BcmSflowExporterTable table({true, kMaxDatagramSize, 32, 10ms});
+  table.addExporter(local.collector());
+  table.sendToAll(makeSample(1));
+  EXPECT_EQ(1, parseDatagram(local.receive()).samplesCnt);
+}
@@ -21,13 +21,20 @@
 #include <folly/Benchmark.h>
 #include <folly/IPAddress.h>
 
+#include <atomic>
+#include <chrono>
 #include <thread>
 
 namespace facebook::fboss {
 
 using utility::getEcmpSizeInHw;
 
-BENCHMARK(HwEcmpGroupShrinkWithCompetingRouteUpdates) {
+/*
+ * Besides the time to shrink the ECMP group, reports how far along the
+ * competing route updates were when the shrink was observed and how long it
+ * took for all of them to be programmed (route_convergence_ms).
+ */
+BENCHMARK_COUNTERS(HwEcmpGroupShrinkWithCompetingRouteUpdates, counters) {
   folly::BenchmarkSuspender suspender;
   constexpr int kEcmpWidth = 4;
   auto ensemble = createHwEnsemble(
@@ -57,10 +64,16 @@ BENCHMARK(HwEcmpGroupShrinkWithCompetingRouteUpdates) {
                          RouterID(0))
                          .getSwitchStates();
 
-  std::thread t([&ensemble, &routeStates]() {
+  std::atomic<int> routeStatesProgrammed{0};
+  std::chrono::milliseconds routeConvergence{0};
+  std::thread t([&]() {
+    auto start = std::chrono::steady_clock::now();
     for (const auto& state : routeStates) {
       ensemble->applyNewState(state);
+      ++routeStatesProgrammed;
     }
+    routeConvergence = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
   });
 
   // Toggle loopback mode via direct SDK calls rathe than going through
@@ -91,7 +104,10 @@ BENCHMARK(HwEcmpGroupShrinkWithCompetingRouteUpdates) {
       kEcmpWidth - 1) {
   }
   suspender.rehire();
+  counters["route_states_at_shrink"] = routeStatesProgrammed.load();
   t.join();
+  counters["route_states"] = routeStates.size();
+  counters["route_convergence_ms"] = routeConvergence.count();
 }
 
 } // namespace facebook::fboss
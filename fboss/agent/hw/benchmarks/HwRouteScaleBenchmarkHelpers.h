@@ -9,22 +9,50 @@
  */
 
 #include "fboss/agent/HwSwitch.h"
+#include "fboss/agent/hw/HwPhaseScheduler.h"
 #include "fboss/agent/hw/test/ConfigFactory.h"
 #include "fboss/agent/hw/test/HwSwitchEnsemble.h"
 #include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
+#include "fboss/agent/state/RouteTable.h"
+#include "fboss/agent/state/RouteTableMap.h"
+#include "fboss/agent/state/SwitchState.h"
 
+#include <fb303/ServiceData.h>
 #include <folly/Benchmark.h>
 
+#include <map>
+#include <string>
+
 namespace facebook::fboss {
 
+/*
+ * Time spent in each hardware programming phase (in usecs) so far, as
+ * reported by HwSwitch implementations that use HwPhaseScheduler.
+ */
+inline std::map<std::string, int64_t> hwProgrammingPhaseTimes() {
+  std::map<std::string, int64_t> counters;
+  fb303::fbData->getCounters(counters);
+  std::map<std::string, int64_t> phaseTimes;
+  auto prefix = HwPhaseScheduler::kCounterPrefix;
+  for (const auto& [name, value] : counters) {
+    if (folly::StringPiece(name).startsWith(prefix)) {
+      phaseTimes.emplace(name.substr(prefix.size()), value);
+    }
+  }
+  return phaseTimes;
+}
+
 /*
  * Helper function to benchmark speed of route insertion, deletion
  * in HW. This function inits the ASIC, generate switch states for
  * a given route distribution and then measures the time it takes
- * to add (or delete post addition) these routes
+ * to add (or delete post addition) these routes. The number of routes
+ * programmed is reported in the routes counter, and the time spent in each
+ * hardware programming phase while adding routes in a counter named after
+ * the phase, e.g. routes_added_changed.us.
  */
 template <typename RouteScaleGeneratorT>
-void routeAddDelBenchmarker(bool measureAdd) {
+void routeAddDelBenchmarker(folly::UserCounters& counters, bool measureAdd) {
   folly::BenchmarkSuspender suspender;
   auto ensemble = createHwEnsemble(
       HwSwitch::PACKET_RX_DESIRED | HwSwitch::LINKSCAN_DESIRED);
@@ -33,6 +61,7 @@ void routeAddDelBenchmarker(bool measureAdd) {
   ensemble->applyInitialConfig(config);
   static const auto states =
       RouteScaleGeneratorT(ensemble->getProgrammedState()).getSwitchStates();
+  auto phaseTimesBefore = hwProgrammingPhaseTimes();
   if (measureAdd) {
     // Activate benchmarker before applying switch states
     // for adding routes to h/w
@@ -41,21 +70,33 @@ void routeAddDelBenchmarker(bool measureAdd) {
   for (auto& state : states) {
     ensemble->applyNewState(state);
   }
+  uint64_t numRoutes = 0;
+  for (const auto& routeTable :
+       *ensemble->getProgrammedState()->getRouteTables()) {
+    numRoutes += routeTable->getRibV4()->size();
+    numRoutes += routeTable->getRibV6()->size();
+  }
+  counters["routes"] = numRoutes;
   // We are about to blow away all routes, before that
   // - Deactivate benchmark measurement if we are measuring
   // route addition
   // - Activate benchmark if we are measuring route deletion
   measureAdd ? suspender.rehire() : suspender.dismiss();
+  if (measureAdd) {
+    for (const auto& [phase, usecs] : hwProgrammingPhaseTimes()) {
+      counters[phase] = usecs - phaseTimesBefore[phase];
+    }
+  }
 }
 
-#define ROUTE_ADD_BENCHMARK(name, RouteScaleGeneratorT) \
-  BENCHMARK(name) {                                     \
-    routeAddDelBenchmarker<RouteScaleGeneratorT>(true); \
+#define ROUTE_ADD_BENCHMARK(name, RouteScaleGeneratorT)           \
+  BENCHMARK_COUNTERS(name, counters) {                            \
+    routeAddDelBenchmarker<RouteScaleGeneratorT>(counters, true); \
   }
 
-#define ROUTE_DEL_BENCHMARK(name, RouteScaleGeneratorT)  \
-  BENCHMARK(name) {                                      \
-    routeAddDelBenchmarker<RouteScaleGeneratorT>(false); \
+#define ROUTE_DEL_BENCHMARK(name, RouteScaleGeneratorT)            \
+  BENCHMARK_COUNTERS(name, counters) {                             \
+    routeAddDelBenchmarker<RouteScaleGeneratorT>(counters, false); \
   }
 
 } // namespace facebook::fboss
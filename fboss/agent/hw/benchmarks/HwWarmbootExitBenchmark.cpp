@@ -17,6 +17,7 @@
 #include "fboss/agent/test/EcmpSetupHelper.h"
 #include "fboss/agent/test/RouteScaleGenerators.h"
 
+#include <fb303/ServiceData.h>
 #include <folly/IPAddressV6.h>
 #include <folly/dynamic.h>
 #include <folly/init/Init.h>
@@ -24,22 +25,47 @@
 
 #include <chrono>
 #include <iostream>
+#include <map>
 
 DEFINE_bool(json, true, "Output in json form");
 
 namespace {
+/*
+ * Time spent saving each table on exit, for HwSwitch implementations that
+ * export it as warm_boot.exit.<table>.us counters
+ */
+std::map<std::string, int64_t> tableExitTimes() {
+  constexpr folly::StringPiece kPrefix{"warm_boot.exit."};
+  std::map<std::string, int64_t> counters;
+  facebook::fb303::fbData->getCounters(counters);
+  std::map<std::string, int64_t> tableTimes;
+  for (const auto& [name, value] : counters) {
+    if (folly::StringPiece(name).startsWith(kPrefix)) {
+      tableTimes.emplace(name.substr(kPrefix.size()), value);
+    }
+  }
+  return tableTimes;
+}
+
 class StopWatch {
  public:
   StopWatch() : startTime_(std::chrono::steady_clock::now()) {}
   ~StopWatch() {
     std::chrono::duration<double, std::milli> durationMillseconds =
         std::chrono::steady_clock::now() - startTime_;
+    auto tableTimes = tableExitTimes();
     if (FLAGS_json) {
       folly::dynamic warmBootTime = folly::dynamic::object;
       warmBootTime["warm_boot_msecs"] = durationMillseconds.count();
+      for (const auto& [table, usecs] : tableTimes) {
+        warmBootTime[table] = usecs;
+      }
       std::cout << warmBootTime << std::endl;
     } else {
       XLOG(INFO) << " warm boot msecs: " << durationMillseconds.count();
+      for (const auto& [table, usecs] : tableTimes) {
+        XLOG(INFO) << " " << table << ": " << usecs;
+      }
     }
   }
 
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/HwPhaseScheduler.h"
+#include "fboss/agent/FbossError.h"
+
+#include <fb303/ServiceData.h>
+#include <folly/Synchronized.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/synchronization/Baton.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+
+using namespace facebook::fboss;
+
+namespace {
+
+size_t position(const std::vector<std::string>& order, const std::string& x) {
+  return std::find(order.begin(), order.end(), x) - order.begin();
+}
+
+int64_t getCounter(const std::string& name) {
+  std::map<std::string, int64_t> counters;
+  facebook::fb303::fbData->getCounters(counters);
+  auto it = counters.find(name);
+  return it == counters.end() ? 0 : it->second;
+}
+
+} // namespace
+
+TEST(HwPhaseSchedulerTests, SerialRunsInOrder) {
+  std::vector<std::string> order;
+  HwPhaseScheduler scheduler;
+  scheduler.addPhase("a", [&]() { order.push_back("a"); });
+  scheduler.addPhase("b", [&]() { order.push_back("b"); });
+  scheduler.addPhase("c", [&]() { order.push_back("c"); }, {"a"});
+  scheduler.run();
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), order);
+}
+
+TEST(HwPhaseSchedulerTests, UnknownDependency) {
+  HwPhaseScheduler scheduler;
+  scheduler.addPhase("a", []() {});
+  EXPECT_THROW(scheduler.addPhase("b", []() {}, {"c"}), FbossError);
+}
+
+TEST(HwPhaseSchedulerTests, ParallelHonorsDependencies) {
+  folly::CPUThreadPoolExecutor executor(4);
+  folly::Synchronized<std::vector<std::string>> order;
+  auto record = [&](const std::string& name) {
+    return [&order, name]() { order.wlock()->push_back(name); };
+  };
+  HwPhaseScheduler scheduler;
+  scheduler.addPhase("interfaces", record("interfaces"));
+  scheduler.addPhase("neighbors", record("neighbors"), {"interfaces"});
+  scheduler.addPhase("acls", record("acls"), {"interfaces"});
+  scheduler.addPhase("routes", record("routes"), {"neighbors"});
+  scheduler.addPhase("ports", record("ports"), {"acls", "routes"});
+  scheduler.run(&executor);
+
+  auto result = order.copy();
+  ASSERT_EQ(5, result.size());
+  EXPECT_EQ("interfaces", result.front());
+  EXPECT_EQ("ports", result.back());
+  EXPECT_LT(position(result, "neighbors"), position(result, "routes"));
+}
+
+TEST(HwPhaseSchedulerTests, IndependentPhasesOverlap) {
+  folly::CPUThreadPoolExecutor executor(2);
+  folly::Baton<> aclsStarted;
+  folly::Baton<> routesStarted;
+  HwPhaseScheduler scheduler;
+  // Each phase waits for the other one to start, which only completes if
+  // they run at the same time.
+  scheduler.addPhase("acls", [&]() {
+    aclsStarted.post();
+    routesStarted.wait();
+  });
+  scheduler.addPhase("routes", [&]() {
+    routesStarted.post();
+    aclsStarted.wait();
+  });
+  scheduler.run(&executor);
+}
+
+TEST(HwPhaseSchedulerTests, ErrorSkipsDependents) {
+  folly::CPUThreadPoolExecutor executor(2);
+  std::atomic<bool> ranDependent{false};
+  HwPhaseScheduler scheduler;
+  scheduler.addPhase("a", []() { throw FbossError("failed"); });
+  scheduler.addPhase("b", [&]() { ranDependent = true; }, {"a"});
+  EXPECT_THROW(scheduler.run(&executor), FbossError);
+  EXPECT_FALSE(ranDependent);
+}
+
+TEST(HwPhaseSchedulerTests, PhaseTimeCounters) {
+  auto counter = HwPhaseScheduler::counterName("timed");
+  auto before = getCounter(counter);
+  HwPhaseScheduler scheduler;
+  scheduler.addPhase("timed", []() {
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  });
+  scheduler.run();
+  EXPECT_GE(getCounter(counter) - before, 2000);
+}
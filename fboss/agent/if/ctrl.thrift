@@ -515,6 +515,22 @@ struct AclEntryThrift {
   22: optional byte lookupClassL2
 }
 
+struct NodeMemoryUsageThrift {
+  1: i64 nodes
+  2: i64 bytes
+  // Nodes/bytes shared with the applied state
+  3: i64 sharedNodes
+  4: i64 sharedBytes
+}
+
+struct SwitchStateMemoryUsage {
+  1: NodeMemoryUsageThrift total
+  // Keyed by top level SwitchState child, e.g. PortMap, VlanMap
+  2: map<string, NodeMemoryUsageThrift> bySubtree
+  // Keyed by node type, e.g. Route<folly::IPAddressV6>, ArpEntry
+  3: map<string, NodeMemoryUsageThrift> byNodeType
+}
+
 service FbossCtrl extends fb303.FacebookService {
   /*
    * Retrieve up-to-date counters from the hardware, and publish all
@@ -562,6 +578,31 @@ service FbossCtrl extends fb303.FacebookService {
   void syncFibInVrf(1: i16 clientId, 2: list<UnicastRoute> routes, 3: i32 vrf)
     throws (1: fboss.FbossBaseError error)
 
+  /*
+   * Pipelined route updates (Stand-Alone RIB only)
+   * - queue route additions/deletions without waiting for them to be
+   *   programmed and return a per-client sequence number for the batch
+   * - batches queued back to back are coalesced into fewer RIB/FIB updates,
+   *   but are always applied in the order a client queued them
+   * - waitForUnicastRouteUpdates returns once every batch of the client up to
+   *   seqNum has been applied, and throws if any of them failed
+   */
+  i64 enqueueUnicastRouteUpdatesInVrf(
+    1: i16 clientId,
+    2: list<UnicastRoute> toAdd,
+    3: list<IpPrefix> toDelete,
+    4: i32 vrf
+  ) throws (1: fboss.FbossBaseError error)
+  i64 enqueueSyncFibInVrf(
+    1: i16 clientId,
+    2: list<UnicastRoute> routes,
+    3: i32 vrf
+  ) throws (1: fboss.FbossBaseError error)
+  void waitForUnicastRouteUpdates(1: i16 clientId, 2: i64 seqNum)
+    throws (1: fboss.FbossBaseError error)
+  i64 getLastCompletedUnicastRouteUpdate(1: i16 clientId)
+    throws (1: fboss.FbossBaseError error)
+
   /*
    * Send packets in binary or hex format to controller.
    *
@@ -847,6 +888,21 @@ service FbossCtrl extends fb303.FacebookService {
    */
   string getCurrentStateJSON(1: string jsonPointer)
 
+  /*
+   * Recent route/state update traces, timestamped per processing stage, in
+   * Chrome trace event format. Requires --enable_update_tracing.
+   */
+  string getUpdateTraces()
+    throws (1: fboss.FbossBaseError error)
+
+  /*
+   * Estimated memory footprint of the desired switch state, broken down by
+   * subtree and node type. Nodes shared with the applied state are reported
+   * separately.
+   */
+  SwitchStateMemoryUsage getSwitchStateMemoryUsage()
+    throws (1: fboss.FbossBaseError error)
+
   /*
    * Apply patch at given path within the state tree. jsonPatch must  be
    * a valid JSON object string
@@ -9,13 +9,24 @@
  */
 #include "fboss/agent/packet/PktUtil.h"
 
+#include <folly/CpuId.h>
 #include <folly/Format.h>
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 #include <folly/MacAddress.h>
+#include <folly/Portability.h>
 #include <folly/io/Cursor.h>
+#include <folly/lang/Bits.h>
 #include "fboss/agent/FbossError.h"
 
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if FOLLY_X64
+#include <immintrin.h>
+#endif
+
 using folly::ByteRange;
 using folly::IOBuf;
 using folly::IPAddressV4;
@@ -26,6 +37,102 @@ using folly::io::Appender;
 using folly::io::Cursor;
 using std::string;
 
+namespace {
+
+/*
+ * The checksum kernels below sum up a contiguous range of bytes as 16 bit
+ * words in host byte order, without folding. By RFC 1071 section 2(B) the
+ * folded result is the same as for network byte order, only byte swapped on
+ * little endian hosts. An odd trailing byte is summed as if it was followed
+ * by a zero byte.
+ */
+using SumWordsFn = uint64_t (*)(const uint8_t* data, size_t len);
+
+uint64_t sumWordsScalar(const uint8_t* data, size_t len) {
+  // Each 64 bit word is added as two 32 bit halves, which is the same as
+  // adding its four 16 bit words modulo 0xffff. Two accumulators to keep
+  // the adds independent.
+  uint64_t sum0 = 0;
+  uint64_t sum1 = 0;
+  while (len >= 16) {
+    uint64_t word0;
+    uint64_t word1;
+    memcpy(&word0, data, sizeof(word0));
+    memcpy(&word1, data + 8, sizeof(word1));
+    sum0 += (word0 & 0xffffffff) + (word0 >> 32);
+    sum1 += (word1 & 0xffffffff) + (word1 >> 32);
+    data += 16;
+    len -= 16;
+  }
+  uint64_t sum = sum0 + sum1;
+  while (len >= 2) {
+    uint16_t word;
+    memcpy(&word, data, sizeof(word));
+    sum += word;
+    data += 2;
+    len -= 2;
+  }
+  if (len) {
+    uint8_t last[2] = {*data, 0};
+    uint16_t word;
+    memcpy(&word, last, sizeof(word));
+    sum += word;
+  }
+  return sum;
+}
+
+#if FOLLY_X64
+__attribute__((target("avx2"))) uint64_t sumWordsAvx2(
+    const uint8_t* data,
+    size_t len) {
+  // Every 32 byte block adds two 16 bit words to each 32 bit lane, so the
+  // lanes can take 2^15 blocks before they may overflow.
+  constexpr size_t kMaxBlocks = 1 << 15;
+  const __m256i zero = _mm256_setzero_si256();
+  uint64_t sum = 0;
+  while (len >= 32) {
+    auto blocks = std::min(len / 32, kMaxBlocks);
+    __m256i acc = zero;
+    for (size_t i = 0; i < blocks; ++i) {
+      auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+      acc = _mm256_add_epi32(acc, _mm256_unpacklo_epi16(block, zero));
+      acc = _mm256_add_epi32(acc, _mm256_unpackhi_epi16(block, zero));
+      data += 32;
+    }
+    len -= blocks * 32;
+    alignas(32) uint32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    for (auto lane : lanes) {
+      sum += lane;
+    }
+  }
+  return sum + sumWordsScalar(data, len);
+}
+#endif
+
+SumWordsFn getSumWordsFn() {
+  static const SumWordsFn sumWords = []() -> SumWordsFn {
+#if FOLLY_X64
+    if (folly::CpuId().avx2()) {
+      return sumWordsAvx2;
+    }
+#endif
+    return sumWordsScalar;
+  }();
+  return sumWords;
+}
+
+uint32_t foldTo16(uint64_t sum) {
+  sum = (sum & 0xffffffff) + (sum >> 32);
+  sum = (sum & 0xffffffff) + (sum >> 32);
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+  return static_cast<uint32_t>(sum);
+}
+
+} // namespace
+
 namespace facebook::fboss {
 
 MacAddress PktUtil::readMac(Cursor* cursor) {
@@ -80,20 +187,32 @@ uint32_t PktUtil::partialChecksumImpl(
     folly::io::Cursor cursor,
     uint64_t length,
     uint32_t value) {
-  // Checksum all the pairs of bytes first
-  while (length > 1) {
-    value += cursor.readBE<uint16_t>();
-    length -= 2;
-  }
-  if (length) {
+  // Checksum each contiguous buffer in the chain in one go. The result is
+  // folded, which is equivalent to the plain sum once finalized.
+  auto sumWords = getSumWordsFn();
+  uint64_t sum = 0;
+  // Whether we are at an odd offset from the start
+  bool odd = false;
+  while (length) {
+    auto bytes = cursor.peekBytes();
+    if (bytes.empty()) {
+      throw std::out_of_range("underflow");
+    }
+    auto len = std::min<uint64_t>(bytes.size(), length);
+    auto bufSum = static_cast<uint16_t>(foldTo16(sumWords(bytes.data(), len)));
     // Bytes are interpreted in n/w byte order
-    // so this last octet represents the 8 MSbits
-    // of the last 16 bit number in this buffer.
-    uint16_t last = cursor.read<uint8_t>();
-    value += (last << 8);
-    --length;
+    bufSum = folly::Endian::big(bufSum);
+    if (odd) {
+      // This buffer starts in the middle of a 16 bit word, so all of its
+      // bytes are paired up the other way round.
+      bufSum = folly::Endian::swap(bufSum);
+    }
+    sum += bufSum;
+    odd ^= (len & 1);
+    cursor.skip(len);
+    length -= len;
   }
-  return value;
+  return value + foldTo16(sum);
 }
 
 uint32_t PktUtil::partialChecksum(
@@ -19,7 +19,8 @@ namespace sflow {
 
 void serializeIP(RWPrivateCursor* cursor, folly::IPAddress ip) {
   // We first push the address type
-  cursor->writeBE<uint32_t>(static_cast<uint32_t>(AddressType::IP_V6));
+  auto type = ip.isV4() ? AddressType::IP_V4 : AddressType::IP_V6;
+  cursor->writeBE<uint32_t>(static_cast<uint32_t>(type));
   // then push the address in bytes
   cursor->push(ip.bytes(), ip.byteCount());
 }
@@ -32,7 +32,7 @@ using byte = uint8_t;
 enum struct AddressType : uint32_t { UNKNOWN = 0, IP_V4 = 1, IP_V6 = 2 };
 
 void serializeIP(folly::io::RWPrivateCursor* cursor, folly::IPAddress ip);
-uint32_t sizeIP(folly::IPAddress ip);
+uint32_t sizeIP(folly::IPAddress const& ip);
 
 /* Data Format */
 using DataFormat = uint32_t;
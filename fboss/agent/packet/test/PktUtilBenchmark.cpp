@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "common/init/Init.h"
+#include "fboss/agent/packet/PktUtil.h"
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+
+#include <memory>
+#include <vector>
+
+using namespace facebook::fboss;
+using folly::IOBuf;
+using folly::io::Cursor;
+
+/*
+ * Internet checksum over packets from 64 bytes to jumbo frames, both in a
+ * single buffer and split in three buffers at odd offsets. The baseline is
+ * the old implementation, which read the packet two bytes at a time through
+ * the cursor.
+ */
+
+namespace {
+
+std::unique_ptr<IOBuf> makePacket(size_t size, size_t numBufs) {
+  std::vector<uint8_t> bytes(size);
+  for (auto& byte : bytes) {
+    byte = folly::Random::rand32(256);
+  }
+  std::unique_ptr<IOBuf> chain;
+  size_t offset = 0;
+  for (size_t i = 0; i < numBufs; ++i) {
+    // Odd sized pieces, except for the last one which takes what is left
+    auto len = i + 1 == numBufs ? size - offset : (size / numBufs) | 1;
+    auto buf = IOBuf::copyBuffer(bytes.data() + offset, len);
+    offset += len;
+    if (chain) {
+      chain->prependChain(std::move(buf));
+    } else {
+      chain = std::move(buf);
+    }
+  }
+  return chain;
+}
+
+uint16_t legacyChecksum(Cursor cursor, uint64_t length) {
+  uint32_t sum = 0;
+  while (length > 1) {
+    sum += cursor.readBE<uint16_t>();
+    length -= 2;
+  }
+  if (length) {
+    sum += cursor.read<uint8_t>() << 8;
+  }
+  return PktUtil::finalizeChecksum(sum);
+}
+
+void runChecksumBenchmark(
+    uint32_t iters,
+    size_t size,
+    size_t numBufs,
+    bool byWord) {
+  folly::BenchmarkSuspender suspender;
+  auto pkt = makePacket(size, numBufs);
+  suspender.dismiss();
+
+  for (uint32_t i = 0; i < iters; ++i) {
+    auto csum = byWord ? legacyChecksum(Cursor(pkt.get()), size)
+                       : PktUtil::internetChecksum(pkt.get());
+    folly::doNotOptimizeAway(csum);
+  }
+}
+
+void checksumByWord(uint32_t iters, size_t size) {
+  runChecksumBenchmark(iters, size, 1, true);
+}
+
+void checksum(uint32_t iters, size_t size) {
+  runChecksumBenchmark(iters, size, 1, false);
+}
+
+void checksumChainedByWord(uint32_t iters, size_t size) {
+  runChecksumBenchmark(iters, size, 3, true);
+}
+
+void checksumChained(uint32_t iters, size_t size) {
+  runChecksumBenchmark(iters, size, 3, false);
+}
+
+} // namespace
+
+#define CHECKSUM_BENCHMARKS(size)                 \
+  BENCHMARK_PARAM(checksumByWord, size)           \
+  BENCHMARK_RELATIVE_PARAM(checksum, size)        \
+  BENCHMARK_PARAM(checksumChainedByWord, size)    \
+  BENCHMARK_RELATIVE_PARAM(checksumChained, size) \
+  BENCHMARK_DRAW_LINE();
+
+CHECKSUM_BENCHMARKS(64)
+CHECKSUM_BENCHMARKS(128)
+CHECKSUM_BENCHMARKS(512)
+CHECKSUM_BENCHMARKS(1500)
+CHECKSUM_BENCHMARKS(4096)
+CHECKSUM_BENCHMARKS(9000)
+
+int main(int argc, char** argv) {
+  facebook::initFacebook(&argc, &argv);
+  folly::runBenchmarks();
+  return EXIT_SUCCESS;
+}
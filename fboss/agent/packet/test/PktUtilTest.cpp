@@ -18,6 +18,9 @@
 #include <folly/logging/xlog.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 using namespace facebook::fboss;
 using folly::IOBuf;
 using folly::IPAddressV4;
@@ -222,3 +225,61 @@ TEST(Checksum, TestKnownOdd) {
   expected = ~expected;
   EXPECT_EQ(expected, PktUtil::internetChecksum(bytes, 9));
 }
+
+namespace {
+// Plain RFC 1071 checksum, two bytes at a time
+uint16_t referenceChecksum(const std::vector<uint8_t>& bytes) {
+  uint32_t sum = 0;
+  for (size_t i = 0; i < bytes.size(); i += 2) {
+    sum += bytes[i] << 8;
+    if (i + 1 < bytes.size()) {
+      sum += bytes[i + 1];
+    }
+  }
+  return PktUtil::finalizeChecksum(sum);
+}
+} // namespace
+
+TEST(Checksum, ChainedBuffers) {
+  for (auto iter = 0; iter < 200; ++iter) {
+    std::vector<uint8_t> bytes(Random::rand32(1, 9000));
+    // All ones makes sure carries are handled right everywhere
+    auto allOnes = iter % 4 == 0;
+    for (auto& byte : bytes) {
+      byte = allOnes ? 0xff : Random::rand32(256);
+    }
+
+    // Split into a chain at random, possibly odd, offsets
+    auto numBufs = Random::rand32(1, 5);
+    std::vector<size_t> splits{0, bytes.size()};
+    for (uint32_t i = 1; i < numBufs; ++i) {
+      splits.push_back(Random::rand32(bytes.size()));
+    }
+    std::sort(splits.begin(), splits.end());
+    std::unique_ptr<IOBuf> chain;
+    for (size_t i = 0; i + 1 < splits.size(); ++i) {
+      auto buf = IOBuf::copyBuffer(
+          bytes.data() + splits[i], splits[i + 1] - splits[i]);
+      if (chain) {
+        chain->prependChain(std::move(buf));
+      } else {
+        chain = std::move(buf);
+      }
+    }
+
+    auto expected = referenceChecksum(bytes);
+    EXPECT_EQ(expected, PktUtil::internetChecksum(chain.get()));
+    EXPECT_EQ(expected, PktUtil::internetChecksum(bytes.data(), bytes.size()));
+
+    // Starting at an odd offset
+    std::vector<uint8_t> tail(bytes.begin() + 1, bytes.end());
+    EXPECT_EQ(
+        referenceChecksum(tail),
+        PktUtil::internetChecksum(Cursor(chain.get()) + 1, tail.size()));
+  }
+}
+
+TEST(Checksum, Underflow) {
+  auto buf = setupBuf();
+  EXPECT_THROW(PktUtil::internetChecksum(Cursor(&buf), 41), std::out_of_range);
+}
@@ -220,3 +220,27 @@ TEST(SflowStructsTest, Serialize) {
     EXPECT_EQ(b.at(i), data[i]);
   }
 }
+
+TEST(SflowStructsTest, SerializeIPv4) {
+  folly::IPAddress agentIP("10.1.2.3");
+  EXPECT_EQ(8, sflow::sizeIP(agentIP));
+
+  std::vector<uint8_t> b(64);
+  auto buf = folly::IOBuf::wrapBuffer(b.data(), b.size());
+  folly::io::RWPrivateCursor cursor(buf.get());
+  sflow::serializeIP(&cursor, agentIP);
+  EXPECT_EQ(8, b.size() - cursor.length());
+
+  constexpr auto data = folly::make_array<uint8_t>(
+      0x00,
+      0x00,
+      0x00,
+      0x01, // ipv4 type = 1
+      0x0a,
+      0x01,
+      0x02,
+      0x03);
+  for (int i = 0; i < data.size(); ++i) {
+    EXPECT_EQ(b.at(i), data[i]);
+  }
+}
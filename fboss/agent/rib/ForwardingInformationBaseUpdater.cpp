@@ -9,6 +9,7 @@
  */
 #include "fboss/agent/rib/ForwardingInformationBaseUpdater.h"
 
+#include "fboss/agent/UpdateTracer.h"
 #include "fboss/agent/state/ForwardingInformationBaseContainer.h"
 #include "fboss/agent/state/ForwardingInformationBaseMap.h"
 #include "fboss/agent/state/NodeMap.h"
@@ -30,6 +31,7 @@ ForwardingInformationBaseUpdater::ForwardingInformationBaseUpdater(
 
 std::shared_ptr<SwitchState> ForwardingInformationBaseUpdater::operator()(
     const std::shared_ptr<SwitchState>& state) {
+  ScopedTraceSpan span("fib_conversion");
   std::shared_ptr<SwitchState> nextState(state);
 
   // A ForwardingInformationBaseContainer holds a
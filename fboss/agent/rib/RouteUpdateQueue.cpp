@@ -0,0 +1,311 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/rib/RouteUpdateQueue.h"
+
+#include "fboss/agent/AddressUtil.h"
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/UpdateTracer.h"
+
+#include <folly/logging/xlog.h>
+#include <folly/system/ThreadName.h>
+
+#include <utility>
+
+namespace {
+
+// The RIB masks prefixes, so 10.0.0.1/24 and 10.0.0.0/24 are the same route
+// and have to be merged as such.
+folly::CIDRNetwork toMaskedNetwork(const facebook::fboss::IpPrefix& prefix) {
+  auto length = static_cast<uint8_t>(prefix.prefixLength);
+  return folly::CIDRNetwork{
+      facebook::network::toIPAddress(prefix.ip).mask(length), length};
+}
+
+} // namespace
+
+namespace facebook::fboss::rib {
+
+RouteUpdateQueue::RouteUpdateQueue(
+    RoutingInformationBase* rib,
+    RoutingInformationBase::FibUpdateFunction fibUpdateCallback,
+    void* cookie,
+    StatsCallback statsCallback)
+    : rib_(rib),
+      fibUpdateCallback_(std::move(fibUpdateCallback)),
+      cookie_(cookie),
+      statsCallback_(std::move(statsCallback)) {
+  thread_ = std::make_unique<std::thread>([this] {
+    folly::setThreadName("fbossRouteUpdQueue");
+    evb_.loopForever();
+  });
+}
+
+RouteUpdateQueue::~RouteUpdateQueue() {
+  stop();
+}
+
+void RouteUpdateQueue::stop() {
+  std::deque<PendingBatch> dropped;
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    if (stopped_) {
+      return;
+    }
+    stopped_ = true;
+    dropped.swap(pending_);
+  }
+
+  // Any processPending() already scheduled finds nothing left to apply, and
+  // terminateLoopSoon() runs after the batch being applied, if any.
+  evb_.runInEventBaseThread([this] { evb_.terminateLoopSoon(); });
+  thread_->join();
+
+  // Only waiters for dropped batches are left once the thread is done
+  std::vector<folly::Promise<folly::Unit>> waiters;
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    for (auto& clientAndState : clients_) {
+      for (auto& seqNumAndWaiter : clientAndState.second.waiters) {
+        waiters.push_back(std::move(seqNumAndWaiter.second));
+      }
+      clientAndState.second.waiters.clear();
+    }
+  }
+  XLOG_IF(INFO, !dropped.empty())
+      << "Dropping " << dropped.size() << " queued route update batches";
+  for (auto& batch : dropped) {
+    batch.promise.setException(
+        FbossError("Route update queue stopped, update dropped"));
+  }
+  for (auto& waiter : waiters) {
+    waiter.setException(
+        FbossError("Route update queue stopped, update dropped"));
+  }
+}
+
+RouteUpdateQueue::Ticket RouteUpdateQueue::enqueue(
+    RouterID routerID,
+    ClientID clientID,
+    AdminDistance adminDistanceFromClientID,
+    std::vector<UnicastRoute> toAdd,
+    std::vector<IpPrefix> toDelete,
+    bool resetClientsRoutes) {
+  folly::Promise<folly::Unit> promise;
+  auto future = promise.getSemiFuture();
+
+  bool scheduleProcessing{false};
+  int64_t seqNum{0};
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    if (stopped_) {
+      return Ticket{clients_[clientID].lastEnqueued,
+                    folly::makeSemiFuture<folly::Unit>(FbossError(
+                        "Route update queue stopped, update rejected"))};
+    }
+    seqNum = ++clients_[clientID].lastEnqueued;
+    pending_.push_back(PendingBatch{routerID,
+                                    clientID,
+                                    adminDistanceFromClientID,
+                                    std::move(toAdd),
+                                    std::move(toDelete),
+                                    resetClientsRoutes,
+                                    seqNum,
+                                    std::move(promise)});
+    scheduleProcessing = !processingScheduled_;
+    processingScheduled_ = true;
+  }
+
+  // As with SwSwitch::updateState(), only schedule a processing run when the
+  // queue goes from empty to non-empty. Anything enqueued while a run is
+  // already scheduled is picked up by that run.
+  if (scheduleProcessing) {
+    evb_.runInEventBaseThread([this] { processPending(); });
+  }
+  return Ticket{seqNum, std::move(future)};
+}
+
+folly::SemiFuture<folly::Unit> RouteUpdateQueue::waitFor(
+    ClientID clientID,
+    int64_t seqNum) {
+  std::lock_guard<std::mutex> g(mutex_);
+  auto& client = clients_[clientID];
+  if (seqNum > client.lastEnqueued) {
+    return folly::makeSemiFuture<folly::Unit>(FbossError(
+        "Route update ",
+        seqNum,
+        " for client ",
+        static_cast<int>(clientID),
+        " was never enqueued, last enqueued: ",
+        client.lastEnqueued));
+  }
+  if (seqNum <= client.lastCompleted) {
+    return folly::makeSemiFuture();
+  }
+  if (stopped_) {
+    return folly::makeSemiFuture<folly::Unit>(
+        FbossError("Route update queue stopped, update dropped"));
+  }
+  folly::Promise<folly::Unit> promise;
+  auto future = promise.getSemiFuture();
+  client.waiters.emplace(seqNum, std::move(promise));
+  return future;
+}
+
+int64_t RouteUpdateQueue::getLastEnqueued(ClientID clientID) const {
+  std::lock_guard<std::mutex> g(mutex_);
+  auto it = clients_.find(clientID);
+  return it == clients_.end() ? 0 : it->second.lastEnqueued;
+}
+
+int64_t RouteUpdateQueue::getLastCompleted(ClientID clientID) const {
+  std::lock_guard<std::mutex> g(mutex_);
+  auto it = clients_.find(clientID);
+  return it == clients_.end() ? 0 : it->second.lastCompleted;
+}
+
+uint64_t RouteUpdateQueue::getRibUpdateCount() const {
+  std::lock_guard<std::mutex> g(mutex_);
+  return ribUpdateCount_;
+}
+
+void RouteUpdateQueue::mergeInto(MergedUpdate* merged, PendingBatch* batch) {
+  if (batch->resetClientsRoutes) {
+    // Anything queued earlier for this client is superseded by the sync
+    merged->resetClientsRoutes = true;
+    merged->prefixToRoute.clear();
+  }
+  // RoutingInformationBase::update() processes additions before deletions,
+  // so the same order is used when folding a batch in.
+  for (auto& route : batch->toAdd) {
+    merged->prefixToRoute[toMaskedNetwork(route.dest)] = std::move(route);
+  }
+  for (const auto& toDelete : batch->toDelete) {
+    merged->prefixToRoute[toMaskedNetwork(toDelete)] = std::nullopt;
+  }
+  merged->adminDistance = batch->adminDistance;
+  merged->lastSeqNum = batch->seqNum;
+  merged->promises.push_back(std::move(batch->promise));
+}
+
+void RouteUpdateQueue::processPending() {
+  std::deque<PendingBatch> batches;
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    batches.swap(pending_);
+    processingScheduled_ = false;
+  }
+
+  // Coalesce per (VRF, client), keeping each client's batches in order.
+  std::vector<MergedUpdate> merged;
+  std::map<std::pair<RouterID, ClientID>, size_t> keyToMerged;
+  for (auto& batch : batches) {
+    auto key = std::make_pair(batch.routerID, batch.clientID);
+    auto it = keyToMerged.find(key);
+    if (it == keyToMerged.end()) {
+      it = keyToMerged.emplace(key, merged.size()).first;
+      merged.emplace_back();
+      merged.back().routerID = batch.routerID;
+      merged.back().clientID = batch.clientID;
+    }
+    mergeInto(&merged[it->second], &batch);
+  }
+  XLOG(DBG2) << "Coalesced " << batches.size() << " route update batches into "
+             << merged.size() << " RIB updates";
+
+  std::vector<folly::exception_wrapper> errors(merged.size());
+  std::map<ClientID, std::pair<int64_t, folly::exception_wrapper>> completed;
+  for (size_t i = 0; i < merged.size(); ++i) {
+    auto& update = merged[i];
+    try {
+      apply(&update);
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "Failed to apply queued route update for client "
+                << static_cast<int>(update.clientID) << ": "
+                << folly::exceptionStr(ex);
+      errors[i] = folly::exception_wrapper(std::current_exception(), ex);
+    }
+    auto& clientCompleted = completed[update.clientID];
+    clientCompleted.first = std::max(clientCompleted.first, update.lastSeqNum);
+    if (errors[i] && !clientCompleted.second) {
+      clientCompleted.second = errors[i];
+    }
+  }
+
+  // Only advance a client's completed sequence number once all of its
+  // batches in this run (possibly spread over several VRFs) are processed,
+  // and do so before fulfilling any promise so that a caller woken up by a
+  // promise always observes its batch as completed.
+  std::vector<std::pair<folly::Promise<folly::Unit>, folly::exception_wrapper>>
+      waitersDone;
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    for (auto& clientAndCompleted : completed) {
+      auto& client = clients_[clientAndCompleted.first];
+      client.lastCompleted = clientAndCompleted.second.first;
+      auto end = client.waiters.upper_bound(client.lastCompleted);
+      for (auto it = client.waiters.begin(); it != end; ++it) {
+        waitersDone.emplace_back(
+            std::move(it->second), clientAndCompleted.second.second);
+      }
+      client.waiters.erase(client.waiters.begin(), end);
+    }
+  }
+  for (size_t i = 0; i < merged.size(); ++i) {
+    for (auto& promise : merged[i].promises) {
+      waitersDone.emplace_back(std::move(promise), errors[i]);
+    }
+  }
+  for (auto& waiterAndError : waitersDone) {
+    if (waiterAndError.second) {
+      waiterAndError.first.setException(waiterAndError.second);
+    } else {
+      waiterAndError.first.setValue();
+    }
+  }
+}
+
+void RouteUpdateQueue::apply(MergedUpdate* merged) {
+  ScopedUpdateTrace trace("queued route update");
+  std::vector<UnicastRoute> toAdd;
+  std::vector<IpPrefix> toDelete;
+  for (auto& prefixAndRoute : merged->prefixToRoute) {
+    if (prefixAndRoute.second) {
+      toAdd.push_back(std::move(*prefixAndRoute.second));
+    } else {
+      IpPrefix prefix;
+      prefix.ip =
+          facebook::network::toBinaryAddress(prefixAndRoute.first.first);
+      prefix.prefixLength = prefixAndRoute.first.second;
+      toDelete.push_back(std::move(prefix));
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    ++ribUpdateCount_;
+  }
+  auto stats = rib_->update(
+      merged->routerID,
+      merged->clientID,
+      merged->adminDistance,
+      toAdd,
+      toDelete,
+      merged->resetClientsRoutes,
+      "queued route update",
+      fibUpdateCallback_,
+      cookie_);
+
+  if (statsCallback_) {
+    statsCallback_(stats);
+  }
+}
+
+} // namespace facebook::fboss::rib
@@ -0,0 +1,153 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/if/gen-cpp2/ctrl_types.h"
+#include "fboss/agent/rib/RoutingInformationBase.h"
+#include "fboss/agent/types.h"
+
+#include <folly/IPAddress.h>
+#include <folly/futures/Future.h>
+#include <folly/io/async/EventBase.h>
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace facebook::fboss::rib {
+
+/*
+ * RouteUpdateQueue allows route clients to pipeline batches of route
+ * additions and deletions instead of blocking on each batch until it has been
+ * programmed.
+ *
+ * Every enqueued batch is assigned a per-client sequence number and is
+ * applied asynchronously on the queue's own thread. All batches that are
+ * pending by the time that thread runs are coalesced, per (VRF, client), into
+ * a single RoutingInformationBase::update() call. A burst of small batches
+ * therefore costs one route resolution and one FIB programming pass rather
+ * than one per batch.
+ *
+ * Batches from the same client are merged in the order they were enqueued,
+ * so the resulting RIB is the same as if they had been applied one at a time.
+ */
+class RouteUpdateQueue {
+ public:
+  using StatsCallback =
+      std::function<void(const RoutingInformationBase::UpdateStatistics&)>;
+
+  struct Ticket {
+    int64_t seqNum;
+    folly::SemiFuture<folly::Unit> done;
+  };
+
+  RouteUpdateQueue(
+      RoutingInformationBase* rib,
+      RoutingInformationBase::FibUpdateFunction fibUpdateCallback,
+      void* cookie,
+      StatsCallback statsCallback = nullptr);
+  ~RouteUpdateQueue();
+
+  /*
+   * Queue a batch of route changes for clientID in routerID. The returned
+   * future is fulfilled once the batch (possibly merged with others) has been
+   * applied to the RIB and FIB, or holds the exception raised while doing so.
+   */
+  Ticket enqueue(
+      RouterID routerID,
+      ClientID clientID,
+      AdminDistance adminDistanceFromClientID,
+      std::vector<UnicastRoute> toAdd,
+      std::vector<IpPrefix> toDelete,
+      bool resetClientsRoutes);
+
+  /*
+   * Returns a future that completes when every batch of clientID up to and
+   * including seqNum has been processed.
+   */
+  folly::SemiFuture<folly::Unit> waitFor(ClientID clientID, int64_t seqNum);
+
+  int64_t getLastEnqueued(ClientID clientID) const;
+  int64_t getLastCompleted(ClientID clientID) const;
+
+  /*
+   * Number of RoutingInformationBase::update() calls made so far. Exposed so
+   * callers (and tests) can observe how effectively batches are coalesced.
+   */
+  uint64_t getRibUpdateCount() const;
+
+  /*
+   * Stops the queue: a batch already being applied is let finish, the
+   * batches still pending are dropped and their futures, as well as those
+   * of waitFor(), hold an FbossError. Batches enqueued afterwards are
+   * rejected the same way. Called on destruction if not called before.
+   */
+  void stop();
+
+ private:
+  struct PendingBatch {
+    RouterID routerID;
+    ClientID clientID;
+    AdminDistance adminDistance;
+    std::vector<UnicastRoute> toAdd;
+    std::vector<IpPrefix> toDelete;
+    bool resetClientsRoutes;
+    int64_t seqNum;
+    folly::Promise<folly::Unit> promise;
+  };
+
+  /*
+   * The net effect of a run of batches for a single (VRF, client). Each
+   * prefix maps to the route to install, or std::nullopt if it is to be
+   * deleted.
+   */
+  struct MergedUpdate {
+    RouterID routerID;
+    ClientID clientID;
+    AdminDistance adminDistance;
+    bool resetClientsRoutes{false};
+    std::map<folly::CIDRNetwork, std::optional<UnicastRoute>> prefixToRoute;
+    int64_t lastSeqNum{0};
+    std::vector<folly::Promise<folly::Unit>> promises;
+  };
+
+  struct ClientState {
+    int64_t lastEnqueued{0};
+    int64_t lastCompleted{0};
+    std::multimap<int64_t, folly::Promise<folly::Unit>> waiters;
+  };
+
+  static void mergeInto(MergedUpdate* merged, PendingBatch* batch);
+
+  void processPending();
+  void apply(MergedUpdate* merged);
+
+  RoutingInformationBase* rib_;
+  RoutingInformationBase::FibUpdateFunction fibUpdateCallback_;
+  void* cookie_;
+  StatsCallback statsCallback_;
+
+  mutable std::mutex mutex_;
+  std::deque<PendingBatch> pending_;
+  bool processingScheduled_{false};
+  std::map<ClientID, ClientState> clients_;
+  uint64_t ribUpdateCount_{0};
+  bool stopped_{false};
+
+  folly::EventBase evb_;
+  std::unique_ptr<std::thread> thread_;
+};
+
+} // namespace facebook::fboss::rib
@@ -12,12 +12,14 @@
 
 #include "fboss/agent/AddressUtil.h"
 #include "fboss/agent/Constants.h"
+#include "fboss/agent/UpdateTracer.h"
 #include "fboss/agent/rib/ConfigApplier.h"
 #include "fboss/agent/rib/ForwardingInformationBaseUpdater.h"
 #include "fboss/agent/rib/RouteNextHopEntry.h"
 #include "fboss/agent/rib/RouteUpdater.h"
 
 #include <memory>
+#include <optional>
 #include <utility>
 
 namespace {
@@ -127,6 +129,9 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
   RouteUpdater updater(
       &(it->second.v4NetworkToRoute), &(it->second.v6NetworkToRoute));
 
+  std::optional<ScopedTraceSpan> mutationSpan;
+  mutationSpan.emplace("rib_mutation");
+
   if (resetClientsRoutes) {
     updater.removeAllRoutesForClient(clientID);
   }
@@ -160,9 +165,14 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
 
     updater.delRoute(network, mask, clientID);
   }
+  mutationSpan.reset();
 
-  updater.updateDone();
+  {
+    ScopedTraceSpan resolutionSpan("rib_resolution");
+    updater.updateDone();
+  }
 
+  ScopedTraceSpan fibSpan("fib_update");
   fibUpdateCallback(
       routerID,
       it->second.v4NetworkToRoute,
@@ -0,0 +1,248 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/AddressUtil.h"
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/if/gen-cpp2/ctrl_types.h"
+#include "fboss/agent/rib/RouteUpdateQueue.h"
+#include "fboss/agent/rib/RoutingInformationBase.h"
+
+#include <folly/IPAddress.h>
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+
+using namespace facebook::fboss;
+using facebook::fboss::rib::RouteUpdateQueue;
+using facebook::fboss::rib::RoutingInformationBase;
+
+namespace {
+
+const RouterID kVrf(0);
+const ClientID kClient = ClientID::BGPD;
+const AdminDistance kAdminDistance = AdminDistance::EBGP;
+
+IpPrefix makePrefix(const std::string& ip, int16_t length) {
+  IpPrefix prefix;
+  prefix.ip = facebook::network::toBinaryAddress(folly::IPAddress(ip));
+  prefix.prefixLength = length;
+  return prefix;
+}
+
+UnicastRoute makeDropRoute(const std::string& ip, int16_t length) {
+  UnicastRoute route;
+  route.dest = makePrefix(ip, length);
+  return route;
+}
+
+std::set<std::string> ribPrefixes(const RoutingInformationBase& rib) {
+  std::set<std::string> prefixes;
+  for (const auto& details : rib.getRouteTableDetails(kVrf)) {
+    prefixes.insert(folly::to<std::string>(
+        facebook::network::toIPAddress(details.dest.ip).str(),
+        "/",
+        details.dest.prefixLength));
+  }
+  return prefixes;
+}
+
+struct FibUpdateTracker {
+  std::atomic<int> count{0};
+  folly::Baton<> firstUpdateStarted;
+  folly::Baton<> unblockFirstUpdate;
+  bool blockFirstUpdate{false};
+};
+
+void trackingFibUpdate(
+    RouterID /*vrf*/,
+    const rib::IPv4NetworkToRouteMap& /*v4NetworkToRoute*/,
+    const rib::IPv6NetworkToRouteMap& /*v6NetworkToRoute*/,
+    void* cookie) {
+  auto tracker = static_cast<FibUpdateTracker*>(cookie);
+  if (tracker->count++ == 0 && tracker->blockFirstUpdate) {
+    tracker->firstUpdateStarted.post();
+    tracker->unblockFirstUpdate.wait();
+  }
+}
+
+} // namespace
+
+TEST(RouteUpdateQueue, SingleBatch) {
+  RoutingInformationBase rib;
+  rib.createVrf(kVrf);
+  FibUpdateTracker tracker;
+  RouteUpdateQueue queue(&rib, &trackingFibUpdate, &tracker);
+
+  auto ticket = queue.enqueue(
+      kVrf,
+      kClient,
+      kAdminDistance,
+      {makeDropRoute("10.0.0.0", 24), makeDropRoute("2001::", 64)},
+      {},
+      false);
+  EXPECT_EQ(1, ticket.seqNum);
+  std::move(ticket.done).get();
+
+  EXPECT_EQ(1, queue.getLastCompleted(kClient));
+  EXPECT_EQ(1, tracker.count.load());
+  EXPECT_EQ(
+      (std::set<std::string>{"10.0.0.0/24", "2001::/64"}), ribPrefixes(rib));
+}
+
+TEST(RouteUpdateQueue, PipelinedBatchesAreCoalescedInOrder) {
+  RoutingInformationBase rib;
+  rib.createVrf(kVrf);
+  FibUpdateTracker tracker;
+  tracker.blockFirstUpdate = true;
+  RouteUpdateQueue queue(&rib, &trackingFibUpdate, &tracker);
+
+  queue.enqueue(
+      kVrf, kClient, kAdminDistance, {makeDropRoute("1.0.0.0", 8)}, {}, false);
+  tracker.firstUpdateStarted.wait();
+
+  // While the first update is being programmed, pipeline several more
+  // batches, including an add followed by a delete of the same prefix.
+  queue.enqueue(
+      kVrf, kClient, kAdminDistance, {makeDropRoute("2.0.0.0", 8)}, {}, false);
+  queue.enqueue(
+      kVrf, kClient, kAdminDistance, {makeDropRoute("3.0.0.0", 8)}, {}, false);
+  queue.enqueue(
+      kVrf, kClient, kAdminDistance, {}, {makePrefix("2.0.0.0", 8)}, false);
+  auto last = queue.enqueue(
+      kVrf, kClient, kAdminDistance, {makeDropRoute("4.0.0.0", 8)}, {}, false);
+  EXPECT_EQ(5, last.seqNum);
+  EXPECT_EQ(5, queue.getLastEnqueued(kClient));
+
+  auto waited = queue.waitFor(kClient, 4);
+  tracker.unblockFirstUpdate.post();
+  std::move(waited).get();
+  std::move(last.done).get();
+
+  // One RIB update for the first batch, one for the other four
+  EXPECT_EQ(2, queue.getRibUpdateCount());
+  EXPECT_EQ(2, tracker.count.load());
+  EXPECT_EQ(5, queue.getLastCompleted(kClient));
+  EXPECT_EQ(
+      (std::set<std::string>{"1.0.0.0/8", "3.0.0.0/8", "4.0.0.0/8"}),
+      ribPrefixes(rib));
+}
+
+TEST(RouteUpdateQueue, SyncSupersedesEarlierBatches) {
+  RoutingInformationBase rib;
+  rib.createVrf(kVrf);
+  FibUpdateTracker tracker;
+  tracker.blockFirstUpdate = true;
+  RouteUpdateQueue queue(&rib, &trackingFibUpdate, &tracker);
+
+  queue.enqueue(
+      kVrf, kClient, kAdminDistance, {makeDropRoute("1.0.0.0", 8)}, {}, false);
+  tracker.firstUpdateStarted.wait();
+  queue.enqueue(
+      kVrf, kClient, kAdminDistance, {makeDropRoute("2.0.0.0", 8)}, {}, false);
+  auto sync = queue.enqueue(
+      kVrf, kClient, kAdminDistance, {makeDropRoute("3.0.0.0", 8)}, {}, true);
+  tracker.unblockFirstUpdate.post();
+  std::move(sync.done).get();
+
+  EXPECT_EQ((std::set<std::string>{"3.0.0.0/8"}), ribPrefixes(rib));
+}
+
+TEST(RouteUpdateQueue, FailuresArePropagated) {
+  RoutingInformationBase rib;
+  rib.createVrf(kVrf);
+  FibUpdateTracker tracker;
+  RouteUpdateQueue queue(&rib, &trackingFibUpdate, &tracker);
+
+  // VRF 1 is not configured
+  auto ticket = queue.enqueue(
+      RouterID(1),
+      kClient,
+      kAdminDistance,
+      {makeDropRoute("10.0.0.0", 24)},
+      {},
+      false);
+  EXPECT_THROW(std::move(ticket.done).get(), FbossError);
+  EXPECT_EQ(1, queue.getLastCompleted(kClient));
+}
+
+TEST(RouteUpdateQueue, WaitForUnknownSeqNum) {
+  RoutingInformationBase rib;
+  rib.createVrf(kVrf);
+  FibUpdateTracker tracker;
+  RouteUpdateQueue queue(&rib, &trackingFibUpdate, &tracker);
+
+  EXPECT_THROW(queue.waitFor(kClient, 1).get(), FbossError);
+  // Nothing outstanding means nothing to wait for
+  queue.waitFor(kClient, 0).get();
+}
+
+TEST(RouteUpdateQueue, PrefixesAreMaskedWhenMerging) {
+  RoutingInformationBase rib;
+  rib.createVrf(kVrf);
+  FibUpdateTracker tracker;
+  tracker.blockFirstUpdate = true;
+  RouteUpdateQueue queue(&rib, &trackingFibUpdate, &tracker);
+
+  queue.enqueue(
+      kVrf, kClient, kAdminDistance, {makeDropRoute("1.0.0.0", 8)}, {}, false);
+  tracker.firstUpdateStarted.wait();
+  // Host bits set on the add, not on the delete: same route
+  queue.enqueue(
+      kVrf,
+      kClient,
+      kAdminDistance,
+      {makeDropRoute("10.0.0.1", 24)},
+      {},
+      false);
+  auto last = queue.enqueue(
+      kVrf, kClient, kAdminDistance, {}, {makePrefix("10.0.0.0", 24)}, false);
+  tracker.unblockFirstUpdate.post();
+  std::move(last.done).get();
+
+  EXPECT_EQ((std::set<std::string>{"1.0.0.0/8"}), ribPrefixes(rib));
+}
+
+TEST(RouteUpdateQueue, StopDropsPendingBatches) {
+  RoutingInformationBase rib;
+  rib.createVrf(kVrf);
+  FibUpdateTracker tracker;
+  tracker.blockFirstUpdate = true;
+  RouteUpdateQueue queue(&rib, &trackingFibUpdate, &tracker);
+
+  auto first = queue.enqueue(
+      kVrf, kClient, kAdminDistance, {makeDropRoute("1.0.0.0", 8)}, {}, false);
+  tracker.firstUpdateStarted.wait();
+  auto pending = queue.enqueue(
+      kVrf, kClient, kAdminDistance, {makeDropRoute("2.0.0.0", 8)}, {}, false);
+  auto waited = queue.waitFor(kClient, pending.seqNum);
+
+  std::thread stopper([&queue] { queue.stop(); });
+  // Once stopped, waiting for the pending batch fails right away
+  while (!queue.waitFor(kClient, pending.seqNum).isReady()) {
+    std::this_thread::yield();
+  }
+  tracker.unblockFirstUpdate.post();
+  stopper.join();
+
+  // The batch being applied completes, the pending one is dropped
+  std::move(first.done).get();
+  EXPECT_THROW(std::move(pending.done).get(), FbossError);
+  EXPECT_THROW(std::move(waited).get(), FbossError);
+  EXPECT_EQ(1, queue.getLastCompleted(kClient));
+  EXPECT_EQ((std::set<std::string>{"1.0.0.0/8"}), ribPrefixes(rib));
+
+  auto rejected = queue.enqueue(
+      kVrf, kClient, kAdminDistance, {makeDropRoute("3.0.0.0", 8)}, {}, false);
+  EXPECT_THROW(std::move(rejected.done).get(), FbossError);
+  EXPECT_EQ(1, tracker.count.load());
+}
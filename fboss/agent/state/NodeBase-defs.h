@@ -12,6 +12,7 @@
 #include "NodeBase.h"
 
 #include <memory>
+#include <type_traits>
 
 namespace facebook::fboss {
 
@@ -29,4 +30,44 @@ void NodeBaseT<NodeT, FieldsT>::publish() {
   NodeBase::publish();
 }
 
+namespace detail {
+
+// Node objects are created with make_shared()/allocate_shared(), so the
+// shared_ptr control block lives in the same allocation as the node.
+constexpr size_t kNodeControlBlockBytes = 2 * sizeof(void*);
+
+template <typename FieldsT, typename = void>
+struct HasDynamicMemoryUsage : std::false_type {};
+
+template <typename FieldsT>
+struct HasDynamicMemoryUsage<
+    FieldsT,
+    std::void_t<decltype(std::declval<const FieldsT&>().dynamicMemoryUsage())>>
+    : std::true_type {};
+
+} // namespace detail
+
+template <typename NodeT, typename FieldsT>
+size_t NodeBaseT<NodeT, FieldsT>::getMemoryUsage() const {
+  // Fields may optionally provide dynamicMemoryUsage() to account for heap
+  // storage (e.g. containers) they own.
+  size_t bytes = sizeof(NodeT) + detail::kNodeControlBlockBytes;
+  if constexpr (detail::HasDynamicMemoryUsage<FieldsT>::value) {
+    bytes += fields_.dynamicMemoryUsage();
+  }
+  return bytes;
+}
+
+template <typename NodeT, typename FieldsT>
+void NodeBaseT<NodeT, FieldsT>::forEachChildNode(
+    folly::FunctionRef<void(const NodeBase*)> fn) const {
+  // forEachChild() is only provided as a non-const method since it is used
+  // for publish(), but we only read the children here.
+  const_cast<FieldsT&>(fields_).forEachChild([&fn](const NodeBase* child) {
+    if (child) {
+      fn(child);
+    }
+  });
+}
+
 } // namespace facebook::fboss
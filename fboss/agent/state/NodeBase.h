@@ -18,6 +18,7 @@
 #include <memory>
 #include <type_traits>
 
+#include <folly/Function.h>
 #include <folly/dynamic.h>
 #include <folly/json.h>
 
@@ -113,6 +114,18 @@ class NodeBase {
     return nodeID_;
   }
 
+  /*
+   * Memory accounting hooks, used by StateMemoryUsage to walk the state tree.
+   *
+   * getMemoryUsage() returns an estimate of the bytes owned by this node
+   * itself: the node object and any heap storage held by its fields, but
+   * not its children nodes.  forEachChildNode() calls fn on every child node
+   * referenced by this node.
+   */
+  virtual size_t getMemoryUsage() const = 0;
+  virtual void forEachChildNode(
+      folly::FunctionRef<void(const NodeBase*)> fn) const = 0;
+
  protected:
   NodeBase();
   NodeBase(NodeID id, uint32_t generation)
@@ -199,6 +212,10 @@ class NodeBaseT : public NodeBase {
 
   void publish() override;
 
+  size_t getMemoryUsage() const override;
+  void forEachChildNode(
+      folly::FunctionRef<void(const NodeBase*)> fn) const override;
+
   const Fields* getFields() const {
     return &fields_;
   }
@@ -40,6 +40,10 @@ struct NodeMapFields {
     extra.forEachChild(fn);
   }
 
+  size_t dynamicMemoryUsage() const {
+    return nodes.capacity() * sizeof(typename NodeContainer::value_type);
+  }
+
   NodeContainer nodes;
   ExtraFields extra;
 };
@@ -245,6 +245,16 @@ Port* Port::modify(std::shared_ptr<SwitchState>* state) {
   return ptr;
 }
 
+void Port::forEachChildNode(
+    folly::FunctionRef<void(const NodeBase*)> fn) const {
+  NodeBaseT::forEachChildNode(fn);
+  // Port queues are not published along with the port (PortFields has no
+  // children), but they are still owned by it.
+  for (const auto& queue : getFields()->queues) {
+    fn(queue.get());
+  }
+}
+
 template class NodeBaseT<Port, PortFields>;
 
 } // namespace facebook::fboss
@@ -206,6 +206,9 @@ class Port : public ThriftyBaseT<state::PortFields, Port, PortFields> {
     writableFields()->queues.swap(queues);
   }
 
+  void forEachChildNode(
+      folly::FunctionRef<void(const NodeBase*)> fn) const override;
+
   VlanID getIngressVlan() const {
     return getFields()->ingressVlan;
   }
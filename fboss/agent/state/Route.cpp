@@ -43,7 +43,8 @@ RouteFields<AddrT>::RouteFields(
 template <typename AddrT>
 bool RouteFields<AddrT>::operator==(const RouteFields& rf) const {
   return (
-      flags == rf.flags && prefix == rf.prefix &&
+      (flags & kRouteFlagsMask) == (rf.flags & kRouteFlagsMask) &&
+      prefix == rf.prefix &&
       nexthopsmulti == rf.nexthopsmulti && fwd == rf.fwd);
 }
 
@@ -54,10 +55,10 @@ folly::dynamic Route<AddrT>::toFollyDynamic() const {
   routeFields[kNextHopsMulti] =
       RouteBase::getFields()->nexthopsmulti.toFollyDynamic();
   routeFields[kFwdInfo] = RouteBase::getFields()->fwd.toFollyDynamic();
-  routeFields[kFlags] = RouteBase::getFields()->flags;
-  if (RouteBase::getFields()->classID.has_value()) {
-    routeFields[kClassID] =
-        static_cast<int>(RouteBase::getFields()->classID.value());
+  routeFields[kFlags] =
+      RouteBase::getFields()->flags & RouteFields<AddrT>::kRouteFlagsMask;
+  if (auto classID = getClassID()) {
+    routeFields[kClassID] = static_cast<int>(classID.value());
   }
 
   return routeFields;
@@ -70,9 +71,9 @@ std::shared_ptr<Route<AddrT>> Route<AddrT>::fromFollyDynamic(
   rt.nexthopsmulti =
       RouteNextHopsMulti::fromFollyDynamic(routeJson[kNextHopsMulti]);
   rt.fwd = RouteNextHopEntry::fromFollyDynamic(routeJson[kFwdInfo]);
-  rt.flags = routeJson[kFlags].asInt();
+  rt.flags = routeJson[kFlags].asInt() & RouteFields<AddrT>::kRouteFlagsMask;
   if (routeJson.find(kClassID) != routeJson.items().end()) {
-    rt.classID = cfg::AclLookupClass(routeJson[kClassID].asInt());
+    rt.setClassID(cfg::AclLookupClass(routeJson[kClassID].asInt()));
   }
 
   auto route = std::make_shared<Route<AddrT>>(rt);
@@ -143,7 +144,7 @@ void Route<AddrT>::update(ClientID clientId, RouteNextHopEntry entry) {
 
 template <typename AddrT>
 void Route<AddrT>::updateClassID(std::optional<cfg::AclLookupClass> classID) {
-  RouteBase::writableFields()->classID = classID;
+  RouteBase::writableFields()->setClassID(classID);
 }
 
 template <typename AddrT>
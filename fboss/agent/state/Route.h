@@ -51,6 +51,33 @@ struct RouteFields {
 
   RouteDetails toRouteDetails() const;
 
+  size_t dynamicMemoryUsage() const {
+    return nexthopsmulti.dynamicMemoryUsage() + fwd.dynamicMemoryUsage();
+  }
+
+  std::optional<cfg::AclLookupClass> getClassID() const {
+    if (!(flags & kClassIDValid)) {
+      return std::nullopt;
+    }
+    return static_cast<cfg::AclLookupClass>(flags >> kClassIDShift);
+  }
+  void setClassID(std::optional<cfg::AclLookupClass> classID) {
+    flags &= kRouteFlagsMask;
+    if (classID) {
+      auto value = static_cast<uint32_t>(*classID);
+      CHECK_LE(value, UINT32_MAX >> kClassIDShift);
+      flags |= kClassIDValid | (value << kClassIDShift);
+    }
+  }
+
+  /*
+   * The Route<> flags live in the low byte of flags, the optional ACL lookup
+   * class is packed in the upper bits to keep routes small.
+   */
+  static constexpr uint32_t kRouteFlagsMask = 0xff;
+  static constexpr uint32_t kClassIDValid = 0x100;
+  static constexpr uint32_t kClassIDShift = 16;
+
   Prefix prefix;
   // The following fields will not be copied during clone()
   /*
@@ -61,7 +88,6 @@ struct RouteFields {
   RouteNextHopEntry fwd{RouteNextHopEntry::Action::DROP,
                         AdminDistance::MAX_ADMIN_DISTANCE};
   uint32_t flags{0};
-  std::optional<cfg::AclLookupClass> classID{std::nullopt};
 };
 
 /// Route<> Class
@@ -175,7 +201,7 @@ class Route : public NodeBaseT<Route<AddrT>, RouteFields<AddrT>> {
   void delEntryForClient(ClientID clientId);
 
   std::optional<cfg::AclLookupClass> getClassID() const {
-    return RouteBase::getFields()->classID;
+    return RouteBase::getFields()->getClassID();
   }
 
  private:
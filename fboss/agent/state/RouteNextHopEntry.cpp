@@ -11,14 +11,108 @@
 
 #include "fboss/agent/FbossError.h"
 
+#include <folly/Indestructible.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <folly/hash/Hash.h>
 #include <folly/logging/xlog.h>
 #include <gflags/gflags.h>
+#include <algorithm>
 #include <numeric>
+#include <vector>
 
 namespace {
 constexpr auto kNexthops = "nexthops";
 constexpr auto kAction = "action";
 constexpr auto kAdminDistance = "adminDistance";
+
+using facebook::fboss::RouteNextHopEntry;
+using NextHopSet = RouteNextHopEntry::NextHopSet;
+
+uint64_t hashNextHops(const NextHopSet& nhops) {
+  uint64_t hash = nhops.size();
+  for (const auto& nhop : nhops) {
+    auto intf = nhop.intfID();
+    hash = folly::hash::hash_128_to_64(
+        hash, std::hash<folly::IPAddress>()(nhop.addr()));
+    hash = folly::hash::hash_128_to_64(hash, nhop.weight());
+    hash = folly::hash::hash_128_to_64(
+        hash, intf ? static_cast<uint64_t>(*intf) + 1 : 0);
+  }
+  return hash;
+}
+
+/*
+ * Table of all next hop sets in use, so that identical sets are only stored
+ * once. The table only holds weak references, a set is removed from it when
+ * the last entry using it goes away.
+ */
+class NextHopSetInterner {
+ public:
+  static NextHopSetInterner* get() {
+    // Routes may outlive static destruction, so never destroy the table
+    static folly::Indestructible<NextHopSetInterner> interner;
+    return interner.get();
+  }
+
+  std::shared_ptr<const NextHopSet> intern(NextHopSet nhops) {
+    auto hash = hashNextHops(nhops);
+    // Sets that are looked at but don't match are only released once the
+    // lock is dropped, since releasing the last reference to a set calls
+    // back into release().
+    std::vector<std::shared_ptr<const NextHopSet>> candidates;
+    auto sets = sets_.wlock();
+    auto& bucket = (*sets)[hash];
+    for (const auto& weakSet : bucket) {
+      auto candidate = weakSet.lock();
+      if (candidate && *candidate == nhops) {
+        return candidate;
+      }
+      candidates.push_back(std::move(candidate));
+    }
+    std::shared_ptr<const NextHopSet> interned(
+        new NextHopSet(std::move(nhops)), [hash](const NextHopSet* set) {
+          NextHopSetInterner::get()->release(hash);
+          delete set;
+        });
+    bucket.push_back(interned);
+    return interned;
+  }
+
+  size_t size() const {
+    size_t count = 0;
+    auto sets = sets_.rlock();
+    for (const auto& bucket : *sets) {
+      count += bucket.second.size();
+    }
+    return count;
+  }
+
+ private:
+  void release(uint64_t hash) {
+    auto sets = sets_.wlock();
+    auto it = sets->find(hash);
+    if (it == sets->end()) {
+      return;
+    }
+    auto& bucket = it->second;
+    bucket.erase(
+        std::remove_if(
+            bucket.begin(),
+            bucket.end(),
+            [](const auto& weakSet) { return weakSet.expired(); }),
+        bucket.end());
+    if (bucket.empty()) {
+      sets->erase(it);
+    }
+  }
+
+  folly::Synchronized<folly::F14FastMap<
+      uint64_t,
+      std::vector<std::weak_ptr<const NextHopSet>>>>
+      sets_;
+};
+
 } // namespace
 
 namespace facebook::fboss {
@@ -46,12 +140,35 @@ std::vector<NextHopThrift> fromRouteNextHopSet(RouteNextHopSet const& nhs) {
 } // namespace util
 
 RouteNextHopEntry::RouteNextHopEntry(NextHopSet nhopSet, AdminDistance distance)
-    : adminDistance_(distance),
-      action_(Action::NEXTHOPS),
-      nhopSet_(std::move(nhopSet)) {
-  if (nhopSet_.size() == 0) {
+    : adminDistance_(distance), action_(Action::NEXTHOPS) {
+  if (nhopSet.size() == 0) {
     throw FbossError("Empty nexthop set is passed to the RouteNextHopEntry");
   }
+  nhopSet_ = NextHopSetInterner::get()->intern(std::move(nhopSet));
+}
+
+RouteNextHopEntry::RouteNextHopEntry(NextHop nhop, AdminDistance distance)
+    : adminDistance_(distance), action_(Action::NEXTHOPS) {
+  NextHopSet nhops;
+  nhops.emplace(std::move(nhop));
+  nhopSet_ = NextHopSetInterner::get()->intern(std::move(nhops));
+}
+
+const RouteNextHopEntry::NextHopSet& RouteNextHopEntry::emptyNextHopSet() {
+  static const folly::Indestructible<NextHopSet> kEmpty;
+  return *kEmpty;
+}
+
+size_t RouteNextHopEntry::dynamicMemoryUsage() const {
+  if (!nhopSet_) {
+    return 0;
+  }
+  auto setBytes = sizeof(NextHopSet) + nhopSet_->capacity() * sizeof(NextHop);
+  return setBytes / nhopSet_.use_count();
+}
+
+size_t RouteNextHopEntry::getInternedNextHopSetCount() {
+  return NextHopSetInterner::get()->size();
 }
 
 NextHopWeight RouteNextHopEntry::getTotalWeight() const {
@@ -82,7 +199,9 @@ std::string RouteNextHopEntry::str() const {
 bool operator==(const RouteNextHopEntry& a, const RouteNextHopEntry& b) {
   return (
       a.getAction() == b.getAction() and
-      a.getNextHopSet() == b.getNextHopSet() and
+      // Interned sets with the same next hops are the same object
+      (&a.getNextHopSet() == &b.getNextHopSet() ||
+       a.getNextHopSet() == b.getNextHopSet()) and
       a.getAdminDistance() == b.getAdminDistance());
 }
 
@@ -131,7 +250,7 @@ folly::dynamic RouteNextHopEntry::toFollyDynamic() const {
   folly::dynamic entry = folly::dynamic::object;
   entry[kAction] = forwardActionStr(action_);
   folly::dynamic nhops = folly::dynamic::array;
-  for (const auto& nhop : nhopSet_) {
+  for (const auto& nhop : getNextHopSet()) {
     nhops.push_back(nhop.toFollyDynamic());
   }
   entry[kNexthops] = std::move(nhops);
@@ -148,8 +267,12 @@ RouteNextHopEntry RouteNextHopEntry::fromFollyDynamic(
       : AdminDistance(entryJson[kAdminDistance].asInt());
   RouteNextHopEntry entry(Action::DROP, adminDistance);
   entry.action_ = action;
+  NextHopSet nhops;
   for (const auto& nhop : entryJson[kNexthops]) {
-    entry.nhopSet_.insert(util::nextHopFromFollyDynamic(nhop));
+    nhops.insert(util::nextHopFromFollyDynamic(nhop));
+  }
+  if (!nhops.empty()) {
+    entry.nhopSet_ = NextHopSetInterner::get()->intern(std::move(nhops));
   }
   return entry;
 }
@@ -158,7 +281,7 @@ bool RouteNextHopEntry::isValid(bool forMplsRoute) const {
   bool valid = true;
   if (!forMplsRoute) {
     /* for ip2mpls routes, next hop label forwarding action must be push */
-    for (const auto& nexthop : nhopSet_) {
+    for (const auto& nexthop : getNextHopSet()) {
       if (action_ != Action::NEXTHOPS) {
         continue;
       }
@@ -13,6 +13,8 @@
 
 #include <folly/dynamic.h>
 
+#include <memory>
+
 #include "fboss/agent/state/RouteNextHop.h"
 #include "fboss/agent/state/RouteTypes.h"
 
@@ -32,10 +34,7 @@ class RouteNextHopEntry {
 
   RouteNextHopEntry(NextHopSet nhopSet, AdminDistance distance);
 
-  RouteNextHopEntry(NextHop nhop, AdminDistance distance)
-      : adminDistance_(distance), action_(Action::NEXTHOPS) {
-    nhopSet_.emplace(std::move(nhop));
-  }
+  RouteNextHopEntry(NextHop nhop, AdminDistance distance);
 
   AdminDistance getAdminDistance() const {
     return adminDistance_;
@@ -46,7 +45,7 @@ class RouteNextHopEntry {
   }
 
   const NextHopSet& getNextHopSet() const {
-    return nhopSet_;
+    return nhopSet_ ? *nhopSet_ : emptyNextHopSet();
   }
 
   NextHopSet normalizedNextHops() const;
@@ -79,16 +78,30 @@ class RouteNextHopEntry {
 
   // Reset the NextHopSet
   void reset() {
-    nhopSet_.clear();
+    nhopSet_.reset();
     action_ = Action::DROP;
   }
 
   bool isValid(bool forMplsRoute = false) const;
 
+  // Heap storage held by this entry, for memory accounting. Next hop sets
+  // are shared, so each entry is charged its share of the set.
+  size_t dynamicMemoryUsage() const;
+
+  // Number of distinct next hop sets currently in use
+  static size_t getInternedNextHopSetCount();
+
  private:
+  static const NextHopSet& emptyNextHopSet();
+
   AdminDistance adminDistance_;
   Action action_{Action::DROP};
-  NextHopSet nhopSet_;
+  /*
+   * Next hop sets are interned: all entries with the same next hops (e.g.
+   * the many routes pointing to the same ECMP group) share a single
+   * immutable set. nullptr stands for the empty set.
+   */
+  std::shared_ptr<const NextHopSet> nhopSet_;
 };
 
 /**
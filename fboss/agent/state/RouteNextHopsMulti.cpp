@@ -140,6 +140,16 @@ bool RouteNextHopsMulti::isSame(ClientID id, const RouteNextHopEntry& nhe)
   return entry && (*entry == nhe);
 }
 
+size_t RouteNextHopsMulti::dynamicMemoryUsage() const {
+  // The first entry is stored inline
+  size_t bytes =
+      map_.capacity() > 1 ? map_.capacity() * sizeof(ClientEntry) : 0;
+  for (const auto& clientAndEntry : map_) {
+    bytes += clientAndEntry.second.dynamicMemoryUsage();
+  }
+  return bytes;
+}
+
 std::pair<ClientID, const RouteNextHopEntry*> RouteNextHopsMulti::getBestEntry()
     const {
   auto entry = getEntryForClient(lowestAdminDistanceClientId_);
@@ -13,7 +13,8 @@
 #include <folly/IPAddress.h>
 #include <folly/dynamic.h>
 
-#include <boost/container/flat_map.hpp>
+#include <folly/small_vector.h>
+#include <folly/sorted_vector_types.h>
 
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 #include "fboss/agent/state/RouteNextHopEntry.h"
@@ -44,8 +45,19 @@ namespace facebook::fboss {
  */
 class RouteNextHopsMulti {
  protected:
+  // Almost all routes come from a single client, so keep one entry inline
+  // rather than allocating a separate map per route.
+  using ClientEntry = std::pair<ClientID, RouteNextHopEntry>;
+  using ClientEntries = folly::sorted_vector_map<
+      ClientID,
+      RouteNextHopEntry,
+      std::less<ClientID>,
+      std::allocator<ClientEntry>,
+      void,
+      folly::small_vector<ClientEntry, 1>>;
+
   ClientID findLowestAdminDistance();
-  boost::container::flat_map<ClientID, RouteNextHopEntry> map_;
+  ClientEntries map_;
   ClientID lowestAdminDistanceClientId_;
 
  public:
@@ -79,6 +91,9 @@ class RouteNextHopsMulti {
   std::pair<ClientID, const RouteNextHopEntry*> getBestEntry() const;
 
   bool isSame(ClientID clientId, const RouteNextHopEntry& nhe) const;
+
+  // Heap storage held by this object, for memory accounting
+  size_t dynamicMemoryUsage() const;
 };
 
 } // namespace facebook::fboss
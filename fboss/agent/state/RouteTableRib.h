@@ -103,6 +103,23 @@ class RouteTableRib : public NodeBase {
     NodeBase::publish();
   }
 
+  size_t getMemoryUsage() const override {
+    // Only tree nodes holding a route are accounted for, the (at most
+    // size() - 1) internal nodes created by the radix tree are not.
+    return sizeof(*this) +
+        radixTree_.size() * sizeof(typename RoutesRadixTree::TreeNode);
+  }
+
+  void forEachChildNode(
+      folly::FunctionRef<void(const NodeBase*)> fn) const override {
+    fn(nodeMap_.get());
+    // Routes in radixTree_ are usually the ones in nodeMap_, but may be
+    // clones of them, see cloneToRadixTreeWithForwardClear().
+    for (auto itr = radixTree_.begin(); itr != radixTree_.end(); ++itr) {
+      fn(itr->value().get());
+    }
+  }
+
   RouteTableRib* modify(RouterID id, std::shared_ptr<SwitchState>* state);
 
   std::shared_ptr<RouteTableRib> clone() const {
@@ -0,0 +1,156 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/state/StateMemoryUsage.h"
+
+#include "fboss/agent/state/NodeBase.h"
+#include "fboss/agent/state/SwitchState.h"
+
+#include <folly/Demangle.h>
+#include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
+
+#include <typeindex>
+#include <vector>
+
+namespace {
+constexpr folly::StringPiece kNamespacePrefix = "facebook::fboss::";
+
+using facebook::fboss::NodeBase;
+using facebook::fboss::NodeMemoryUsage;
+using facebook::fboss::StateMemoryUsage;
+using NodeSet = folly::F14FastSet<const NodeBase*>;
+
+void collectNodes(const NodeBase* node, NodeSet* nodes) {
+  if (!nodes->insert(node).second) {
+    return;
+  }
+  node->forEachChildNode(
+      [nodes](const NodeBase* child) { collectNodes(child, nodes); });
+}
+
+class MemoryWalker {
+ public:
+  explicit MemoryWalker(const NodeSet* otherNodes) : otherNodes_(otherNodes) {}
+
+  void walk(
+      const NodeBase* node,
+      NodeMemoryUsage* subtree,
+      std::map<std::string, NodeMemoryUsage>* byNodeType) {
+    if (!visited_.insert(node).second) {
+      return;
+    }
+    NodeMemoryUsage usage;
+    usage.nodes = 1;
+    usage.bytes = node->getMemoryUsage();
+    if (otherNodes_ && otherNodes_->count(node)) {
+      usage.sharedNodes = 1;
+      usage.sharedBytes = usage.bytes;
+    }
+    *subtree += usage;
+    (*byNodeType)[typeName(node)] += usage;
+    node->forEachChildNode([&](const NodeBase* child) {
+      walk(child, subtree, byNodeType);
+    });
+  }
+
+  const std::string& typeName(const NodeBase* node) {
+    std::type_index type(typeid(*node));
+    auto it = typeNames_.find(type);
+    if (it == typeNames_.end()) {
+      it = typeNames_.emplace(type, StateMemoryUsage::nodeTypeName(node)).first;
+    }
+    return it->second;
+  }
+
+ private:
+  const NodeSet* otherNodes_;
+  NodeSet visited_;
+  // Demangling is expensive, so do it once per type
+  folly::F14FastMap<std::type_index, std::string> typeNames_;
+};
+
+} // namespace
+
+namespace facebook::fboss {
+
+NodeMemoryUsage& NodeMemoryUsage::operator+=(const NodeMemoryUsage& other) {
+  nodes += other.nodes;
+  bytes += other.bytes;
+  sharedNodes += other.sharedNodes;
+  sharedBytes += other.sharedBytes;
+  return *this;
+}
+
+StateMemoryUsage StateMemoryUsage::compute(
+    const std::shared_ptr<SwitchState>& state,
+    const std::shared_ptr<SwitchState>& other) {
+  return compute(state.get(), other.get());
+}
+
+StateMemoryUsage StateMemoryUsage::compute(
+    const NodeBase* root,
+    const NodeBase* other) {
+  StateMemoryUsage result;
+  if (!root) {
+    return result;
+  }
+
+  NodeSet otherNodes;
+  if (other) {
+    collectNodes(other, &otherNodes);
+  }
+  MemoryWalker walker(other ? &otherNodes : nullptr);
+
+  // The root itself is accounted for under its own name, each of its
+  // children makes up a subtree.
+  auto rootName = walker.typeName(root);
+  NodeMemoryUsage rootUsage;
+  rootUsage.nodes = 1;
+  rootUsage.bytes = root->getMemoryUsage();
+  if (otherNodes.count(root)) {
+    rootUsage.sharedNodes = 1;
+    rootUsage.sharedBytes = rootUsage.bytes;
+  }
+  result.bySubtree_[rootName] += rootUsage;
+  result.byNodeType_[rootName] += rootUsage;
+
+  std::vector<const NodeBase*> children;
+  root->forEachChildNode(
+      [&children](const NodeBase* child) { children.push_back(child); });
+  for (const auto* child : children) {
+    auto& subtree = result.bySubtree_[walker.typeName(child)];
+    walker.walk(child, &subtree, &result.byNodeType_);
+  }
+
+  for (const auto& subtree : result.bySubtree_) {
+    result.total_ += subtree.second;
+  }
+  return result;
+}
+
+std::string StateMemoryUsage::nodeTypeName(const NodeBase* node) {
+  auto name = folly::demangle(typeid(*node));
+  std::string result;
+  result.reserve(name.size());
+  // Strip the namespace everywhere, including in template arguments
+  folly::StringPiece remaining(name);
+  while (!remaining.empty()) {
+    auto pos = remaining.find(kNamespacePrefix);
+    if (pos == folly::StringPiece::npos) {
+      result.append(remaining.begin(), remaining.end());
+      break;
+    }
+    result.append(remaining.begin(), remaining.begin() + pos);
+    remaining.advance(pos + kNamespacePrefix.size());
+  }
+  return result;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace facebook::fboss {
+
+class NodeBase;
+class SwitchState;
+
+struct NodeMemoryUsage {
+  uint64_t nodes{0};
+  uint64_t bytes{0};
+  // Nodes (and their bytes) also referenced by the state we compared against
+  uint64_t sharedNodes{0};
+  uint64_t sharedBytes{0};
+
+  uint64_t uniqueBytes() const {
+    return bytes - sharedBytes;
+  }
+
+  NodeMemoryUsage& operator+=(const NodeMemoryUsage& other);
+};
+
+/*
+ * Memory footprint of a SwitchState tree.
+ *
+ * The tree is walked via NodeBase::forEachChildNode(), with the bytes of
+ * every node estimated by NodeBase::getMemoryUsage().  Nodes referenced from
+ * several places (e.g. shared copy-on-write nodes) are only counted once.
+ *
+ * Usage is broken down both by subtree, i.e. the top level SwitchState
+ * children (PortMap, VlanMap, RouteTableMap, AclMap, ...), and by node type
+ * (Route<folly::IPAddressV4>, ArpEntry, MacEntry, PortQueue, ...).
+ *
+ * When computed against another state, e.g. the applied vs. desired states,
+ * nodes reachable from both are reported as shared.
+ */
+class StateMemoryUsage {
+ public:
+  static StateMemoryUsage compute(
+      const std::shared_ptr<SwitchState>& state,
+      const std::shared_ptr<SwitchState>& other = nullptr);
+
+  static StateMemoryUsage compute(
+      const NodeBase* root,
+      const NodeBase* other = nullptr);
+
+  const NodeMemoryUsage& getTotal() const {
+    return total_;
+  }
+  const std::map<std::string, NodeMemoryUsage>& getBySubtree() const {
+    return bySubtree_;
+  }
+  const std::map<std::string, NodeMemoryUsage>& getByNodeType() const {
+    return byNodeType_;
+  }
+
+  /*
+   * Name of the node's type without the facebook::fboss namespace, as used
+   * for the subtree and node type keys.
+   */
+  static std::string nodeTypeName(const NodeBase* node);
+
+ private:
+  NodeMemoryUsage total_;
+  std::map<std::string, NodeMemoryUsage> bySubtree_;
+  std::map<std::string, NodeMemoryUsage> byNodeType_;
+};
+
+} // namespace facebook::fboss
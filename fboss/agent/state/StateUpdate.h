@@ -9,7 +9,9 @@
  */
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <vector>
 
 #include <folly/FBString.h>
 #include <folly/IntrusiveList.h>
@@ -17,6 +19,7 @@
 namespace facebook::fboss {
 
 class SwitchState;
+class UpdateTrace;
 
 /*
  * StateUpdate objects are used to make changes to the SwitchState.
@@ -85,6 +88,11 @@ class StateUpdate {
   std::string name_;
   bool allowCoalesce_;
 
+  // Set by SwSwitch when the update is queued: the update traces active on
+  // the queueing thread (if tracing is enabled) and the time it was queued.
+  std::vector<std::shared_ptr<UpdateTrace>> traces_;
+  std::chrono::steady_clock::time_point enqueueTime_;
+
   // An intrusive list hook for maintaining the list of pending updates.
   folly::IntrusiveListHook listHook_;
   // The SwSwitch code needs access to our listHook_ member so it can maintain
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "common/init/Init.h"
+#include "fboss/agent/ApplyThriftConfig.h"
+#include "fboss/agent/hw/mock/MockPlatform.h"
+#include "fboss/agent/state/AclEntry.h"
+#include "fboss/agent/state/AclMap.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <folly/Benchmark.h>
+
+using namespace facebook::fboss;
+
+/*
+ * Number of hardware ACL operations caused by inserting a single ACL into a
+ * config with kAcls ACLs. A changed ACL is removed and re-added in hardware,
+ * so it counts as two operations. The time reported is the time it takes to
+ * apply the config.
+ */
+
+namespace {
+
+constexpr int kAcls = 2000;
+
+cfg::AclEntry makeAcl(const std::string& name, int port) {
+  cfg::AclEntry acl;
+  *acl.name_ref() = name;
+  *acl.actionType_ref() = cfg::AclActionType::DENY;
+  acl.srcPort_ref() = port;
+  return acl;
+}
+
+int countHwOps(
+    const std::shared_ptr<SwitchState>& oldState,
+    const std::shared_ptr<SwitchState>& newState) {
+  int ops = 0;
+  StateDelta delta(oldState, newState);
+  for (const auto& aclDelta : delta.getAclsDelta()) {
+    ops += (aclDelta.getOld() && aclDelta.getNew()) ? 2 : 1;
+  }
+  return ops;
+}
+
+void runAclInsertBenchmark(folly::UserCounters& counters, int pos) {
+  folly::BenchmarkSuspender suspender;
+  auto platform = createMockPlatform();
+  cfg::SwitchConfig config;
+  for (int i = 0; i < kAcls; ++i) {
+    config.acls_ref()->push_back(
+        makeAcl(folly::to<std::string>("acl", i), i));
+  }
+  auto state = publishAndApplyConfig(
+      std::make_shared<SwitchState>(), &config, platform.get());
+  config.acls_ref()->insert(
+      config.acls_ref()->begin() + pos, makeAcl("inserted", kAcls));
+  suspender.dismiss();
+
+  auto newState = publishAndApplyConfig(state, &config, platform.get());
+
+  suspender.rehire();
+  counters["hw_ops"] = countHwOps(state, newState);
+}
+
+} // namespace
+
+BENCHMARK_COUNTERS(AclInsertTop, counters) {
+  runAclInsertBenchmark(counters, 0);
+}
+
+BENCHMARK_COUNTERS(AclInsertSecond, counters) {
+  runAclInsertBenchmark(counters, 1);
+}
+
+BENCHMARK_COUNTERS(AclInsertMiddle, counters) {
+  runAclInsertBenchmark(counters, kAcls / 2);
+}
+
+BENCHMARK_COUNTERS(AclInsertBottom, counters) {
+  runAclInsertBenchmark(counters, kAcls);
+}
+
+int main(int argc, char** argv) {
+  facebook::initFacebook(&argc, &argv);
+  folly::runBenchmarks();
+  return EXIT_SUCCESS;
+}
@@ -8,12 +8,14 @@
  *
  */
 
+#include "fboss/agent/AclPriorityAllocator.h"
 #include "fboss/agent/ApplyThriftConfig.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/hw/mock/MockPlatform.h"
 #include "fboss/agent/state/AclEntry.h"
 #include "fboss/agent/state/AclMap.h"
 #include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/StateDelta.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/test/TestUtils.h"
 
@@ -265,6 +267,104 @@ TEST(Acl, stateDelta) {
   EXPECT_EQ(iter, aclDelta45.end());
 }
 
+TEST(Acl, InsertOnlyAddsOneAcl) {
+  auto platform = createMockPlatform();
+  auto stateV0 = make_shared<SwitchState>();
+
+  cfg::SwitchConfig config;
+  constexpr auto kNumAcls = 100;
+  config.acls_ref()->resize(kNumAcls);
+  for (auto i = 0; i < kNumAcls; ++i) {
+    *config.acls[i].name_ref() = folly::to<std::string>("acl", i);
+    *config.acls[i].actionType_ref() = cfg::AclActionType::DENY;
+    config.acls_ref()[i].srcPort_ref() = i;
+  }
+  auto stateV1 = publishAndApplyConfig(stateV0, &config, platform.get());
+  ASSERT_NE(nullptr, stateV1);
+
+  // Insert at the top, in the middle and at the bottom. Every time only the
+  // new ACL shows up in the delta, everything else keeps its priority. The
+  // exception is the first ACL, which sits at the very start of the priority
+  // range and so has to make room for an ACL inserted before it.
+  auto state = stateV1;
+  for (auto pos : {0, kNumAcls / 2, kNumAcls + 2}) {
+    cfg::AclEntry acl;
+    *acl.name_ref() = folly::to<std::string>("inserted", pos);
+    *acl.actionType_ref() = cfg::AclActionType::DENY;
+    acl.dstPort_ref() = pos;
+    config.acls_ref()->insert(config.acls_ref()->begin() + pos, acl);
+    auto newState = publishAndApplyConfig(state, &config, platform.get());
+    ASSERT_NE(nullptr, newState);
+
+    StateDelta delta(state, newState);
+    int added = 0;
+    int changedOrRemoved = 0;
+    for (const auto& aclDelta : delta.getAclsDelta()) {
+      if (!aclDelta.getOld()) {
+        EXPECT_EQ(*acl.name_ref(), aclDelta.getNew()->getID());
+        ++added;
+      } else {
+        ++changedOrRemoved;
+      }
+    }
+    EXPECT_EQ(1, added);
+    EXPECT_EQ(pos == 0 ? 1 : 0, changedOrRemoved);
+
+    // Still in config order
+    int lastPriority = 0;
+    for (const auto& cfgAcl : *config.acls_ref()) {
+      auto priority = newState->getAcl(*cfgAcl.name_ref())->getPriority();
+      EXPECT_LT(lastPriority, priority);
+      lastPriority = priority;
+    }
+    state = newState;
+  }
+}
+
+TEST(Acl, AppliedConfigCache) {
+  auto platform = createMockPlatform();
+  auto stateV0 = make_shared<SwitchState>();
+  AppliedConfigCache cache;
+
+  cfg::SwitchConfig config;
+  config.acls_ref()->resize(2);
+  for (auto i = 0; i < 2; ++i) {
+    *config.acls[i].name_ref() = folly::to<std::string>("acl", i);
+    *config.acls[i].actionType_ref() = cfg::AclActionType::DENY;
+    config.acls_ref()[i].srcPort_ref() = i;
+  }
+  auto stateV1 =
+      publishAndApplyConfig(stateV0, &config, platform.get(), nullptr, &cache);
+  ASSERT_NE(nullptr, stateV1);
+
+  // Same config, nothing to do
+  EXPECT_EQ(
+      nullptr,
+      publishAndApplyConfig(stateV1, &config, platform.get(), nullptr, &cache));
+
+  // Someone else changed an ACL behind our back. Even though the config did
+  // not change, it has to be put back.
+  auto stateV2 = stateV1->clone();
+  auto acls = stateV2->getAcls()->clone();
+  auto acl0 = acls->getEntry("acl0")->clone();
+  acl0->setSrcPort(100);
+  acls->updateNode(acl0);
+  stateV2->resetAcls(acls);
+  auto stateV3 =
+      publishAndApplyConfig(stateV2, &config, platform.get(), nullptr, &cache);
+  ASSERT_NE(nullptr, stateV3);
+  EXPECT_EQ(*stateV1->getAcl("acl0"), *stateV3->getAcl("acl0"));
+  EXPECT_EQ(stateV2->getAcl("acl1"), stateV3->getAcl("acl1"));
+
+  // Changing one ACL only touches that ACL
+  config.acls_ref()[1].srcPort_ref() = 10;
+  auto stateV4 =
+      publishAndApplyConfig(stateV3, &config, platform.get(), nullptr, &cache);
+  ASSERT_NE(nullptr, stateV4);
+  EXPECT_EQ(stateV3->getAcl("acl0"), stateV4->getAcl("acl0"));
+  EXPECT_EQ(10, stateV4->getAcl("acl1")->getSrcPort());
+}
+
 TEST(Acl, Icmp) {
   auto platform = createMockPlatform();
   auto stateV0 = make_shared<SwitchState>();
@@ -394,10 +494,18 @@ TEST(Acl, AclGeneration) {
   EXPECT_NE(acls->getEntryIf("acl5"), nullptr);
 
   EXPECT_EQ(acls->getEntryIf("acl1")->getPriority(), kAclStartPriority);
-  EXPECT_EQ(acls->getEntryIf("acl4")->getPriority(), kAclStartPriority + 1);
-  EXPECT_EQ(acls->getEntryIf("acl2")->getPriority(), kAclStartPriority + 2);
-  EXPECT_EQ(acls->getEntryIf("acl3")->getPriority(), kAclStartPriority + 3);
-  EXPECT_EQ(acls->getEntryIf("acl5")->getPriority(), kAclStartPriority + 4);
+  EXPECT_EQ(
+      acls->getEntryIf("acl4")->getPriority(),
+      kAclStartPriority + AclPriorityAllocator::kGap);
+  EXPECT_EQ(
+      acls->getEntryIf("acl2")->getPriority(),
+      kAclStartPriority + 2 * AclPriorityAllocator::kGap);
+  EXPECT_EQ(
+      acls->getEntryIf("acl3")->getPriority(),
+      kAclStartPriority + 3 * AclPriorityAllocator::kGap);
+  EXPECT_EQ(
+      acls->getEntryIf("acl5")->getPriority(),
+      kAclStartPriority + 4 * AclPriorityAllocator::kGap);
 
   // Ensure that the global actions in global traffic policy has been added to
   // the ACL entries
@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "common/init/Init.h"
+#include "fboss/agent/state/Route.h"
+#include "fboss/agent/state/RouteTableRib.h"
+#include "fboss/agent/state/StateMemoryUsage.h"
+
+#include <folly/Benchmark.h>
+#include <folly/IPAddressV4.h>
+#include <folly/IPAddressV6.h>
+#include <folly/memory/MallctlHelper.h>
+#include <folly/memory/Malloc.h>
+
+using namespace facebook::fboss;
+
+/*
+ * Bytes per route in a RouteTableRib, for a few route shapes.
+ *
+ * bytes_per_route is the estimate from StateMemoryUsage. When running with
+ * jemalloc, allocated_per_route is the number of bytes actually allocated
+ * (net of frees) while building the table.
+ */
+
+namespace {
+
+constexpr uint32_t kRoutes = 100000;
+// Number of distinct ECMP groups the routes point to
+constexpr uint32_t kEcmpGroups = 16;
+
+uint64_t netAllocatedBytes() {
+  if (!folly::usingJEMalloc()) {
+    return 0;
+  }
+  uint64_t allocated = 0;
+  uint64_t deallocated = 0;
+  folly::mallctlRead("thread.allocated", &allocated);
+  folly::mallctlRead("thread.deallocated", &deallocated);
+  return allocated - deallocated;
+}
+
+folly::IPAddressV6 makeV6(uint32_t index) {
+  folly::ByteArray16 bytes{};
+  bytes[0] = 0x24;
+  bytes[1] = 0x01;
+  bytes[8] = (index >> 24) & 0xff;
+  bytes[9] = (index >> 16) & 0xff;
+  bytes[10] = (index >> 8) & 0xff;
+  bytes[11] = index & 0xff;
+  return folly::IPAddressV6(bytes);
+}
+
+template <typename AddrT>
+RoutePrefix<AddrT> makePrefix(uint32_t index);
+
+template <>
+RoutePrefix<folly::IPAddressV4> makePrefix(uint32_t index) {
+  return RoutePrefix<folly::IPAddressV4>{
+      folly::IPAddressV4::fromLongHBO(0x0a000000 + (index << 8)), 24};
+}
+
+template <>
+RoutePrefix<folly::IPAddressV6> makePrefix(uint32_t index) {
+  return RoutePrefix<folly::IPAddressV6>{makeV6(index), 64};
+}
+
+RouteNextHopEntry makeNextHops(uint32_t group, int ecmpWidth) {
+  RouteNextHopEntry::NextHopSet nhops;
+  for (int i = 0; i < ecmpWidth; ++i) {
+    auto addr = folly::IPAddressV4::fromLongHBO(
+        0x0b000000 + (group << 8) + static_cast<uint32_t>(i));
+    nhops.emplace(ResolvedNextHop(addr, InterfaceID(i + 1), ECMP_WEIGHT));
+  }
+  return RouteNextHopEntry(std::move(nhops), AdminDistance::EBGP);
+}
+
+template <typename AddrT>
+void runRouteMemoryBenchmark(
+    folly::UserCounters& counters,
+    int ecmpWidth,
+    int numClients) {
+  folly::BenchmarkSuspender suspender;
+  std::vector<RouteNextHopEntry> groups;
+  for (uint32_t group = 0; group < kEcmpGroups; ++group) {
+    groups.push_back(makeNextHops(group, ecmpWidth));
+  }
+  auto emptyRib = std::make_shared<RouteTableRib<AddrT>>();
+  auto emptyBytes = StateMemoryUsage::compute(emptyRib.get()).getTotal().bytes;
+
+  auto allocatedBefore = netAllocatedBytes();
+  suspender.dismiss();
+
+  auto rib = std::make_shared<RouteTableRib<AddrT>>();
+  for (uint32_t i = 0; i < kRoutes; ++i) {
+    const auto& nhops = groups[i % kEcmpGroups];
+    auto route = std::make_shared<Route<AddrT>>(
+        makePrefix<AddrT>(i), ClientID::BGPD, nhops);
+    for (int client = 1; client < numClients; ++client) {
+      route->update(ClientID(static_cast<int>(ClientID::BGPD) + client), nhops);
+    }
+    route->setResolved(nhops);
+    rib->addRoute(route);
+    rib->addRouteInRadixTree(route);
+  }
+
+  suspender.rehire();
+  auto allocated = netAllocatedBytes() - allocatedBefore;
+  auto usage = StateMemoryUsage::compute(rib.get());
+  counters["bytes_per_route"] =
+      static_cast<int>((usage.getTotal().bytes - emptyBytes) / kRoutes);
+  if (folly::usingJEMalloc()) {
+    counters["allocated_per_route"] = static_cast<int>(allocated / kRoutes);
+  }
+  counters["nexthop_sets"] =
+      static_cast<int>(RouteNextHopEntry::getInternedNextHopSetCount());
+}
+
+} // namespace
+
+BENCHMARK_COUNTERS(RouteV4Ecmp1, counters) {
+  runRouteMemoryBenchmark<folly::IPAddressV4>(counters, 1, 1);
+}
+
+BENCHMARK_COUNTERS(RouteV4Ecmp4, counters) {
+  runRouteMemoryBenchmark<folly::IPAddressV4>(counters, 4, 1);
+}
+
+BENCHMARK_COUNTERS(RouteV4Ecmp64, counters) {
+  runRouteMemoryBenchmark<folly::IPAddressV4>(counters, 64, 1);
+}
+
+BENCHMARK_COUNTERS(RouteV4Ecmp4TwoClients, counters) {
+  runRouteMemoryBenchmark<folly::IPAddressV4>(counters, 4, 2);
+}
+
+BENCHMARK_COUNTERS(RouteV6Ecmp4, counters) {
+  runRouteMemoryBenchmark<folly::IPAddressV6>(counters, 4, 1);
+}
+
+BENCHMARK_COUNTERS(RouteV6Ecmp64, counters) {
+  runRouteMemoryBenchmark<folly::IPAddressV6>(counters, 64, 1);
+}
+
+int main(int argc, char** argv) {
+  facebook::initFacebook(&argc, &argv);
+  folly::runBenchmarks();
+  return EXIT_SUCCESS;
+}
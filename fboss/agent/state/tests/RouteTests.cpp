@@ -1024,6 +1024,54 @@ void checkChangedRouteTable(
   EXPECT_EQ(removedIDs, foundRemoved);
 }
 
+TEST(Route, StaticRoutesReconciled) {
+  auto platform = createMockPlatform();
+  auto stateV0 = make_shared<SwitchState>();
+
+  cfg::SwitchConfig config;
+  config.vlans_ref()->resize(1);
+  *config.vlans[0].id_ref() = 1;
+  config.interfaces_ref()->resize(1);
+  *config.interfaces[0].intfID_ref() = 1;
+  *config.interfaces[0].vlanID_ref() = 1;
+  *config.interfaces[0].routerID_ref() = 0;
+  config.interfaces_ref()[0].mac_ref() = "00:00:00:00:00:11";
+  config.interfaces_ref()[0].ipAddresses_ref()->resize(1);
+  config.interfaces[0].ipAddresses_ref()[0] = "1.1.1.1/24";
+
+  config.staticRoutesWithNhops_ref()->resize(2);
+  for (auto i = 0; i < 2; ++i) {
+    *config.staticRoutesWithNhops[i].prefix_ref() =
+        folly::sformat("20.20.{}.0/24", i);
+    config.staticRoutesWithNhops_ref()[i].nexthops_ref()->resize(1);
+    config.staticRoutesWithNhops[i].nexthops_ref()[0] = "1.1.1.2";
+  }
+  config.staticRoutesToNull_ref()->resize(1);
+  *config.staticRoutesToNull[0].prefix_ref() = "30.30.30.0/24";
+
+  auto stateV1 = publishAndApplyConfig(stateV0, &config, platform.get());
+  ASSERT_NE(nullptr, stateV1);
+  auto tablesV1 = stateV1->getRouteTables();
+
+  // Re-applying the same static routes does not touch any route
+  EXPECT_EQ(nullptr, publishAndApplyConfig(stateV1, &config, platform.get()));
+
+  // Change the nexthop of one route, drop one and add one. Only those are
+  // updated, the other static route is left alone.
+  config.staticRoutesWithNhops[1].nexthops_ref()[0] = "1.1.1.3";
+  *config.staticRoutesToNull[0].prefix_ref() = "40.40.40.0/24";
+  auto stateV2 = publishAndApplyConfig(stateV1, &config, platform.get());
+  ASSERT_NE(nullptr, stateV2);
+  auto tablesV2 = stateV2->getRouteTables();
+  EXPECT_NODEMAP_MATCH(tablesV2);
+  checkChangedRoute(
+      tablesV1,
+      tablesV2,
+      {TEMP::Route{0, IPAddress("20.20.1.0"), 24}},
+      {TEMP::Route{0, IPAddress("40.40.40.0"), 24}},
+      {TEMP::Route{0, IPAddress("30.30.30.0"), 24}});
+}
+
 TEST(RouteTableMap, applyConfig) {
   auto platform = createMockPlatform();
   auto stateV0 = make_shared<SwitchState>();
@@ -1742,6 +1790,57 @@ TEST(Route, serializeRouteNextHopsMulti) {
   EXPECT_TRUE(nhm1 == nhm2);
 }
 
+// Entries with the same next hops share a single interned set
+TEST(Route, internedNextHopSets) {
+  auto baseCount = RouteNextHopEntry::getInternedNextHopSetCount();
+  {
+    RouteNextHopEntry entry1(newNextHops(4, "5.5.5."), DISTANCE);
+    RouteNextHopEntry entry2(newNextHops(4, "5.5.5."), DISTANCE);
+    RouteNextHopEntry entry3(newNextHops(3, "5.5.5."), DISTANCE);
+    EXPECT_EQ(&entry1.getNextHopSet(), &entry2.getNextHopSet());
+    EXPECT_NE(&entry1.getNextHopSet(), &entry3.getNextHopSet());
+    EXPECT_EQ(entry1, entry2);
+    EXPECT_EQ(baseCount + 2, RouteNextHopEntry::getInternedNextHopSetCount());
+
+    auto deserialized =
+        RouteNextHopEntry::fromFollyDynamic(entry1.toFollyDynamic());
+    EXPECT_EQ(&entry1.getNextHopSet(), &deserialized.getNextHopSet());
+
+    entry3.reset();
+    EXPECT_TRUE(entry3.getNextHopSet().empty());
+    EXPECT_EQ(baseCount + 1, RouteNextHopEntry::getInternedNextHopSetCount());
+  }
+  // Sets are released along with the last entry using them
+  EXPECT_EQ(baseCount, RouteNextHopEntry::getInternedNextHopSetCount());
+}
+
+// The class ID is packed along with the route flags
+TEST(Route, classIDAndFlags) {
+  RoutePrefixV4 prefix{IPAddressV4("10.1.1.0"), 24};
+  auto route = make_shared<RouteV4>(
+      prefix, CLIENT_A, RouteNextHopEntry(newNextHops(2, "1.1.1."), DISTANCE));
+  EXPECT_EQ(std::nullopt, route->getClassID());
+
+  route->setResolved(RouteNextHopEntry(newNextHops(2, "1.1.1."), DISTANCE));
+  route->setConnected();
+  route->updateClassID(cfg::AclLookupClass::DST_CLASS_L3_LOCAL_IP4);
+  EXPECT_TRUE(route->isResolved());
+  EXPECT_TRUE(route->isConnected());
+  EXPECT_EQ(cfg::AclLookupClass::DST_CLASS_L3_LOCAL_IP4, route->getClassID());
+
+  auto deserialized = RouteV4::fromFollyDynamic(route->toFollyDynamic());
+  EXPECT_TRUE(deserialized->isResolved());
+  EXPECT_TRUE(deserialized->isConnected());
+  EXPECT_EQ(
+      cfg::AclLookupClass::DST_CLASS_L3_LOCAL_IP4, deserialized->getClassID());
+
+  route->clearForward();
+  EXPECT_FALSE(route->isResolved());
+  EXPECT_EQ(cfg::AclLookupClass::DST_CLASS_L3_LOCAL_IP4, route->getClassID());
+  route->updateClassID(std::nullopt);
+  EXPECT_EQ(std::nullopt, route->getClassID());
+}
+
 // Test priority ranking of nexthop lists within a RouteNextHopsMulti.
 TEST(Route, listRanking) {
   auto list00 = newNextHops(3, "0.0.0.");
@@ -0,0 +1,206 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "common/init/Init.h"
+#include "fboss/agent/state/AclEntry.h"
+#include "fboss/agent/state/AclMap.h"
+#include "fboss/agent/state/ArpTable.h"
+#include "fboss/agent/state/MacEntry.h"
+#include "fboss/agent/state/MacTable.h"
+#include "fboss/agent/state/NdpTable.h"
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/PortMap.h"
+#include "fboss/agent/state/PortQueue.h"
+#include "fboss/agent/state/Route.h"
+#include "fboss/agent/state/RouteTableRib.h"
+#include "fboss/agent/state/StateMemoryUsage.h"
+
+#include <folly/Benchmark.h>
+#include <folly/IPAddressV4.h>
+#include <folly/IPAddressV6.h>
+#include <folly/MacAddress.h>
+
+using namespace facebook::fboss;
+
+/*
+ * Reports the estimated memory overhead per entry of the various maps in the
+ * SwitchState, as computed by StateMemoryUsage. The time reported is the
+ * time it takes to walk a map of that size.
+ */
+
+namespace {
+
+constexpr uint32_t kEntries = 10000;
+constexpr uint32_t kPorts = 128;
+constexpr uint8_t kQueuesPerPort = 8;
+constexpr int kEcmpWidth = 4;
+
+folly::IPAddressV6 makeV6(uint32_t index) {
+  folly::ByteArray16 bytes{};
+  bytes[0] = 0x24;
+  bytes[1] = 0x01;
+  bytes[12] = (index >> 24) & 0xff;
+  bytes[13] = (index >> 16) & 0xff;
+  bytes[14] = (index >> 8) & 0xff;
+  bytes[15] = index & 0xff;
+  return folly::IPAddressV6(bytes);
+}
+
+RouteNextHopEntry makeEcmpNextHops(bool v6) {
+  RouteNextHopEntry::NextHopSet nhops;
+  for (int i = 0; i < kEcmpWidth; ++i) {
+    folly::IPAddress addr = v6
+        ? folly::IPAddress(makeV6(0xffff0000 + i))
+        : folly::IPAddress(folly::IPAddressV4::fromLongHBO(0x0b000000 + i));
+    nhops.emplace(UnresolvedNextHop(addr, ECMP_WEIGHT));
+  }
+  return RouteNextHopEntry(std::move(nhops), AdminDistance::EBGP);
+}
+
+std::shared_ptr<ArpTable> makeArpTable(uint32_t entries) {
+  auto table = std::make_shared<ArpTable>();
+  for (uint32_t i = 0; i < entries; ++i) {
+    table->addEntry(
+        folly::IPAddressV4::fromLongHBO(0x0a000000 + i),
+        folly::MacAddress::fromHBO(i),
+        PortDescriptor(PortID(1)),
+        InterfaceID(1));
+  }
+  return table;
+}
+
+std::shared_ptr<NdpTable> makeNdpTable(uint32_t entries) {
+  auto table = std::make_shared<NdpTable>();
+  for (uint32_t i = 0; i < entries; ++i) {
+    table->addEntry(
+        makeV6(i),
+        folly::MacAddress::fromHBO(i),
+        PortDescriptor(PortID(1)),
+        InterfaceID(1));
+  }
+  return table;
+}
+
+std::shared_ptr<MacTable> makeMacTable(uint32_t entries) {
+  auto table = std::make_shared<MacTable>();
+  for (uint32_t i = 0; i < entries; ++i) {
+    table->addEntry(std::make_shared<MacEntry>(
+        folly::MacAddress::fromHBO(i), PortDescriptor(PortID(1))));
+  }
+  return table;
+}
+
+std::shared_ptr<AclMap> makeAclMap(uint32_t entries) {
+  auto acls = std::make_shared<AclMap>();
+  for (uint32_t i = 0; i < entries; ++i) {
+    acls->addEntry(
+        std::make_shared<AclEntry>(i, folly::to<std::string>("acl", i)));
+  }
+  return acls;
+}
+
+std::shared_ptr<RouteTableRib<folly::IPAddressV4>> makeV4Rib(uint32_t entries) {
+  auto rib = std::make_shared<RouteTableRib<folly::IPAddressV4>>();
+  auto nhops = makeEcmpNextHops(false);
+  for (uint32_t i = 0; i < entries; ++i) {
+    RoutePrefix<folly::IPAddressV4> prefix{
+        folly::IPAddressV4::fromLongHBO(0x0a000000 + (i << 8)), 24};
+    auto route = std::make_shared<Route<folly::IPAddressV4>>(
+        prefix, ClientID::BGPD, nhops);
+    rib->addRoute(route);
+    rib->addRouteInRadixTree(route);
+  }
+  return rib;
+}
+
+std::shared_ptr<RouteTableRib<folly::IPAddressV6>> makeV6Rib(uint32_t entries) {
+  auto rib = std::make_shared<RouteTableRib<folly::IPAddressV6>>();
+  auto nhops = makeEcmpNextHops(true);
+  for (uint32_t i = 0; i < entries; ++i) {
+    RoutePrefix<folly::IPAddressV6> prefix{makeV6(i << 16), 112};
+    auto route = std::make_shared<Route<folly::IPAddressV6>>(
+        prefix, ClientID::BGPD, nhops);
+    rib->addRoute(route);
+    rib->addRouteInRadixTree(route);
+  }
+  return rib;
+}
+
+std::shared_ptr<PortMap> makePortMap(uint32_t entries) {
+  auto ports = std::make_shared<PortMap>();
+  for (uint32_t i = 0; i < entries; ++i) {
+    auto port =
+        std::make_shared<Port>(PortID(i), folly::to<std::string>("port", i));
+    QueueConfig queues;
+    for (uint8_t queue = 0; queue < kQueuesPerPort; ++queue) {
+      queues.push_back(std::make_shared<PortQueue>(queue));
+    }
+    port->resetPortQueues(std::move(queues));
+    ports->addPort(port);
+  }
+  return ports;
+}
+
+template <typename MakeFn>
+void runMemoryBenchmark(
+    folly::UserCounters& counters,
+    uint32_t entries,
+    MakeFn makeMap) {
+  folly::BenchmarkSuspender suspender;
+  auto empty = StateMemoryUsage::compute(makeMap(0).get());
+  auto map = makeMap(entries);
+  suspender.dismiss();
+
+  auto usage = StateMemoryUsage::compute(map.get());
+
+  suspender.rehire();
+  auto bytes = usage.getTotal().bytes - empty.getTotal().bytes;
+  auto nodes = usage.getTotal().nodes - empty.getTotal().nodes;
+  counters["bytes_per_entry"] = static_cast<int>(bytes / entries);
+  counters["nodes_per_entry"] = static_cast<int>(nodes / entries);
+  counters["total_kb"] = static_cast<int>(usage.getTotal().bytes / 1024);
+}
+
+} // namespace
+
+BENCHMARK_COUNTERS(ArpTableMemory, counters) {
+  runMemoryBenchmark(counters, kEntries, makeArpTable);
+}
+
+BENCHMARK_COUNTERS(NdpTableMemory, counters) {
+  runMemoryBenchmark(counters, kEntries, makeNdpTable);
+}
+
+BENCHMARK_COUNTERS(MacTableMemory, counters) {
+  runMemoryBenchmark(counters, kEntries, makeMacTable);
+}
+
+BENCHMARK_COUNTERS(AclMapMemory, counters) {
+  runMemoryBenchmark(counters, kEntries, makeAclMap);
+}
+
+BENCHMARK_COUNTERS(RouteTableRibV4Memory, counters) {
+  runMemoryBenchmark(counters, kEntries, makeV4Rib);
+}
+
+BENCHMARK_COUNTERS(RouteTableRibV6Memory, counters) {
+  runMemoryBenchmark(counters, kEntries, makeV6Rib);
+}
+
+// Includes kQueuesPerPort PortQueue nodes per port
+BENCHMARK_COUNTERS(PortMapMemory, counters) {
+  runMemoryBenchmark(counters, kPorts, makePortMap);
+}
+
+int main(int argc, char** argv) {
+  facebook::initFacebook(&argc, &argv);
+  folly::runBenchmarks();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/PortMap.h"
+#include "fboss/agent/state/PortQueue.h"
+#include "fboss/agent/state/StateMemoryUsage.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+
+TEST(StateMemoryUsage, NothingShared) {
+  auto state = testStateA();
+  auto usage = StateMemoryUsage::compute(state);
+
+  const auto& total = usage.getTotal();
+  EXPECT_GT(total.nodes, 0);
+  EXPECT_GT(total.bytes, 0);
+  EXPECT_EQ(0, total.sharedNodes);
+  EXPECT_EQ(total.bytes, total.uniqueBytes());
+
+  // Totals add up across subtrees as well as across node types
+  NodeMemoryUsage byType;
+  for (const auto& nodeType : usage.getByNodeType()) {
+    byType += nodeType.second;
+  }
+  EXPECT_EQ(total.nodes, byType.nodes);
+  EXPECT_EQ(total.bytes, byType.bytes);
+
+  EXPECT_EQ(1, usage.getBySubtree().count("PortMap"));
+  EXPECT_EQ(1, usage.getBySubtree().count("VlanMap"));
+  EXPECT_EQ(
+      state->getPorts()->size(), usage.getByNodeType().at("Port").nodes);
+}
+
+TEST(StateMemoryUsage, SharedWithOtherState) {
+  auto state = testStateA();
+  state->publish();
+
+  auto fullyShared = StateMemoryUsage::compute(state, state);
+  EXPECT_EQ(fullyShared.getTotal().nodes, fullyShared.getTotal().sharedNodes);
+  EXPECT_EQ(0, fullyShared.getTotal().uniqueBytes());
+
+  // Modifying a port copies the port, the port map and the switch state,
+  // everything else is still shared.
+  auto newState = state;
+  auto port = newState->getPorts()->getPortIf(PortID(1))->modify(&newState);
+  QueueConfig queues;
+  queues.push_back(std::make_shared<PortQueue>(static_cast<uint8_t>(0)));
+  queues.push_back(std::make_shared<PortQueue>(static_cast<uint8_t>(1)));
+  port->resetPortQueues(queues);
+
+  auto usage = StateMemoryUsage::compute(newState, state);
+  const auto& total = usage.getTotal();
+  EXPECT_EQ(5, total.nodes - total.sharedNodes);
+  EXPECT_EQ(2, usage.getByNodeType().at("PortQueue").nodes);
+  EXPECT_EQ(0, usage.getByNodeType().at("PortQueue").sharedNodes);
+  // Only the new queues were added
+  EXPECT_EQ(StateMemoryUsage::compute(state).getTotal().nodes + 2, total.nodes);
+
+  const auto& portMap = usage.getBySubtree().at("PortMap");
+  EXPECT_EQ(portMap.nodes - 4, portMap.sharedNodes);
+  EXPECT_EQ(0, usage.getBySubtree().at("VlanMap").uniqueBytes());
+}
@@ -0,0 +1,170 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/AclPriorityAllocator.h"
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/state/AclEntry.h"
+#include "fboss/agent/state/AclMap.h"
+
+#include <folly/Conv.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr int kMinPriority = 1000;
+constexpr int kMaxPriority = 100000;
+
+std::shared_ptr<AclMap> makeAcls(
+    const std::vector<std::string>& names,
+    const std::vector<int>& priorities) {
+  auto acls = std::make_shared<AclMap>();
+  for (size_t i = 0; i < names.size(); ++i) {
+    acls->addEntry(std::make_shared<AclEntry>(priorities[i], names[i]));
+  }
+  return acls;
+}
+
+std::vector<std::string> makeNames(int numAcls) {
+  std::vector<std::string> names;
+  for (int i = 0; i < numAcls; ++i) {
+    names.push_back(folly::to<std::string>("acl", i));
+  }
+  return names;
+}
+
+int numChanged(
+    const std::vector<std::string>& oldNames,
+    const std::vector<int>& oldPriorities,
+    const std::vector<std::string>& newNames,
+    const std::vector<int>& newPriorities) {
+  int changed = 0;
+  for (size_t i = 0; i < newNames.size(); ++i) {
+    auto old = std::find(oldNames.begin(), oldNames.end(), newNames[i]);
+    if (old == oldNames.end() ||
+        oldPriorities[old - oldNames.begin()] != newPriorities[i]) {
+      ++changed;
+    }
+  }
+  return changed;
+}
+
+} // namespace
+
+TEST(AclPriorityAllocator, FreshAllocationIsGapped) {
+  auto names = makeNames(10);
+  auto priorities =
+      AclPriorityAllocator(kMinPriority, kMaxPriority, nullptr).allocate(names);
+  ASSERT_EQ(names.size(), priorities.size());
+  for (size_t i = 0; i < priorities.size(); ++i) {
+    EXPECT_EQ(kMinPriority + i * AclPriorityAllocator::kGap, priorities[i]);
+  }
+}
+
+TEST(AclPriorityAllocator, InsertKeepsExisting) {
+  auto names = makeNames(1000);
+  auto priorities =
+      AclPriorityAllocator(kMinPriority, kMaxPriority, nullptr).allocate(names);
+
+  // Keep inserting right after the first ACL, which eventually runs out of
+  // room in between the first two ACLs. Renumbering all the ACLs after the
+  // insertion point would change ~1000 ACLs every time.
+  constexpr int kInserts = 50;
+  int changed = 0;
+  for (int i = 0; i < kInserts; ++i) {
+    auto newNames = names;
+    newNames.insert(
+        newNames.begin() + 1, folly::to<std::string>("inserted", i));
+    auto newPriorities =
+        AclPriorityAllocator(
+            kMinPriority, kMaxPriority, makeAcls(names, priorities))
+            .allocate(newNames);
+    ASSERT_TRUE(std::is_sorted(newPriorities.begin(), newPriorities.end()));
+    changed += numChanged(names, priorities, newNames, newPriorities);
+    names = std::move(newNames);
+    priorities = std::move(newPriorities);
+  }
+  EXPECT_LT(changed, 10 * kInserts);
+}
+
+TEST(AclPriorityAllocator, MoveOnlyRenumbersMovedAcl) {
+  auto names = makeNames(100);
+  auto priorities =
+      AclPriorityAllocator(kMinPriority, kMaxPriority, nullptr).allocate(names);
+
+  auto newNames = names;
+  std::rotate(newNames.begin() + 10, newNames.begin() + 11, newNames.end());
+  auto newPriorities =
+      AclPriorityAllocator(
+          kMinPriority, kMaxPriority, makeAcls(names, priorities))
+          .allocate(newNames);
+  EXPECT_EQ(1, numChanged(names, priorities, newNames, newPriorities));
+  EXPECT_EQ("acl10", newNames.back());
+  EXPECT_LT(priorities.back(), newPriorities.back());
+}
+
+TEST(AclPriorityAllocator, KeepsConsecutivePriorities) {
+  // Priorities as handed out before the allocator, one apart
+  auto names = makeNames(100);
+  std::vector<int> priorities;
+  for (int i = 0; i < 100; ++i) {
+    priorities.push_back(kMinPriority + i);
+  }
+  auto acls = makeAcls(names, priorities);
+
+  EXPECT_EQ(
+      priorities,
+      AclPriorityAllocator(kMinPriority, kMaxPriority, acls).allocate(names));
+
+  auto newNames = names;
+  newNames.push_back("appended");
+  auto newPriorities =
+      AclPriorityAllocator(kMinPriority, kMaxPriority, acls).allocate(newNames);
+  EXPECT_EQ(1, numChanged(names, priorities, newNames, newPriorities));
+
+  // There is no room in between, the ACLs after the new one have to move,
+  // but none of the ones before it
+  newNames = names;
+  newNames.insert(newNames.begin() + 90, "inserted");
+  newPriorities =
+      AclPriorityAllocator(kMinPriority, kMaxPriority, acls).allocate(newNames);
+  ASSERT_TRUE(std::is_sorted(newPriorities.begin(), newPriorities.end()));
+  EXPECT_TRUE(std::equal(
+      priorities.begin(), priorities.begin() + 90, newPriorities.begin()));
+  EXPECT_EQ(11, numChanged(names, priorities, newNames, newPriorities));
+}
+
+TEST(AclPriorityAllocator, PrioritiesOfRemovedAclsNotReused) {
+  auto names = makeNames(2);
+  auto priorities =
+      AclPriorityAllocator(kMinPriority, kMaxPriority, nullptr).allocate(names);
+
+  // acl0 is renamed, the new name must not reuse acl0's priority
+  std::vector<std::string> newNames{"renamed", "acl1"};
+  auto newPriorities =
+      AclPriorityAllocator(
+          kMinPriority, kMaxPriority, makeAcls(names, priorities))
+          .allocate(newNames);
+  EXPECT_NE(priorities[0], newPriorities[0]);
+  EXPECT_EQ(priorities[1], newPriorities[1]);
+  EXPECT_LT(newPriorities[0], newPriorities[1]);
+}
+
+TEST(AclPriorityAllocator, Full) {
+  auto names = makeNames(11);
+  EXPECT_THROW(
+      AclPriorityAllocator(1, 10, nullptr).allocate(names), FbossError);
+  names.pop_back();
+  auto priorities = AclPriorityAllocator(1, 10, nullptr).allocate(names);
+  EXPECT_EQ(1, priorities.front());
+  EXPECT_EQ(10, priorities.back());
+}
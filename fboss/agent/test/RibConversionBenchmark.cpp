@@ -13,6 +13,7 @@
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/hw/sim/SimPlatform.h"
 #include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/state/StateMemoryUsage.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/test/HwTestHandle.h"
 #include "fboss/agent/test/RouteScaleGenerators.h"
@@ -24,8 +25,28 @@
 
 using namespace facebook::fboss;
 
+namespace {
+
+// Report the estimated memory used by the route tables, per route
+void reportRouteMemory(
+    folly::UserCounters& counters,
+    const std::shared_ptr<RouteTableMap>& routeTables) {
+  auto usage = StateMemoryUsage::compute(routeTables.get());
+  uint64_t routes = 0;
+  for (const auto& nodeType : usage.getByNodeType()) {
+    if (nodeType.first.find("Route<") == 0) {
+      routes += nodeType.second.nodes;
+    }
+  }
+  counters["routes"] = static_cast<int>(routes);
+  counters["bytes_per_route"] =
+      routes ? static_cast<int>(usage.getTotal().bytes / routes) : 0;
+}
+
+} // namespace
+
 template <typename Generator>
-static void runConversionBenchmark() {
+static void runConversionBenchmark(folly::UserCounters& counters) {
   auto constexpr kEcmpWidth = 4;
 
   SimPlatform plat(folly::MacAddress(), 128);
@@ -61,22 +82,26 @@ static void runConversionBenchmark() {
   auto swStateRib = standaloneToSwitchStateRib(standaloneRib);
 
   syncFibWithStandaloneRib(standaloneRib, sw);
+
+  // Don't count the memory accounting walk itself
+  folly::BenchmarkSuspender suspender;
+  reportRouteMemory(counters, swStateRib);
 }
 
-BENCHMARK(RibConversionFSW) {
-  runConversionBenchmark<utility::FSWRouteScaleGenerator>();
+BENCHMARK_COUNTERS(RibConversionFSW, counters) {
+  runConversionBenchmark<utility::FSWRouteScaleGenerator>(counters);
 }
 
-BENCHMARK(RibConversionTHAlpm) {
-  runConversionBenchmark<utility::THAlpmRouteScaleGenerator>();
+BENCHMARK_COUNTERS(RibConversionTHAlpm, counters) {
+  runConversionBenchmark<utility::THAlpmRouteScaleGenerator>(counters);
 }
 
-BENCHMARK(RibConversionHgridDu) {
-  runConversionBenchmark<utility::HgridDuRouteScaleGenerator>();
+BENCHMARK_COUNTERS(RibConversionHgridDu, counters) {
+  runConversionBenchmark<utility::HgridDuRouteScaleGenerator>(counters);
 }
 
-BENCHMARK(RibConversionHgridUu) {
-  runConversionBenchmark<utility::HgridUuRouteScaleGenerator>();
+BENCHMARK_COUNTERS(RibConversionHgridUu, counters) {
+  runConversionBenchmark<utility::HgridUuRouteScaleGenerator>(counters);
 }
 
 int main(int argc, char** argv) {
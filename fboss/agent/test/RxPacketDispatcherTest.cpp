@@ -0,0 +1,208 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/RxPacketDispatcher.h"
+#include "fboss/agent/hw/mock/MockRxPacket.h"
+
+#include <folly/Synchronized.h>
+#include <folly/synchronization/Baton.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+using PacketClass = RxPacketDispatcher::PacketClass;
+using DropPolicy = RxPacketDispatcher::DropPolicy;
+
+namespace {
+
+const std::string kMacs = "02 00 00 00 00 01  02 00 00 00 00 02";
+
+std::unique_ptr<MockRxPacket> makePacket(
+    const std::string& hex,
+    PortID port = PortID(1)) {
+  auto pkt = MockRxPacket::fromHex(kMacs + hex);
+  pkt->padToLength(68);
+  pkt->setSrcPort(port);
+  return pkt;
+}
+
+std::unique_ptr<MockRxPacket> makeLacp(PortID port = PortID(1)) {
+  // Slow protocols, LACP subtype
+  return makePacket("88 09  01", port);
+}
+
+std::unique_ptr<MockRxPacket> makeNdp(PortID port = PortID(1)) {
+  return makePacket(
+      "86 dd"
+      // Version, traffic class, flow label, payload length
+      "60 00 00 00  00 18"
+      // Next header (ICMPv6), hop limit
+      "3a ff"
+      // Source and destination address
+      "fe 80 00 00 00 00 00 00 00 00 00 00 00 00 00 01"
+      "ff 02 00 00 00 00 00 00 00 00 00 01 ff 00 00 02"
+      // Neighbor solicitation
+      "87 00 00 00",
+      port);
+}
+
+PortID srcPort(const std::unique_ptr<RxPacket>& pkt) {
+  return pkt->getSrcPort();
+}
+
+std::array<RxPacketDispatcher::ClassConfig, RxPacketDispatcher::kNumClasses>
+configsWithNeighbor(size_t capacity, DropPolicy dropPolicy) {
+  return {
+      RxPacketDispatcher::defaultConfig(PacketClass::CONTROL),
+      RxPacketDispatcher::defaultConfig(PacketClass::ROUTING),
+      RxPacketDispatcher::ClassConfig{capacity, dropPolicy, 0},
+      RxPacketDispatcher::defaultConfig(PacketClass::DEFAULT)};
+}
+
+/*
+ * Sends ND packets from ports 1 to 5 while the NEIGHBOR worker is stuck on
+ * the first one, and returns the ports of the packets that got handled.
+ */
+std::vector<PortID> ndStorm(DropPolicy dropPolicy, uint64_t* drops) {
+  folly::Baton<> started;
+  folly::Baton<> unblock;
+  folly::Synchronized<std::vector<PortID>> handled;
+  {
+    RxPacketDispatcher dispatcher(
+        [&](std::unique_ptr<RxPacket> pkt) {
+          handled.wlock()->push_back(srcPort(pkt));
+          if (!started.ready()) {
+            started.post();
+            unblock.wait();
+          }
+        },
+        configsWithNeighbor(2, dropPolicy));
+    dispatcher.dispatch(makeNdp(PortID(1)));
+    started.wait();
+    for (int port = 2; port <= 5; ++port) {
+      dispatcher.dispatch(makeNdp(PortID(port)));
+    }
+    *drops = dispatcher.drops(PacketClass::NEIGHBOR);
+    unblock.post();
+  }
+  return handled.copy();
+}
+
+} // namespace
+
+TEST(RxPacketDispatcherTest, Classify) {
+  EXPECT_EQ(
+      PacketClass::CONTROL, RxPacketDispatcher::classify(makeLacp().get()));
+  EXPECT_EQ(
+      PacketClass::CONTROL,
+      RxPacketDispatcher::classify(makePacket("88 cc").get()));
+  EXPECT_EQ(
+      PacketClass::NEIGHBOR,
+      RxPacketDispatcher::classify(makePacket("08 06  00 01").get()));
+  // ARP in a VLAN tagged frame
+  EXPECT_EQ(
+      PacketClass::NEIGHBOR,
+      RxPacketDispatcher::classify(makePacket("81 00 00 05  08 06").get()));
+  EXPECT_EQ(
+      PacketClass::NEIGHBOR, RxPacketDispatcher::classify(makeNdp().get()));
+
+  auto ipv4 = [](const std::string& proto, const std::string& ports) {
+    return makePacket(
+        "08 00  45 00 00 28  00 00 00 00  40 " + proto +
+        " 00 00  0a 00 00 01  0a 00 00 02" + ports);
+  };
+  // TCP to port 179
+  EXPECT_EQ(
+      PacketClass::ROUTING,
+      RxPacketDispatcher::classify(ipv4("06", "c0 01 00 b3").get()));
+  // TCP from port 179
+  EXPECT_EQ(
+      PacketClass::ROUTING,
+      RxPacketDispatcher::classify(ipv4("06", "00 b3 c0 01").get()));
+  // TCP, not BGP
+  EXPECT_EQ(
+      PacketClass::DEFAULT,
+      RxPacketDispatcher::classify(ipv4("06", "c0 01 00 16").get()));
+  // UDP to port 179
+  EXPECT_EQ(
+      PacketClass::DEFAULT,
+      RxPacketDispatcher::classify(ipv4("11", "c0 01 00 b3").get()));
+
+  auto ipv6Bgp = makePacket(
+      "86 dd  60 00 00 00  00 14  06 40"
+      "fe 80 00 00 00 00 00 00 00 00 00 00 00 00 00 01"
+      "fe 80 00 00 00 00 00 00 00 00 00 00 00 00 00 02"
+      "c0 01 00 b3");
+  EXPECT_EQ(PacketClass::ROUTING, RxPacketDispatcher::classify(ipv6Bgp.get()));
+
+  // Too short to tell
+  EXPECT_EQ(
+      PacketClass::DEFAULT,
+      RxPacketDispatcher::classify(MockRxPacket::fromHex(kMacs).get()));
+}
+
+TEST(RxPacketDispatcherTest, HandlesOnWorkers) {
+  folly::Synchronized<std::vector<std::thread::id>> threads;
+  {
+    RxPacketDispatcher dispatcher([&](std::unique_ptr<RxPacket> /*pkt*/) {
+      threads.wlock()->push_back(std::this_thread::get_id());
+    });
+    for (int i = 0; i < 10; ++i) {
+      dispatcher.dispatch(makeLacp());
+      dispatcher.dispatch(makeNdp());
+    }
+  }
+  // Everything queued is handled before the dispatcher goes away
+  auto result = threads.copy();
+  ASSERT_EQ(20, result.size());
+  for (auto id : result) {
+    EXPECT_NE(std::this_thread::get_id(), id);
+  }
+}
+
+TEST(RxPacketDispatcherTest, DropNewest) {
+  uint64_t drops;
+  auto handled = ndStorm(DropPolicy::DROP_NEWEST, &drops);
+  EXPECT_EQ(2, drops);
+  EXPECT_EQ((std::vector<PortID>{PortID(1), PortID(2), PortID(3)}), handled);
+}
+
+TEST(RxPacketDispatcherTest, DropOldest) {
+  uint64_t drops;
+  auto handled = ndStorm(DropPolicy::DROP_OLDEST, &drops);
+  EXPECT_EQ(2, drops);
+  EXPECT_EQ((std::vector<PortID>{PortID(1), PortID(4), PortID(5)}), handled);
+}
+
+TEST(RxPacketDispatcherTest, StormDoesNotDelayControl) {
+  folly::Baton<> unblock;
+  folly::Baton<> lacpHandled;
+  RxPacketDispatcher dispatcher(
+      [&](std::unique_ptr<RxPacket> pkt) {
+        auto cls = RxPacketDispatcher::classify(pkt.get());
+        if (cls == PacketClass::NEIGHBOR) {
+          unblock.wait();
+        } else if (cls == PacketClass::CONTROL) {
+          lacpHandled.post();
+        }
+      },
+      configsWithNeighbor(16, DropPolicy::DROP_OLDEST));
+  for (int i = 0; i < 100; ++i) {
+    dispatcher.dispatch(makeNdp());
+  }
+  dispatcher.dispatch(makeLacp());
+  EXPECT_TRUE(lacpHandled.try_wait_for(std::chrono::seconds(5)));
+  EXPECT_GT(dispatcher.drops(PacketClass::NEIGHBOR), 0);
+  EXPECT_EQ(0, dispatcher.drops(PacketClass::CONTROL));
+  unblock.post();
+}
@@ -0,0 +1,169 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/RxPacketPolicer.h"
+#include "fboss/agent/hw/mock/MockRxPacket.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace facebook::fboss;
+using folly::MacAddress;
+using PacketClass = RxPacketPolicer::PacketClass;
+
+namespace {
+
+// Rates are powers of two, so that token counts are exact
+constexpr double kNow = 1000;
+
+std::unique_ptr<MockRxPacket> makePacket(
+    const std::string& srcMac,
+    const std::string& payload,
+    PortID port = PortID(1)) {
+  auto pkt = MockRxPacket::fromHex("ff ff ff ff ff ff " + srcMac + payload);
+  pkt->padToLength(68);
+  pkt->setSrcPort(port);
+  return pkt;
+}
+
+std::unique_ptr<MockRxPacket> makeArp(
+    const std::string& srcMac = "02 00 00 00 00 01",
+    PortID port = PortID(1)) {
+  return makePacket(srcMac, "08 06  00 01", port);
+}
+
+std::unique_ptr<MockRxPacket> makeUdpV4(const std::string& dstPort) {
+  return makePacket(
+      "02 00 00 00 00 01",
+      "08 00  45 00 01 48  00 00 00 00  40 11 00 00"
+      "00 00 00 00  ff ff ff ff"
+      // Source port 68, destination port
+      "00 44 " + dstPort);
+}
+
+RxPacketPolicer makePolicer(double arpPps, size_t maxBuckets = 100) {
+  return RxPacketPolicer(
+      {RxPacketPolicer::Rate{arpPps, arpPps},
+       RxPacketPolicer::Rate{8, 8},
+       RxPacketPolicer::Rate{8, 8}},
+      maxBuckets);
+}
+
+// Returns how many of count packets from the given source are admitted
+int admitted(
+    RxPacketPolicer& policer,
+    int count,
+    const std::string& srcMac = "02 00 00 00 00 01",
+    PortID port = PortID(1),
+    double now = kNow) {
+  int result = 0;
+  for (int i = 0; i < count; ++i) {
+    result += policer.admit(makeArp(srcMac, port).get(), now);
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(RxPacketPolicerTest, Classify) {
+  MacAddress srcMac;
+  EXPECT_EQ(
+      PacketClass::ARP, RxPacketPolicer::classify(makeArp().get(), &srcMac));
+  EXPECT_EQ(MacAddress("02:00:00:00:00:01"), srcMac);
+
+  // VLAN tagged
+  EXPECT_EQ(
+      PacketClass::ARP,
+      RxPacketPolicer::classify(
+          makePacket("02 00 00 00 00 02", "81 00 00 05  08 06").get(),
+          &srcMac));
+  EXPECT_EQ(MacAddress("02:00:00:00:00:02"), srcMac);
+
+  auto ndp = makePacket(
+      "02 00 00 00 00 01",
+      "86 dd  60 00 00 00  00 18  3a ff"
+      "fe 80 00 00 00 00 00 00 00 00 00 00 00 00 00 01"
+      "ff 02 00 00 00 00 00 00 00 00 00 01 ff 00 00 02"
+      // Neighbor solicitation
+      "87 00 00 00");
+  EXPECT_EQ(PacketClass::NDP, RxPacketPolicer::classify(ndp.get(), &srcMac));
+
+  auto dhcpv6 = makePacket(
+      "02 00 00 00 00 01",
+      "86 dd  60 00 00 00  00 18  11 ff"
+      "fe 80 00 00 00 00 00 00 00 00 00 00 00 00 00 01"
+      "ff 02 00 00 00 00 00 00 00 00 00 00 00 01 00 02"
+      // Source port 546, destination port 547
+      "02 22 02 23");
+  EXPECT_EQ(
+      PacketClass::DHCP, RxPacketPolicer::classify(dhcpv6.get(), &srcMac));
+
+  EXPECT_EQ(
+      PacketClass::DHCP,
+      RxPacketPolicer::classify(makeUdpV4("00 43").get(), &srcMac));
+  EXPECT_EQ(
+      std::nullopt,
+      RxPacketPolicer::classify(makeUdpV4("00 35").get(), &srcMac));
+  EXPECT_EQ(
+      std::nullopt,
+      RxPacketPolicer::classify(
+          MockRxPacket::fromHex("ff ff ff ff ff ff 02").get(), &srcMac));
+}
+
+TEST(RxPacketPolicerTest, BurstThenRate) {
+  auto policer = makePolicer(8);
+  EXPECT_EQ(8, admitted(policer, 20));
+  EXPECT_EQ(12, policer.drops(PortID(1), PacketClass::ARP));
+  // Half a second later, half the bucket is back
+  EXPECT_EQ(
+      4, admitted(policer, 20, "02 00 00 00 00 01", PortID(1), kNow + 0.5));
+  EXPECT_EQ(28, policer.drops(PortID(1), PacketClass::ARP));
+}
+
+TEST(RxPacketPolicerTest, SourcesAreIsolated) {
+  auto policer = makePolicer(8);
+  EXPECT_EQ(8, admitted(policer, 100));
+  // Another host on the same port, and the same host on another port
+  EXPECT_EQ(8, admitted(policer, 8, "02 00 00 00 00 02"));
+  EXPECT_EQ(8, admitted(policer, 8, "02 00 00 00 00 01", PortID(2)));
+  EXPECT_EQ(0, policer.drops(PortID(2), PacketClass::ARP));
+  EXPECT_EQ(3, policer.numBuckets());
+}
+
+TEST(RxPacketPolicerTest, UnpolicedTraffic) {
+  auto policer = makePolicer(0);
+  EXPECT_EQ(100, admitted(policer, 100));
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(policer.admit(makeUdpV4("00 35").get(), kNow));
+  }
+  EXPECT_EQ(0, policer.numBuckets());
+}
+
+TEST(RxPacketPolicerTest, TooManySourcesShareBucket) {
+  auto policer = makePolicer(8, 2);
+  EXPECT_EQ(8, admitted(policer, 8, "02 00 00 00 00 01"));
+  EXPECT_EQ(8, admitted(policer, 8, "02 00 00 00 00 02"));
+  // Any further sources share one bucket
+  EXPECT_EQ(8, admitted(policer, 8, "02 00 00 00 00 03"));
+  EXPECT_EQ(0, admitted(policer, 8, "02 00 00 00 00 04"));
+  EXPECT_EQ(3, policer.numBuckets());
+}
+
+TEST(RxPacketPolicerTest, IdleBucketsForgotten) {
+  auto policer = makePolicer(8);
+  EXPECT_EQ(8, admitted(policer, 15));
+  EXPECT_EQ(8, admitted(policer, 8, "02 00 00 00 00 02"));
+  policer.exportStats(kNow);
+  EXPECT_EQ(2, policer.numBuckets());
+  // Buckets are full again a second later
+  policer.exportStats(kNow + 1);
+  EXPECT_EQ(0, policer.numBuckets());
+  EXPECT_EQ(7, policer.drops(PortID(1), PacketClass::ARP));
+}
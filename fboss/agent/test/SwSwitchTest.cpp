@@ -14,10 +14,12 @@
 #include "fboss/agent/Main.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/PortStats.h"
+#include "fboss/agent/StateObserver.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/state/ArpTable.h"
 #include "fboss/agent/state/Interface.h"
 #include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/StateDelta.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/state/Vlan.h"
 #include "fboss/agent/test/CounterCache.h"
@@ -27,8 +29,14 @@
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 #include <folly/MacAddress.h>
+#include <folly/synchronization/Baton.h>
 
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+DECLARE_bool(enable_pipelined_hw_programming);
 
 using namespace facebook::fboss;
 using folly::IPAddressV4;
@@ -36,6 +44,7 @@ using folly::IPAddressV6;
 using folly::MacAddress;
 using std::string;
 using ::testing::_;
+using ::testing::Invoke;
 using ::testing::Return;
 
 class SwSwitchTest : public ::testing::Test {
@@ -125,6 +134,115 @@ TEST_F(SwSwitchTest, HwRejectsUpdateThenAccepts) {
   EXPECT_EQ(0, counters.value(SwitchStats::kCounterPrefix + "hw_out_of_sync"));
 }
 
+namespace {
+class RecordingObserver : public StateObserver {
+ public:
+  void stateUpdated(const StateDelta& delta) override {
+    std::lock_guard<std::mutex> g(mutex_);
+    newStates_.push_back(delta.newState());
+  }
+
+  std::vector<std::shared_ptr<SwitchState>> getNewStates() const {
+    std::lock_guard<std::mutex> g(mutex_);
+    return newStates_;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<std::shared_ptr<SwitchState>> newStates_;
+};
+} // namespace
+
+class SwSwitchPipelinedTest : public SwSwitchTest {
+ public:
+  void SetUp() override {
+    FLAGS_enable_pipelined_hw_programming = true;
+    SwSwitchTest::SetUp();
+  }
+
+  void TearDown() override {
+    SwSwitchTest::TearDown();
+    FLAGS_enable_pipelined_hw_programming = false;
+  }
+};
+
+TEST_F(SwSwitchPipelinedTest, HwRejectsUpdateThenAccepts) {
+  CounterCache counters(sw);
+  RecordingObserver observer;
+  sw->registerStateObserver(&observer, "RecordingObserver");
+  EXPECT_EQ(sw->getAppliedState(), sw->getDesiredState());
+  auto origState = sw->getAppliedState();
+  auto newState = bringAllPortsUp(sw->getAppliedState()->clone());
+  EXPECT_HW_CALL(sw, stateChanged(_)).WillRepeatedly(Return(origState));
+  sw->updateState(
+      "Reject update",
+      [=](const std::shared_ptr<SwitchState>& /*state*/) { return newState; });
+  // Blocking updates only return once the hardware caught up with them
+  waitForStateUpdates(sw);
+  EXPECT_EQ(newState, sw->getDesiredState());
+  EXPECT_EQ(origState, sw->getAppliedState());
+  // Observers are only notified of what got programmed
+  EXPECT_TRUE(observer.getNewStates().empty());
+  counters.update();
+  counters.checkDelta(SwitchStats::kCounterPrefix + "hw_out_of_sync", 1);
+
+  // Have HwSwitch now accept everything. The next state update picks up the
+  // update queued to get back in sync, and the hardware catches up with the
+  // desired state.
+  EXPECT_HW_CALL(sw, stateChanged(_))
+      .WillRepeatedly(
+          Invoke([](const StateDelta& delta) { return delta.newState(); }));
+  waitForStateUpdates(sw);
+  EXPECT_EQ(sw->getAppliedState(), sw->getDesiredState());
+  EXPECT_TRUE(sw->getAppliedState()->getPorts()->getPort(PortID(1))->isUp());
+  auto notified = observer.getNewStates();
+  ASSERT_FALSE(notified.empty());
+  EXPECT_EQ(sw->getAppliedState(), notified.back());
+  counters.update();
+  counters.checkDelta(SwitchStats::kCounterPrefix + "hw_out_of_sync", -1);
+  sw->unregisterStateObserver(&observer);
+}
+
+TEST_F(SwSwitchPipelinedTest, NonCoalescingUpdatesProgrammedSeparately) {
+  const PortID kPort1{1};
+  folly::Baton<> programming;
+  folly::Baton<> finishProgramming;
+  std::atomic<bool> block{true};
+  std::vector<bool> port1Up;
+  EXPECT_HW_CALL(sw, stateChanged(_))
+      .WillRepeatedly(Invoke([&](const StateDelta& delta) {
+        if (block.exchange(false)) {
+          programming.post();
+          finishProgramming.wait();
+        }
+        port1Up.push_back(
+            delta.newState()->getPorts()->getPort(kPort1)->isUp());
+        return delta.newState();
+      }));
+
+  sw->updateState(
+      "Bring Ports Up", [](const std::shared_ptr<SwitchState>& state) {
+        return bringAllPortsUp(state);
+      });
+  programming.wait();
+  // Flap the ports while the hardware is busy with the previous update
+  sw->updateStateNoCoalescing(
+      "Bring Ports Down", [](const std::shared_ptr<SwitchState>& state) {
+        return bringAllPortsDown(state);
+      });
+  sw->updateStateNoCoalescing(
+      "Bring Ports Up Again", [](const std::shared_ptr<SwitchState>& state) {
+        return bringAllPortsUp(state);
+      });
+  // Both are handed over to the hw programming thread by now
+  sw->getUpdateEvb()->runInEventBaseThreadAndWait([] {});
+  finishProgramming.post();
+  waitForStateUpdates(sw);
+
+  // The flap isn't coalesced into no change
+  EXPECT_EQ(std::vector<bool>({true, false, true}), port1Up);
+}
+
 TEST_F(SwSwitchTest, TestStateNonCoalescing) {
   const PortID kPort1{1};
   const VlanID kVlan1{1};
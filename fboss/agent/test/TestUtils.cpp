@@ -118,9 +118,10 @@ shared_ptr<SwitchState> publishAndApplyConfig(
     shared_ptr<SwitchState>& state,
     const cfg::SwitchConfig* config,
     const Platform* platform,
-    rib::RoutingInformationBase* rib) {
+    rib::RoutingInformationBase* rib,
+    AppliedConfigCache* cache) {
   state->publish();
-  return applyThriftConfig(state, config, platform, rib);
+  return applyThriftConfig(state, config, platform, rib, cache);
 }
 
 std::unique_ptr<SwSwitch> setupMockSwitchWithoutHW(
@@ -27,6 +27,7 @@
 
 namespace facebook::fboss {
 
+class AppliedConfigCache;
 class MockHwSwitch;
 class MockPlatform;
 class MockTunManager;
@@ -61,7 +62,8 @@ std::shared_ptr<SwitchState> publishAndApplyConfig(
     std::shared_ptr<SwitchState>& state,
     const cfg::SwitchConfig* config,
     const Platform* platform,
-    rib::RoutingInformationBase* rib = nullptr);
+    rib::RoutingInformationBase* rib = nullptr,
+    AppliedConfigCache* cache = nullptr);
 
 /*
  * Create a SwSwitch for testing purposes, with the specified initial state.
@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/UpdateTracer.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/HwTestHandle.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <folly/json.h>
+#include <gtest/gtest.h>
+
+#include <set>
+
+using namespace facebook::fboss;
+
+namespace {
+
+std::set<std::string> tracedStages(const std::string& chromeTrace) {
+  std::set<std::string> stages;
+  auto parsed = folly::parseJson(chromeTrace);
+  for (const auto& event : parsed["traceEvents"]) {
+    EXPECT_EQ("X", event["ph"].asString());
+    EXPECT_GE(event["dur"].asInt(), 0);
+    stages.insert(event["name"].asString());
+  }
+  return stages;
+}
+
+class UpdateTracerTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    FLAGS_enable_update_tracing = true;
+  }
+  void TearDown() override {
+    FLAGS_enable_update_tracing = false;
+  }
+};
+
+} // namespace
+
+TEST_F(UpdateTracerTest, DisabledIsNoop) {
+  FLAGS_enable_update_tracing = false;
+  EXPECT_EQ(nullptr, UpdateTracer::get()->startTrace("disabled"));
+  {
+    ScopedUpdateTrace trace("disabled");
+    EXPECT_TRUE(UpdateTracer::currentTraces().empty());
+    ScopedTraceSpan span("disabled_stage");
+  }
+  EXPECT_EQ(0, tracedStages(UpdateTracer::get()->dumpChromeTrace()).count(
+                   "disabled_stage"));
+}
+
+TEST_F(UpdateTracerTest, NestedSpans) {
+  {
+    ScopedUpdateTrace trace("nested");
+    ASSERT_EQ(1, UpdateTracer::currentTraces().size());
+    ScopedTraceSpan outer("outer_stage");
+    { ScopedTraceSpan inner("inner_stage"); }
+  }
+  EXPECT_TRUE(UpdateTracer::currentTraces().empty());
+  auto stages = tracedStages(UpdateTracer::get()->dumpChromeTrace());
+  EXPECT_EQ(1, stages.count("outer_stage"));
+  EXPECT_EQ(1, stages.count("inner_stage"));
+}
+
+TEST_F(UpdateTracerTest, TraceFollowsStateUpdate) {
+  auto handle = createTestHandle(testStateA());
+  auto sw = handle->getSw();
+  sw->initialConfigApplied(std::chrono::steady_clock::now());
+  waitForStateUpdates(sw);
+
+  {
+    ScopedUpdateTrace trace("state update");
+    sw->updateStateBlocking(
+        "traced update", [](const std::shared_ptr<SwitchState>& state) {
+          auto newState = state->clone();
+          newState->setArpTimeout(std::chrono::seconds(42));
+          return newState;
+        });
+  }
+
+  // Spans recorded on the update thread land in the trace started on this
+  // thread.
+  auto stages = tracedStages(UpdateTracer::get()->dumpChromeTrace());
+  for (const auto& stage : {"state_update_queue_wait",
+                            "state_update_fn",
+                            "apply_update",
+                            "hw_state_changed",
+                            "observer_notification"}) {
+    EXPECT_EQ(1, stages.count(stage)) << "missing stage " << stage;
+  }
+}
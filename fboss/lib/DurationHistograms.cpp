@@ -0,0 +1,34 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/lib/DurationHistograms.h"
+
+#include <fb303/ServiceData.h>
+
+namespace facebook::fboss {
+
+void DurationHistograms::addValue(
+    const std::string& key,
+    std::chrono::microseconds duration) {
+  exportHistogram(key);
+  fb303::fbData->addHistogramValue(key, duration.count());
+}
+
+void DurationHistograms::exportHistogram(const std::string& key) {
+  if (exported_.rlock()->count(key)) {
+    return;
+  }
+  auto exported = exported_.wlock();
+  if (exported->insert(key).second) {
+    fb303::fbData->addHistogram(key, bucketWidth_, min_, max_);
+    fb303::fbData->exportHistogramPercentile(key, 50, 95, 99);
+  }
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,48 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Synchronized.h>
+
+#include <chrono>
+#include <cstdint>
+#include <set>
+#include <string>
+
+namespace facebook::fboss {
+
+/*
+ * A family of fb303 duration histograms whose keys are only known at run
+ * time (e.g. one per stage). Each key is registered, exporting p50/p95/p99,
+ * the first time a value is added for it.
+ *
+ * Every key gets its own histogram, so keep the bucket count small: the
+ * defaults match the 20 buckets of the state_update.us histogram.
+ */
+class DurationHistograms {
+ public:
+  explicit DurationHistograms(
+      int64_t bucketWidthUsecs = 50000,
+      int64_t minUsecs = 0,
+      int64_t maxUsecs = 1000000)
+      : bucketWidth_(bucketWidthUsecs), min_(minUsecs), max_(maxUsecs) {}
+
+  void addValue(const std::string& key, std::chrono::microseconds duration);
+
+ private:
+  void exportHistogram(const std::string& key);
+
+  const int64_t bucketWidth_;
+  const int64_t min_;
+  const int64_t max_;
+  folly::Synchronized<std::set<std::string>> exported_;
+};
+
+} // namespace facebook::fboss
@@ -34,6 +34,9 @@ const std::string getColorStr(facebook::fboss::FbDomFpga::LedColor ledColor) {
 
 constexpr uint32_t kFacebookFpgaPimTypeReg = 0x0;
 constexpr uint32_t kFacebookFpgaPortLedBase = 0x0310;
+// Not confirmed against the FPGA spec yet, which is why qsfp_service only
+// scans it with --refresh_transceivers_on_events
+constexpr uint32_t kFacebookFpgaQsfpIntrReg = 0x0040;
 constexpr uint32_t kFacebookFpgaQsfpPresentReg = 0x0048;
 constexpr uint32_t kFacebookFpgaQsfpResetReg = 0x0070;
 constexpr uint32_t kFacebookFpgaPimTypeBase = 0xFF000000;
@@ -89,6 +92,10 @@ uint32_t FbDomFpga::getQsfpsPresence() {
   return read(kFacebookFpgaQsfpPresentReg);
 }
 
+uint32_t FbDomFpga::getQsfpsInterrupt() {
+  return read(kFacebookFpgaQsfpIntrReg);
+}
+
 void FbDomFpga::ensureQsfpOutOfReset(int qsfp) {
   uint32_t currentResetReg = read(kFacebookFpgaQsfpResetReg);
   // 1 to hold QSFP reset active. 0 to release QSFP reset.
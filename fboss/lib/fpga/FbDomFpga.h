@@ -44,6 +44,8 @@ class FbDomFpga {
 
   bool isQsfpPresent(int qsfp);
   uint32_t getQsfpsPresence();
+  // One bit per QSFP, set while the QSFP asserts IntL
+  uint32_t getQsfpsInterrupt();
   void ensureQsfpOutOfReset(int qsfp);
 
   /* Function to trigger the QSFP hard reset by toggling the bit from
@@ -11,9 +11,22 @@
 #include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
 
+#include <gflags/gflags.h>
+
 #include <algorithm>
 #include <thread>
 
+DEFINE_bool(
+    fpga_i2c_async_engine,
+    false,
+    "Run FPGA I2C transactions through the asynchronous descriptor engine, "
+    "which polls for completions instead of sleeping");
+DEFINE_int32(
+    fpga_i2c_descriptors,
+    1,
+    "Number of descriptors per RTC the asynchronous FPGA I2C engine keeps "
+    "transactions in flight on");
+
 namespace {
 constexpr uint32_t kFacebookFpgaRTCWriteBlock = 0x2000;
 constexpr uint32_t kFacebookFpgaRTCReadBlock = 0x3000;
@@ -191,7 +204,14 @@ FbFpgaI2cController::FbFpgaI2cController(
       thread_(new std::thread([&, pim, rtcId]() {
         initThread(folly::format("I2c_pim{:d}_rtc{:d}", pim, rtcId).str());
         eventBase_->loopForever();
-      })) {}
+      })) {
+  if (FLAGS_fpga_i2c_async_engine) {
+    FbFpgaI2cEngine::Options options;
+    options.descriptors = std::clamp<int32_t>(
+        FLAGS_fpga_i2c_descriptors, 1, FbFpgaI2cEngine::kMaxDescriptors);
+    engine_ = std::make_unique<FbFpgaI2cEngine>(fpga, rtcId, pim, options);
+  }
+}
 
 FbFpgaI2cController::~FbFpgaI2cController() {
   eventBase_->runInEventBaseThread([&] { eventBase_->terminateLoopSoon(); });
@@ -200,7 +220,9 @@ FbFpgaI2cController::~FbFpgaI2cController() {
 
 uint8_t FbFpgaI2cController::readByte(uint8_t channel, uint8_t offset) {
   uint8_t buf;
-  if (eventBase_->isInEventBaseThread()) {
+  if (engine_) {
+    read(channel, offset, folly::MutableByteRange(&buf, 1));
+  } else if (eventBase_->isInEventBaseThread()) {
     buf = syncedFbI2c_.lock()->readByte(channel, offset);
   } else {
     via(eventBase_.get())
@@ -216,7 +238,10 @@ void FbFpgaI2cController::read(
     uint8_t channel,
     uint8_t offset,
     folly::MutableByteRange buf) {
-  if (eventBase_->isInEventBaseThread()) {
+  if (engine_) {
+    auto data = engine_->read(channel, offset, buf.size()).get();
+    std::copy(data.begin(), data.end(), buf.begin());
+  } else if (eventBase_->isInEventBaseThread()) {
     syncedFbI2c_.lock()->read(channel, offset, buf);
   } else {
     via(eventBase_.get())
@@ -231,7 +256,9 @@ void FbFpgaI2cController::writeByte(
     uint8_t channel,
     uint8_t offset,
     uint8_t val) {
-  if (eventBase_->isInEventBaseThread()) {
+  if (engine_) {
+    write(channel, offset, folly::ByteRange(&val, 1));
+  } else if (eventBase_->isInEventBaseThread()) {
     syncedFbI2c_.lock()->writeByte(channel, offset, val);
   } else {
     via(eventBase_.get())
@@ -246,7 +273,10 @@ void FbFpgaI2cController::write(
     uint8_t channel,
     uint8_t offset,
     folly::ByteRange buf) {
-  if (eventBase_->isInEventBaseThread()) {
+  if (engine_) {
+    std::vector<uint8_t> data(buf.begin(), buf.end());
+    engine_->write(channel, offset, std::move(data)).get();
+  } else if (eventBase_->isInEventBaseThread()) {
     syncedFbI2c_.lock()->write(channel, offset, buf);
   } else {
     via(eventBase_.get())
@@ -257,6 +287,36 @@ void FbFpgaI2cController::write(
   }
 }
 
+folly::SemiFuture<std::vector<uint8_t>>
+FbFpgaI2cController::readAsync(uint8_t channel, uint8_t offset, size_t len) {
+  if (engine_) {
+    return engine_->read(channel, offset, len);
+  }
+  return via(eventBase_.get())
+      .thenValue([=](auto&&) {
+        std::vector<uint8_t> buf(len);
+        syncedFbI2c_.lock()->read(
+            channel, offset, folly::MutableByteRange(buf.data(), buf.size()));
+        return buf;
+      })
+      .semi();
+}
+
+folly::SemiFuture<folly::Unit> FbFpgaI2cController::writeAsync(
+    uint8_t channel,
+    uint8_t offset,
+    std::vector<uint8_t> buf) {
+  if (engine_) {
+    return engine_->write(channel, offset, std::move(buf));
+  }
+  return via(eventBase_.get())
+      .thenValue([this, channel, offset, buf = std::move(buf)](auto&&) {
+        syncedFbI2c_.lock()->write(
+            channel, offset, folly::ByteRange(buf.data(), buf.size()));
+      })
+      .semi();
+}
+
 folly::EventBase* FbFpgaI2cController::getEventBase() {
   return eventBase_.get();
 }
@@ -3,15 +3,18 @@
 #pragma once
 
 #include "fboss/lib/fpga/FbDomFpga.h"
+#include "fboss/lib/fpga/FbFpgaI2cEngine.h"
 #include "fboss/lib/i2c/I2cController.h"
 #include "fboss/lib/usb/TransceiverI2CApi.h"
 
 #include <folly/Range.h>
 #include <folly/Synchronized.h>
+#include <folly/futures/Future.h>
 #include <folly/io/async/EventBase.h>
 
 #include <stdint.h>
 #include <thread>
+#include <vector>
 
 namespace facebook::fboss {
 inline uint8_t getI2cControllerIdx(uint8_t port) {
@@ -51,6 +54,13 @@ class FbFpgaI2c : public I2cController {
   int rtcId_{-1};
 };
 
+/*
+ * Serializes the I2C transactions of an RTC on its own thread.
+ *
+ * With --fpga_i2c_async_engine, transactions go through an FbFpgaI2cEngine
+ * instead, which pipelines them on the RTC descriptors and polls for their
+ * completion rather than sleeping.
+ */
 class FbFpgaI2cController {
  public:
   FbFpgaI2cController(FbDomFpga* fpga, uint32_t rtcId, uint32_t pim);
@@ -62,16 +72,32 @@ class FbFpgaI2cController {
   void writeByte(uint8_t channel, uint8_t offset, uint8_t val);
   void write(uint8_t channel, uint8_t offset, folly::ByteRange buf);
 
+  folly::SemiFuture<std::vector<uint8_t>>
+  readAsync(uint8_t channel, uint8_t offset, size_t len);
+  folly::SemiFuture<folly::Unit>
+  writeAsync(uint8_t channel, uint8_t offset, std::vector<uint8_t> buf);
+
   folly::EventBase* getEventBase();
 
+  // Whether transactions go through the FbFpgaI2cEngine, so that the ones
+  // issued from several threads are queued and pipelined on the RTC rather
+  // than serialized on the controller thread
+  bool isPipelined() const {
+    return engine_ != nullptr;
+  }
+
   /* Get the I2c transaction stats from this controller with the lock
    */
   const I2cControllerStats& getI2cControllerPlatformStats() const {
+    if (engine_) {
+      return engine_->getI2cControllerPlatformStats();
+    }
     return syncedFbI2c_.lock()->getI2cControllerPlatformStats();
   }
 
  private:
   folly::Synchronized<FbFpgaI2c, std::mutex> syncedFbI2c_;
+  std::unique_ptr<FbFpgaI2cEngine> engine_;
   std::unique_ptr<folly::EventBase> eventBase_;
   std::unique_ptr<std::thread> thread_;
 };
@@ -0,0 +1,70 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/lib/fpga/FbFpgaI2cControllerPool.h"
+
+#include "fboss/agent/FbossError.h"
+
+#include <folly/Format.h>
+#include <folly/logging/xlog.h>
+
+namespace facebook::fboss {
+
+FbFpgaI2cControllerPool::FbFpgaI2cControllerPool(
+    const std::vector<FbDomFpga*>& pimFpgas,
+    uint32_t rtcsPerPim)
+    : rtcsPerPim_(rtcsPerPim),
+      controllers_(pimFpgas.size()),
+      channelThreads_(pimFpgas.size()) {
+  for (uint32_t pim = 1; pim <= pimFpgas.size(); ++pim) {
+    auto& controllers = controllers_[pim - 1];
+    for (uint32_t rtc = 0; rtc < rtcsPerPim_; ++rtc) {
+      controllers.push_back(std::make_unique<FbFpgaI2cController>(
+          pimFpgas[pim - 1], rtc, pim));
+      if (!controllers.back()->isPipelined()) {
+        continue;
+      }
+      auto& threads = channelThreads_[pim - 1];
+      threads.resize(rtcsPerPim_ * kChannelsPerRtc);
+      for (uint32_t channel = 0; channel < kChannelsPerRtc; ++channel) {
+        threads[rtc * kChannelsPerRtc + channel] =
+            std::make_unique<folly::ScopedEventBaseThread>(
+                folly::sformat("I2c_pim{}_rtc{}_ch{}", pim, rtc, channel));
+      }
+    }
+  }
+  XLOG(DBG2) << "Created I2C controllers for " << pimFpgas.size()
+             << " PIMs with " << rtcsPerPim_ << " RTCs each";
+}
+
+FbFpgaI2cController* FbFpgaI2cControllerPool::getController(
+    uint8_t pim,
+    uint8_t rtc) const {
+  if (pim < 1 || pim > controllers_.size() || rtc >= rtcsPerPim_) {
+    throw FbossError("No I2C controller for pim ", pim, " rtc ", rtc);
+  }
+  return controllers_[pim - 1][rtc].get();
+}
+
+folly::EventBase* FbFpgaI2cControllerPool::getEventBase(
+    uint8_t pim,
+    uint8_t port) const {
+  auto controller = getControllerForPort(pim, port);
+  const auto& threads = channelThreads_[pim - 1];
+  if (port < threads.size() && threads[port]) {
+    return threads[port]->getEventBase();
+  }
+  return controller->getEventBase();
+}
+
+std::vector<std::reference_wrapper<const I2cControllerStats>>
+FbFpgaI2cControllerPool::getI2cControllerStats() const {
+  std::vector<std::reference_wrapper<const I2cControllerStats>> stats;
+  for (const auto& controllers : controllers_) {
+    for (const auto& controller : controllers) {
+      stats.push_back(controller->getI2cControllerPlatformStats());
+    }
+  }
+  return stats;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,67 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include "fboss/lib/fpga/FbDomFpga.h"
+#include "fboss/lib/fpga/FbFpgaI2c.h"
+
+#include <folly/io/async/EventBase.h>
+#include <folly/io/async/ScopedEventBaseThread.h>
+
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * The I2C controllers of all the real time controllers (RTC) of a set of
+ * PIM DOM FPGAs, so that transceiver transactions can be spread across all
+ * of them.
+ *
+ * Every RTC serves kChannelsPerRtc consecutive ports of its PIM, and has its
+ * own thread, so ports behind different RTCs are accessed in parallel.
+ * When the controllers pipeline transactions through an FbFpgaI2cEngine,
+ * every channel gets its own thread too, so that the transactions of all
+ * the ports behind an RTC are in flight at once.
+ *
+ * NOTE: PIM numbers start from 1, as in the FPGA.
+ */
+class FbFpgaI2cControllerPool {
+ public:
+  static constexpr uint32_t kChannelsPerRtc = 4;
+
+  // pimFpgas[i] is the DOM FPGA of PIM i + 1
+  FbFpgaI2cControllerPool(
+      const std::vector<FbDomFpga*>& pimFpgas,
+      uint32_t rtcsPerPim);
+
+  uint32_t getNumPims() const {
+    return controllers_.size();
+  }
+  uint32_t getRtcsPerPim() const {
+    return rtcsPerPim_;
+  }
+
+  FbFpgaI2cController* getController(uint8_t pim, uint8_t rtc) const;
+  FbFpgaI2cController* getControllerForPort(uint8_t pim, uint8_t port) const {
+    return getController(pim, getI2cControllerIdx(port));
+  }
+
+  // The event base to run the transactions of a port on
+  folly::EventBase* getEventBase(uint8_t pim, uint8_t port) const;
+
+  std::vector<std::reference_wrapper<const I2cControllerStats>>
+  getI2cControllerStats() const;
+
+ private:
+  const uint32_t rtcsPerPim_;
+  std::vector<std::vector<std::unique_ptr<FbFpgaI2cController>>> controllers_;
+  // Threads of the channels of pipelined controllers, indexed like ports.
+  // Declared last so that they stop before the controllers they use.
+  std::vector<std::vector<std::unique_ptr<folly::ScopedEventBaseThread>>>
+      channelThreads_;
+};
+
+} // namespace facebook::fboss
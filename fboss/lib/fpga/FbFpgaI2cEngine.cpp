@@ -0,0 +1,262 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/lib/fpga/FbFpgaI2cEngine.h"
+
+#include "fboss/agent/Utils.h"
+#include "fboss/lib/fpga/FbFpgaI2c.h"
+#include "fboss/lib/fpga/FbFpgaRegisters.h"
+
+#include <folly/Format.h>
+#include <folly/logging/xlog.h>
+#include <folly/portability/Asm.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr uint32_t kFacebookFpgaRTCWriteBlock = 0x2000;
+constexpr uint32_t kFacebookFpgaRTCReadBlock = 0x3000;
+constexpr uint32_t kFacebookFpgaRTCIOBlockSize = 0x0200;
+// The descriptors of an RTC are laid out back to back, each a lower and an
+// upper register. Each descriptor gets an equal share of the IO blocks.
+constexpr uint32_t kDescriptorIncr = 0x8;
+constexpr uint32_t kDescriptorIOBlockSize = kFacebookFpgaRTCIOBlockSize /
+    facebook::fboss::FbFpgaI2cEngine::kMaxDescriptors;
+// Status bits of a descriptor
+constexpr uint32_t kStatusBitsPerDescriptor = 4;
+constexpr uint32_t kStatusDone = 0x1;
+constexpr uint32_t kStatusError = 0x2;
+// Largest length of the descriptor length field
+constexpr size_t kMaxDescriptorLen = 0xff;
+constexpr auto kMinBackoff = std::chrono::microseconds(10);
+} // unnamed namespace
+
+namespace facebook::fboss {
+
+FbFpgaI2cEngine::FbFpgaI2cEngine(
+    FbDomFpga* fpga,
+    uint32_t rtcId,
+    uint32_t pim,
+    const Options& options)
+    : I2cController(
+          folly::to<std::string>("i2cController.pim.", pim, ".rtc.", rtcId)),
+      fpga_(fpga),
+      rtcId_(rtcId),
+      options_(options) {
+  if (options_.descriptors < 1 || options_.descriptors > kMaxDescriptors) {
+    throw FbFpgaI2cError(folly::to<std::string>(
+        "Invalid number of I2C descriptors: ", options_.descriptors));
+  }
+  thread_ = std::thread([this, pim, rtcId]() {
+    initThread(folly::format("I2cEng_pim{:d}_rtc{:d}", pim, rtcId).str());
+    run();
+  });
+}
+
+FbFpgaI2cEngine::~FbFpgaI2cEngine() {
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_one();
+  thread_.join();
+}
+
+size_t FbFpgaI2cEngine::maxTransactionSize() const {
+  // With a single descriptor, it can use all of the IO blocks
+  return options_.descriptors == 1 ? kMaxDescriptorLen
+                                   : kDescriptorIOBlockSize;
+}
+
+folly::SemiFuture<std::vector<uint8_t>>
+FbFpgaI2cEngine::read(uint8_t channel, uint8_t offset, size_t len) {
+  return enqueue(Transaction{true, channel, offset, len, {}, {}, {}});
+}
+
+folly::SemiFuture<folly::Unit> FbFpgaI2cEngine::write(
+    uint8_t channel,
+    uint8_t offset,
+    std::vector<uint8_t> buf) {
+  auto len = buf.size();
+  return enqueue(
+             Transaction{false, channel, offset, len, std::move(buf), {}, {}})
+      .deferValue([](auto&&) {});
+}
+
+folly::SemiFuture<std::vector<uint8_t>> FbFpgaI2cEngine::enqueue(
+    Transaction txn) {
+  if (txn.len == 0 || txn.len > maxTransactionSize()) {
+    return folly::makeSemiFuture<std::vector<uint8_t>>(FbFpgaI2cError(
+        folly::to<std::string>("Invalid I2C transaction length ", txn.len)));
+  }
+  auto future = txn.promise.getSemiFuture();
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    queue_.push_back(std::move(txn));
+  }
+  cond_.notify_one();
+  return future;
+}
+
+void FbFpgaI2cEngine::run() {
+  auto lastProgress = std::chrono::steady_clock::now();
+  auto backoff = kMinBackoff;
+  while (true) {
+    std::vector<std::pair<uint32_t, Transaction>> toIssue;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (numInFlight_ == 0) {
+        cond_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) {
+          // Stopped with nothing left to do
+          return;
+        }
+      }
+      for (uint32_t slot = 0; slot < options_.descriptors && !queue_.empty();
+           ++slot) {
+        if (!inFlight_[slot]) {
+          toIssue.emplace_back(slot, std::move(queue_.front()));
+          queue_.pop_front();
+        }
+      }
+    }
+    for (auto& [slot, txn] : toIssue) {
+      issue(slot, std::move(txn));
+    }
+    if (!toIssue.empty()) {
+      lastProgress = std::chrono::steady_clock::now();
+    }
+
+    if (reapCompletions()) {
+      lastProgress = std::chrono::steady_clock::now();
+      backoff = kMinBackoff;
+      continue;
+    }
+    // Short transactions complete within microseconds, so spin for a while
+    // before giving up the CPU
+    if (std::chrono::steady_clock::now() - lastProgress < options_.spinTime) {
+      folly::asm_volatile_pause();
+      continue;
+    }
+    std::this_thread::sleep_for(backoff);
+    backoff = std::min(backoff * 2, options_.maxBackoff);
+  }
+}
+
+void FbFpgaI2cEngine::issue(uint32_t slot, Transaction txn) {
+  I2cDescriptorLower descLower;
+  I2cDescriptorUpper descUpper;
+  descLower.reg = 0;
+  descUpper.reg = 0;
+
+  descLower.op = txn.isRead ? 1 : 0;
+  descLower.len = txn.len;
+
+  descUpper.offset = txn.offset;
+  descUpper.channel = txn.channel;
+  descUpper.valid = 1;
+
+  if (txn.isRead) {
+    incrReadTotal();
+  } else {
+    incrWriteTotal();
+    auto writeBlockAddr = ioBlockAddr(kFacebookFpgaRTCWriteBlock, slot);
+    for (size_t bytesWritten = 0; bytesWritten < txn.len; bytesWritten += 4) {
+      uint32_t data = 0;
+      std::memcpy(
+          &data,
+          txn.data.data() + bytesWritten,
+          std::min(txn.len - bytesWritten, (size_t)4));
+      fpga_->write(writeBlockAddr + bytesWritten, data);
+    }
+  }
+
+  XLOG(DBG5) << "Descriptor " << slot << ": " << descLower;
+  fpga_->write(
+      descriptorAddr(I2cDescriptorLower::baseAddr::value, slot), descLower.reg);
+  XLOG(DBG5) << "Descriptor " << slot << ": " << descUpper;
+  fpga_->write(
+      descriptorAddr(I2cDescriptorUpper::baseAddr::value, slot), descUpper.reg);
+
+  txn.deadline = std::chrono::steady_clock::now() + options_.timeout +
+      options_.timePerByte * txn.len;
+  inFlight_[slot] = std::move(txn);
+  ++numInFlight_;
+}
+
+bool FbFpgaI2cEngine::reapCompletions() {
+  if (numInFlight_ == 0) {
+    return false;
+  }
+  I2cRtcStatus rtcStatus;
+  rtcStatus.reg = fpga_->read(
+      I2cRtcStatus::baseAddr::value + I2cRtcStatus::addrIncr::value * rtcId_);
+  auto now = std::chrono::steady_clock::now();
+  bool completed = false;
+  for (uint32_t slot = 0; slot < options_.descriptors; ++slot) {
+    if (!inFlight_[slot]) {
+      continue;
+    }
+    auto bits = rtcStatus.reg >> (slot * kStatusBitsPerDescriptor);
+    if (bits & kStatusError) {
+      XLOG(DBG5) << "I2C read/write ops has error.";
+      complete(slot, true);
+    } else if (bits & kStatusDone) {
+      complete(slot, false);
+    } else if (now >= inFlight_[slot]->deadline) {
+      XLOG(DBG5) << "I2C read/write ops timed out.";
+      complete(slot, true);
+    } else {
+      continue;
+    }
+    completed = true;
+  }
+  return completed;
+}
+
+void FbFpgaI2cEngine::complete(uint32_t slot, bool error) {
+  auto txn = std::move(*inFlight_[slot]);
+  inFlight_[slot].reset();
+  --numInFlight_;
+
+  if (error) {
+    if (txn.isRead) {
+      incrReadFailed();
+    } else {
+      incrWriteFailed();
+    }
+    txn.promise.setException(FbFpgaI2cError(
+        txn.isRead ? "I2C read failed." : "I2C write failed."));
+    return;
+  }
+
+  std::vector<uint8_t> result;
+  if (txn.isRead) {
+    result.resize(txn.len);
+    auto readBlockAddr = ioBlockAddr(kFacebookFpgaRTCReadBlock, slot);
+    for (size_t bytesRead = 0; bytesRead < txn.len; bytesRead += 4) {
+      uint32_t data = fpga_->read(readBlockAddr + bytesRead);
+      std::memcpy(
+          result.data() + bytesRead,
+          &data,
+          std::min(txn.len - bytesRead, (size_t)4));
+    }
+    incrReadBytes(txn.len);
+  } else {
+    incrWriteBytes(txn.len);
+  }
+  txn.promise.setValue(std::move(result));
+}
+
+uint32_t FbFpgaI2cEngine::descriptorAddr(uint32_t base, uint32_t slot) const {
+  // See FbFpgaI2c::getRegAddr() for the layout of the RTC registers
+  return base + I2cDescriptorLower::addrIncr::value * rtcId_ +
+      kDescriptorIncr * slot;
+}
+
+uint32_t FbFpgaI2cEngine::ioBlockAddr(uint32_t base, uint32_t slot) const {
+  return base + kFacebookFpgaRTCIOBlockSize * rtcId_ +
+      kDescriptorIOBlockSize * slot;
+}
+
+} // namespace facebook::fboss
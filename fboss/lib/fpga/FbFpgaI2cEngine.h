@@ -0,0 +1,104 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include "fboss/lib/fpga/FbDomFpga.h"
+#include "fboss/lib/i2c/I2cController.h"
+
+#include <folly/futures/Future.h>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Asynchronous I2C engine for one real time controller (RTC) of an
+ * FbDomFpga.
+ *
+ * Transactions are queued and return a future. A worker thread keeps up to
+ * Options::descriptors of them in flight on the RTC descriptors, and polls
+ * the RTC status for completions: busy-polling for Options::spinTime after
+ * the last completion, then sleeping with an exponential backoff capped at
+ * Options::maxBackoff. This replaces the fixed sleep of FbFpgaI2c, which
+ * costs a millisecond or more per transaction regardless of its length.
+ *
+ * Transactions are issued in the order they were queued.
+ */
+class FbFpgaI2cEngine : public I2cController {
+ public:
+  static constexpr uint32_t kMaxDescriptors = 4;
+
+  struct Options {
+    // Descriptors kept in flight on the RTC, up to kMaxDescriptors
+    uint32_t descriptors{1};
+    std::chrono::microseconds spinTime{50};
+    std::chrono::microseconds maxBackoff{500};
+    // A transaction of len bytes fails after timeout + len * timePerByte
+    std::chrono::microseconds timeout{10000};
+    std::chrono::microseconds timePerByte{100};
+  };
+
+  FbFpgaI2cEngine(
+      FbDomFpga* fpga,
+      uint32_t rtcId,
+      uint32_t pim,
+      const Options& options);
+  // Completes all the queued transactions first
+  ~FbFpgaI2cEngine();
+
+  folly::SemiFuture<std::vector<uint8_t>>
+  read(uint8_t channel, uint8_t offset, size_t len);
+  folly::SemiFuture<folly::Unit>
+  write(uint8_t channel, uint8_t offset, std::vector<uint8_t> buf);
+
+  // Longest transaction a descriptor can carry
+  size_t maxTransactionSize() const;
+
+ private:
+  struct Transaction {
+    bool isRead;
+    uint8_t channel;
+    uint8_t offset;
+    size_t len;
+    // Data to write
+    std::vector<uint8_t> data;
+    folly::Promise<std::vector<uint8_t>> promise;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  folly::SemiFuture<std::vector<uint8_t>> enqueue(Transaction txn);
+  void run();
+  void issue(uint32_t slot, Transaction txn);
+  // Completes the transactions in flight that are done, failed or timed
+  // out. Returns whether any did.
+  bool reapCompletions();
+  void complete(uint32_t slot, bool error);
+
+  uint32_t descriptorAddr(uint32_t base, uint32_t slot) const;
+  uint32_t ioBlockAddr(uint32_t base, uint32_t slot) const;
+
+  FbDomFpga* fpga_{nullptr};
+  const uint32_t rtcId_;
+  const Options options_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<Transaction> queue_;
+  bool stop_{false};
+
+  // Only accessed by the worker thread
+  std::array<std::optional<Transaction>, kMaxDescriptors> inFlight_;
+  uint32_t numInFlight_{0};
+
+  std::thread thread_;
+};
+
+} // namespace facebook::fboss
@@ -105,6 +105,18 @@ std::array<bool, MinipackFpga::kNumPortsPerPim> MinipackFpga::scanQsfpPresence(
   return qsfpPresence;
 }
 
+std::array<bool, MinipackFpga::kNumPortsPerPim> MinipackFpga::scanQsfpInterrupt(
+    uint8_t pim) {
+  uint32_t qsfpIntrReg = pimFpgas_[pim - 1]->getQsfpsInterrupt();
+  // Same layout as the presence register, a bit per QSFP from the lower end
+  XLOG(DBG5) << folly::format("qsfpIntrReg value:{:#x}", qsfpIntrReg);
+  std::array<bool, kNumPortsPerPim> qsfpInterrupt;
+  for (int i = 0; i < kNumPortsPerPim; i++) {
+    qsfpInterrupt[i] = (qsfpIntrReg >> i) & 1;
+  }
+  return qsfpInterrupt;
+}
+
 void MinipackFpga::ensureQsfpOutOfReset(uint8_t pim, int qsfp) {
   pimFpgas_[pim - 1]->ensureQsfpOutOfReset(qsfp);
 }
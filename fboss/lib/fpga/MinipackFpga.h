@@ -46,6 +46,7 @@ class MinipackFpga {
 
   bool isQsfpPresent(uint8_t pim, int qsfp);
   std::array<bool, kNumPortsPerPim> scanQsfpPresence(uint8_t pim);
+  std::array<bool, kNumPortsPerPim> scanQsfpInterrupt(uint8_t pim);
   void ensureQsfpOutOfReset(uint8_t pim, int qsfp);
 
   /* Trigger the QSFP hard reset of a given port on a given line card (PIM)
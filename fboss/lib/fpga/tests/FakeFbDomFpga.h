@@ -0,0 +1,221 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include "fboss/lib/fpga/FbDomFpga.h"
+#include "fboss/lib/fpga/FbFpgaRegisters.h"
+#include "fboss/lib/test/FakePhysicalMemory.h"
+
+#include <folly/Range.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * FbDomFpga with its registers in process memory, and a fake I2C device of
+ * 256 bytes behind every channel of its real time controllers (RTC).
+ *
+ * Writing a valid descriptor queues a transaction that takes latency +
+ * len * latencyPerByte. Like on the hardware, the transactions of an RTC go
+ * over its bus one at a time. They are completed when the RTC status is
+ * read, so no thread is needed to drive them.
+ */
+class FakeFbDomFpga : public FbDomFpga {
+ public:
+  static constexpr uint32_t kNumRtcs = 8;
+  static constexpr uint32_t kNumChannels = 4;
+  static constexpr uint32_t kDescriptorsPerRtc = 4;
+
+  FakeFbDomFpga(
+      std::chrono::microseconds latency,
+      std::chrono::microseconds latencyPerByte)
+      : FbDomFpga(kFakeAddr, kFakeSize, 0),
+        regs_(kFakeAddr, kFakeSize, false),
+        latency_(latency),
+        latencyPerByte_(latencyPerByte) {
+    regs_.mmap();
+  }
+
+  uint32_t read(uint32_t offset) const override {
+    std::lock_guard<std::mutex> g(mutex_);
+    if (offset >= I2cRtcStatus::baseAddr::value &&
+        offset < I2cRtcStatus::baseAddr::value +
+                I2cRtcStatus::addrIncr::value * kNumRtcs) {
+      completeTransactions(
+          (offset - I2cRtcStatus::baseAddr::value) /
+          I2cRtcStatus::addrIncr::value);
+    }
+    return regs_.read(offset);
+  }
+
+  void write(uint32_t offset, uint32_t value) override {
+    std::lock_guard<std::mutex> g(mutex_);
+    regs_.write(offset, value);
+    auto descBase = I2cDescriptorUpper::baseAddr::value;
+    auto descEnd = descBase + I2cDescriptorUpper::addrIncr::value * kNumRtcs;
+    if (offset < descBase || offset >= descEnd ||
+        (offset - descBase) % kDescriptorIncr != 0) {
+      return;
+    }
+    I2cDescriptorUpper upper;
+    upper.reg = value;
+    if (upper.valid) {
+      auto rtc = (offset - descBase) / I2cDescriptorUpper::addrIncr::value;
+      auto slot = (offset - descBase) % I2cDescriptorUpper::addrIncr::value /
+          kDescriptorIncr;
+      startTransaction(rtc, slot, offset - 4, upper);
+    }
+  }
+
+  void setDeviceData(
+      uint32_t rtc,
+      uint32_t channel,
+      uint8_t offset,
+      folly::ByteRange data) {
+    std::lock_guard<std::mutex> g(mutex_);
+    for (size_t i = 0; i < data.size(); ++i) {
+      devices_[rtc][channel][(offset + i) % kDeviceSize] = data[i];
+    }
+  }
+
+  std::vector<uint8_t>
+  getDeviceData(uint32_t rtc, uint32_t channel, uint8_t offset, size_t len) {
+    std::lock_guard<std::mutex> g(mutex_);
+    std::vector<uint8_t> data(len);
+    for (size_t i = 0; i < len; ++i) {
+      data[i] = devices_[rtc][channel][(offset + i) % kDeviceSize];
+    }
+    return data;
+  }
+
+  // Transactions on a failed channel complete with an error
+  void setChannelFailed(uint32_t rtc, uint32_t channel, bool failed) {
+    std::lock_guard<std::mutex> g(mutex_);
+    failed_[rtc][channel] = failed;
+  }
+
+  // Most transactions that were in flight at once on an RTC
+  uint32_t maxInFlight(uint32_t rtc) const {
+    std::lock_guard<std::mutex> g(mutex_);
+    return maxInFlight_[rtc];
+  }
+
+ private:
+  static constexpr uint64_t kFakeAddr = 0xfb000000;
+  static constexpr uint32_t kFakeSize = 0x4000;
+  static constexpr uint32_t kDeviceSize = 256;
+  static constexpr uint32_t kDescriptorIncr = 0x8;
+  static constexpr uint32_t kWriteBlock = 0x2000;
+  static constexpr uint32_t kReadBlock = 0x3000;
+  static constexpr uint32_t kIOBlockSize = 0x200;
+  static constexpr uint32_t kStatusBitsPerDescriptor = 4;
+
+  struct Transaction {
+    bool active{false};
+    bool isRead;
+    uint32_t channel;
+    uint8_t offset;
+    size_t len;
+    std::chrono::steady_clock::time_point doneAt;
+  };
+
+  uint32_t ioBlockAddr(uint32_t base, uint32_t rtc, uint32_t slot) const {
+    return base + kIOBlockSize * rtc + kIOBlockSize / kDescriptorsPerRtc * slot;
+  }
+
+  void startTransaction(
+      uint32_t rtc,
+      uint32_t slot,
+      uint32_t lowerAddr,
+      I2cDescriptorUpper upper) {
+    I2cDescriptorLower lower;
+    lower.reg = regs_.read(lowerAddr);
+    auto& txn = transactions_[rtc][slot];
+    txn.active = true;
+    txn.isRead = lower.op == 1;
+    txn.channel = upper.channel;
+    txn.offset = upper.offset;
+    txn.len = lower.len;
+    busyUntil_[rtc] =
+        std::max(busyUntil_[rtc], std::chrono::steady_clock::now()) +
+        latency_ + latencyPerByte_ * txn.len;
+    txn.doneAt = busyUntil_[rtc];
+    // A new transaction clears the status of its descriptor
+    setStatus(rtc, slot, 0);
+
+    uint32_t inFlight = std::count_if(
+        transactions_[rtc].begin(),
+        transactions_[rtc].end(),
+        [](const auto& t) { return t.active; });
+    maxInFlight_[rtc] = std::max(maxInFlight_[rtc], inFlight);
+  }
+
+  void completeTransactions(uint32_t rtc) const {
+    auto now = std::chrono::steady_clock::now();
+    for (uint32_t slot = 0; slot < kDescriptorsPerRtc; ++slot) {
+      auto& txn = transactions_[rtc][slot];
+      if (!txn.active || now < txn.doneAt) {
+        continue;
+      }
+      txn.active = false;
+      if (failed_[rtc][txn.channel]) {
+        setStatus(rtc, slot, 0x2);
+        continue;
+      }
+      auto& device = devices_[rtc][txn.channel];
+      auto block =
+          ioBlockAddr(txn.isRead ? kReadBlock : kWriteBlock, rtc, slot);
+      std::vector<uint8_t> data(txn.len + 3);
+      if (txn.isRead) {
+        for (size_t i = 0; i < txn.len; ++i) {
+          data[i] = device[(txn.offset + i) % kDeviceSize];
+        }
+        for (size_t i = 0; i < txn.len; i += 4) {
+          uint32_t word;
+          std::memcpy(&word, data.data() + i, 4);
+          regs_.write(block + i, word);
+        }
+      } else {
+        for (size_t i = 0; i < txn.len; i += 4) {
+          uint32_t word = regs_.read(block + i);
+          std::memcpy(data.data() + i, &word, 4);
+        }
+        for (size_t i = 0; i < txn.len; ++i) {
+          device[(txn.offset + i) % kDeviceSize] = data[i];
+        }
+      }
+      setStatus(rtc, slot, 0x1);
+    }
+  }
+
+  void setStatus(uint32_t rtc, uint32_t slot, uint32_t bits) const {
+    auto addr =
+        I2cRtcStatus::baseAddr::value + I2cRtcStatus::addrIncr::value * rtc;
+    auto shift = slot * kStatusBitsPerDescriptor;
+    auto status = regs_.read(addr) & ~(0xfu << shift);
+    regs_.write(addr, status | (bits << shift));
+  }
+
+  mutable std::mutex mutex_;
+  // Registers change under status reads, as the hardware would
+  mutable FakePhysicalMemory32 regs_;
+  const std::chrono::microseconds latency_;
+  const std::chrono::microseconds latencyPerByte_;
+  mutable std::array<
+      std::array<std::array<uint8_t, kDeviceSize>, kNumChannels>,
+      kNumRtcs>
+      devices_{};
+  mutable std::array<std::array<Transaction, kDescriptorsPerRtc>, kNumRtcs>
+      transactions_{};
+  std::array<std::array<bool, kNumChannels>, kNumRtcs> failed_{};
+  std::array<std::chrono::steady_clock::time_point, kNumRtcs> busyUntil_{};
+  std::array<uint32_t, kNumRtcs> maxInFlight_{};
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,144 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/lib/fpga/FbFpgaI2c.h"
+#include "fboss/lib/fpga/FbFpgaI2cControllerPool.h"
+#include "fboss/lib/fpga/tests/FakeFbDomFpga.h"
+
+#include <folly/Benchmark.h>
+#include <folly/futures/Future.h>
+#include <gflags/gflags.h>
+
+#include <memory>
+#include <vector>
+
+using namespace facebook::fboss;
+
+DECLARE_bool(fpga_i2c_async_engine);
+DECLARE_int32(fpga_i2c_descriptors);
+
+DEFINE_int32(
+    fake_i2c_latency_us,
+    100,
+    "Fixed latency of a transaction on the fake I2C bus");
+DEFINE_int32(
+    fake_i2c_latency_per_byte_us,
+    25,
+    "Latency of every byte of a transaction on the fake I2C bus, 25us is "
+    "about a 400KHz bus");
+
+namespace {
+
+// A full Minipack chassis: 8 PIMs of 16 ports, behind 4 RTCs each
+constexpr uint32_t kNumPims = 8;
+constexpr uint32_t kPortsPerPim = 16;
+constexpr uint32_t kRtcsPerPim =
+    kPortsPerPim / FbFpgaI2cControllerPool::kChannelsPerRtc;
+// A DOM refresh of a port reads a couple of 128 byte pages and a few
+// single bytes
+constexpr size_t kPageSize = 128;
+constexpr int kPagesPerRefresh = 2;
+constexpr int kBytesPerRefresh = 4;
+
+struct Chassis {
+  std::vector<std::unique_ptr<FakeFbDomFpga>> fpgas;
+  std::unique_ptr<FbFpgaI2cControllerPool> pool;
+};
+
+std::unique_ptr<Chassis> makeChassis(bool engine, uint32_t descriptors) {
+  FLAGS_fpga_i2c_async_engine = engine;
+  FLAGS_fpga_i2c_descriptors = descriptors;
+  auto chassis = std::make_unique<Chassis>();
+  std::vector<FbDomFpga*> pimFpgas;
+  for (uint32_t pim = 1; pim <= kNumPims; ++pim) {
+    chassis->fpgas.push_back(std::make_unique<FakeFbDomFpga>(
+        std::chrono::microseconds(FLAGS_fake_i2c_latency_us),
+        std::chrono::microseconds(FLAGS_fake_i2c_latency_per_byte_us)));
+    pimFpgas.push_back(chassis->fpgas.back().get());
+  }
+  chassis->pool =
+      std::make_unique<FbFpgaI2cControllerPool>(pimFpgas, kRtcsPerPim);
+  return chassis;
+}
+
+void refreshPort(
+    const FbFpgaI2cControllerPool& pool,
+    uint8_t pim,
+    uint8_t port) {
+  auto controller = pool.getControllerForPort(pim, port);
+  auto channel = getI2cControllerChannel(port);
+  std::vector<uint8_t> page(kPageSize);
+  for (int i = 0; i < kPagesPerRefresh; ++i) {
+    controller->read(channel, kPageSize, folly::range(page));
+  }
+  for (int i = 0; i < kBytesPerRefresh; ++i) {
+    controller->readByte(channel, i);
+  }
+}
+
+// Refreshes the ports one after the other
+void sequentialRefresh(size_t iters, bool engine, uint32_t descriptors) {
+  std::unique_ptr<Chassis> chassis;
+  BENCHMARK_SUSPEND {
+    chassis = makeChassis(engine, descriptors);
+  }
+  for (size_t i = 0; i < iters; ++i) {
+    for (uint8_t pim = 1; pim <= kNumPims; ++pim) {
+      for (uint8_t port = 0; port < kPortsPerPim; ++port) {
+        refreshPort(*chassis->pool, pim, port);
+      }
+    }
+  }
+  BENCHMARK_SUSPEND {
+    chassis.reset();
+  }
+}
+
+// Refreshes all the ports at once on the event bases of the pool, like
+// WedgeManager::refreshTransceivers()
+void poolRefresh(size_t iters, bool engine, uint32_t descriptors) {
+  std::unique_ptr<Chassis> chassis;
+  BENCHMARK_SUSPEND {
+    chassis = makeChassis(engine, descriptors);
+  }
+  for (size_t i = 0; i < iters; ++i) {
+    std::vector<folly::Future<folly::Unit>> futures;
+    for (uint8_t pim = 1; pim <= kNumPims; ++pim) {
+      for (uint8_t port = 0; port < kPortsPerPim; ++port) {
+        auto pool = chassis->pool.get();
+        futures.push_back(
+            folly::via(pool->getEventBase(pim, port))
+                .thenValue([pool, pim, port](auto&&) {
+                  refreshPort(*pool, pim, port);
+                }));
+      }
+    }
+    folly::collectAllUnsafe(futures.begin(), futures.end()).wait();
+  }
+  BENCHMARK_SUSPEND {
+    chassis.reset();
+  }
+}
+
+} // namespace
+
+BENCHMARK(SequentialRefresh, n) {
+  sequentialRefresh(n, false, 1);
+}
+
+BENCHMARK_RELATIVE(PoolRefresh, n) {
+  poolRefresh(n, false, 1);
+}
+
+BENCHMARK_RELATIVE(EnginePoolRefresh, n) {
+  poolRefresh(n, true, 1);
+}
+
+BENCHMARK_RELATIVE(PipelinedEnginePoolRefresh, n) {
+  poolRefresh(n, true, FbFpgaI2cEngine::kMaxDescriptors);
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
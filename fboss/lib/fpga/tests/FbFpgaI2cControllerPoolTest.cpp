@@ -0,0 +1,110 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/lib/fpga/FbFpgaI2c.h"
+#include "fboss/lib/fpga/FbFpgaI2cControllerPool.h"
+#include "fboss/lib/fpga/tests/FakeFbDomFpga.h"
+
+#include <folly/futures/Future.h>
+#include <gflags/gflags.h>
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+DECLARE_bool(fpga_i2c_async_engine);
+DECLARE_int32(fpga_i2c_descriptors);
+
+using namespace facebook::fboss;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uint32_t kNumPims = 2;
+constexpr uint32_t kRtcsPerPim = 4;
+constexpr uint32_t kPortsPerPim =
+    kRtcsPerPim * FbFpgaI2cControllerPool::kChannelsPerRtc;
+
+class FbFpgaI2cControllerPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    for (uint32_t pim = 1; pim <= kNumPims; ++pim) {
+      fpgas_.push_back(std::make_unique<FakeFbDomFpga>(20us, 1us));
+    }
+  }
+
+  void TearDown() override {
+    FLAGS_fpga_i2c_async_engine = false;
+    FLAGS_fpga_i2c_descriptors = 1;
+  }
+
+  std::unique_ptr<FbFpgaI2cControllerPool> makePool() {
+    std::vector<FbDomFpga*> pimFpgas;
+    for (const auto& fpga : fpgas_) {
+      pimFpgas.push_back(fpga.get());
+    }
+    return std::make_unique<FbFpgaI2cControllerPool>(pimFpgas, kRtcsPerPim);
+  }
+
+  std::set<folly::EventBase*> eventBases(const FbFpgaI2cControllerPool& pool) {
+    std::set<folly::EventBase*> evbs;
+    for (uint8_t pim = 1; pim <= kNumPims; ++pim) {
+      for (uint8_t port = 0; port < kPortsPerPim; ++port) {
+        evbs.insert(pool.getEventBase(pim, port));
+      }
+    }
+    return evbs;
+  }
+
+  std::vector<std::unique_ptr<FakeFbDomFpga>> fpgas_;
+};
+
+} // namespace
+
+TEST_F(FbFpgaI2cControllerPoolTest, PortsMapToControllers) {
+  auto pool = makePool();
+  EXPECT_EQ(kNumPims, pool->getNumPims());
+  EXPECT_EQ(kNumPims * kRtcsPerPim, pool->getI2cControllerStats().size());
+
+  std::vector<uint8_t> data{0xab};
+  fpgas_[1]->setDeviceData(2, 1, 0x10, folly::range(data));
+  // Port 9 of PIM 2 is channel 1 of its RTC 2
+  EXPECT_EQ(pool->getController(2, 2), pool->getControllerForPort(2, 9));
+  EXPECT_EQ(0xab, pool->getControllerForPort(2, 9)->readByte(1, 0x10));
+
+  EXPECT_THROW(pool->getController(0, 0), FbossError);
+  EXPECT_THROW(pool->getController(kNumPims + 1, 0), FbossError);
+  EXPECT_THROW(pool->getController(1, kRtcsPerPim), FbossError);
+}
+
+TEST_F(FbFpgaI2cControllerPoolTest, EventBasePerController) {
+  auto pool = makePool();
+  EXPECT_EQ(kNumPims * kRtcsPerPim, eventBases(*pool).size());
+  EXPECT_EQ(
+      pool->getController(1, 3)->getEventBase(), pool->getEventBase(1, 13));
+}
+
+TEST_F(FbFpgaI2cControllerPoolTest, EventBasePerChannelWhenPipelined) {
+  FLAGS_fpga_i2c_async_engine = true;
+  FLAGS_fpga_i2c_descriptors = FbFpgaI2cEngine::kMaxDescriptors;
+  auto pool = makePool();
+  EXPECT_EQ(kNumPims * kPortsPerPim, eventBases(*pool).size());
+
+  // Refreshing all the ports of an RTC at once keeps its descriptors busy
+  std::vector<folly::Future<folly::Unit>> futures;
+  for (uint8_t port = 0; port < FbFpgaI2cControllerPool::kChannelsPerRtc;
+       ++port) {
+    futures.push_back(folly::via(pool->getEventBase(1, port))
+                          .thenValue([&pool, port](auto&&) {
+                            std::vector<uint8_t> buf(128);
+                            for (int i = 0; i < 8; ++i) {
+                              pool->getControllerForPort(1, port)->read(
+                                  getI2cControllerChannel(port),
+                                  0,
+                                  folly::range(buf));
+                            }
+                          }));
+  }
+  folly::collectAllUnsafe(futures.begin(), futures.end()).get();
+  EXPECT_LT(1, fpgas_[0]->maxInFlight(0));
+}
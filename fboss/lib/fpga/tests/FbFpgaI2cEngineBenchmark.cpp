@@ -0,0 +1,111 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/lib/fpga/FbFpgaI2c.h"
+#include "fboss/lib/fpga/FbFpgaI2cEngine.h"
+#include "fboss/lib/fpga/tests/FakeFbDomFpga.h"
+
+#include <folly/Benchmark.h>
+#include <folly/futures/Future.h>
+#include <gflags/gflags.h>
+
+#include <memory>
+#include <vector>
+
+using namespace facebook::fboss;
+
+DEFINE_int32(
+    fake_i2c_latency_us,
+    100,
+    "Fixed latency of a transaction on the fake I2C bus");
+DEFINE_int32(
+    fake_i2c_latency_per_byte_us,
+    25,
+    "Latency of every byte of a transaction on the fake I2C bus, 25us is "
+    "about a 400KHz bus");
+
+namespace {
+
+constexpr uint32_t kRtc = 0;
+constexpr uint32_t kPim = 1;
+// A DOM refresh of a port reads a couple of 128 byte pages and a few
+// single bytes
+constexpr size_t kPageSize = 128;
+
+std::unique_ptr<FakeFbDomFpga> makeFpga() {
+  return std::make_unique<FakeFbDomFpga>(
+      std::chrono::microseconds(FLAGS_fake_i2c_latency_us),
+      std::chrono::microseconds(FLAGS_fake_i2c_latency_per_byte_us));
+}
+
+FbFpgaI2cEngine::Options makeOptions(uint32_t descriptors) {
+  FbFpgaI2cEngine::Options options;
+  options.descriptors = descriptors;
+  return options;
+}
+
+void syncReads(size_t iters, size_t len) {
+  std::unique_ptr<FakeFbDomFpga> fpga;
+  std::unique_ptr<FbFpgaI2c> i2c;
+  BENCHMARK_SUSPEND {
+    fpga = makeFpga();
+    i2c = std::make_unique<FbFpgaI2c>(fpga.get(), kRtc, kPim);
+  }
+  std::vector<uint8_t> buf(len);
+  for (size_t i = 0; i < iters; ++i) {
+    i2c->read(i % FakeFbDomFpga::kNumChannels, 0, folly::range(buf));
+  }
+}
+
+void engineReads(size_t iters, size_t len, uint32_t descriptors) {
+  std::unique_ptr<FakeFbDomFpga> fpga;
+  std::unique_ptr<FbFpgaI2cEngine> engine;
+  BENCHMARK_SUSPEND {
+    fpga = makeFpga();
+    engine = std::make_unique<FbFpgaI2cEngine>(
+        fpga.get(), kRtc, kPim, makeOptions(descriptors));
+  }
+  std::vector<folly::SemiFuture<std::vector<uint8_t>>> futures;
+  futures.reserve(iters);
+  for (size_t i = 0; i < iters; ++i) {
+    futures.push_back(engine->read(i % FakeFbDomFpga::kNumChannels, 0, len));
+  }
+  folly::collectAll(std::move(futures)).get();
+  BENCHMARK_SUSPEND {
+    engine.reset();
+    fpga.reset();
+  }
+}
+
+} // namespace
+
+BENCHMARK(SyncReadByte, n) {
+  syncReads(n, 1);
+}
+
+BENCHMARK_RELATIVE(EngineReadByte, n) {
+  engineReads(n, 1, 1);
+}
+
+BENCHMARK_RELATIVE(PipelinedEngineReadByte, n) {
+  engineReads(n, 1, FbFpgaI2cEngine::kMaxDescriptors);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(SyncReadPage, n) {
+  syncReads(n, kPageSize);
+}
+
+BENCHMARK_RELATIVE(EngineReadPage, n) {
+  engineReads(n, kPageSize, 1);
+}
+
+BENCHMARK_RELATIVE(PipelinedEngineReadPage, n) {
+  engineReads(n, kPageSize, FbFpgaI2cEngine::kMaxDescriptors);
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
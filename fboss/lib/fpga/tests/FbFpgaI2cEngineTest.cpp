@@ -0,0 +1,115 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/lib/fpga/FbFpgaI2c.h"
+#include "fboss/lib/fpga/FbFpgaI2cEngine.h"
+#include "fboss/lib/fpga/tests/FakeFbDomFpga.h"
+
+#include <folly/futures/Future.h>
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uint32_t kRtc = 2;
+constexpr uint32_t kPim = 1;
+
+FbFpgaI2cEngine::Options makeOptions(uint32_t descriptors) {
+  FbFpgaI2cEngine::Options options;
+  options.descriptors = descriptors;
+  return options;
+}
+
+std::vector<uint8_t> pattern(size_t len, uint8_t seed) {
+  std::vector<uint8_t> data(len);
+  for (size_t i = 0; i < len; ++i) {
+    data[i] = seed + i;
+  }
+  return data;
+}
+
+} // namespace
+
+TEST(FbFpgaI2cEngineTest, ReadAndWrite) {
+  FakeFbDomFpga fpga(20us, 1us);
+  FbFpgaI2cEngine engine(&fpga, kRtc, kPim, makeOptions(1));
+
+  auto data = pattern(128, 7);
+  engine.write(3, 0x80, data).get();
+  EXPECT_EQ(data, fpga.getDeviceData(kRtc, 3, 0x80, 128));
+  EXPECT_EQ(data, engine.read(3, 0x80, 128).get());
+  // Other channels are left alone
+  EXPECT_EQ(std::vector<uint8_t>(128), engine.read(2, 0x80, 128).get());
+
+  const auto& stats = engine.getI2cControllerPlatformStats();
+  EXPECT_EQ(2, *stats.readTotal__ref());
+  EXPECT_EQ(256, *stats.readBytes__ref());
+  EXPECT_EQ(1, *stats.writeTotal__ref());
+  EXPECT_EQ(128, *stats.writeBytes__ref());
+}
+
+TEST(FbFpgaI2cEngineTest, PipelinedTransactions) {
+  FakeFbDomFpga fpga(20us, 1us);
+  for (uint32_t channel = 0; channel < FakeFbDomFpga::kNumChannels;
+       ++channel) {
+    auto data = pattern(256, channel * 16);
+    fpga.setDeviceData(kRtc, channel, 0, folly::range(data));
+  }
+
+  FbFpgaI2cEngine engine(
+      &fpga, kRtc, kPim, makeOptions(FbFpgaI2cEngine::kMaxDescriptors));
+  EXPECT_EQ(128, engine.maxTransactionSize());
+  std::vector<folly::SemiFuture<std::vector<uint8_t>>> futures;
+  for (int i = 0; i < 32; ++i) {
+    futures.push_back(engine.read(i % FakeFbDomFpga::kNumChannels, i, 64));
+  }
+  auto results = folly::collectAll(std::move(futures)).get();
+  for (int i = 0; i < 32; ++i) {
+    auto expected = pattern(64, i % FakeFbDomFpga::kNumChannels * 16 + i);
+    EXPECT_EQ(expected, results[i].value());
+  }
+  EXPECT_EQ(FbFpgaI2cEngine::kMaxDescriptors, fpga.maxInFlight(kRtc));
+}
+
+TEST(FbFpgaI2cEngineTest, Errors) {
+  FakeFbDomFpga fpga(20us, 1us);
+  FbFpgaI2cEngine engine(&fpga, kRtc, kPim, makeOptions(2));
+  fpga.setChannelFailed(kRtc, 1, true);
+
+  EXPECT_THROW(engine.read(1, 0, 1).get(), FbFpgaI2cError);
+  EXPECT_THROW(engine.write(1, 0, {1}).get(), FbFpgaI2cError);
+  // Only the failed channel is affected
+  EXPECT_NO_THROW(engine.read(0, 0, 1).get());
+  // Lengths a descriptor can't carry
+  EXPECT_THROW(engine.read(0, 0, 0).get(), FbFpgaI2cError);
+  EXPECT_THROW(engine.read(0, 0, 129).get(), FbFpgaI2cError);
+
+  const auto& stats = engine.getI2cControllerPlatformStats();
+  EXPECT_EQ(1, *stats.readFailed__ref());
+  EXPECT_EQ(1, *stats.writeFailed__ref());
+}
+
+TEST(FbFpgaI2cEngineTest, Timeout) {
+  FakeFbDomFpga fpga(50ms, 0us);
+  auto options = makeOptions(1);
+  options.timeout = 1ms;
+  options.timePerByte = 0us;
+  FbFpgaI2cEngine engine(&fpga, kRtc, kPim, options);
+  EXPECT_THROW(engine.read(0, 0, 1).get(), FbFpgaI2cError);
+}
+
+TEST(FbFpgaI2cEngineTest, MatchesSyncController) {
+  FakeFbDomFpga fpga(20us, 1us);
+  auto data = pattern(32, 3);
+  fpga.setDeviceData(kRtc, 0, 0x10, folly::range(data));
+
+  FbFpgaI2c i2c(&fpga, kRtc, kPim);
+  std::vector<uint8_t> syncData(32);
+  i2c.read(0, 0x10, folly::range(syncData));
+  EXPECT_EQ(data, syncData);
+
+  FbFpgaI2cEngine engine(&fpga, kRtc, kPim, makeOptions(1));
+  EXPECT_EQ(data, engine.read(0, 0x10, 32).get());
+}
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <chrono>
+
+#include <folly/Range.h>
+
+namespace facebook::fboss {
+
+/*
+ * The steps of an I2C transaction that are worth telling apart when looking
+ * for slow buses: waiting for exclusive access to the bus, pointing the mux
+ * at the device, and the transfer itself.
+ */
+enum class I2cPhase {
+  LOCK_WAIT,
+  MUX_SELECT,
+  TRANSFER,
+};
+
+/*
+ * Receives the time spent in every phase of the I2C transactions done on the
+ * thread it is installed on (see ScopedI2cPhaseRecorder), e.g. to profile a
+ * transceiver refresh. The bus code reports phases with ScopedI2cPhase,
+ * which costs a thread local read when no recorder is installed.
+ */
+class I2cPhaseRecorder {
+ public:
+  virtual ~I2cPhaseRecorder() = default;
+
+  /* bus is the name of the controller, if the bus code knows it */
+  virtual void record(
+      I2cPhase phase,
+      folly::StringPiece bus,
+      std::chrono::nanoseconds duration) = 0;
+
+  static I2cPhaseRecorder* current() {
+    return current_;
+  }
+
+ private:
+  friend class ScopedI2cPhaseRecorder;
+
+  static inline thread_local I2cPhaseRecorder* current_{nullptr};
+};
+
+/* Installs a recorder on the calling thread for the lifetime of the object */
+class ScopedI2cPhaseRecorder {
+ public:
+  explicit ScopedI2cPhaseRecorder(I2cPhaseRecorder* recorder)
+      : previous_(I2cPhaseRecorder::current_) {
+    I2cPhaseRecorder::current_ = recorder;
+  }
+
+  ~ScopedI2cPhaseRecorder() {
+    I2cPhaseRecorder::current_ = previous_;
+  }
+
+ private:
+  ScopedI2cPhaseRecorder(ScopedI2cPhaseRecorder const&) = delete;
+  ScopedI2cPhaseRecorder& operator=(ScopedI2cPhaseRecorder const&) = delete;
+
+  I2cPhaseRecorder* previous_;
+};
+
+/* Times a phase, from construction to destruction */
+class ScopedI2cPhase {
+ public:
+  explicit ScopedI2cPhase(I2cPhase phase, folly::StringPiece bus = "")
+      : recorder_(I2cPhaseRecorder::current()), phase_(phase), bus_(bus) {
+    if (recorder_) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~ScopedI2cPhase() {
+    if (recorder_) {
+      recorder_->record(
+          phase_, bus_, std::chrono::steady_clock::now() - start_);
+    }
+  }
+
+ private:
+  ScopedI2cPhase(ScopedI2cPhase const&) = delete;
+  ScopedI2cPhase& operator=(ScopedI2cPhase const&) = delete;
+
+  I2cPhaseRecorder* recorder_;
+  I2cPhase phase_;
+  folly::StringPiece bus_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace facebook::fboss
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <utility>
 #include <vector>
 
 #include <folly/Range.h>
@@ -128,6 +129,18 @@ class ExternalPhy {
 
   virtual void programOnePort(PhyPortConfig config) = 0;
 
+  /*
+   * Programs several ports of the PHY. The default programs them one by
+   * one; PHYs on MDIO should queue the register accesses of all ports in an
+   * MdioBatch instead, so that the ports go out in one pass over the bus
+   * rather than a round trip per access.
+   */
+  virtual void programPorts(const std::vector<PhyPortConfig>& configs) {
+    for (const auto& config : configs) {
+      programOnePort(config);
+    }
+  }
+
   virtual bool legalOnePortConfig(const PhyPortConfig& /* config */) {
     // optionally overridable by subclasses
     return true;
@@ -142,6 +155,20 @@ class ExternalPhy {
     return std::vector<ExternalPhyLaneDiagInfo>();
   };
 
+  /*
+   * Diag info of several ports, given as (system lanes, line lanes) masks.
+   * Like programPorts() this can be overridden to read the registers of all
+   * ports in a single batch.
+   */
+  virtual std::vector<std::vector<ExternalPhyLaneDiagInfo>> getPortsDiagInfo(
+      const std::vector<std::pair<uint32_t, uint32_t>>& ports) {
+    std::vector<std::vector<ExternalPhyLaneDiagInfo>> diagInfo;
+    for (const auto& [sysLanes, lineLanes] : ports) {
+      diagInfo.push_back(getOnePortDiagInfo(sysLanes, lineLanes));
+    }
+    return diagInfo;
+  }
+
   virtual ExternalPhyPortStats getPortStats(const PhyPortConfig& config) = 0;
 
   virtual void reset() = 0;
@@ -12,6 +12,7 @@
 
 #include <glog/logging.h>
 
+#include "fboss/lib/i2c/I2cPhaseRecorder.h"
 #include "fboss/lib/usb/UsbError.h"
 
 using folly::MutableByteRange;
@@ -124,12 +125,19 @@ void BaseWedgeI2CBus::moduleRead(
     int offset,
     int len,
     uint8_t* buf) {
-  selectQsfp(module);
+  {
+    ScopedI2cPhase phase(I2cPhase::MUX_SELECT);
+    selectQsfp(module);
+  }
   CHECK_NE(selectedPort_, NO_PORT);
 
-  read(address, offset, len, buf);
+  {
+    ScopedI2cPhase phase(I2cPhase::TRANSFER);
+    read(address, offset, len, buf);
+  }
 
   // TODO: remove this after we ensure exclusive access to cp2112 chip
+  ScopedI2cPhase phase(I2cPhase::MUX_SELECT);
   unselectQsfp();
 }
 
@@ -139,12 +147,19 @@ void BaseWedgeI2CBus::moduleWrite(
     int offset,
     int len,
     const uint8_t* buf) {
-  selectQsfp(module);
+  {
+    ScopedI2cPhase phase(I2cPhase::MUX_SELECT);
+    selectQsfp(module);
+  }
   CHECK_NE(selectedPort_, NO_PORT);
 
-  write(address, offset, len, buf);
+  {
+    ScopedI2cPhase phase(I2cPhase::TRANSFER);
+    write(address, offset, len, buf);
+  }
 
   // TODO: remove this after we ensure exclusive access to cp2112 chip
+  ScopedI2cPhase phase(I2cPhase::MUX_SELECT);
   unselectQsfp();
 }
 
@@ -34,8 +34,15 @@
 #include <folly/ScopeGuard.h>
 #include <folly/lang/Bits.h>
 #include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
 #include <libusb-1.0/libusb.h>
 
+DEFINE_bool(
+    cp2112_async_transfers,
+    false,
+    "Use libusb asynchronous transfers to talk to the CP2112, polling the "
+    "transfer status as responses arrive instead of sleeping between polls");
+
 using folly::ByteRange;
 using folly::Endian;
 using folly::MutableByteRange;
@@ -116,7 +123,8 @@ void vlogHex(
 } // namespace
 
 namespace facebook::fboss {
-CP2112::CP2112() : ownCtx_(true) {
+CP2112::CP2112()
+    : ownCtx_(true), asyncTransfers_(FLAGS_cp2112_async_transfers) {
   lastResetTime_ = std::chrono::steady_clock::now();
   int rc = libusb_init(&ctx_);
   if (rc != 0) {
@@ -124,7 +132,18 @@ CP2112::CP2112() : ownCtx_(true) {
   }
 }
 
-CP2112::CP2112(libusb_context* ctx) : ctx_(ctx), ownCtx_(false) {}
+CP2112::CP2112(libusb_context* ctx)
+    : ctx_(ctx),
+      ownCtx_(false),
+      asyncTransfers_(FLAGS_cp2112_async_transfers) {}
+
+CP2112::CP2112(std::unique_ptr<UsbHandle> handle)
+    : handle_(std::move(handle)),
+      findDevice_(false),
+      ownCtx_(false),
+      asyncTransfers_(FLAGS_cp2112_async_transfers) {
+  lastResetTime_ = std::chrono::steady_clock::now();
+}
 
 CP2112::~CP2112() {
   close();
@@ -149,10 +168,22 @@ void CP2112::open(bool setSmbusConfig) {
 }
 
 void CP2112::close() {
-  handle_.close();
+  try {
+    drainAsyncTransfers();
+  } catch (const UsbError& ex) {
+    LOG(ERROR) << "error completing USB transfers before closing: "
+               << ex.what();
+  }
+  handle_->close();
   dev_.reset();
 }
 
+void CP2112::setAsyncTransfers(bool async) {
+  // The sync transfers must not race with async transfers still in flight
+  drainAsyncTransfers();
+  asyncTransfers_ = async;
+}
+
 void CP2112::resetFromUserver() {
   try {
     uint8_t buf[2]{ReportID::RESET_DEVICE, 1};
@@ -423,9 +454,11 @@ void CP2112::writeReadUnsafe(
 }
 
 void CP2112::openDevice() {
-  dev_ = UsbDevice::find(ctx_, VENDOR_ID, PRODUCT_ID);
-  handle_ = dev_.open();
-  handle_.claimInterface(0);
+  if (findDevice_) {
+    dev_ = UsbDevice::find(ctx_, VENDOR_ID, PRODUCT_ID);
+    *handle_ = dev_.open();
+  }
+  handle_->claimInterface(0);
 }
 
 void CP2112::initSettings() {
@@ -627,6 +660,7 @@ void CP2112::processReadResponse(MutableByteRange buf, milliseconds timeout) {
     if (sendRead) {
       usbBuf[0] = ReportID::READ_FORCE_SEND;
       usbBuf[1] = 1;
+      armIntrIn(milliseconds(10));
       intrOut("read force send", usbBuf, sizeof(usbBuf), milliseconds(5));
       sendRead = false;
     }
@@ -739,6 +773,7 @@ void CP2112::getTransferStatusImpl(
   usbBuf[0] = ReportID::XFER_STATUS_REQUEST;
   usbBuf[1] = 1;
 
+  armIntrIn(milliseconds(20));
   intrOut("get xfer status", usbBuf, bufSize, timeout);
   // Wait for the XFER_STATUS_RESPONSE.  Note that we ignore timeout here,
   // and always pass in a fixed timeout of 20ms.  The device should return
@@ -833,7 +868,9 @@ milliseconds CP2112::waitForTransfer(
 milliseconds CP2112::updateTimeLeft(steady_clock::time_point end, bool sleep) {
   auto now = steady_clock::now();
   auto timeLeft = duration_cast<milliseconds>(end - now);
-  if (timeLeft >= milliseconds(0) && sleep) {
+  // With async transfers the next poll waits on the response to the previous
+  // one instead, which arrives within a couple of USB frames
+  if (timeLeft >= milliseconds(0) && sleep && !asyncTransfers_) {
     auto sleepDuration = std::min(timeLeft, milliseconds(10));
     usleep(sleepDuration.count() * 1000);
     timeLeft -= sleepDuration;
@@ -852,15 +889,8 @@ CP2112::featureReportIn(ReportID report, uint8_t* buf, uint16_t length) {
   uint16_t wValue = ReportType::FEATURE | static_cast<uint16_t>(report);
   uint16_t wIndex = 0; // the interface index
   unsigned int timeoutMS = 1000;
-  int rc = libusb_control_transfer(
-      handle_.handle(),
-      bRequestType,
-      bRequest,
-      wValue,
-      wIndex,
-      buf,
-      length,
-      timeoutMS);
+  int rc = handle_->controlTransfer(
+      bRequestType, bRequest, wValue, wIndex, buf, length, timeoutMS);
   if (rc < 0) {
     throw LibusbError(rc, "failed to get feature report ", report);
   }
@@ -895,8 +925,7 @@ void CP2112::featureReportOut(
   uint16_t wValue = ReportType::FEATURE | static_cast<uint16_t>(report);
   uint16_t wIndex = 0; // the interface index
   unsigned int timeoutMS = 1000;
-  int rc = libusb_control_transfer(
-      handle_.handle(),
+  int rc = handle_->controlTransfer(
       bRequestType,
       bRequest,
       wValue,
@@ -940,13 +969,13 @@ void CP2112::intrOut(
   // checks, and not inside libusb calls.
   int usbTimeout = std::max(timeout.count(), 5L);
 
-  int rc = libusb_interrupt_transfer(
-      handle_.handle(),
-      outEndpoint,
-      const_cast<uint8_t*>(buf),
-      length,
-      &lenResult,
-      usbTimeout);
+  if (asyncTransfers_) {
+    asyncIntrOut(name, buf, length, milliseconds(usbTimeout));
+    return;
+  }
+
+  int rc = handle_->interruptTransfer(
+      outEndpoint, const_cast<uint8_t*>(buf), length, &lenResult, usbTimeout);
   if (rc != 0) {
     busGood_ = false;
     throw LibusbError(rc, "failed to send ", name, " request");
@@ -965,8 +994,14 @@ void CP2112::intrIn(uint8_t* buf, uint16_t length, milliseconds timeout) {
   // With a timeout of 0 libusb won't even bother checking for available data,
   // it just returns a timeout error immediately.
   int usbTimeout = std::max(timeout.count(), 1L);
-  int rc = libusb_interrupt_transfer(
-      handle_.handle(), outEndpoint, buf, length, &lenResult, usbTimeout);
+  if (asyncTransfers_) {
+    asyncIntrIn(buf, length, milliseconds(usbTimeout));
+    vlogHex(6, "intr in:", buf, length);
+    return;
+  }
+
+  int rc = handle_->interruptTransfer(
+      outEndpoint, buf, length, &lenResult, usbTimeout);
   if (rc != 0) {
     busGood_ = false;
     throw LibusbError(rc, "error waiting for interrupt response");
@@ -981,6 +1016,103 @@ void CP2112::intrIn(uint8_t* buf, uint16_t length, milliseconds timeout) {
   vlogHex(6, "intr in:", buf, length);
 }
 
+void CP2112::submitAsync(
+    AsyncTransfer& transfer,
+    uint8_t endpoint,
+    milliseconds timeout) {
+  transfer.pending = true;
+  transfer.rc = 0;
+  try {
+    handle_->submitInterruptTransfer(
+        endpoint,
+        transfer.buf.data(),
+        transfer.buf.size(),
+        timeout.count(),
+        [&transfer](int rc, int transferred) {
+          transfer.pending = false;
+          transfer.rc = rc;
+          transfer.transferred = transferred;
+        });
+  } catch (const UsbError&) {
+    transfer.pending = false;
+    busGood_ = false;
+    throw;
+  }
+}
+
+void CP2112::waitForAsync(const AsyncTransfer& transfer) {
+  // Every transfer has a libusb timeout, so this can't wait forever
+  while (transfer.pending) {
+    handle_->handleEvents(ctx_, milliseconds(10));
+  }
+}
+
+void CP2112::drainAsyncTransfers() {
+  for (const auto& out : asyncOut_) {
+    waitForAsync(out);
+  }
+  waitForAsync(asyncIn_);
+  for (auto& out : asyncOut_) {
+    out.rc = 0;
+  }
+}
+
+void CP2112::checkAsyncOut() {
+  for (auto& out : asyncOut_) {
+    if (!out.pending && out.rc != 0) {
+      auto rc = out.rc;
+      out.rc = 0;
+      busGood_ = false;
+      throw LibusbError(rc, "failed to send ", out.name, " request");
+    }
+  }
+}
+
+void CP2112::asyncIntrOut(
+    StringPiece name,
+    const uint8_t* buf,
+    uint16_t length,
+    milliseconds timeout) {
+  // Out reports go out in the order they were submitted, so this only waits
+  // if all of the out transfers are still queued
+  auto& out = asyncOut_[nextAsyncOut_];
+  nextAsyncOut_ = (nextAsyncOut_ + 1) % kAsyncOutDepth;
+  waitForAsync(out);
+  checkAsyncOut();
+
+  memcpy(out.buf.data(), buf, length);
+  out.name = name.str();
+  submitAsync(out, LIBUSB_ENDPOINT_OUT | 1, timeout);
+}
+
+void CP2112::asyncIntrIn(uint8_t* buf, uint16_t length, milliseconds timeout) {
+  if (!asyncIn_.pending) {
+    submitAsync(asyncIn_, LIBUSB_ENDPOINT_IN | 1, timeout);
+  }
+  waitForAsync(asyncIn_);
+  // Report errors of the requests this responds to first
+  checkAsyncOut();
+
+  if (asyncIn_.rc != 0) {
+    busGood_ = false;
+    throw LibusbError(asyncIn_.rc, "error waiting for interrupt response");
+  }
+  if (asyncIn_.transferred != 64) {
+    busGood_ = false;
+    throw UsbError(
+        "unexpected interrupt response length received from "
+        "CP2112:",
+        asyncIn_.transferred);
+  }
+  memcpy(buf, asyncIn_.buf.data(), length);
+}
+
+void CP2112::armIntrIn(milliseconds timeout) {
+  if (asyncTransfers_ && !asyncIn_.pending) {
+    submitAsync(asyncIn_, LIBUSB_ENDPOINT_IN | 1, timeout);
+  }
+}
+
 bool CP2112::SMBusConfig::operator==(const SMBusConfig& other) const {
   return memcmp(this, &other, sizeof(SMBusConfig)) == 0;
 }
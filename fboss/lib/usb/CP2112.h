@@ -15,8 +15,11 @@
 
 #include <folly/Range.h>
 
+#include <array>
 #include <chrono>
 #include <cstdint>
+#include <memory>
+#include <string>
 
 struct libusb_transfer;
 
@@ -83,6 +86,13 @@ class CP2112Intf : public I2cController {
  * implement a non-blocking API, but Linux's standard I2C APIs only provide
  * blocking APIs.  Code that wants to deal with other I2C interfaces therefore
  * already has to support blocking operation.
+ *
+ * With async transfers enabled (--cp2112_async_transfers), the interrupt
+ * transfers underneath are libusb asynchronous transfers: out reports are
+ * queued without waiting for each to go out, so a request and its first
+ * status poll (or a mux select and the read behind it) go out back to back,
+ * and the transfer status is polled again as soon as the previous status
+ * response arrives rather than after sleeping for up to 10ms.
  */
 class CP2112 : public CP2112Intf {
  public:
@@ -257,13 +267,23 @@ class CP2112 : public CP2112Intf {
 
   CP2112();
   explicit CP2112(libusb_context* ctx);
+  /*
+   * Talk to the device through the given handle, rather than looking it up
+   * on the USB bus.  Used to run against a mock UsbHandle.
+   */
+  explicit CP2112(std::unique_ptr<UsbHandle> handle);
   ~CP2112() override;
 
   void open(bool setSmbusConfig = true) override;
   void close() override;
   bool isOpen() const {
-    return handle_.isOpen();
+    return handle_->isOpen();
+  }
+
+  bool getAsyncTransfers() const {
+    return asyncTransfers_;
   }
+  void setAsyncTransfers(bool async);
 
   std::chrono::milliseconds getDefaultTimeout() const override {
     return defaultTimeout_;
@@ -435,10 +455,47 @@ class CP2112 : public CP2112Intf {
       std::chrono::milliseconds timeout);
   void intrIn(uint8_t* buf, uint16_t length, std::chrono::milliseconds timeout);
 
+  struct AsyncTransfer {
+    std::array<uint8_t, 64> buf;
+    bool pending{false};
+    int rc{0};
+    int transferred{0};
+    // The request an out transfer sends, for error messages
+    std::string name;
+  };
+  // Out reports that can be queued at once
+  static constexpr size_t kAsyncOutDepth = 4;
+
+  void submitAsync(
+      AsyncTransfer& transfer,
+      uint8_t endpoint,
+      std::chrono::milliseconds timeout);
+  void waitForAsync(const AsyncTransfer& transfer);
+  void drainAsyncTransfers();
+  void checkAsyncOut();
+  void asyncIntrOut(
+      folly::StringPiece name,
+      const uint8_t* buf,
+      uint16_t length,
+      std::chrono::milliseconds timeout);
+  void asyncIntrIn(
+      uint8_t* buf,
+      uint16_t length,
+      std::chrono::milliseconds timeout);
+  // In async mode, start receiving the next interrupt in report before
+  // sending the request it responds to
+  void armIntrIn(std::chrono::milliseconds timeout);
+
   libusb_context* ctx_{nullptr};
   UsbDevice dev_;
-  UsbHandle handle_;
+  std::unique_ptr<UsbHandle> handle_{std::make_unique<UsbHandle>()};
+  // Whether to look up the device on the USB bus when opening
+  bool findDevice_{true};
   bool ownCtx_{false};
+  bool asyncTransfers_{false};
+  std::array<AsyncTransfer, kAsyncOutDepth> asyncOut_;
+  size_t nextAsyncOut_{0};
+  AsyncTransfer asyncIn_;
   bool busGood_{true};
   std::chrono::milliseconds defaultTimeout_{500};
   std::chrono::time_point<std::chrono::steady_clock> lastResetTime_;
@@ -9,6 +9,7 @@
  */
 #include "fboss/lib/usb/Minipack16QI2CBus.h"
 #include "fboss/agent/Utils.h"
+#include "fboss/lib/i2c/I2cPhaseRecorder.h"
 #include "fboss/lib/fpga/MinipackFpga.h"
 
 #include <folly/container/Enumerate.h>
@@ -43,12 +44,12 @@ Minipack16QI2CBus::Minipack16QI2CBus() {
   MinipackFpga::getInstance()->initHW();
 
   // Initialize the real time I2C access controllers.
+  std::vector<FbDomFpga*> pimFpgas;
   for (uint32_t pim = 1; pim <= MinipackFpga::kNumberPim; ++pim) {
-    for (uint32_t rtc = 0; rtc < 4; rtc++) {
-      i2cControllers_[pim - 1][rtc] = std::make_unique<FbFpgaI2cController>(
-          MinipackFpga::getInstance()->getDomFpga(pim), rtc, pim);
-    }
+    pimFpgas.push_back(MinipackFpga::getInstance()->getDomFpga(pim));
   }
+  i2cControllers_ = std::make_unique<FbFpgaI2cControllerPool>(
+      pimFpgas, kPortsPerPim / FbFpgaI2cControllerPool::kChannelsPerRtc);
 }
 
 Minipack16QI2CBus::~Minipack16QI2CBus() {}
@@ -72,11 +73,12 @@ void Minipack16QI2CBus::moduleRead(
       offset,
       len);
 
-  getI2cController(pim, getI2cControllerIdx(port))
-      ->read(
-          getI2cControllerChannel(port),
-          offset,
-          folly::MutableByteRange(buf, len));
+  auto controller = i2cControllers_->getControllerForPort(pim, port);
+  ScopedI2cPhase phase(
+      I2cPhase::TRANSFER,
+      *controller->getI2cControllerPlatformStats().controllerName__ref());
+  controller->read(
+      getI2cControllerChannel(port), offset, folly::MutableByteRange(buf, len));
 }
 
 void Minipack16QI2CBus::moduleWrite(
@@ -98,9 +100,12 @@ void Minipack16QI2CBus::moduleWrite(
       offset,
       len);
 
-  getI2cController(pim, getI2cControllerIdx(port))
-      ->write(
-          getI2cControllerChannel(port), offset, folly::ByteRange(data, len));
+  auto controller = i2cControllers_->getControllerForPort(pim, port);
+  ScopedI2cPhase phase(
+      I2cPhase::TRANSFER,
+      *controller->getI2cControllerPlatformStats().controllerName__ref());
+  controller->write(
+      getI2cControllerChannel(port), offset, folly::ByteRange(data, len));
 }
 
 bool Minipack16QI2CBus::isPresent(unsigned int module) {
@@ -130,6 +135,21 @@ void Minipack16QI2CBus::scanPresence(
   }
 }
 
+bool Minipack16QI2CBus::scanInterrupts(std::map<int32_t, bool>& interrupts) {
+  std::set<uint8_t> pimsToScan;
+  for (auto interrupt : interrupts) {
+    pimsToScan.insert(getPim(interrupt.first + 1));
+  }
+
+  for (auto pim : pimsToScan) {
+    auto pimQsfpInterrupt = MinipackFpga::getInstance()->scanQsfpInterrupt(pim);
+    for (int port = 0; port < kPortsPerPim; port++) {
+      interrupts[getModule(pim, port) - 1] = pimQsfpInterrupt[port];
+    }
+  }
+  return true;
+}
+
 void Minipack16QI2CBus::ensureOutOfReset(unsigned int module) {
   auto pim = getPim(module);
   auto port = getQsfpPimPort(module);
@@ -137,15 +157,8 @@ void Minipack16QI2CBus::ensureOutOfReset(unsigned int module) {
 }
 
 folly::EventBase* Minipack16QI2CBus::getEventBase(unsigned int module) {
-  return i2cControllers_[getPim(module) - 1]
-                        [getI2cControllerIdx(getQsfpPimPort(module))]
-                            ->getEventBase();
-}
-
-FbFpgaI2cController* Minipack16QI2CBus::getI2cController(
-    uint8_t pim,
-    uint8_t idx) const {
-  return i2cControllers_[pim - 1][idx].get();
+  return i2cControllers_->getEventBase(
+      getPim(module), getQsfpPimPort(module));
 }
 
 /* Consolidate the i2c transaction stats from all the pims using their
@@ -156,16 +169,7 @@ FbFpgaI2cController* Minipack16QI2CBus::getI2cController(
  */
 std::vector<std::reference_wrapper<const I2cControllerStats>>
 Minipack16QI2CBus::getI2cControllerStats() {
-  std::vector<std::reference_wrapper<const I2cControllerStats>>
-      i2cControllerCurrentStats;
-
-  for (uint32_t pim = 1; pim <= MinipackFpga::kNumberPim; ++pim) {
-    for (uint32_t idx = 0; idx < 4; idx++) {
-      i2cControllerCurrentStats.push_back(
-          getI2cController(pim, idx)->getI2cControllerPlatformStats());
-    }
-  }
-  return i2cControllerCurrentStats;
+  return i2cControllers_->getI2cControllerStats();
 }
 
 } // namespace facebook::fboss
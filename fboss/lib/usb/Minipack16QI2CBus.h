@@ -10,6 +10,7 @@
 #pragma once
 
 #include "fboss/lib/fpga/FbFpgaI2c.h"
+#include "fboss/lib/fpga/FbFpgaI2cControllerPool.h"
 #include "fboss/lib/i2c/gen-cpp2/i2c_controller_stats_types.h"
 #include "fboss/lib/usb/PCA9548MuxedBus.h"
 
@@ -41,6 +42,7 @@ class Minipack16QI2CBus : public TransceiverI2CApi {
 
   bool isPresent(unsigned int module) override;
   void scanPresence(std::map<int32_t, ModulePresence>& presences) override;
+  bool scanInterrupts(std::map<int32_t, bool>& interrupts) override;
   void ensureOutOfReset(unsigned int module) override;
   void verifyBus(bool /* autoReset */) override {}
 
@@ -53,15 +55,16 @@ class Minipack16QI2CBus : public TransceiverI2CApi {
   std::vector<std::reference_wrapper<const I2cControllerStats>>
   getI2cControllerStats() override;
 
+  /* Modules behind different RTCs, and with the async I2C engine also the
+   * modules behind the same RTC, get different event bases, so that
+   * refreshing all the transceivers keeps every RTC busy
+   */
   folly::EventBase* getEventBase(unsigned int module) override;
 
  private:
-  FbFpgaI2cController* getI2cController(uint8_t pim, uint8_t idx) const;
-
   static constexpr uint8_t MODULES_PER_PIM = 16;
 
-  std::array<std::array<std::unique_ptr<FbFpgaI2cController>, 4>, 8>
-      i2cControllers_;
+  std::unique_ptr<FbFpgaI2cControllerPool> i2cControllers_;
 };
 
 } // namespace facebook::fboss
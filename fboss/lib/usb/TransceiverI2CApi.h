@@ -65,6 +65,15 @@ class TransceiverI2CApi {
    */
   virtual void scanPresence(std::map<int32_t, ModulePresence>& presences) = 0;
 
+  /*
+   * Function will read whether the transceivers assert their IntL pin
+   * according to the indexes provided. Platforms that can't read it return
+   * false, and the transceiver flags have to be polled instead.
+   */
+  virtual bool scanInterrupts(std::map<int32_t, bool>& /* interrupts */) {
+    return false;
+  }
+
   /*
    * Function bring transceiver out of reset whenever a transceiver has been
    * detected plugging in.
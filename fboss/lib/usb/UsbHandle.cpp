@@ -11,11 +11,45 @@
 
 #include <folly/ScopeGuard.h>
 
+#include <memory>
+
 #include <glog/logging.h>
 #include <libusb-1.0/libusb.h>
 
 #include "fboss/lib/usb/UsbError.h"
 
+namespace {
+
+int transferStatusToError(int status) {
+  switch (status) {
+    case LIBUSB_TRANSFER_COMPLETED:
+      return 0;
+    case LIBUSB_TRANSFER_TIMED_OUT:
+      return LIBUSB_ERROR_TIMEOUT;
+    case LIBUSB_TRANSFER_CANCELLED:
+      return LIBUSB_ERROR_INTERRUPTED;
+    case LIBUSB_TRANSFER_STALL:
+      return LIBUSB_ERROR_PIPE;
+    case LIBUSB_TRANSFER_NO_DEVICE:
+      return LIBUSB_ERROR_NO_DEVICE;
+    case LIBUSB_TRANSFER_OVERFLOW:
+      return LIBUSB_ERROR_OVERFLOW;
+    default:
+      return LIBUSB_ERROR_IO;
+  }
+}
+
+void LIBUSB_CALL transferDone(libusb_transfer* transfer) {
+  // The transfer is freed by libusb after this returns
+  std::unique_ptr<facebook::fboss::UsbHandle::TransferCallback> callback(
+      static_cast<facebook::fboss::UsbHandle::TransferCallback*>(
+          transfer->user_data));
+  (*callback)(
+      transferStatusToError(transfer->status), transfer->actual_length);
+}
+
+} // namespace
+
 namespace facebook::fboss {
 UsbHandle::UsbHandle(UsbHandle&& other) noexcept : handle_(other.handle_) {
   other.handle_ = nullptr;
@@ -78,4 +112,68 @@ void UsbHandle::claimInterface(int iface) {
   }
 }
 
+int UsbHandle::controlTransfer(
+    uint8_t requestType,
+    uint8_t request,
+    uint16_t value,
+    uint16_t index,
+    uint8_t* buf,
+    uint16_t length,
+    unsigned int timeoutMS) {
+  return libusb_control_transfer(
+      handle_, requestType, request, value, index, buf, length, timeoutMS);
+}
+
+int UsbHandle::interruptTransfer(
+    uint8_t endpoint,
+    uint8_t* buf,
+    int length,
+    int* transferred,
+    unsigned int timeoutMS) {
+  return libusb_interrupt_transfer(
+      handle_, endpoint, buf, length, transferred, timeoutMS);
+}
+
+void UsbHandle::submitInterruptTransfer(
+    uint8_t endpoint,
+    uint8_t* buf,
+    int length,
+    unsigned int timeoutMS,
+    TransferCallback callback) {
+  DCHECK(isOpen());
+  auto transfer = libusb_alloc_transfer(0);
+  if (!transfer) {
+    throw LibusbError(LIBUSB_ERROR_NO_MEM, "failed to allocate USB transfer");
+  }
+  auto userData = new TransferCallback(std::move(callback));
+  libusb_fill_interrupt_transfer(
+      transfer,
+      handle_,
+      endpoint,
+      buf,
+      length,
+      transferDone,
+      userData,
+      timeoutMS);
+  transfer->flags = LIBUSB_TRANSFER_FREE_TRANSFER;
+  auto rc = libusb_submit_transfer(transfer);
+  if (rc != 0) {
+    delete userData;
+    libusb_free_transfer(transfer);
+    throw LibusbError(rc, "failed to submit USB transfer");
+  }
+}
+
+void UsbHandle::handleEvents(
+    libusb_context* ctx,
+    std::chrono::microseconds timeout) {
+  struct timeval tv;
+  tv.tv_sec = timeout.count() / 1000000;
+  tv.tv_usec = timeout.count() % 1000000;
+  auto rc = libusb_handle_events_timeout_completed(ctx, &tv, nullptr);
+  if (rc != 0) {
+    throw LibusbError(rc, "failed to handle USB events");
+  }
+}
+
 } // namespace facebook::fboss
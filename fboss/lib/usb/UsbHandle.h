@@ -9,6 +9,12 @@
  */
 #pragma once
 
+#include <folly/Function.h>
+
+#include <chrono>
+#include <cstdint>
+
+struct libusb_context;
 struct libusb_device;
 struct libusb_device_handle;
 
@@ -18,12 +24,15 @@ namespace facebook::fboss {
  *
  * It mainly provides RAII cleanup on destruction, as well as some slighty
  * more native-feeling C++ methods.
+ *
+ * The transfer methods are virtual so that a mock device can stand in for the
+ * USB bus in tests and benchmarks.
  */
 class UsbHandle {
  public:
   UsbHandle() {}
   explicit UsbHandle(libusb_device_handle* handle) : handle_(handle) {}
-  ~UsbHandle() {
+  virtual ~UsbHandle() {
     close();
   }
 
@@ -36,14 +45,55 @@ class UsbHandle {
   }
 
   void openFrom(libusb_device* dev, bool autoDetach = true);
-  void close();
+  virtual void close();
 
-  bool isOpen() const {
+  virtual bool isOpen() const {
     return handle_ != nullptr;
   }
 
   void setAutoDetachKernelDriver(bool autoDetach);
-  void claimInterface(int iface);
+  virtual void claimInterface(int iface);
+
+  /*
+   * Synchronous transfers.  These return the libusb return code, so that
+   * callers can decide which errors to tolerate.
+   */
+  virtual int controlTransfer(
+      uint8_t requestType,
+      uint8_t request,
+      uint16_t value,
+      uint16_t index,
+      uint8_t* buf,
+      uint16_t length,
+      unsigned int timeoutMS);
+  virtual int interruptTransfer(
+      uint8_t endpoint,
+      uint8_t* buf,
+      int length,
+      int* transferred,
+      unsigned int timeoutMS);
+
+  /*
+   * Asynchronous interrupt transfers.
+   *
+   * The callback is invoked from handleEvents() with the libusb error code of
+   * the transfer (0 on success) and the number of bytes transferred.  buf
+   * must stay valid until then.
+   */
+  using TransferCallback = folly::Function<void(int rc, int transferred)>;
+  virtual void submitInterruptTransfer(
+      uint8_t endpoint,
+      uint8_t* buf,
+      int length,
+      unsigned int timeoutMS,
+      TransferCallback callback);
+  /*
+   * Wait up to timeout for transfer events, and run the callbacks of the
+   * transfers that completed.
+   */
+  virtual void handleEvents(
+      libusb_context* ctx,
+      std::chrono::microseconds timeout);
 
  private:
   UsbHandle(const UsbHandle& other) = delete;
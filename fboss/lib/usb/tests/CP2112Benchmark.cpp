@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/usb/CP2112.h"
+#include "fboss/lib/usb/tests/MockUsbHandle.h"
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include <memory>
+#include <vector>
+
+using namespace facebook::fboss;
+
+DEFINE_int32(
+    mock_usb_latency_us,
+    1000,
+    "Time an interrupt report takes to cross the mock USB bus, a full speed "
+    "USB frame by default");
+DEFINE_int32(
+    mock_i2c_latency_us,
+    100,
+    "Fixed latency of a transaction on the mock I2C bus");
+DEFINE_int32(
+    mock_i2c_latency_per_byte_us,
+    25,
+    "Latency of every byte of a transaction on the mock I2C bus, 25us is "
+    "about a 400KHz bus");
+
+namespace {
+
+constexpr uint8_t kMuxAddr = 0xe0;
+constexpr uint8_t kQsfpAddr = 0xa0;
+
+std::unique_ptr<CP2112> makeDevice(bool async) {
+  MockUsbHandle::Options options;
+  options.usbLatency = std::chrono::microseconds(FLAGS_mock_usb_latency_us);
+  options.busLatency = std::chrono::microseconds(FLAGS_mock_i2c_latency_us);
+  options.busLatencyPerByte =
+      std::chrono::microseconds(FLAGS_mock_i2c_latency_per_byte_us);
+  auto handle = std::make_unique<MockUsbHandle>(options);
+  handle->addDevice(kMuxAddr);
+  handle->addDevice(kQsfpAddr);
+
+  auto dev = std::make_unique<CP2112>(std::move(handle));
+  dev->setAsyncTransfers(async);
+  dev->open();
+  return dev;
+}
+
+// A transceiver read the way WedgeI2CBus does it: select the port on the
+// mux, write the offset, then read
+void muxedReads(size_t iters, size_t len, bool async) {
+  std::unique_ptr<CP2112> dev;
+  BENCHMARK_SUSPEND {
+    dev = makeDevice(async);
+  }
+  std::vector<uint8_t> buf(len);
+  for (size_t i = 0; i < iters; ++i) {
+    dev->writeByte(kMuxAddr, 1 << (i % 8));
+    dev->writeByte(kQsfpAddr, 0);
+    dev->read(kQsfpAddr, folly::range(buf));
+  }
+  BENCHMARK_SUSPEND {
+    dev.reset();
+  }
+}
+
+} // namespace
+
+BENCHMARK(SyncMuxedReadByte, n) {
+  muxedReads(n, 1, false);
+}
+
+BENCHMARK_RELATIVE(AsyncMuxedReadByte, n) {
+  muxedReads(n, 1, true);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(SyncMuxedReadPage, n) {
+  muxedReads(n, 128, false);
+}
+
+BENCHMARK_RELATIVE(AsyncMuxedReadPage, n) {
+  muxedReads(n, 128, true);
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
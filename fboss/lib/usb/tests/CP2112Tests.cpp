@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/usb/CP2112.h"
+#include "fboss/lib/usb/UsbError.h"
+#include "fboss/lib/usb/tests/MockUsbHandle.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+using namespace std::chrono_literals;
+
+namespace {
+
+// On-the-wire addresses of a mux and a transceiver
+constexpr uint8_t kMuxAddr = 0xe0;
+constexpr uint8_t kQsfpAddr = 0xa0;
+
+std::vector<uint8_t> pattern(size_t len, uint8_t seed) {
+  std::vector<uint8_t> data(len);
+  for (size_t i = 0; i < len; ++i) {
+    data[i] = seed + i;
+  }
+  return data;
+}
+
+/*
+ * Runs every test with sync and async transfers
+ */
+class CP2112Test : public ::testing::TestWithParam<bool> {
+ protected:
+  void SetUp() override {
+    MockUsbHandle::Options options;
+    options.usbLatency = 50us;
+    options.busLatency = 50us;
+    options.busLatencyPerByte = 1us;
+    auto handle = std::make_unique<MockUsbHandle>(options);
+    handle->addDevice(kMuxAddr);
+    handle->addDevice(kQsfpAddr);
+    handle_ = handle.get();
+
+    dev_ = std::make_unique<CP2112>(std::move(handle));
+    dev_->setAsyncTransfers(GetParam());
+    dev_->open();
+  }
+
+  MockUsbHandle* handle_;
+  std::unique_ptr<CP2112> dev_;
+};
+
+} // namespace
+
+TEST_P(CP2112Test, Open) {
+  EXPECT_TRUE(dev_->isOpen());
+  EXPECT_EQ(400000, dev_->getSMBusConfig().speed);
+  EXPECT_EQ(CP2112::PART_NUMBER, dev_->getVersion().partNumber);
+  dev_->close();
+  EXPECT_FALSE(dev_->isOpen());
+}
+
+TEST_P(CP2112Test, ReadAndWrite) {
+  auto data = pattern(128, 3);
+  handle_->setDeviceData(kQsfpAddr, 0x80, folly::range(data));
+
+  // Mux select, then an offset write and the read behind it
+  dev_->writeByte(kMuxAddr, 0x4);
+  EXPECT_EQ(std::vector<uint8_t>{0x4}, handle_->getDeviceData(kMuxAddr, 0, 1));
+  dev_->writeByte(kQsfpAddr, 0x80);
+  std::vector<uint8_t> buf(128);
+  dev_->read(kQsfpAddr, folly::range(buf));
+  EXPECT_EQ(data, buf);
+
+  std::vector<uint8_t> writeBuf{0x10, 0xaa, 0xbb};
+  dev_->write(kQsfpAddr, folly::range(writeBuf));
+  EXPECT_EQ(
+      (std::vector<uint8_t>{0xaa, 0xbb}),
+      handle_->getDeviceData(kQsfpAddr, 0x10, 2));
+
+  uint8_t offset = 0x10;
+  std::vector<uint8_t> readBuf(2);
+  dev_->writeReadUnsafe(
+      kQsfpAddr, folly::ByteRange(&offset, 1), folly::range(readBuf));
+  EXPECT_EQ((std::vector<uint8_t>{0xaa, 0xbb}), readBuf);
+
+  const auto& stats = dev_->getI2cControllerPlatformStats();
+  EXPECT_EQ(2, *stats.readTotal__ref());
+  EXPECT_EQ(130, *stats.readBytes__ref());
+  EXPECT_EQ(4, *stats.writeTotal__ref());
+  EXPECT_EQ(0, *stats.readFailed__ref());
+}
+
+TEST_P(CP2112Test, Nack) {
+  std::vector<uint8_t> buf(1);
+  EXPECT_THROW(dev_->read(0x50, folly::range(buf)), UsbError);
+  EXPECT_THROW(dev_->writeByte(0x50, 0), UsbError);
+
+  // The device is still usable afterwards
+  handle_->setDeviceData(kQsfpAddr, 0, folly::range(pattern(1, 7)));
+  dev_->writeByte(kQsfpAddr, 0);
+  dev_->read(kQsfpAddr, folly::range(buf));
+  EXPECT_EQ(7, buf[0]);
+
+  const auto& stats = dev_->getI2cControllerPlatformStats();
+  EXPECT_EQ(1, *stats.readFailed__ref());
+  EXPECT_EQ(1, *stats.writeFailed__ref());
+}
+
+TEST_P(CP2112Test, SwitchModes) {
+  handle_->setDeviceData(kQsfpAddr, 0, folly::range(pattern(4, 1)));
+  std::vector<uint8_t> buf(4);
+  for (auto async : {true, false, true}) {
+    dev_->setAsyncTransfers(async);
+    dev_->writeByte(kQsfpAddr, 0);
+    dev_->read(kQsfpAddr, folly::range(buf));
+    EXPECT_EQ(pattern(4, 1), buf);
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(
+    CP2112Test,
+    CP2112Test,
+    ::testing::Bool(),
+    [](const ::testing::TestParamInfo<bool>& info) {
+      return info.param ? "Async" : "Sync";
+    });
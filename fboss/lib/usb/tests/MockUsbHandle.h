@@ -0,0 +1,405 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/lib/usb/UsbHandle.h"
+
+#include <folly/Range.h>
+#include <libusb-1.0/libusb.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * A UsbHandle talking to a simulated CP2112 instead of a USB device, to run
+ * the CP2112 code off box.
+ *
+ * I2C devices of 256 bytes can be added at any (on-the-wire) address.  Like
+ * transceivers and muxes, a write sets the device offset from its first byte
+ * and stores the remaining bytes there, and a read returns the data at the
+ * current offset.  An I2C transaction of len bytes keeps the bus busy for
+ * busLatency + len * busLatencyPerByte, and one to an address without a
+ * device fails with a NACK.
+ *
+ * Every interrupt report takes usbLatency to cross the USB bus, one after
+ * the other in each direction, like interrupt transfers that are serviced
+ * once per USB frame.  Only the feature reports the CP2112 class uses to
+ * open the device are supported.
+ */
+class MockUsbHandle : public UsbHandle {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Options {
+    std::chrono::microseconds usbLatency{1000};
+    std::chrono::microseconds busLatency{100};
+    std::chrono::microseconds busLatencyPerByte{25};
+  };
+
+  explicit MockUsbHandle(const Options& options) : options_(options) {}
+
+  void addDevice(uint8_t address) {
+    devices_[address];
+  }
+
+  void setDeviceData(uint8_t address, uint8_t offset, folly::ByteRange data) {
+    auto& device = devices_.at(address);
+    for (size_t i = 0; i < data.size(); ++i) {
+      device.data[(offset + i) % kDeviceSize] = data[i];
+    }
+  }
+
+  std::vector<uint8_t>
+  getDeviceData(uint8_t address, uint8_t offset, size_t len) const {
+    const auto& device = devices_.at(address);
+    std::vector<uint8_t> data(len);
+    for (size_t i = 0; i < len; ++i) {
+      data[i] = device.data[(offset + i) % kDeviceSize];
+    }
+    return data;
+  }
+
+  uint32_t numStatusRequests() const {
+    return numStatusRequests_;
+  }
+
+  bool isOpen() const override {
+    return open_;
+  }
+  void close() override {
+    open_ = false;
+  }
+  void claimInterface(int /* iface */) override {
+    open_ = true;
+  }
+
+  int controlTransfer(
+      uint8_t requestType,
+      uint8_t /* request */,
+      uint16_t value,
+      uint16_t /* index */,
+      uint8_t* buf,
+      uint16_t length,
+      unsigned int /* timeoutMS */) override {
+    uint8_t report = value & 0xff;
+    if (requestType & LIBUSB_ENDPOINT_IN) {
+      memset(buf, 0, length);
+      buf[0] = report;
+      if (report == kSmbusConfig) {
+        memcpy(buf + 1, smbusConfig_.data(), std::min<size_t>(length - 1, 13));
+      } else if (report == kGetVersion && length >= 3) {
+        buf[1] = 0x0c;
+        buf[2] = 2;
+      }
+      return length;
+    }
+    if (report == kSmbusConfig) {
+      memcpy(smbusConfig_.data(), buf + 1, std::min<size_t>(length - 1, 13));
+    }
+    return length;
+  }
+
+  int interruptTransfer(
+      uint8_t endpoint,
+      uint8_t* buf,
+      int length,
+      int* transferred,
+      unsigned int timeoutMS) override {
+    if (!(endpoint & LIBUSB_ENDPOINT_IN)) {
+      auto arrival = sendOut(buf);
+      std::this_thread::sleep_until(arrival);
+      *transferred = length;
+      return 0;
+    }
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMS);
+    if (inReports_.empty() || inReports_.front().availableAt > deadline) {
+      std::this_thread::sleep_until(deadline);
+      return LIBUSB_ERROR_TIMEOUT;
+    }
+    std::this_thread::sleep_until(inReports_.front().availableAt);
+    *transferred = receiveIn(buf, length);
+    return 0;
+  }
+
+  void submitInterruptTransfer(
+      uint8_t endpoint,
+      uint8_t* buf,
+      int length,
+      unsigned int timeoutMS,
+      TransferCallback callback) override {
+    if (!(endpoint & LIBUSB_ENDPOINT_IN)) {
+      outCompletions_.push_back({sendOut(buf), length, std::move(callback)});
+      return;
+    }
+    pendingIns_.push_back(
+        {buf,
+         length,
+         Clock::now() + std::chrono::milliseconds(timeoutMS),
+         std::move(callback)});
+  }
+
+  void handleEvents(
+      libusb_context* /* ctx */,
+      std::chrono::microseconds timeout) override {
+    auto end = Clock::now() + timeout;
+    auto next = nextEvent();
+    if (next > end) {
+      std::this_thread::sleep_until(end);
+      return;
+    }
+    std::this_thread::sleep_until(next);
+
+    // Complete the due transfers, in order, before running any callback, as
+    // the callbacks may submit more transfers
+    auto now = Clock::now();
+    std::vector<std::pair<TransferCallback, std::pair<int, int>>> done;
+    while (!outCompletions_.empty() && outCompletions_.front().at <= now) {
+      auto& out = outCompletions_.front();
+      done.push_back({std::move(out.callback), {0, out.length}});
+      outCompletions_.pop_front();
+    }
+    while (!pendingIns_.empty()) {
+      auto& in = pendingIns_.front();
+      if (!inReports_.empty() && inReports_.front().availableAt <= now) {
+        auto transferred = receiveIn(in.buf, in.length);
+        done.push_back({std::move(in.callback), {0, transferred}});
+      } else if (in.deadline <= now) {
+        done.push_back({std::move(in.callback), {LIBUSB_ERROR_TIMEOUT, 0}});
+      } else {
+        break;
+      }
+      pendingIns_.pop_front();
+    }
+    for (auto& [callback, result] : done) {
+      callback(result.first, result.second);
+    }
+  }
+
+ private:
+  static constexpr size_t kDeviceSize = 256;
+  static constexpr size_t kReportSize = 64;
+  static constexpr size_t kMaxReadResponse = 61;
+  // CP2112 report IDs
+  static constexpr uint8_t kSmbusConfig = 0x06;
+  static constexpr uint8_t kGetVersion = 0x05;
+  static constexpr uint8_t kReadRequest = 0x10;
+  static constexpr uint8_t kWriteReadRequest = 0x11;
+  static constexpr uint8_t kReadForceSend = 0x12;
+  static constexpr uint8_t kReadResponse = 0x13;
+  static constexpr uint8_t kWrite = 0x14;
+  static constexpr uint8_t kXferStatusRequest = 0x15;
+  static constexpr uint8_t kXferStatusResponse = 0x16;
+  static constexpr uint8_t kCancelXfer = 0x17;
+
+  struct Device {
+    std::array<uint8_t, kDeviceSize> data{};
+    uint8_t offset{0};
+  };
+
+  struct Transfer {
+    bool active{false};
+    bool isRead{false};
+    bool failed{false};
+    Clock::time_point doneAt;
+    // Data read from the device, and how much of it was sent over USB
+    std::vector<uint8_t> readData;
+    size_t readSent{0};
+  };
+
+  struct InReport {
+    Clock::time_point availableAt;
+    std::array<uint8_t, kReportSize> buf{};
+  };
+
+  struct OutCompletion {
+    Clock::time_point at;
+    int length;
+    TransferCallback callback;
+  };
+
+  struct PendingIn {
+    uint8_t* buf;
+    int length;
+    Clock::time_point deadline;
+    TransferCallback callback;
+  };
+
+  // Returns when the report reaches the device
+  Clock::time_point sendOut(const uint8_t* buf) {
+    auto arrival =
+        std::max(Clock::now(), lastOutArrival_) + options_.usbLatency;
+    lastOutArrival_ = arrival;
+    processOut(buf, arrival);
+    return arrival;
+  }
+
+  int receiveIn(uint8_t* buf, int length) {
+    auto len = std::min<size_t>(length, kReportSize);
+    memcpy(buf, inReports_.front().buf.data(), len);
+    inReports_.pop_front();
+    return len;
+  }
+
+  Clock::time_point nextEvent() const {
+    auto next = Clock::time_point::max();
+    if (!outCompletions_.empty()) {
+      next = outCompletions_.front().at;
+    }
+    if (!pendingIns_.empty()) {
+      auto in = inReports_.empty()
+          ? pendingIns_.front().deadline
+          : std::min(
+                pendingIns_.front().deadline, inReports_.front().availableAt);
+      next = std::min(next, in);
+    }
+    return next;
+  }
+
+  void queueIn(Clock::time_point at, const std::array<uint8_t, 64>& buf) {
+    InReport report;
+    report.availableAt = std::max(at, lastInAvailable_) + options_.usbLatency;
+    report.buf = buf;
+    lastInAvailable_ = report.availableAt;
+    inReports_.push_back(report);
+  }
+
+  void startTransfer(
+      Clock::time_point at,
+      uint8_t address,
+      folly::ByteRange writeData,
+      size_t readLen) {
+    xfer_ = Transfer();
+    xfer_.active = true;
+    xfer_.isRead = readLen > 0;
+    auto start = std::max(at, busFreeAt_);
+    auto it = devices_.find(address);
+    if (it == devices_.end()) {
+      // Only the address goes out before the NACK
+      xfer_.failed = true;
+      xfer_.doneAt = start + options_.busLatency;
+      busFreeAt_ = xfer_.doneAt;
+      return;
+    }
+    auto& device = it->second;
+    if (!writeData.empty()) {
+      device.offset = writeData[0];
+      for (size_t i = 1; i < writeData.size(); ++i) {
+        device.data[device.offset++] = writeData[i];
+      }
+    }
+    for (size_t i = 0; i < readLen; ++i) {
+      xfer_.readData.push_back(device.data[device.offset++]);
+    }
+    xfer_.doneAt = start + options_.busLatency +
+        options_.busLatencyPerByte * (writeData.size() + readLen);
+    busFreeAt_ = xfer_.doneAt;
+  }
+
+  void processOut(const uint8_t* buf, Clock::time_point at) {
+    std::array<uint8_t, kReportSize> in{};
+    switch (buf[0]) {
+      case kReadRequest:
+        startTransfer(at, buf[1], folly::ByteRange(), (buf[2] << 8) | buf[3]);
+        break;
+      case kWriteReadRequest:
+        startTransfer(
+            at,
+            buf[1],
+            folly::ByteRange(buf + 5, buf[4]),
+            (buf[2] << 8) | buf[3]);
+        break;
+      case kWrite:
+        startTransfer(at, buf[1], folly::ByteRange(buf + 3, buf[2]), 0);
+        break;
+      case kXferStatusRequest:
+        ++numStatusRequests_;
+        in[0] = kXferStatusResponse;
+        if (!xfer_.active) {
+          in[1] = 0;
+        } else if (at < xfer_.doneAt) {
+          in[1] = 1;
+          in[2] = xfer_.isRead ? 2 : 3;
+        } else if (xfer_.failed) {
+          in[1] = 3;
+          in[2] = 0;
+        } else {
+          in[1] = 2;
+          in[2] = 5;
+          in[5] = xfer_.readData.size() >> 8;
+          in[6] = xfer_.readData.size() & 0xff;
+        }
+        queueIn(at, in);
+        break;
+      case kReadForceSend:
+        sendReadResponses(at);
+        break;
+      case kCancelXfer:
+        xfer_ = Transfer();
+        break;
+      default:
+        break;
+    }
+  }
+
+  void sendReadResponses(Clock::time_point at) {
+    std::array<uint8_t, kReportSize> in{};
+    in[0] = kReadResponse;
+    if (!xfer_.active || !xfer_.isRead || xfer_.failed) {
+      return;
+    }
+    if (at < xfer_.doneAt) {
+      in[1] = 1;
+      queueIn(at, in);
+      return;
+    }
+    if (xfer_.readSent > xfer_.readData.size()) {
+      // Everything, including the final empty response, was already sent
+      return;
+    }
+    while (xfer_.readSent < xfer_.readData.size()) {
+      auto len =
+          std::min(kMaxReadResponse, xfer_.readData.size() - xfer_.readSent);
+      in[1] = 2;
+      in[2] = len;
+      memcpy(in.data() + 3, xfer_.readData.data() + xfer_.readSent, len);
+      xfer_.readSent += len;
+      queueIn(at, in);
+    }
+    // The device finishes with an empty response
+    in[1] = 0;
+    in[2] = 0;
+    queueIn(at, in);
+    xfer_.readSent = xfer_.readData.size() + 1;
+  }
+
+  const Options options_;
+  bool open_{false};
+  std::map<uint8_t, Device> devices_;
+  // Speed 100KHz, address 2, as the hardware defaults to
+  std::array<uint8_t, 13> smbusConfig_{0x00, 0x01, 0x86, 0xa0, 0x02};
+  Transfer xfer_;
+  Clock::time_point busFreeAt_;
+  Clock::time_point lastOutArrival_;
+  Clock::time_point lastInAvailable_;
+  std::deque<InReport> inReports_;
+  std::deque<OutCompletion> outCompletions_;
+  std::deque<PendingIn> pendingIns_;
+  uint32_t numStatusRequests_{0};
+};
+
+} // namespace facebook::fboss
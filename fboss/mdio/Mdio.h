@@ -165,6 +165,10 @@ class MdioController {
       return locked_;
     }
 
+    IO& operator*() {
+      return *locked_;
+    }
+
    private:
     LockedPtr locked_;
     ProcLock procLock_;
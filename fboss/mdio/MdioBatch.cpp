@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/mdio/MdioBatch.h"
+
+namespace facebook {
+namespace fboss {
+
+MdioBatch::ReadHandle MdioBatch::read(
+    phy::PhyAddress physAddr,
+    phy::Cl45DeviceAddress devAddr,
+    phy::Cl45RegisterAddress regAddr) {
+  checkCanAdd(physAddr);
+  ++numAccesses_;
+  ReadHandle handle = results_.size();
+  results_.push_back(0);
+  push(Op{OpType::READ, physAddr, devAddr, regAddr, 0, 0, handle});
+  return handle;
+}
+
+void MdioBatch::write(
+    phy::PhyAddress physAddr,
+    phy::Cl45DeviceAddress devAddr,
+    phy::Cl45RegisterAddress regAddr,
+    phy::Cl45Data data) {
+  checkCanAdd(physAddr);
+  ++numAccesses_;
+  push(Op{OpType::WRITE, physAddr, devAddr, regAddr, 0, data, std::nullopt});
+}
+
+void MdioBatch::modify(
+    phy::PhyAddress physAddr,
+    phy::Cl45DeviceAddress devAddr,
+    phy::Cl45RegisterAddress regAddr,
+    phy::Cl45Data mask,
+    phy::Cl45Data value) {
+  checkCanAdd(physAddr);
+  ++numAccesses_;
+  if (auto last = lastOpOnRegister(physAddr, devAddr, regAddr)) {
+    switch (last->type) {
+      case OpType::READ:
+        // Write back what the read gets, instead of reading it again
+        last->type = OpType::MODIFY;
+        last->mask = mask;
+        last->data = value;
+        return;
+      case OpType::WRITE:
+        last->data = (last->data & ~mask) | (value & mask);
+        return;
+      case OpType::MODIFY:
+        last->data = (last->data & ~mask) | (value & mask);
+        last->mask |= mask;
+        return;
+    }
+  }
+  if (mask == static_cast<phy::Cl45Data>(~0)) {
+    push(Op{OpType::WRITE, physAddr, devAddr, regAddr, 0, value, std::nullopt});
+  } else {
+    push(Op{
+        OpType::MODIFY, physAddr, devAddr, regAddr, mask, value, std::nullopt});
+  }
+}
+
+phy::Cl45Data MdioBatch::result(ReadHandle handle) const {
+  if (!executed_) {
+    throw MdioError("MDIO batch hasn't executed yet");
+  }
+  if (handle >= results_.size()) {
+    throw MdioError("Invalid MDIO batch read handle ", handle);
+  }
+  return results_[handle];
+}
+
+size_t MdioBatch::transactions() const {
+  size_t transactions = 0;
+  for (const auto& op : ops_) {
+    transactions += op.type == OpType::MODIFY ? 2 : 1;
+  }
+  return transactions;
+}
+
+void MdioBatch::clear() {
+  ops_.clear();
+  results_.clear();
+  lastOp_.fill(0);
+  numAccesses_ = 0;
+  executed_ = false;
+}
+
+MdioBatch::Op* MdioBatch::lastOpOnRegister(
+    phy::PhyAddress physAddr,
+    phy::Cl45DeviceAddress devAddr,
+    phy::Cl45RegisterAddress regAddr) {
+  if (!lastOp_[physAddr]) {
+    return nullptr;
+  }
+  auto& op = ops_[lastOp_[physAddr] - 1];
+  if (op.devAddr != devAddr || op.regAddr != regAddr) {
+    return nullptr;
+  }
+  return &op;
+}
+
+void MdioBatch::checkCanAdd(phy::PhyAddress physAddr) const {
+  if (executed_) {
+    throw MdioError("Can't add to an MDIO batch that has executed");
+  }
+  if (physAddr >= kMaxPhys) {
+    throw MdioError("Invalid PHY address ", static_cast<int>(physAddr));
+  }
+}
+
+void MdioBatch::push(Op op) {
+  ops_.push_back(std::move(op));
+  lastOp_[ops_.back().physAddr] = ops_.size();
+}
+
+} // namespace fboss
+} // namespace facebook
@@ -0,0 +1,199 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/mdio/Mdio.h"
+#include "fboss/mdio/MdioError.h"
+#include "fboss/mdio/Phy.h"
+
+#include <folly/Executor.h>
+#include <folly/futures/Future.h>
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace facebook {
+namespace fboss {
+
+/*
+ * A batch of Cl45 register accesses, queued up front and executed in one
+ * go while holding the MDIO controller. This saves taking the controller
+ * (and the inter-process lock) for every access, and lets the batch fuse
+ * accesses to the same register:
+ *
+ * - a modify() right after a read() of the register reuses the value read,
+ * - a modify() right after a write() or another modify() of the register
+ *   is folded into it,
+ * - a modify() of all the bits is a plain write.
+ *
+ * "Right after" is per PHY: accesses to other PHYs in between don't stop
+ * the fusion, since the order of accesses is only kept per PHY. Reads are
+ * never served from the batch, they always go to the device, as status
+ * registers may change or clear on read.
+ */
+class MdioBatch {
+ public:
+  using ReadHandle = size_t;
+
+  /* Queues a read, the value is available from result() after execute() */
+  ReadHandle read(
+      phy::PhyAddress physAddr,
+      phy::Cl45DeviceAddress devAddr,
+      phy::Cl45RegisterAddress regAddr);
+
+  void write(
+      phy::PhyAddress physAddr,
+      phy::Cl45DeviceAddress devAddr,
+      phy::Cl45RegisterAddress regAddr,
+      phy::Cl45Data data);
+
+  /* Sets the bits of the register in mask to those of value */
+  void modify(
+      phy::PhyAddress physAddr,
+      phy::Cl45DeviceAddress devAddr,
+      phy::Cl45RegisterAddress regAddr,
+      phy::Cl45Data mask,
+      phy::Cl45Data value);
+
+  /*
+   * Runs the batch on io, which has the readCl45()/writeCl45() of Mdio.
+   * The caller has to hold the controller io belongs to.
+   */
+  template <typename IO>
+  void execute(IO& io);
+
+  /* Runs the batch while holding the controller */
+  template <typename IO>
+  void execute(MdioController<IO>& controller) {
+    auto locked = controller.fully_lock();
+    execute(*locked);
+  }
+
+  /* Throws MdioError if the batch didn't execute */
+  phy::Cl45Data result(ReadHandle handle) const;
+
+  /* Number of accesses queued, before fusion */
+  size_t size() const {
+    return numAccesses_;
+  }
+  /* Number of MDIO transactions executing the batch takes */
+  size_t transactions() const;
+  bool empty() const {
+    return ops_.empty();
+  }
+  bool executed() const {
+    return executed_;
+  }
+
+  /* Empties the batch so that it can be reused */
+  void clear();
+
+ private:
+  enum class OpType {
+    READ,
+    WRITE,
+    // Read, then write back with the bits in mask changed
+    MODIFY,
+  };
+
+  struct Op {
+    OpType type;
+    phy::PhyAddress physAddr;
+    phy::Cl45DeviceAddress devAddr;
+    phy::Cl45RegisterAddress regAddr;
+    phy::Cl45Data mask{0};
+    phy::Cl45Data data{0};
+    // Where the value read goes, if a read() asked for it
+    std::optional<ReadHandle> result;
+  };
+
+  static constexpr size_t kMaxPhys = 32;
+
+  Op* lastOpOnRegister(
+      phy::PhyAddress physAddr,
+      phy::Cl45DeviceAddress devAddr,
+      phy::Cl45RegisterAddress regAddr);
+  void checkCanAdd(phy::PhyAddress physAddr) const;
+  void push(Op op);
+
+  std::vector<Op> ops_;
+  std::vector<phy::Cl45Data> results_;
+  // Index + 1 of the last op on each PHY, 0 if there is none
+  std::array<size_t, kMaxPhys> lastOp_{};
+  size_t numAccesses_{0};
+  bool executed_{false};
+};
+
+template <typename IO>
+void MdioBatch::execute(IO& io) {
+  for (const auto& op : ops_) {
+    switch (op.type) {
+      case OpType::READ:
+        results_[*op.result] =
+            io.readCl45(op.physAddr, op.devAddr, op.regAddr);
+        break;
+      case OpType::WRITE:
+        io.writeCl45(op.physAddr, op.devAddr, op.regAddr, op.data);
+        break;
+      case OpType::MODIFY: {
+        auto value = io.readCl45(op.physAddr, op.devAddr, op.regAddr);
+        if (op.result) {
+          results_[*op.result] = value;
+        }
+        io.writeCl45(
+            op.physAddr,
+            op.devAddr,
+            op.regAddr,
+            (value & ~op.mask) | (op.data & op.mask));
+        break;
+      }
+    }
+  }
+  executed_ = true;
+}
+
+/*
+ * Executes batches on their controllers: the batches of a controller run
+ * one after the other, in order, while different controllers run in
+ * parallel on executor. PHYs behind the same controller share its bus, so
+ * they can't go any faster than that.
+ *
+ * Waits for all batches to finish, and throws the first error, if any.
+ */
+template <typename IO>
+void executeBatches(
+    const std::vector<std::pair<MdioController<IO>*, MdioBatch*>>& batches,
+    folly::Executor* executor) {
+  std::map<MdioController<IO>*, std::vector<MdioBatch*>> byController;
+  for (const auto& [controller, batch] : batches) {
+    byController[controller].push_back(batch);
+  }
+
+  std::vector<folly::Future<folly::Unit>> futures;
+  for (auto& [controller, controllerBatches] : byController) {
+    futures.push_back(folly::via(
+        executor, [controller = controller, &queue = controllerBatches]() {
+          for (auto batch : queue) {
+            batch->execute(*controller);
+          }
+        }));
+  }
+  auto results = folly::collectAll(std::move(futures)).get();
+  for (auto& result : results) {
+    result.value();
+  }
+}
+
+} // namespace fboss
+} // namespace facebook
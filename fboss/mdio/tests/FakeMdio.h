@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/mdio/Mdio.h"
+#include "fboss/mdio/MdioError.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace facebook {
+namespace fboss {
+
+/*
+ * An MDIO bus with fake PHYs on it. Every register of every PHY is backed
+ * by memory and reads as 0 until written. Each transaction takes latency,
+ * to model the time spent on the bus, and is logged so that tests can check
+ * what went over the bus.
+ *
+ * MdioController copies the IO it is given, so the copies share the state.
+ */
+class FakeMdio : public Mdio {
+ public:
+  struct Transaction {
+    bool isRead;
+    phy::PhyAddress physAddr;
+    phy::Cl45DeviceAddress devAddr;
+    phy::Cl45RegisterAddress regAddr;
+    phy::Cl45Data data;
+  };
+
+  explicit FakeMdio(
+      int id,
+      std::chrono::microseconds latency = std::chrono::microseconds(0))
+      : id_(id), state_(std::make_shared<State>()) {
+    state_->latency = latency;
+  }
+
+  phy::Cl45Data readCl45(
+      phy::PhyAddress physAddr,
+      phy::Cl45DeviceAddress devAddr,
+      phy::Cl45RegisterAddress regAddr) override {
+    wait();
+    std::lock_guard<std::mutex> g(state_->mutex);
+    checkFailed();
+    auto data = state_->registers[{physAddr, devAddr, regAddr}];
+    state_->log.push_back(Transaction{true, physAddr, devAddr, regAddr, data});
+    return data;
+  }
+
+  void writeCl45(
+      phy::PhyAddress physAddr,
+      phy::Cl45DeviceAddress devAddr,
+      phy::Cl45RegisterAddress regAddr,
+      phy::Cl45Data data) override {
+    wait();
+    std::lock_guard<std::mutex> g(state_->mutex);
+    checkFailed();
+    state_->registers[{physAddr, devAddr, regAddr}] = data;
+    state_->log.push_back(
+        Transaction{false, physAddr, devAddr, regAddr, data});
+  }
+
+  /* Register access for tests, without going over the bus */
+  phy::Cl45Data getRegister(
+      phy::PhyAddress physAddr,
+      phy::Cl45DeviceAddress devAddr,
+      phy::Cl45RegisterAddress regAddr) const {
+    std::lock_guard<std::mutex> g(state_->mutex);
+    auto it = state_->registers.find({physAddr, devAddr, regAddr});
+    return it == state_->registers.end() ? 0 : it->second;
+  }
+
+  void setRegister(
+      phy::PhyAddress physAddr,
+      phy::Cl45DeviceAddress devAddr,
+      phy::Cl45RegisterAddress regAddr,
+      phy::Cl45Data data) {
+    std::lock_guard<std::mutex> g(state_->mutex);
+    state_->registers[{physAddr, devAddr, regAddr}] = data;
+  }
+
+  /* All transactions fail with an MdioError while set */
+  void setFailed(bool failed) {
+    std::lock_guard<std::mutex> g(state_->mutex);
+    state_->failed = failed;
+  }
+
+  std::vector<Transaction> getLog() const {
+    std::lock_guard<std::mutex> g(state_->mutex);
+    return state_->log;
+  }
+
+  void clearLog() {
+    std::lock_guard<std::mutex> g(state_->mutex);
+    state_->log.clear();
+  }
+
+  int getId() const {
+    return id_;
+  }
+
+ private:
+  using RegisterKey = std::
+      tuple<phy::PhyAddress, phy::Cl45DeviceAddress, phy::Cl45RegisterAddress>;
+
+  struct State {
+    mutable std::mutex mutex;
+    std::map<RegisterKey, phy::Cl45Data> registers;
+    std::vector<Transaction> log;
+    std::chrono::microseconds latency{0};
+    bool failed{false};
+  };
+
+  void wait() const {
+    if (state_->latency.count() > 0) {
+      std::this_thread::sleep_for(state_->latency);
+    }
+  }
+
+  void checkFailed() const {
+    if (state_->failed) {
+      throw MdioError("MDIO transaction failed on fake controller ", id_);
+    }
+  }
+
+  int id_;
+  std::shared_ptr<State> state_;
+};
+
+} // namespace fboss
+} // namespace facebook
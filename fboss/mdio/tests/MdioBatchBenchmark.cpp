@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/mdio/MdioBatch.h"
+#include "fboss/mdio/tests/FakeMdio.h"
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+using namespace facebook::fboss;
+
+namespace {
+
+// A gearbox port: a handful of lane registers on each side, each of them
+// set with a read-modify-write, as a PHY driver would do
+constexpr int kNumPorts = 16;
+constexpr int kRegistersPerPort = 16;
+constexpr phy::Cl45DeviceAddress kPmaPmd = 1;
+
+phy::PhyAddress portPhy(int port) {
+  return port % 4;
+}
+
+phy::Cl45RegisterAddress portRegister(int port, int reg) {
+  return 0x8000 + port * kRegistersPerPort + reg;
+}
+
+} // namespace
+
+BENCHMARK(ProgramPortsPerAccess, iters) {
+  folly::BenchmarkSuspender suspender;
+  MdioController<FakeMdio> controller(0);
+  suspender.dismiss();
+  for (size_t iter = 0; iter < iters; ++iter) {
+    for (int port = 0; port < kNumPorts; ++port) {
+      for (int reg = 0; reg < kRegistersPerPort; ++reg) {
+        auto addr = portRegister(port, reg);
+        auto value = controller.readCl45(portPhy(port), kPmaPmd, addr);
+        controller.writeCl45(
+            portPhy(port), kPmaPmd, addr, (value & ~0xff) | reg);
+      }
+    }
+  }
+}
+
+BENCHMARK_RELATIVE(ProgramPortsBatched, iters) {
+  folly::BenchmarkSuspender suspender;
+  MdioController<FakeMdio> controller(0);
+  suspender.dismiss();
+  for (size_t iter = 0; iter < iters; ++iter) {
+    MdioBatch batch;
+    for (int port = 0; port < kNumPorts; ++port) {
+      for (int reg = 0; reg < kRegistersPerPort; ++reg) {
+        batch.modify(
+            portPhy(port), kPmaPmd, portRegister(port, reg), 0xff, reg);
+      }
+    }
+    batch.execute(controller);
+  }
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,160 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/mdio/MdioBatch.h"
+#include "fboss/mdio/tests/FakeMdio.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+constexpr phy::Cl45DeviceAddress kPmaPmd = 1;
+constexpr phy::Cl45DeviceAddress kAn = 7;
+} // namespace
+
+TEST(MdioBatchTest, ReadsAndWrites) {
+  FakeMdio mdio(0);
+  mdio.setRegister(1, kPmaPmd, 0x10, 0xabcd);
+
+  MdioBatch batch;
+  auto before = batch.read(1, kPmaPmd, 0x10);
+  batch.write(1, kPmaPmd, 0x10, 0x1234);
+  auto after = batch.read(1, kPmaPmd, 0x10);
+  EXPECT_EQ(3, batch.size());
+  EXPECT_EQ(3, batch.transactions());
+  EXPECT_THROW(batch.result(before), MdioError);
+
+  batch.execute(mdio);
+  EXPECT_EQ(0xabcd, batch.result(before));
+  EXPECT_EQ(0x1234, batch.result(after));
+  EXPECT_EQ(3, mdio.getLog().size());
+  EXPECT_THROW(batch.result(after + 1), MdioError);
+}
+
+TEST(MdioBatchTest, FusesModifies) {
+  FakeMdio mdio(0);
+  mdio.setRegister(1, kPmaPmd, 0x10, 0xff00);
+  mdio.setRegister(1, kPmaPmd, 0x11, 0x00ff);
+
+  MdioBatch batch;
+  // Read-modify-write of the value the read gets
+  auto read = batch.read(1, kPmaPmd, 0x10);
+  batch.modify(1, kPmaPmd, 0x10, 0x000f, 0x0003);
+  // Modifies of another PHY in between don't get in the way
+  batch.modify(2, kPmaPmd, 0x10, 0x00f0, 0x0050);
+  batch.modify(1, kPmaPmd, 0x10, 0xf000, 0x1000);
+  // Folded into the write
+  batch.write(1, kAn, 0x0, 0x1000);
+  batch.modify(1, kAn, 0x0, 0x0200, 0x0200);
+  // A full modify is a write
+  batch.modify(1, kPmaPmd, 0x11, 0xffff, 0x4321);
+  EXPECT_EQ(7, batch.size());
+  // Read + write of 1.0x10, of 2.0x10, and a write of 7.0x0 and 1.0x11
+  EXPECT_EQ(6, batch.transactions());
+
+  batch.execute(mdio);
+  EXPECT_EQ(6, mdio.getLog().size());
+  EXPECT_EQ(0xff00, batch.result(read));
+  EXPECT_EQ(0x1f03, mdio.getRegister(1, kPmaPmd, 0x10));
+  EXPECT_EQ(0x0050, mdio.getRegister(2, kPmaPmd, 0x10));
+  EXPECT_EQ(0x1200, mdio.getRegister(1, kAn, 0x0));
+  EXPECT_EQ(0x4321, mdio.getRegister(1, kPmaPmd, 0x11));
+}
+
+TEST(MdioBatchTest, KeepsOrderPerPhy) {
+  FakeMdio mdio(0);
+
+  MdioBatch batch;
+  batch.modify(1, kPmaPmd, 0x10, 0x1, 0x1);
+  // Another register of the same PHY ends the fusion, e.g. for registers
+  // that select what the following accesses go to
+  batch.write(1, kPmaPmd, 0x20, 0x5);
+  batch.modify(1, kPmaPmd, 0x10, 0x2, 0x2);
+  EXPECT_EQ(5, batch.transactions());
+
+  batch.execute(mdio);
+  auto log = mdio.getLog();
+  ASSERT_EQ(5, log.size());
+  EXPECT_EQ(0x10, log[1].regAddr);
+  EXPECT_EQ(0x20, log[2].regAddr);
+  EXPECT_EQ(0x10, log[3].regAddr);
+  EXPECT_EQ(0x3, mdio.getRegister(1, kPmaPmd, 0x10));
+}
+
+TEST(MdioBatchTest, Errors) {
+  FakeMdio mdio(0);
+  MdioBatch batch;
+  EXPECT_THROW(batch.read(32, kPmaPmd, 0x10), MdioError);
+
+  batch.write(1, kPmaPmd, 0x10, 0x1);
+  mdio.setFailed(true);
+  EXPECT_THROW(batch.execute(mdio), MdioError);
+  EXPECT_FALSE(batch.executed());
+
+  mdio.setFailed(false);
+  batch.execute(mdio);
+  EXPECT_THROW(batch.write(1, kPmaPmd, 0x10, 0x2), MdioError);
+
+  batch.clear();
+  EXPECT_TRUE(batch.empty());
+  EXPECT_NO_THROW(batch.write(1, kPmaPmd, 0x10, 0x2));
+}
+
+TEST(MdioBatchTest, ExecuteBatchesOnControllers) {
+  constexpr int kNumControllers = 2;
+  constexpr int kPhysPerController = 4;
+  std::vector<std::unique_ptr<MdioController<FakeMdio>>> controllers;
+  for (int i = 0; i < kNumControllers; ++i) {
+    controllers.push_back(std::make_unique<MdioController<FakeMdio>>(
+        i, std::chrono::microseconds(100)));
+  }
+
+  std::vector<MdioBatch> batches(kNumControllers * kPhysPerController);
+  std::vector<std::pair<MdioController<FakeMdio>*, MdioBatch*>> jobs;
+  for (size_t i = 0; i < batches.size(); ++i) {
+    phy::PhyAddress phy = i / kNumControllers;
+    batches[i].write(phy, kPmaPmd, 0x10, i);
+    batches[i].modify(phy, kPmaPmd, 0x10, 0xff00, 0xab00);
+    jobs.emplace_back(controllers[i % kNumControllers].get(), &batches[i]);
+  }
+
+  folly::CPUThreadPoolExecutor executor(kNumControllers);
+  executeBatches(jobs, &executor);
+
+  for (size_t i = 0; i < batches.size(); ++i) {
+    auto mdio = controllers[i % kNumControllers]->fully_lock();
+    phy::PhyAddress phy = i / kNumControllers;
+    EXPECT_EQ(0xab00 | i, mdio->getRegister(phy, kPmaPmd, 0x10));
+  }
+  for (auto& controller : controllers) {
+    // One fused write per PHY, in the order the batches were given
+    auto log = controller->fully_lock()->getLog();
+    ASSERT_EQ(kPhysPerController, log.size());
+    for (int i = 0; i < kPhysPerController; ++i) {
+      EXPECT_EQ(i, log[i].physAddr);
+    }
+  }
+
+  controllers[1]->fully_lock()->setFailed(true);
+  for (auto& batch : batches) {
+    batch.clear();
+    batch.write(0, kPmaPmd, 0x10, 0);
+  }
+  EXPECT_THROW(executeBatches(jobs, &executor), MdioError);
+  // The other controller isn't affected
+  EXPECT_TRUE(batches[0].executed());
+}
@@ -20,6 +20,17 @@ DEFINE_int32(
     5,
     "Interval (in seconds) to run the main loop that determines "
     "if we need to change or fetch data for transceivers");
+DEFINE_int32(
+    event_loop_interval,
+    30,
+    "Interval (in seconds) to run the main loop when transceivers are "
+    "refreshed on presence and interrupt changes in between, see "
+    "refresh_transceivers_on_events");
+DEFINE_int32(
+    event_scan_interval_ms,
+    100,
+    "Interval (in milliseconds) to scan transceiver presence and interrupts "
+    "with refresh_transceivers_on_events");
 
 int doServerLoop(std::shared_ptr<apache::thrift::ThriftServer>
         thriftServer, std::shared_ptr<QsfpServiceHandler>);
@@ -51,13 +62,27 @@ int main(int argc, char **argv) {
       },
       std::chrono::seconds(FLAGS_stats_publish_interval),
       "statsPublish");
+  // Where presence and interrupt changes trigger refreshes of the
+  // transceivers that changed, the full refresh is only needed for the
+  // slowly changing data and can run much less often
+  auto eventsSupported =
+      handler->getTransceiverManager()->supportsTransceiverEvents();
   scheduler.addFunction(
     [mgr = handler->getTransceiverManager()]() {
       mgr->refreshTransceivers();
     },
-    std::chrono::seconds(FLAGS_loop_interval),
+    std::chrono::seconds(
+        eventsSupported ? FLAGS_event_loop_interval : FLAGS_loop_interval),
     "refreshTransceivers"
   );
+  if (eventsSupported) {
+    scheduler.addFunction(
+        [mgr = handler->getTransceiverManager()]() {
+          mgr->scanTransceiverEvents();
+        },
+        std::chrono::milliseconds(FLAGS_event_scan_interval_ms),
+        "scanTransceiverEvents");
+  }
 
   // Schedule the function to periodically send the I2c transaction
   // stats to the ServiceData object which gets pulled by FBagent.
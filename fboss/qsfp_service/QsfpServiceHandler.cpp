@@ -4,6 +4,8 @@
 #include <folly/logging/xlog.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
 
+#include "fboss/qsfp_service/RefreshProfiler.h"
+
 namespace facebook { namespace fboss {
 
 QsfpServiceHandler::QsfpServiceHandler(
@@ -53,4 +55,10 @@ void QsfpServiceHandler::syncPorts(
   manager_->syncPorts(info, std::move(ports));
 }
 
+void QsfpServiceHandler::getRefreshProfiles(
+    std::vector<RefreshCycleProfile>& profiles) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  profiles = RefreshProfiler::get()->getCycles();
+}
+
 }} // facebook::fboss
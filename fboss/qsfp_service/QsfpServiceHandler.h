@@ -45,6 +45,11 @@ class QsfpServiceHandler : public facebook::fboss::QsfpServiceSvIf,
    */
   void customizeTransceiver(int32_t idx, cfg::PortSpeed speed) override;
 
+  /*
+   * Returns the timing of the last transceiver refresh cycles.
+   */
+  void getRefreshProfiles(std::vector<RefreshCycleProfile>& profiles) override;
+
   /*
    * Return a pointer to the transceiver manager.
    */
@@ -0,0 +1,191 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/qsfp_service/RefreshProfiler.h"
+
+#include <folly/Conv.h>
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+DEFINE_bool(
+    enable_refresh_profiling,
+    false,
+    "Time every transceiver refresh by I2C phase, page and decode, and "
+    "export the timings as histograms");
+DEFINE_int32(
+    refresh_profile_history,
+    32,
+    "Number of refresh cycles to keep for getRefreshProfiles()");
+
+namespace {
+constexpr auto kProfilePrefix = "qsfp.refresh.";
+
+int64_t toUsecs(std::chrono::nanoseconds duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+      .count();
+}
+
+int64_t nowMsecs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+} // namespace
+
+namespace facebook { namespace fboss {
+
+RefreshProfiler* RefreshProfiler::get() {
+  static RefreshProfiler profiler;
+  return &profiler;
+}
+
+RefreshProfiler::CycleId RefreshProfiler::startCycle(
+    folly::StringPiece trigger) {
+  if (!FLAGS_enable_refresh_profiling) {
+    return kNoCycle;
+  }
+  auto id = nextCycleId_++;
+  OpenCycle cycle;
+  *cycle.profile.id_ref() = id;
+  *cycle.profile.trigger_ref() = trigger.str();
+  *cycle.profile.startTime_ref() = nowMsecs();
+  cycle.start = Clock::now();
+  *current_.wlock() = std::move(cycle);
+  openCycle_ = id;
+  return id;
+}
+
+void RefreshProfiler::finishCycle(Clock::duration publishTime) {
+  openCycle_ = kNoCycle;
+  auto cycle = std::exchange(*current_.wlock(), std::nullopt);
+  if (!cycle) {
+    return;
+  }
+  auto& profile = cycle->profile;
+  *profile.totalUs_ref() = toUsecs(Clock::now() - cycle->start);
+  *profile.publishUs_ref() = toUsecs(publishTime);
+  recordStage("cycle.total", *profile.totalUs_ref());
+  recordStage("cycle.publish", *profile.publishUs_ref());
+
+  auto history = history_.wlock();
+  history->push_back(std::move(profile));
+  auto maxHistory =
+      static_cast<size_t>(std::max(FLAGS_refresh_profile_history, 0));
+  while (history->size() > maxHistory) {
+    history->pop_front();
+  }
+}
+
+void RefreshProfiler::recordTransceiver(
+    CycleId cycle,
+    TransceiverRefreshProfile profile) {
+  recordStage("total", *profile.totalUs_ref());
+  recordStage("lock_wait", *profile.lockWaitUs_ref());
+  recordStage("mux_select", *profile.muxSelectUs_ref());
+  recordStage("transfer", *profile.transferUs_ref());
+  recordStage("settle", *profile.settleUs_ref());
+  recordStage("read", *profile.readUs_ref());
+  recordStage("decode", *profile.decodeUs_ref());
+  if (!profile.bus_ref()->empty()) {
+    recordStage(
+        folly::to<std::string>("bus.", *profile.bus_ref(), ".transfer"),
+        *profile.transferUs_ref());
+  }
+
+  auto current = current_.wlock();
+  if (*current && *(*current)->profile.id_ref() == cycle) {
+    (*current)->profile.transceivers_ref()->push_back(std::move(profile));
+  }
+}
+
+std::vector<RefreshCycleProfile> RefreshProfiler::getCycles() const {
+  auto history = history_.rlock();
+  return std::vector<RefreshCycleProfile>(history->begin(), history->end());
+}
+
+void RefreshProfiler::recordStage(folly::StringPiece stage, int64_t usecs) {
+  stageHistograms_.addValue(
+      folly::to<std::string>(kProfilePrefix, stage, ".us"),
+      std::chrono::microseconds(usecs));
+}
+
+ScopedTransceiverRefresh::ScopedTransceiverRefresh(int32_t transceiver)
+    : cycle_(ScopedRefreshCycle::current()),
+      active_(
+          FLAGS_enable_refresh_profiling &&
+          RefreshProfiler::get()->cycleOpen(cycle_)),
+      uncaughtExceptions_(std::uncaught_exceptions()) {
+  if (!active_) {
+    return;
+  }
+  start_ = RefreshProfiler::Clock::now();
+  *profile_.transceiver_ref() = transceiver;
+  previous_ = current_;
+  current_ = this;
+  phaseRecorder_.emplace(this);
+}
+
+ScopedTransceiverRefresh::~ScopedTransceiverRefresh() {
+  if (!active_) {
+    return;
+  }
+  phaseRecorder_.reset();
+  current_ = previous_;
+  *profile_.totalUs_ref() = toUsecs(RefreshProfiler::Clock::now() - start_);
+  *profile_.failed_ref() = std::uncaught_exceptions() > uncaughtExceptions_;
+  try {
+    RefreshProfiler::get()->recordTransceiver(cycle_, std::move(profile_));
+  } catch (const std::exception&) {
+    // Losing a profile is better than terminating during unwinding
+  }
+}
+
+void ScopedTransceiverRefresh::record(
+    I2cPhase phase,
+    folly::StringPiece bus,
+    std::chrono::nanoseconds duration) {
+  auto usecs = toUsecs(duration);
+  switch (phase) {
+    case I2cPhase::LOCK_WAIT:
+      *profile_.lockWaitUs_ref() += usecs;
+      break;
+    case I2cPhase::MUX_SELECT:
+      *profile_.muxSelectUs_ref() += usecs;
+      break;
+    case I2cPhase::TRANSFER:
+      *profile_.transferUs_ref() += usecs;
+      ++*profile_.transactions_ref();
+      break;
+  }
+  if (!bus.empty() && profile_.bus_ref()->empty()) {
+    *profile_.bus_ref() = bus.str();
+  }
+}
+
+void ScopedTransceiverRefresh::addPageRead(
+    folly::StringPiece page,
+    RefreshProfiler::Clock::duration duration) {
+  auto usecs = toUsecs(duration);
+  *profile_.readUs_ref() += usecs;
+  (*profile_.pageReadUs_ref())[page.str()] += usecs;
+}
+
+void ScopedTransceiverRefresh::addSettle(
+    RefreshProfiler::Clock::duration duration) {
+  *profile_.settleUs_ref() += toUsecs(duration);
+}
+
+void ScopedTransceiverRefresh::addDecode(
+    RefreshProfiler::Clock::duration duration) {
+  *profile_.decodeUs_ref() += toUsecs(duration);
+}
+
+}} // namespace facebook::fboss
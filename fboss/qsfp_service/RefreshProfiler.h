@@ -0,0 +1,170 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <gflags/gflags.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "fboss/lib/DurationHistograms.h"
+#include "fboss/lib/i2c/I2cPhaseRecorder.h"
+#include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+
+DECLARE_bool(enable_refresh_profiling);
+DECLARE_int32(refresh_profile_history);
+
+namespace facebook { namespace fboss {
+
+/*
+ * Process wide collector of transceiver refresh timings. Profiling is
+ * opt-in (--enable_refresh_profiling).
+ *
+ * A refresh cycle is opened by the manager before it fires the refreshes of
+ * a set of transceivers and closed after it published the results. The
+ * refreshes the manager fires for the cycle (see ScopedRefreshCycle) report
+ * where their time went (see ScopedTransceiverRefresh), from any of the I2C
+ * threads. Refreshes that run in the meantime for other reasons, e.g. the
+ * ones thrift calls trigger, aren't part of the cycle.
+ *
+ * All stages are fed into fb303 histograms named
+ * "qsfp.refresh.<stage>.us", with p50/p95/p99 exported, and the last
+ * --refresh_profile_history cycles are kept for getRefreshProfiles().
+ */
+class RefreshProfiler {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using CycleId = int64_t;
+
+  // No cycle, e.g. as profiling is off
+  static constexpr CycleId kNoCycle = 0;
+
+  static RefreshProfiler* get();
+
+  /* Refreshes are only profiled while their cycle is open */
+  bool cycleOpen(CycleId cycle) const {
+    return cycle != kNoCycle &&
+        openCycle_.load(std::memory_order_relaxed) == cycle;
+  }
+
+  /*
+   * trigger says why the transceivers are refreshed, e.g. "full". Returns
+   * the id the refreshes of the cycle run under, see ScopedRefreshCycle.
+   */
+  CycleId startCycle(folly::StringPiece trigger);
+  void finishCycle(Clock::duration publishTime);
+
+  /* Dropped if cycle isn't the open cycle anymore */
+  void recordTransceiver(CycleId cycle, TransceiverRefreshProfile profile);
+
+  /* Oldest first */
+  std::vector<RefreshCycleProfile> getCycles() const;
+
+ private:
+  struct OpenCycle {
+    RefreshCycleProfile profile;
+    Clock::time_point start;
+  };
+
+  RefreshProfiler() = default;
+
+  void recordStage(folly::StringPiece stage, int64_t usecs);
+
+  std::atomic<CycleId> openCycle_{kNoCycle};
+  std::atomic<CycleId> nextCycleId_{1};
+  folly::Synchronized<std::optional<OpenCycle>> current_;
+  folly::Synchronized<std::deque<RefreshCycleProfile>> history_;
+  DurationHistograms stageHistograms_;
+};
+
+/*
+ * Marks the transceiver refreshes run on this thread, while the object is
+ * alive, as part of cycle. Code that hands the refreshes to other threads
+ * passes current() along to them.
+ */
+class ScopedRefreshCycle {
+ public:
+  explicit ScopedRefreshCycle(RefreshProfiler::CycleId cycle)
+      : previous_(current_) {
+    current_ = cycle;
+  }
+  ~ScopedRefreshCycle() {
+    current_ = previous_;
+  }
+
+  /* The cycle the refreshes on this thread are part of, if any */
+  static RefreshProfiler::CycleId current() {
+    return current_;
+  }
+
+ private:
+  ScopedRefreshCycle(ScopedRefreshCycle const&) = delete;
+  ScopedRefreshCycle& operator=(ScopedRefreshCycle const&) = delete;
+
+  static inline thread_local RefreshProfiler::CycleId current_{
+      RefreshProfiler::kNoCycle};
+
+  RefreshProfiler::CycleId previous_;
+};
+
+/*
+ * Profiles the refresh of a single transceiver, from construction to
+ * destruction, and hands the result to the RefreshProfiler. The I2C phases
+ * come in through the I2cPhaseRecorder interface while the object is alive,
+ * the rest is reported by the transceiver code through current().
+ *
+ * This does nothing if profiling is off, or if the refresh isn't part of an
+ * open cycle.
+ */
+class ScopedTransceiverRefresh : public I2cPhaseRecorder {
+ public:
+  explicit ScopedTransceiverRefresh(int32_t transceiver);
+  ~ScopedTransceiverRefresh() override;
+
+  /* The profile of the refresh running on this thread, if any */
+  static ScopedTransceiverRefresh* current() {
+    return current_;
+  }
+
+  void record(
+      I2cPhase phase,
+      folly::StringPiece bus,
+      std::chrono::nanoseconds duration) override;
+
+  /* page is "lower", or "page" and the page number in hex */
+  void addPageRead(
+      folly::StringPiece page,
+      RefreshProfiler::Clock::duration duration);
+  void addSettle(RefreshProfiler::Clock::duration duration);
+  void addDecode(RefreshProfiler::Clock::duration duration);
+
+ private:
+  ScopedTransceiverRefresh(ScopedTransceiverRefresh const&) = delete;
+  ScopedTransceiverRefresh& operator=(ScopedTransceiverRefresh const&) =
+      delete;
+
+  static inline thread_local ScopedTransceiverRefresh* current_{nullptr};
+
+  RefreshProfiler::CycleId cycle_;
+  bool active_;
+  int uncaughtExceptions_;
+  RefreshProfiler::Clock::time_point start_;
+  TransceiverRefreshProfile profile_;
+  ScopedTransceiverRefresh* previous_{nullptr};
+  std::optional<ScopedI2cPhaseRecorder> phaseRecorder_;
+};
+
+}} // namespace facebook::fboss
@@ -47,6 +47,15 @@ class TransceiverManager {
    */
   virtual void publishI2cTransactionStats() = 0;
 
+  /* Platforms that can read the presence and interrupt state of all the
+   * transceivers at once refresh the transceivers that changed as soon as
+   * scanTransceiverEvents() sees them, and need full refreshes less often.
+   */
+  virtual bool supportsTransceiverEvents() const {
+    return false;
+  }
+  virtual void scanTransceiverEvents() {}
+
  private:
   // Forbidden copy constructor and assignment operator
   TransceiverManager(TransceiverManager const &) = delete;
@@ -37,4 +37,10 @@ service QsfpService extends fb303.FacebookService {
   map<i32, transceiver.TransceiverInfo> syncPorts(1: map<i32, ctrl.PortStatus> ports)
     throws (1: fboss.FbossBaseError error)
 
+  /*
+   * Timing of the last --refresh_profile_history transceiver refresh
+   * cycles, oldest first, to find the slow transceivers and buses.
+   */
+  list<transceiver.RefreshCycleProfile> getRefreshProfiles()
+
 }
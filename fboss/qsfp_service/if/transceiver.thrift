@@ -224,3 +224,40 @@ struct CmisData {
   8: optional IOBuf page13,
   9: optional IOBuf page14,
 }
+
+// Where the time of a transceiver refresh went, as measured by qsfp_service.
+// All times are in microseconds.
+struct TransceiverRefreshProfile {
+  1: i32 transceiver,
+  // Name of the I2C controller the transceiver is on, if the bus knows it
+  2: string bus,
+  3: i64 totalUs,
+  // Reading the pages, the sum of pageReadUs
+  4: i64 readUs,
+  // The I2C phases of all reads and writes of the refresh
+  5: i64 lockWaitUs,
+  6: i64 muxSelectUs,
+  7: i64 transferUs,
+  // Waiting for the module after writes, e.g. page changes
+  8: i64 settleUs,
+  // Decoding the cached pages into TransceiverInfo
+  9: i64 decodeUs,
+  // Read time of every page, keyed by "lower" or "page<hex number>"
+  10: map<string, i64> pageReadUs,
+  // Number of I2C transfers
+  11: i32 transactions,
+  12: bool failed,
+}
+
+// A refresh of a set of transceivers: all of them on the periodic refresh,
+// or those that raised an event
+struct RefreshCycleProfile {
+  1: i64 id,
+  2: string trigger,
+  // Milliseconds since the epoch
+  3: i64 startTime,
+  4: i64 totalUs,
+  // Publishing the refreshed info to its readers, e.g. shared memory
+  5: i64 publishUs,
+  6: list<TransceiverRefreshProfile> transceivers,
+}
@@ -14,6 +14,18 @@
 #include <folly/logging/xlog.h>
 #include <chrono>
 
+DEFINE_bool(
+    qsfp_cache_use_shm,
+    false,
+    "Read transceiver info from the shared memory qsfp_service publishes "
+    "to with --publish_transceiver_shm, falling back to thrift when it "
+    "isn't available");
+DEFINE_int32(
+    qsfp_shm_max_age,
+    30,
+    "Seconds after which transceiver info in shared memory that hasn't "
+    "been refreshed is not used anymore");
+
 namespace facebook { namespace fboss {
 
 namespace {
@@ -30,6 +42,10 @@ void QsfpCache::init(folly::EventBase* evb, const PortMapThrift& ports) {
     return;
   }
   evb_ = evb;
+  if (FLAGS_qsfp_cache_use_shm) {
+    shmReader_ = std::make_unique<TransceiverShmReader>(
+        FLAGS_qsfp_shm_name, std::chrono::seconds(FLAGS_qsfp_shm_max_age));
+  }
   initialized_.store(true, std::memory_order_release);
 
   portsChanged(ports);
@@ -189,6 +205,12 @@ std::optional<TransceiverInfo> QsfpCache::getIf(TransceiverID tcvrId) {
     throw std::runtime_error("Cache not yet initialized...");
   }
 
+  if (shmReader_) {
+    if (auto fromShm = shmReader_->get(static_cast<int32_t>(tcvrId))) {
+      return fromShm;
+    }
+  }
+
   auto lockedTcvrs = tcvrs_.rlock();
   auto it = lockedTcvrs->find(tcvrId);
   if (it != lockedTcvrs->end()) {
@@ -27,6 +27,7 @@
 #include "fboss/agent/types.h"
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+#include "fboss/qsfp_service/lib/TransceiverShm.h"
 
 /*
  * This class is a helper for clients that want to exchange port state w/ qsfp
@@ -62,6 +63,13 @@
  * and store the last aliveSince. If this changes, we reset remoteGen_
  * back to zero so we will re-sync all ports.
  *
+ * Shared memory
+ * -------------
+ * qsfp_service also publishes the info of all transceivers to shared
+ * memory (see TransceiverShm.h). When that is available the getters
+ * read from it, which is cheaper and fresher than the syncPorts
+ * responses, and only fall back to the thrift data when it isn't.
+ *
  * Threading model
  * ---------------
  * All thrift calls to qsfp_service are done on evb_. No guarantee for
@@ -139,6 +147,9 @@ class QsfpCache : private folly::AsyncTimeout {
   // gets a new unique generation number
   uint32_t incrementGen();
 
+  // reads transceiver info from shared memory, if enabled
+  std::unique_ptr<TransceiverShmReader> shmReader_;
+
   struct PortCacheValue {
     PortStatus port;
     uint32_t generation{0};
@@ -0,0 +1,342 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/qsfp_service/lib/TransceiverShm.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include <folly/Conv.h>
+#include <folly/Exception.h>
+#include <folly/File.h>
+#include <folly/logging/xlog.h>
+#include <folly/String.h>
+#include <folly/portability/Asm.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+DEFINE_string(
+    qsfp_shm_name,
+    "/fboss_qsfp_transceivers",
+    "Name of the shared memory region qsfp_service publishes transceiver "
+    "info to");
+
+namespace facebook {
+namespace fboss {
+
+namespace {
+// "QSFP"
+constexpr uint32_t kShmMagic = 0x51534650;
+// Bump whenever the layout below changes
+constexpr uint32_t kShmVersion = 1;
+// How often a reader retries to map a region that isn't there
+constexpr std::chrono::seconds kReopenInterval(10);
+// How often a reader retries a slot the writer keeps changing under it
+constexpr int kMaxReadRetries = 100;
+
+struct alignas(64) ShmHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t numSlots;
+  uint32_t slotSize;
+  // steady_clock is CLOCK_MONOTONIC, which is the same for all processes
+  std::atomic<int64_t> lastPublishNs;
+};
+
+struct alignas(64) ShmSlot {
+  std::atomic<uint32_t> seq;
+  std::atomic<uint32_t> len;
+  std::atomic<uint64_t> generation;
+  uint8_t data[TransceiverShmWriter::kMaxInfoSize];
+};
+
+// The atomics are shared between processes, so they must not need a lock
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<int64_t>::is_always_lock_free);
+
+size_t regionSize(uint32_t numSlots) {
+  return sizeof(ShmHeader) + sizeof(ShmSlot) * numSlots;
+}
+
+ShmHeader* getHeader(void* region) {
+  return static_cast<ShmHeader*>(region);
+}
+
+const ShmHeader* getHeader(const void* region) {
+  return static_cast<const ShmHeader*>(region);
+}
+
+ShmSlot* getSlot(void* region, uint32_t id) {
+  auto* base = static_cast<uint8_t*>(region) + sizeof(ShmHeader);
+  return reinterpret_cast<ShmSlot*>(base + sizeof(ShmSlot) * id);
+}
+
+const ShmSlot* getSlot(const void* region, uint32_t id) {
+  auto* base = static_cast<const uint8_t*>(region) + sizeof(ShmHeader);
+  return reinterpret_cast<const ShmSlot*>(base + sizeof(ShmSlot) * id);
+}
+
+int64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+} // namespace
+
+TransceiverShmWriter::TransceiverShmWriter(
+    const std::string& name,
+    uint32_t numSlots)
+    : name_(name),
+      numSlots_(numSlots),
+      size_(regionSize(numSlots)),
+      published_(numSlots) {
+  int fd = ::shm_open(name_.c_str(), O_CREAT | O_RDWR, 0644);
+  if (fd < 0) {
+    folly::throwSystemError("Cannot open shared memory ", name_);
+  }
+  folly::File file(fd, true /* ownsFd */);
+
+  struct stat st;
+  if (::fstat(file.fd(), &st) < 0) {
+    folly::throwSystemError("Cannot stat shared memory ", name_);
+  }
+  if (st.st_size != 0 && static_cast<size_t>(st.st_size) != size_) {
+    // Left behind by a qsfp_service with a different layout. Readers may
+    // still have it mapped, so don't resize it under them but start over
+    // with a new one. They move over once the old one goes stale.
+    XLOG(INFO) << "Replacing shared memory " << name_ << " of size "
+               << st.st_size << " with one of size " << size_;
+    ::shm_unlink(name_.c_str());
+    fd = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+      folly::throwSystemError("Cannot create shared memory ", name_);
+    }
+    file = folly::File(fd, true /* ownsFd */);
+  }
+  if (::ftruncate(file.fd(), size_) < 0) {
+    folly::throwSystemError("Cannot size shared memory ", name_);
+  }
+
+  region_ =
+      ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, file.fd(), 0);
+  if (region_ == MAP_FAILED) {
+    region_ = nullptr;
+    folly::throwSystemError("Cannot mmap shared memory ", name_);
+  }
+
+  // The slots may still have data from before a restart. Clear them through
+  // the seqlock, keeping the generations going, so readers that cached the
+  // old data notice.
+  for (uint32_t id = 0; id < numSlots_; ++id) {
+    writeSlot(id, "");
+  }
+  auto* header = getHeader(region_);
+  header->numSlots = numSlots_;
+  header->slotSize = sizeof(ShmSlot);
+  header->version = kShmVersion;
+  header->lastPublishNs.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  header->magic = kShmMagic;
+  XLOG(INFO) << "Publishing " << numSlots_ << " transceivers to shared memory "
+             << name_;
+}
+
+TransceiverShmWriter::~TransceiverShmWriter() {
+  // Leave the region behind, readers notice it going stale. Unlinking it
+  // would only make them look up a new region every time.
+  if (region_) {
+    ::munmap(region_, size_);
+  }
+}
+
+void TransceiverShmWriter::publish(int32_t id, const TransceiverInfo& info) {
+  if (id < 0 || static_cast<uint32_t>(id) >= numSlots_) {
+    throw std::runtime_error(folly::to<std::string>(
+        "Transceiver ", id, " doesn't fit in shared memory ", name_));
+  }
+
+  std::string data;
+  apache::thrift::CompactSerializer::serialize(info, &data);
+  if (data.size() > kMaxInfoSize) {
+    XLOG(ERR) << "Transceiver " << id << " info of " << data.size()
+              << " bytes doesn't fit in shared memory, readers will use "
+              << "thrift for it";
+    data.clear();
+  }
+
+  std::lock_guard<std::mutex> g(mutex_);
+  if (published_[id] == data) {
+    return;
+  }
+  writeSlot(id, data);
+  published_[id] = std::move(data);
+}
+
+void TransceiverShmWriter::heartbeat() {
+  getHeader(region_)->lastPublishNs.store(
+      nowNs(), std::memory_order_release);
+}
+
+void TransceiverShmWriter::writeSlot(uint32_t id, const std::string& data) {
+  auto* slot = getSlot(region_, id);
+  auto seq = slot->seq.load(std::memory_order_relaxed);
+  // An odd sequence number tells readers the slot is being changed
+  slot->seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot->len.store(data.size(), std::memory_order_relaxed);
+  slot->generation.store(
+      slot->generation.load(std::memory_order_relaxed) + 1,
+      std::memory_order_relaxed);
+  std::memcpy(slot->data, data.data(), data.size());
+
+  slot->seq.store(seq + 2, std::memory_order_release);
+}
+
+TransceiverShmReader::TransceiverShmReader(
+    const std::string& name,
+    std::chrono::seconds maxAge)
+    : name_(name), maxAge_(maxAge) {}
+
+TransceiverShmReader::~TransceiverShmReader() {
+  std::lock_guard<std::mutex> g(mutex_);
+  unmapLocked();
+}
+
+bool TransceiverShmReader::isAvailable() {
+  std::lock_guard<std::mutex> g(mutex_);
+  return ensureMappedLocked();
+}
+
+std::optional<TransceiverInfo> TransceiverShmReader::get(int32_t id) {
+  std::lock_guard<std::mutex> g(mutex_);
+  if (!ensureMappedLocked() || id < 0 ||
+      static_cast<uint32_t>(id) >= numSlots_) {
+    return std::nullopt;
+  }
+
+  const auto* slot = getSlot(region_, id);
+  auto& cached = cache_[id];
+  std::string data;
+  for (int retry = 0; retry < kMaxReadRetries; ++retry) {
+    auto seq = slot->seq.load(std::memory_order_acquire);
+    if (seq & 1) {
+      folly::asm_volatile_pause();
+      continue;
+    }
+    auto generation = slot->generation.load(std::memory_order_relaxed);
+    auto len = std::min<size_t>(
+        slot->len.load(std::memory_order_relaxed),
+        TransceiverShmWriter::kMaxInfoSize);
+    if (generation != cached.generation) {
+      // This copy may race with the writer, in which case the sequence
+      // number tells us to throw it away
+      data.assign(reinterpret_cast<const char*>(slot->data), len);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->seq.load(std::memory_order_relaxed) != seq) {
+      continue;
+    }
+
+    if (generation != cached.generation) {
+      cached.generation = generation;
+      cached.info.reset();
+      if (!data.empty()) {
+        try {
+          cached.info = apache::thrift::CompactSerializer::deserialize<
+              TransceiverInfo>(data);
+        } catch (const std::exception& ex) {
+          XLOG(ERR) << "Cannot deserialize transceiver " << id
+                    << " from shared memory: " << ex.what();
+        }
+      }
+    }
+    return cached.info;
+  }
+  XLOG(DBG2) << "Transceiver " << id << " kept changing in shared memory";
+  return std::nullopt;
+}
+
+bool TransceiverShmReader::ensureMappedLocked() {
+  if (region_) {
+    auto age = std::chrono::nanoseconds(
+        nowNs() -
+        getHeader(region_)->lastPublishNs.load(std::memory_order_acquire));
+    if (age <= maxAge_) {
+      return true;
+    }
+    XLOG(DBG2) << "Shared memory " << name_ << " went stale";
+    unmapLocked();
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  if (lastOpenAttempt_.time_since_epoch().count() != 0 &&
+      now - lastOpenAttempt_ < kReopenInterval) {
+    return false;
+  }
+  lastOpenAttempt_ = now;
+
+  int fd = ::shm_open(name_.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    XLOG(DBG2) << "Shared memory " << name_ << " not there yet";
+    return false;
+  }
+  folly::File file(fd, true /* ownsFd */);
+  struct stat st;
+  if (::fstat(file.fd(), &st) < 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(ShmHeader)) {
+    return false;
+  }
+  size_t size = st.st_size;
+  auto* region = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, file.fd(), 0);
+  if (region == MAP_FAILED) {
+    XLOG(ERR) << "Cannot mmap shared memory " << name_ << ": "
+              << folly::errnoStr(errno);
+    return false;
+  }
+
+  const auto* header = getHeader(static_cast<const void*>(region));
+  bool valid = header->magic == kShmMagic;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  valid = valid && header->version == kShmVersion &&
+      header->slotSize == sizeof(ShmSlot) &&
+      regionSize(header->numSlots) <= size;
+  if (!valid) {
+    XLOG(DBG2) << "Shared memory " << name_ << " has an unknown layout";
+    ::munmap(region, size);
+    return false;
+  }
+
+  region_ = region;
+  size_ = size;
+  numSlots_ = header->numSlots;
+  cache_.assign(numSlots_, CachedInfo());
+  XLOG(INFO) << "Reading " << numSlots_ << " transceivers from shared memory "
+             << name_;
+  // Only use it if it's fresh
+  return ensureMappedLocked();
+}
+
+void TransceiverShmReader::unmapLocked() {
+  if (region_) {
+    ::munmap(const_cast<void*>(region_), size_);
+    region_ = nullptr;
+    size_ = 0;
+    numSlots_ = 0;
+    cache_.clear();
+  }
+}
+
+} // namespace fboss
+} // namespace facebook
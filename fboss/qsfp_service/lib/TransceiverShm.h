@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+
+DECLARE_string(qsfp_shm_name);
+
+/*
+ * qsfp_service publishes the TransceiverInfo of every transceiver into a
+ * POSIX shared memory region, so that clients on the box (wedge_agent
+ * through QsfpCache) can read it without a thrift call.
+ *
+ * Layout
+ * ------
+ * The region is a header followed by one fixed size slot per transceiver.
+ * A slot holds the TransceiverInfo in compact serialization and a
+ * generation number that changes every time the info does, so a reader only
+ * has to deserialize a transceiver when it actually changed.
+ *
+ * Consistency
+ * -----------
+ * Every slot is protected by a seqlock: the writer makes the sequence
+ * number odd while it updates the slot and even again once it is done.
+ * Readers copy the slot out and retry if the sequence number was odd or
+ * changed under them. Readers never block the writer, and there is only one
+ * writer, qsfp_service.
+ *
+ * Liveness
+ * --------
+ * The header has the time of the last publish. Readers treat a region that
+ * hasn't been published to for a while as gone (e.g. qsfp_service died or
+ * was restarted with a new layout), and callers fall back to thrift.
+ */
+
+namespace facebook {
+namespace fboss {
+
+class TransceiverShmWriter {
+ public:
+  // Largest serialized TransceiverInfo a slot can hold
+  static constexpr size_t kMaxInfoSize = 8192;
+
+  TransceiverShmWriter(const std::string& name, uint32_t numSlots);
+  ~TransceiverShmWriter();
+
+  /*
+   * Publishes the info of a transceiver, bumping its generation if it
+   * changed. Throws if the id doesn't fit in the region.
+   */
+  void publish(int32_t id, const TransceiverInfo& info);
+
+  /* Marks the data as fresh, to be called once all of it is published */
+  void heartbeat();
+
+  uint32_t getNumSlots() const {
+    return numSlots_;
+  }
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  TransceiverShmWriter(TransceiverShmWriter const&) = delete;
+  TransceiverShmWriter& operator=(TransceiverShmWriter const&) = delete;
+
+  void writeSlot(uint32_t id, const std::string& data);
+
+  std::string name_;
+  uint32_t numSlots_;
+  size_t size_;
+  void* region_{nullptr};
+  // What's in every slot, to only touch the slots that change
+  std::vector<std::string> published_;
+  std::mutex mutex_;
+};
+
+class TransceiverShmReader {
+ public:
+  TransceiverShmReader(const std::string& name, std::chrono::seconds maxAge);
+  ~TransceiverShmReader();
+
+  /*
+   * Returns the info of a transceiver, or an empty optional if the region or
+   * the transceiver isn't available, in which case callers should fall back
+   * to thrift. Safe to call from any thread.
+   */
+  std::optional<TransceiverInfo> get(int32_t id);
+
+  /* Whether the region is mapped and fresh, mostly useful for logging */
+  bool isAvailable();
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  TransceiverShmReader(TransceiverShmReader const&) = delete;
+  TransceiverShmReader& operator=(TransceiverShmReader const&) = delete;
+
+  struct CachedInfo {
+    uint64_t generation{0};
+    std::optional<TransceiverInfo> info;
+  };
+
+  bool ensureMappedLocked();
+  void unmapLocked();
+
+  std::string name_;
+  std::chrono::seconds maxAge_;
+  const void* region_{nullptr};
+  size_t size_{0};
+  uint32_t numSlots_{0};
+  std::chrono::steady_clock::time_point lastOpenAttempt_;
+  std::vector<CachedInfo> cache_;
+  std::mutex mutex_;
+};
+
+} // namespace fboss
+} // namespace facebook
@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/qsfp_service/lib/TransceiverShm.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <folly/Conv.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr uint32_t kNumSlots = 4;
+constexpr std::chrono::seconds kMaxAge(60);
+
+class TransceiverShmTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    name_ = folly::to<std::string>("/fboss_qsfp_shm_test_", ::getpid());
+  }
+
+  void TearDown() override {
+    ::shm_unlink(name_.c_str());
+  }
+
+  TransceiverInfo makeInfo(int32_t port, const std::string& vendor) {
+    TransceiverInfo info;
+    *info.present_ref() = true;
+    *info.port_ref() = port;
+    Vendor vendorInfo;
+    *vendorInfo.name_ref() = vendor;
+    info.vendor_ref() = vendorInfo;
+    return info;
+  }
+
+  std::string name_;
+};
+
+} // namespace
+
+TEST_F(TransceiverShmTest, NotPublished) {
+  TransceiverShmReader reader(name_, kMaxAge);
+  EXPECT_FALSE(reader.isAvailable());
+  EXPECT_FALSE(reader.get(0).has_value());
+}
+
+TEST_F(TransceiverShmTest, PublishAndRead) {
+  TransceiverShmWriter writer(name_, kNumSlots);
+  writer.publish(1, makeInfo(1, "FINISAR"));
+  writer.heartbeat();
+
+  TransceiverShmReader reader(name_, kMaxAge);
+  ASSERT_TRUE(reader.isAvailable());
+  auto info = reader.get(1);
+  ASSERT_TRUE(info.has_value());
+  EXPECT_EQ(makeInfo(1, "FINISAR"), *info);
+  // Nothing published for the others, or out of range
+  EXPECT_FALSE(reader.get(0).has_value());
+  EXPECT_FALSE(reader.get(kNumSlots).has_value());
+
+  writer.publish(1, makeInfo(1, "INTEL"));
+  writer.heartbeat();
+  EXPECT_EQ(makeInfo(1, "INTEL"), *reader.get(1));
+
+  EXPECT_THROW(writer.publish(kNumSlots, makeInfo(0, "")), std::exception);
+}
+
+TEST_F(TransceiverShmTest, WriterRestart) {
+  TransceiverShmReader reader(name_, kMaxAge);
+  {
+    TransceiverShmWriter writer(name_, kNumSlots);
+    writer.publish(2, makeInfo(2, "FINISAR"));
+    writer.heartbeat();
+    ASSERT_TRUE(reader.get(2).has_value());
+  }
+
+  // A new writer starts over, and readers don't keep the old data
+  TransceiverShmWriter writer(name_, kNumSlots);
+  writer.heartbeat();
+  EXPECT_FALSE(reader.get(2).has_value());
+}
+
+TEST_F(TransceiverShmTest, Stale) {
+  TransceiverShmWriter writer(name_, kNumSlots);
+  writer.publish(0, makeInfo(0, "FINISAR"));
+
+  // Never marked fresh
+  TransceiverShmReader reader(name_, kMaxAge);
+  EXPECT_FALSE(reader.get(0).has_value());
+}
@@ -0,0 +1,103 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+
+/*
+ * Building blocks for the compiled page layouts of the transceiver specs
+ * (see SffPageDecoder and CmisPageDecoder).
+ *
+ * The field maps in SffFieldInfo/CmisFieldInfo are still what the modules
+ * use to read and write single fields, but decoding the DOM data on every
+ * refresh through them costs a map lookup and a bounds check per field.
+ * The layouts instead describe the fields as constexpr offsets into the
+ * cached 128 byte pages, checked once at compile time, so that decoding is
+ * a straight walk over the pages.
+ */
+
+namespace facebook {
+namespace fboss {
+
+struct PageField {
+  static constexpr int kPageSize = 128;
+
+  int page;
+  // Offset into the cached page, i.e. upper page offsets are less 128
+  int offset;
+  int length;
+
+  /* Field of the lower page, at the offset given in the spec */
+  static constexpr PageField lower(int page, int offset, int length) {
+    return PageField{page, offset, length};
+  }
+
+  /* Field of an upper page, at the offset given in the spec */
+  static constexpr PageField upper(int page, int offset, int length) {
+    return PageField{page, offset - kPageSize, length};
+  }
+
+  constexpr bool fits() const {
+    return offset >= 0 && length > 0 && offset + length <= kPageSize;
+  }
+
+  constexpr bool fits(int elementSize, int count) const {
+    return fits() && elementSize * count <= length;
+  }
+};
+
+namespace page_layout {
+
+inline uint16_t readU16(const uint8_t* page, const PageField& field, int i) {
+  const uint8_t* data = page + field.offset + 2 * i;
+  return data[0] << 8 | data[1];
+}
+
+/*
+ * The four alarm and warning flags of a sensor are consecutive bits,
+ * starting at bit 'offset' with warning low
+ */
+inline FlagLevels decodeFlags(uint8_t data, int offset) {
+  FlagLevels flags;
+  *flags.warn_ref()->low_ref() = data & (1 << offset);
+  *flags.warn_ref()->high_ref() = data & (1 << (offset + 1));
+  *flags.alarm_ref()->low_ref() = data & (1 << (offset + 2));
+  *flags.alarm_ref()->high_ref() = data & (1 << (offset + 3));
+  return flags;
+}
+
+/*
+ * Thresholds are stored as four two-byte values: alarm high, alarm low,
+ * warning high and warning low
+ */
+inline ThresholdLevels decodeThresholdLevels(
+    const uint8_t* page,
+    const PageField& field,
+    double (*conversion)(uint16_t value)) {
+  ThresholdLevels thresh;
+  *thresh.alarm_ref()->high_ref() = conversion(readU16(page, field, 0));
+  *thresh.alarm_ref()->low_ref() = conversion(readU16(page, field, 1));
+  *thresh.warn_ref()->high_ref() = conversion(readU16(page, field, 2));
+  *thresh.warn_ref()->low_ref() = conversion(readU16(page, field, 3));
+  return thresh;
+}
+
+/*
+ * Strings are padded with spaces. This doesn't validate them, that is up to
+ * the module (see QsfpModule::validateVendorInfo).
+ */
+inline std::string decodeString(const uint8_t* page, const PageField& field) {
+  const uint8_t* data = page + field.offset;
+  int length = field.length;
+  while (length > 0 && data[length - 1] == ' ') {
+    --length;
+  }
+  return std::string(reinterpret_cast<const char*>(data), length);
+}
+
+} // namespace page_layout
+} // namespace fboss
+} // namespace facebook
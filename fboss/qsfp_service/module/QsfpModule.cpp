@@ -14,9 +14,11 @@
 #include <iomanip>
 #include "fboss/agent/FbossError.h"
 #include "fboss/qsfp_service/module/TransceiverImpl.h"
+#include "fboss/qsfp_service/RefreshProfiler.h"
 #include "fboss/qsfp_service/StatsPublisher.h"
 #include "fboss/lib/usb/TransceiverI2CApi.h"
 
+#include <folly/ScopeGuard.h>
 #include <folly/io/IOBuf.h>
 #include <folly/io/async/EventBase.h>
 #include <folly/logging/xlog.h>
@@ -45,25 +47,18 @@ TransceiverID QsfpModule::getID() const {
   return TransceiverID(qsfpImpl_->getNum());
 }
 
-/*
- * Given a byte, extract bit fields for various alarm flags;
- * note the we might want to use the lower or the upper nibble,
- * so offset is the number of the bit to start at;  this is usually
- * 0 or 4.
- */
-
-FlagLevels QsfpModule::getQsfpFlags(const uint8_t *data,
-                                    int offset) {
-  FlagLevels flags;
-
-  CHECK_GE(offset, 0);
-  CHECK_LE(offset, 4);
-  *flags.warn_ref()->low_ref() = (*data & (1 << offset));
-  *flags.warn_ref()->high_ref() = (*data & (1 << ++offset));
-  *flags.alarm_ref()->low_ref() = (*data & (1 << ++offset));
-  *flags.alarm_ref()->high_ref() = (*data & (1 << ++offset));
-
-  return flags;
+void QsfpModule::validateVendorInfo(Vendor& vendor) const {
+  for (auto* value :
+       {&*vendor.name_ref(),
+        &*vendor.oui_ref(),
+        &*vendor.partNumber_ref(),
+        &*vendor.rev_ref(),
+        &*vendor.serialNumber_ref(),
+        &*vendor.dateCode_ref()}) {
+    if (!validateQsfpString(*value)) {
+      *value = "UNKNOWN";
+    }
+  }
 }
 
 QsfpModule::QsfpModule(
@@ -113,6 +108,9 @@ bool QsfpModule::detectPresenceLocked() {
                << " QSFP status changed to " << currentQsfpStatus;
     dirty_ = true;
     present_ = currentQsfpStatus;
+    // Whatever module is there now, write to it the way that is safe for
+    // any module until we have read its vendor info
+    qsfpImpl_->setVendorInfo(Vendor());
 
     // If a transceiver went from present to missing, clear the cached data.
     if (!present_) {
@@ -274,14 +272,22 @@ folly::Future<folly::Unit> QsfpModule::futureRefresh() {
     return folly::makeFuture();
   }
 
-  return via(i2cEvb).thenValue([&](auto&&) mutable {
-    try {
-      this->refresh();
-    } catch (const std::exception& ex) {
-      XLOG(DBG2) << "Transceiver " << static_cast<int>(this->getID())
-                 << ": Error calling refresh(): " << ex.what();
-    }
-  });
+  // The refresh is part of the refresh cycle it is fired for, if any
+  return via(i2cEvb).thenValue(
+      [this, cycle = ScopedRefreshCycle::current()](auto&&) mutable {
+        ScopedRefreshCycle participate(cycle);
+        try {
+          this->refresh();
+        } catch (const std::exception& ex) {
+          XLOG(DBG2) << "Transceiver " << static_cast<int>(this->getID())
+                     << ": Error calling refresh(): " << ex.what();
+        }
+      });
+}
+
+void QsfpModule::markDataStale() {
+  lock_guard<std::mutex> g(qsfpModuleMutex_);
+  lastRefreshTime_ = 0;
 }
 
 void QsfpModule::refreshLocked() {
@@ -293,14 +299,21 @@ void QsfpModule::refreshLocked() {
     return;
   }
 
+  ScopedTransceiverRefresh profile(static_cast<int32_t>(getID()));
+
   if (dirty_) {
     // make sure data is up to date before trying to customize.
     ensureOutOfReset();
     updateQsfpData(true);
+    // The module may have been swapped for another one, customize it the
+    // way the module that is there now wants to be written to
+    if (present_) {
+      qsfpImpl_->setVendorInfo(getVendorInfo());
+    }
   }
 
   if (customizeWanted) {
-    customizeTransceiverLocked(getPortSpeed());
+    customizeTransceiverBatchedLocked(getPortSpeed());
 
     if (shouldRemediate(FLAGS_remediate_interval)) {
       remediateFlakyTransceiver();
@@ -317,8 +330,14 @@ void QsfpModule::refreshLocked() {
     updateQsfpData(false);
   }
 
+  auto decodeStart = RefreshProfiler::Clock::now();
+  auto info = parseDataLocked();
+  profile.addDecode(RefreshProfiler::Clock::now() - decodeStart);
+  if (auto vendor = info.vendor_ref()) {
+    qsfpImpl_->setVendorInfo(*vendor);
+  }
   // assign
-  *info_.wlock() = parseDataLocked();
+  *info_.wlock() = std::move(info);
 }
 
 bool QsfpModule::shouldRemediate(time_t cooldown) const {
@@ -329,10 +348,31 @@ bool QsfpModule::shouldRemediate(time_t cooldown) const {
 void QsfpModule::customizeTransceiver(cfg::PortSpeed speed) {
   lock_guard<std::mutex> g(qsfpModuleMutex_);
   if (present_) {
-    customizeTransceiverLocked(speed);
+    customizeTransceiverBatchedLocked(speed);
   }
 }
 
+void QsfpModule::customizeTransceiverBatchedLocked(cfg::PortSpeed speed) {
+  /*
+   * This must be called with a lock held on qsfpModuleMutex_
+   *
+   * Customization is a series of small writes to the module. Batch them so
+   * the module only needs to settle once after all of them.
+   */
+  qsfpImpl_->beginWriteBatch();
+  SCOPE_FAIL {
+    // Still send out the writes queued before the failure
+    try {
+      qsfpImpl_->commitWriteBatch();
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "Transceiver " << static_cast<int>(this->getID())
+                << ": Error committing customization writes: " << ex.what();
+    }
+  };
+  customizeTransceiverLocked(speed);
+  qsfpImpl_->commitWriteBatch();
+}
+
 void QsfpModule::customizeTransceiverLocked(cfg::PortSpeed speed) {
   /*
    * This must be called with a lock held on qsfpModuleMutex_
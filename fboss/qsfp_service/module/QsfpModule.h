@@ -78,6 +78,7 @@ class QsfpModule : public Transceiver {
 
   virtual void refresh() override;
   folly::Future<folly::Unit> futureRefresh() override;
+  void markDataStale() override;
   void refreshLocked();
 
   /*
@@ -163,6 +164,12 @@ class QsfpModule : public Transceiver {
    */
   virtual void customizeTransceiverLocked(
       cfg::PortSpeed speed = cfg::PortSpeed::DEFAULT) = 0;
+  /*
+   * Wraps customizeTransceiverLocked() in a write batch of the
+   * TransceiverImpl. This must be called with a lock held on
+   * qsfpModuleMutex_
+   */
+  void customizeTransceiverBatchedLocked(cfg::PortSpeed speed);
 
   /*
    * This function returns a pointer to the value in the static cached
@@ -209,12 +216,12 @@ class QsfpModule : public Transceiver {
    * returns the freeside transceiver technology type
    */
   virtual TransmitterTechnology getQsfpTransmitterTechnology() const = 0;
+  bool validateQsfpString(const std::string& value) const;
   /*
-   * Parse out flag values from bitfields
+   * Replaces the vendor strings that don't pass validateQsfpString with
+   * "UNKNOWN"
    */
-  static FlagLevels getQsfpFlags(const uint8_t* data, int offset);
-
-  bool validateQsfpString(const std::string& value) const;
+  void validateVendorInfo(Vendor& vendor) const;
 
   /*
    * Retreives all alarm and warning thresholds
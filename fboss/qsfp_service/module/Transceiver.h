@@ -47,6 +47,12 @@ class Transceiver {
   virtual void refresh() = 0;
   virtual folly::Future<folly::Unit> futureRefresh() = 0;
 
+  /*
+   * Make the next refresh re-read the data that changes frequently, e.g.
+   * because the transceiver raised an interrupt for one of its flags.
+   */
+  virtual void markDataStale() = 0;
+
   /*
    * Return all of the transceiver information
    */
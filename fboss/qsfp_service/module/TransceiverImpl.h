@@ -73,6 +73,21 @@ class TransceiverImpl {
     return nullptr;
   }
 
+  /*
+   * Writes made between beginWriteBatch() and commitWriteBatch() may be
+   * deferred, so that consecutive writes go to the module as one
+   * transaction and it only has to settle once. Reads flush the writes
+   * queued before them. Implementations without batching write through.
+   */
+  virtual void beginWriteBatch() {}
+  virtual void commitWriteBatch() {}
+
+  /*
+   * Tells the implementation which module it talks to, once the vendor
+   * info has been read, so it can tune its writes to the module.
+   */
+  virtual void setVendorInfo(const Vendor& /*vendor*/) {}
+
  private:
   // Forbidden copy contructor and assignment operator
   TransceiverImpl(TransceiverImpl const &) = delete;
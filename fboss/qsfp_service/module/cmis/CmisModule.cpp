@@ -11,6 +11,7 @@
 #include "fboss/qsfp_service/StatsPublisher.h"
 #include "fboss/qsfp_service/module/TransceiverImpl.h"
 #include "fboss/qsfp_service/module/cmis/CmisFieldInfo.h"
+#include "fboss/qsfp_service/module/cmis/CmisPageDecoder.h"
 
 #include <folly/io/IOBuf.h>
 #include <folly/io/async/EventBase.h>
@@ -217,16 +218,6 @@ CmisModule::CmisModule(
 
 CmisModule::~CmisModule() {}
 
-FlagLevels CmisModule::getQsfpSensorFlags(CmisField fieldName, int offset) {
-  int dataOffset;
-  int dataLength;
-  int dataAddress;
-
-  getQsfpFieldAddress(fieldName, dataAddress, dataOffset, dataLength);
-  const uint8_t* data = getQsfpValuePtr(dataAddress, dataOffset, dataLength);
-  return getQsfpFlags(data, offset);
-}
-
 double CmisModule::getQsfpDACLength() const {
   uint8_t value;
   getFieldValueLocked(CmisField::LENGTH_COPPER, &value);
@@ -252,25 +243,12 @@ double CmisModule::getQsfpOMLength(CmisField field) const {
 }
 
 GlobalSensors CmisModule::getSensorInfo() {
-  GlobalSensors info = GlobalSensors();
-  info.temp.value =
-      getQsfpSensor(CmisField::TEMPERATURE, CmisFieldInfo::getTemp);
-  info.temp.flags_ref() =
-      getQsfpSensorFlags(CmisField::MODULE_ALARMS, 0);
-  info.vcc.value = getQsfpSensor(CmisField::VCC, CmisFieldInfo::getVcc);
-  info.vcc.flags_ref() =
-      getQsfpSensorFlags(CmisField::MODULE_ALARMS, 4);
-  return info;
+  return CmisPageDecoder::decodeSensors(getCachedPages());
 }
 
 Vendor CmisModule::getVendorInfo() {
-  Vendor vendor = Vendor();
-  vendor.name = getQsfpString(CmisField::VENDOR_NAME);
-  vendor.oui = getQsfpString(CmisField::VENDOR_OUI);
-  vendor.partNumber = getQsfpString(CmisField::PART_NUMBER);
-  vendor.rev = getQsfpString(CmisField::REVISION_NUMBER);
-  vendor.serialNumber = getQsfpString(CmisField::VENDOR_SERIAL_NUMBER);
-  vendor.dateCode = getQsfpString(CmisField::MFG_DATE);
+  Vendor vendor = CmisPageDecoder::decodeVendor(getCachedPages());
+  validateVendorInfo(vendor);
   return vendor;
 }
 
@@ -299,48 +277,8 @@ Cable CmisModule::getCableInfo() {
   return cable;
 }
 
-/*
- * Threhold values are stored just once;  they aren't per-channel,
- * so in all cases we simple assemble two-byte values and convert
- * them based on the type of the field.
- */
-ThresholdLevels CmisModule::getThresholdValues(
-    CmisField field,
-    double (*conversion)(uint16_t value)) {
-  int offset;
-  int length;
-  int dataAddress;
-
-  CHECK(!flatMem_);
-
-  ThresholdLevels thresh;
-
-  getQsfpFieldAddress(field, dataAddress, offset, length);
-  const uint8_t* data = getQsfpValuePtr(dataAddress, offset, length);
-
-  CHECK_GE(length, 8);
-  thresh.alarm.high = conversion(data[0] << 8 | data[1]);
-  thresh.alarm.low = conversion(data[2] << 8 | data[3]);
-  thresh.warn.high = conversion(data[4] << 8 | data[5]);
-  thresh.warn.low = conversion(data[6] << 8 | data[7]);
-
-  return thresh;
-}
-
 std::optional<AlarmThreshold> CmisModule::getThresholdInfo() {
-  if (flatMem_) {
-    return {};
-  }
-  AlarmThreshold threshold = AlarmThreshold();
-  threshold.temp =
-      getThresholdValues(CmisField::TEMPERATURE_THRESH, CmisFieldInfo::getTemp);
-  threshold.vcc =
-      getThresholdValues(CmisField::VCC_THRESH, CmisFieldInfo::getVcc);
-  threshold.rxPwr =
-      getThresholdValues(CmisField::RX_PWR_THRESH, CmisFieldInfo::getPwr);
-  threshold.txBias =
-      getThresholdValues(CmisField::TX_BIAS_THRESH, CmisFieldInfo::getTxBias);
-  return threshold;
+  return CmisPageDecoder::decodeThresholds(getCachedPages());
 }
 
 uint8_t CmisModule::getSettingsValue(CmisField field, uint8_t mask) {
@@ -407,115 +345,11 @@ PowerControlState CmisModule::getPowerControlValue() {
   }
 }
 
-/*
- * For the specified field, collect alarm and warning flags for the channel.
- */
-
-FlagLevels CmisModule::getChannelFlags(CmisField field, int channel) {
-  FlagLevels flags;
-  int offset;
-  int length;
-  int dataAddress;
-
-  CHECK_GE(channel, 0);
-  CHECK_LE(channel, 8);
-
-  getQsfpFieldAddress(field, dataAddress, offset, length);
-  const uint8_t* data = getQsfpValuePtr(dataAddress, offset, length);
-
-  flags.warn.low = (data[3] & (1 << channel));
-  flags.warn.high = (data[2] & (1 << channel));
-  flags.alarm.low = (data[1] & (1 << channel));
-  flags.alarm.high = (data[0] & (1 << channel));
-
-  return flags;
-}
-
-/*
- * Iterate through channels collecting appropriate data;
- */
-
 bool CmisModule::getSensorsPerChanInfo(std::vector<Channel>& channels) {
-  const uint8_t* data;
-  int offset;
-  int length;
-  int dataAddress;
-
-  for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
-    channels[channel].sensors.rxPwr.flags_ref() =
-        getChannelFlags(CmisField::RX_PWR_FLAG, channel);
-  }
-
-  for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
-    channels[channel].sensors.txBias.flags_ref() =
-        getChannelFlags(CmisField::TX_BIAS_FLAG, channel);
-  }
-
-  for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
-    channels[channel].sensors.txPwr.flags_ref() =
-        getChannelFlags(CmisField::TX_PWR_FLAG, channel);
-  }
-
-  getQsfpFieldAddress(CmisField::CHANNEL_RX_PWR, dataAddress, offset, length);
-  data = getQsfpValuePtr(dataAddress, offset, length);
-
-  for (auto& channel : channels) {
-    uint16_t value = data[0] << 8 | data[1];
-    channel.sensors.rxPwr.value = CmisFieldInfo::getPwr(value);
-    data += 2;
-    length--;
-  }
-  CHECK_GE(length, 0);
-
-  getQsfpFieldAddress(CmisField::CHANNEL_TX_BIAS, dataAddress, offset, length);
-  data = getQsfpValuePtr(dataAddress, offset, length);
-  for (auto& channel : channels) {
-    uint16_t value = data[0] << 8 | data[1];
-    channel.sensors.txBias.value = CmisFieldInfo::getTxBias(value);
-    data += 2;
-    length--;
-  }
-  CHECK_GE(length, 0);
-
-  getQsfpFieldAddress(CmisField::CHANNEL_TX_PWR, dataAddress, offset, length);
-  data = getQsfpValuePtr(dataAddress, offset, length);
-
-  for (auto& channel : channels) {
-    uint16_t value = data[0] << 8 | data[1];
-    channel.sensors.txPwr.value = CmisFieldInfo::getPwr(value);
-    data += 2;
-    length--;
-  }
-  CHECK_GE(length, 0);
-
+  CmisPageDecoder::decodeChannels(getCachedPages(), channels);
   return true;
 }
 
-std::string CmisModule::getQsfpString(CmisField field) const {
-  int offset;
-  int length;
-  int dataAddress;
-
-  getQsfpFieldAddress(field, dataAddress, offset, length);
-  const uint8_t* data = getQsfpValuePtr(dataAddress, offset, length);
-
-  while (length > 0 && data[length - 1] == ' ') {
-    --length;
-  }
-
-  std::string value(reinterpret_cast<const char*>(data), length);
-  return validateQsfpString(value) ? value : "UNKNOWN";
-}
-
-double CmisModule::getQsfpSensor(
-    CmisField field,
-    double (*conversion)(uint16_t value)) {
-  auto info = CmisFieldInfo::getCmisFieldAddress(cmisFields, field);
-  const uint8_t* data =
-      getQsfpValuePtr(info.dataAddress, info.offset, info.length);
-  return conversion(data[0] << 8 | data[1]);
-}
-
 TransmitterTechnology CmisModule::getQsfpTransmitterTechnology() const {
   auto info = CmisFieldInfo::getCmisFieldAddress(
       cmisFields, CmisField::MEDIA_INTERFACE_TECHNOLOGY);
@@ -533,14 +367,7 @@ TransmitterTechnology CmisModule::getQsfpTransmitterTechnology() const {
 }
 
 SignalFlags CmisModule::getSignalFlagInfo() {
-  SignalFlags signalFlags = SignalFlags();
-
-  signalFlags.txLos_ref() = getSettingsValue(CmisField::TX_LOS_FLAG);
-  signalFlags.rxLos_ref() = getSettingsValue(CmisField::RX_LOS_FLAG);
-  signalFlags.txLol_ref() = getSettingsValue(CmisField::TX_LOL_FLAG);
-  signalFlags.rxLol_ref() = getSettingsValue(CmisField::RX_LOL_FLAG);
-
-  return signalFlags;
+  return CmisPageDecoder::decodeSignalFlags(getCachedPages());
 }
 
 void CmisModule::setQsfpFlatMem() {
@@ -613,6 +440,20 @@ CmisModule::getQsfpValuePtr(int dataAddress, int offset, int length) const {
   }
 }
 
+CmisPageDecoder::Pages CmisModule::getCachedPages() const {
+  if (!cacheIsValid()) {
+    throw FbossError("Qsfp is either not present or the data is not read");
+  }
+  CmisPageDecoder::Pages pages;
+  pages.lower = lowerPage_;
+  pages.page00 = page0_;
+  if (!flatMem_) {
+    pages.page02 = page02_;
+    pages.page11 = page11_;
+  }
+  return pages;
+}
+
 RawDOMData CmisModule::getRawDOMData() {
   lock_guard<std::mutex> g(qsfpModuleMutex_);
   RawDOMData data;
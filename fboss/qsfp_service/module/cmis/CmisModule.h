@@ -6,12 +6,23 @@
 
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+#include "fboss/qsfp_service/module/cmis/CmisPageDecoder.h"
 
 namespace facebook {
 namespace fboss {
 
 enum class CmisField;
 
+/*
+ * Looks up field in the cmisFields map: the page it is on, and its offset and
+ * length as given in the spec
+ */
+void getQsfpFieldAddress(
+    CmisField field,
+    int& dataAddress,
+    int& offset,
+    int& length);
+
 class CmisModule : public QsfpModule {
  public:
   explicit CmisModule(
@@ -87,6 +98,11 @@ class CmisModule : public QsfpModule {
    * before calling this function.
    */
   const uint8_t* getQsfpValuePtr(int dataAddress, int offset, int length) const override;
+  /*
+   * The cached pages, for CmisPageDecoder to decode the DOM data from. Like
+   * getQsfpValuePtr this throws if the cache isn't valid.
+   */
+  CmisPageDecoder::Pages getCachedPages() const;
   /*
    * Perform transceiver customization
    * This must be called with a lock held on qsfpModuleMutex_
@@ -111,10 +127,6 @@ class CmisModule : public QsfpModule {
    * Set appropriate application code for PortSpeed, if supported
    */
   void setApplicationCode(cfg::PortSpeed speed);
-  /*
-   * returns individual sensor values after scaling
-   */
-  double getQsfpSensor(CmisField field, double (*conversion)(uint16_t value));
   /*
    * returns cable length (negative for "longer than we can represent")
    */
@@ -126,22 +138,6 @@ class CmisModule : public QsfpModule {
    * returns the freeside transceiver technology type
    */
   virtual TransmitterTechnology getQsfpTransmitterTechnology() const override;
-  /*
-   * Extract sensor flag levels
-   */
-  FlagLevels getQsfpSensorFlags(CmisField fieldName, int offset);
-  /*
-   * This function returns various strings from the QSFP EEPROM
-   * caller needs to check if DOM is supported or not
-   */
-  std::string getQsfpString(CmisField flag) const;
-
-  /*
-   * Fills in values for alarm and warning thresholds based on field name
-   */
-  ThresholdLevels getThresholdValues(
-      CmisField field,
-      double (*conversion)(uint16_t value));
   /*
    * Retreives all alarm and warning thresholds
    */
@@ -154,10 +150,6 @@ class CmisModule : public QsfpModule {
    * Gather per-channel information for thrift queries
    */
   bool getSensorsPerChanInfo(std::vector<Channel>& channels) override;
-  /*
-   * Gather per-channel flag values from bitfields.
-   */
-  FlagLevels getChannelFlags(CmisField field, int channel);
   /*
    * Gather the vendor info for thrift queries
    */
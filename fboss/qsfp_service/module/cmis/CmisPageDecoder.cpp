@@ -0,0 +1,216 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/qsfp_service/module/cmis/CmisPageDecoder.h"
+
+#include <algorithm>
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/qsfp_service/module/cmis/CmisFieldInfo.h"
+
+namespace facebook {
+namespace fboss {
+
+using page_layout::decodeFlags;
+using page_layout::decodeString;
+using page_layout::decodeThresholdLevels;
+using page_layout::readU16;
+
+namespace {
+
+// Numbered as the CmisPages of the cmisFields map
+enum CmisPage {
+  LOWER = 0,
+  PAGE00 = 1,
+  PAGE02 = 3,
+  PAGE11 = 5,
+};
+
+// As per CMIS4.0, matching the cmisFields map in CmisModule.cpp
+
+// Lower page
+constexpr auto kModuleAlarms = PageField::lower(LOWER, 9, 3);
+constexpr auto kTemperature = PageField::lower(LOWER, 14, 2);
+constexpr auto kVcc = PageField::lower(LOWER, 16, 2);
+
+// Page 00h
+constexpr auto kVendorName = PageField::upper(PAGE00, 129, 16);
+constexpr auto kVendorOui = PageField::upper(PAGE00, 145, 3);
+constexpr auto kPartNumber = PageField::upper(PAGE00, 148, 16);
+constexpr auto kRevisionNumber = PageField::upper(PAGE00, 164, 2);
+constexpr auto kVendorSerialNumber = PageField::upper(PAGE00, 166, 16);
+constexpr auto kMfgDate = PageField::upper(PAGE00, 182, 8);
+
+// Page 02h
+constexpr auto kTemperatureThresh = PageField::upper(PAGE02, 128, 8);
+constexpr auto kVccThresh = PageField::upper(PAGE02, 136, 8);
+constexpr auto kTxBiasThresh = PageField::upper(PAGE02, 184, 8);
+constexpr auto kRxPwrThresh = PageField::upper(PAGE02, 192, 8);
+
+// Page 11h
+constexpr auto kTxLosFlag = PageField::upper(PAGE11, 136, 1);
+constexpr auto kTxLolFlag = PageField::upper(PAGE11, 137, 1);
+constexpr auto kTxPwrFlag = PageField::upper(PAGE11, 139, 4);
+constexpr auto kTxBiasFlag = PageField::upper(PAGE11, 143, 4);
+constexpr auto kRxLosFlag = PageField::upper(PAGE11, 147, 1);
+constexpr auto kRxLolFlag = PageField::upper(PAGE11, 148, 1);
+constexpr auto kRxPwrFlag = PageField::upper(PAGE11, 149, 4);
+constexpr auto kChannelTxPwr = PageField::upper(PAGE11, 154, 16);
+constexpr auto kChannelTxBias = PageField::upper(PAGE11, 170, 16);
+constexpr auto kChannelRxPwr = PageField::upper(PAGE11, 186, 16);
+
+static_assert(kModuleAlarms.fits());
+static_assert(kTemperature.fits(2, 1) && kVcc.fits(2, 1));
+static_assert(kVendorName.fits() && kVendorOui.fits());
+static_assert(kPartNumber.fits() && kRevisionNumber.fits());
+static_assert(kVendorSerialNumber.fits() && kMfgDate.fits());
+static_assert(kTemperatureThresh.fits(2, 4) && kVccThresh.fits(2, 4));
+static_assert(kTxBiasThresh.fits(2, 4) && kRxPwrThresh.fits(2, 4));
+static_assert(kTxLosFlag.fits() && kTxLolFlag.fits());
+static_assert(kRxLosFlag.fits() && kRxLolFlag.fits());
+// The channel flags are a byte per flag level, with a bit per lane
+static_assert(kTxPwrFlag.fits(1, 4) && CmisPageDecoder::CHANNEL_COUNT <= 8);
+static_assert(kTxBiasFlag.fits(1, 4) && kRxPwrFlag.fits(1, 4));
+static_assert(kChannelTxPwr.fits(2, CmisPageDecoder::CHANNEL_COUNT));
+static_assert(kChannelTxBias.fits(2, CmisPageDecoder::CHANNEL_COUNT));
+static_assert(kChannelRxPwr.fits(2, CmisPageDecoder::CHANNEL_COUNT));
+
+/*
+ * The lane flags of a sensor are four bytes: alarm high, alarm low, warning
+ * high and warning low, with a bit per lane in each of them
+ */
+FlagLevels channelFlags(const uint8_t* page, const PageField& field, int i) {
+  const uint8_t* data = page + field.offset;
+  FlagLevels flags;
+  *flags.alarm_ref()->high_ref() = data[0] & (1 << i);
+  *flags.alarm_ref()->low_ref() = data[1] & (1 << i);
+  *flags.warn_ref()->high_ref() = data[2] & (1 << i);
+  *flags.warn_ref()->low_ref() = data[3] & (1 << i);
+  return flags;
+}
+
+const uint8_t* getLanePage(const CmisPageDecoder::Pages& pages) {
+  if (!pages.page11) {
+    throw FbossError("Accessing lane data on flatMem module.");
+  }
+  return pages.page11;
+}
+
+} // namespace
+
+GlobalSensors CmisPageDecoder::decodeSensors(const Pages& pages) {
+  const uint8_t* lower = pages.lower;
+  GlobalSensors info;
+  *info.temp_ref()->value_ref() =
+      CmisFieldInfo::getTemp(readU16(lower, kTemperature, 0));
+  info.temp_ref()->flags_ref() = decodeFlags(lower[kModuleAlarms.offset], 0);
+  *info.vcc_ref()->value_ref() =
+      CmisFieldInfo::getVcc(readU16(lower, kVcc, 0));
+  info.vcc_ref()->flags_ref() = decodeFlags(lower[kModuleAlarms.offset], 4);
+  return info;
+}
+
+void CmisPageDecoder::decodeChannels(
+    const Pages& pages,
+    std::vector<Channel>& channels) {
+  const uint8_t* page11 = getLanePage(pages);
+  int count = std::min<int>(channels.size(), CHANNEL_COUNT);
+  for (int i = 0; i < count; i++) {
+    auto& sensors = *channels[i].sensors_ref();
+    *sensors.rxPwr_ref()->value_ref() =
+        CmisFieldInfo::getPwr(readU16(page11, kChannelRxPwr, i));
+    sensors.rxPwr_ref()->flags_ref() = channelFlags(page11, kRxPwrFlag, i);
+    *sensors.txBias_ref()->value_ref() =
+        CmisFieldInfo::getTxBias(readU16(page11, kChannelTxBias, i));
+    sensors.txBias_ref()->flags_ref() = channelFlags(page11, kTxBiasFlag, i);
+    *sensors.txPwr_ref()->value_ref() =
+        CmisFieldInfo::getPwr(readU16(page11, kChannelTxPwr, i));
+    sensors.txPwr_ref()->flags_ref() = channelFlags(page11, kTxPwrFlag, i);
+  }
+}
+
+SignalFlags CmisPageDecoder::decodeSignalFlags(const Pages& pages) {
+  const uint8_t* page11 = getLanePage(pages);
+  SignalFlags signalFlags;
+  *signalFlags.txLos_ref() = page11[kTxLosFlag.offset];
+  *signalFlags.rxLos_ref() = page11[kRxLosFlag.offset];
+  *signalFlags.txLol_ref() = page11[kTxLolFlag.offset];
+  *signalFlags.rxLol_ref() = page11[kRxLolFlag.offset];
+  return signalFlags;
+}
+
+Vendor CmisPageDecoder::decodeVendor(const Pages& pages) {
+  const uint8_t* page00 = pages.page00;
+  Vendor vendor;
+  *vendor.name_ref() = decodeString(page00, kVendorName);
+  *vendor.oui_ref() = decodeString(page00, kVendorOui);
+  *vendor.partNumber_ref() = decodeString(page00, kPartNumber);
+  *vendor.rev_ref() = decodeString(page00, kRevisionNumber);
+  *vendor.serialNumber_ref() = decodeString(page00, kVendorSerialNumber);
+  *vendor.dateCode_ref() = decodeString(page00, kMfgDate);
+  return vendor;
+}
+
+std::optional<AlarmThreshold> CmisPageDecoder::decodeThresholds(
+    const Pages& pages) {
+  const uint8_t* page02 = pages.page02;
+  if (!page02) {
+    return std::nullopt;
+  }
+  AlarmThreshold threshold;
+  *threshold.temp_ref() =
+      decodeThresholdLevels(page02, kTemperatureThresh, CmisFieldInfo::getTemp);
+  *threshold.vcc_ref() =
+      decodeThresholdLevels(page02, kVccThresh, CmisFieldInfo::getVcc);
+  *threshold.rxPwr_ref() =
+      decodeThresholdLevels(page02, kRxPwrThresh, CmisFieldInfo::getPwr);
+  *threshold.txBias_ref() =
+      decodeThresholdLevels(page02, kTxBiasThresh, CmisFieldInfo::getTxBias);
+  return threshold;
+}
+
+void CmisPageDecoder::decode(const Pages& pages, TransceiverInfo& info) {
+  info.sensor_ref() = decodeSensors(pages);
+  info.vendor_ref() = decodeVendor(pages);
+  if (auto threshold = decodeThresholds(pages)) {
+    info.thresholds_ref() = *threshold;
+  }
+  if (info.channels_ref()->size() < CHANNEL_COUNT) {
+    info.channels_ref()->resize(CHANNEL_COUNT);
+    for (int i = 0; i < CHANNEL_COUNT; i++) {
+      *(*info.channels_ref())[i].channel_ref() = i;
+    }
+  }
+  decodeChannels(pages, *info.channels_ref());
+  info.signalFlag_ref() = decodeSignalFlags(pages);
+}
+
+std::map<CmisField, PageField> CmisPageDecoder::getFieldLayout() {
+  return {
+      {CmisField::MODULE_ALARMS, kModuleAlarms},
+      {CmisField::TEMPERATURE, kTemperature},
+      {CmisField::VCC, kVcc},
+      {CmisField::VENDOR_NAME, kVendorName},
+      {CmisField::VENDOR_OUI, kVendorOui},
+      {CmisField::PART_NUMBER, kPartNumber},
+      {CmisField::REVISION_NUMBER, kRevisionNumber},
+      {CmisField::VENDOR_SERIAL_NUMBER, kVendorSerialNumber},
+      {CmisField::MFG_DATE, kMfgDate},
+      {CmisField::TEMPERATURE_THRESH, kTemperatureThresh},
+      {CmisField::VCC_THRESH, kVccThresh},
+      {CmisField::TX_BIAS_THRESH, kTxBiasThresh},
+      {CmisField::RX_PWR_THRESH, kRxPwrThresh},
+      {CmisField::TX_LOS_FLAG, kTxLosFlag},
+      {CmisField::TX_LOL_FLAG, kTxLolFlag},
+      {CmisField::TX_PWR_FLAG, kTxPwrFlag},
+      {CmisField::TX_BIAS_FLAG, kTxBiasFlag},
+      {CmisField::RX_LOS_FLAG, kRxLosFlag},
+      {CmisField::RX_LOL_FLAG, kRxLolFlag},
+      {CmisField::RX_PWR_FLAG, kRxPwrFlag},
+      {CmisField::CHANNEL_TX_PWR, kChannelTxPwr},
+      {CmisField::CHANNEL_TX_BIAS, kChannelTxBias},
+      {CmisField::CHANNEL_RX_PWR, kChannelRxPwr},
+  };
+}
+
+} // namespace fboss
+} // namespace facebook
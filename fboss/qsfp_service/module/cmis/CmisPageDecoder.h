@@ -0,0 +1,66 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+#include "fboss/qsfp_service/module/PageLayout.h"
+
+namespace facebook {
+namespace fboss {
+
+enum class CmisField;
+
+/*
+ * Decodes the DOM data of a CMIS module from its cached pages, using the
+ * compiled layout in CmisPageDecoder.cpp instead of per-field lookups in
+ * the CmisFieldInfo map.
+ *
+ * Like SffPageDecoder this covers sensors, per channel data, signal flags,
+ * vendor and thresholds. Cable and settings info stay in CmisModule.
+ */
+class CmisPageDecoder {
+ public:
+  enum : unsigned int {
+    CHANNEL_COUNT = 4,
+  };
+
+  struct Pages {
+    const uint8_t* lower{nullptr};
+    const uint8_t* page00{nullptr};
+    // Not available on flat memory modules
+    const uint8_t* page02{nullptr};
+    const uint8_t* page11{nullptr};
+  };
+
+  static GlobalSensors decodeSensors(const Pages& pages);
+  /*
+   * Fills in the sensors of the first CHANNEL_COUNT channels. Throws on
+   * flat memory modules, which don't have the lane pages.
+   */
+  static void decodeChannels(
+      const Pages& pages,
+      std::vector<Channel>& channels);
+  /* Throws on flat memory modules */
+  static SignalFlags decodeSignalFlags(const Pages& pages);
+  /* Strings are trimmed, but not validated */
+  static Vendor decodeVendor(const Pages& pages);
+  /* Thresholds are on page 02h, so this is empty for flat memory modules */
+  static std::optional<AlarmThreshold> decodeThresholds(const Pages& pages);
+
+  /* Decodes all of the above into info, in a single pass over the pages */
+  static void decode(const Pages& pages, TransceiverInfo& info);
+
+  /*
+   * Where the layout has each field it decodes, for tests to check against
+   * the cmisFields map
+   */
+  static std::map<CmisField, PageField> getFieldLayout();
+};
+
+} // namespace fboss
+} // namespace facebook
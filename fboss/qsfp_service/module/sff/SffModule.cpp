@@ -11,6 +11,7 @@
 #include "fboss/qsfp_service/StatsPublisher.h"
 #include "fboss/qsfp_service/module/TransceiverImpl.h"
 #include "fboss/qsfp_service/module/sff/SffFieldInfo.h"
+#include "fboss/qsfp_service/module/sff/SffPageDecoder.h"
 
 #include <folly/io/IOBuf.h>
 #include <folly/io/async/EventBase.h>
@@ -136,17 +137,6 @@ SffModule::SffModule(
 
 SffModule::~SffModule() {}
 
-FlagLevels SffModule::getQsfpSensorFlags(SffField fieldName) {
-  int offset;
-  int length;
-  int dataAddress;
-
-  /* Determine if QSFP is present */
-  getQsfpFieldAddress(fieldName, dataAddress, offset, length);
-  const uint8_t* data = getQsfpValuePtr(dataAddress, offset, length);
-  return getQsfpFlags(data, 4);
-}
-
 double SffModule::getQsfpDACLength() const {
   auto base = getQsfpCableLength(SffField::LENGTH_COPPER);
   auto fractional = getQsfpCableLength(SffField::LENGTH_COPPER_DECIMETERS);
@@ -182,25 +172,12 @@ int SffModule::getQsfpDACGauge() const {
 }
 
 GlobalSensors SffModule::getSensorInfo() {
-  GlobalSensors info = GlobalSensors();
-  *info.temp_ref()->value_ref() =
-      getQsfpSensor(SffField::TEMPERATURE, SffFieldInfo::getTemp);
-  info.temp_ref()->flags_ref() =
-      getQsfpSensorFlags(SffField::TEMPERATURE_ALARMS);
-  *info.vcc_ref()->value_ref() =
-      getQsfpSensor(SffField::VCC, SffFieldInfo::getVcc);
-  info.vcc_ref()->flags_ref() = getQsfpSensorFlags(SffField::VCC_ALARMS);
-  return info;
+  return SffPageDecoder::decodeSensors(getCachedPages());
 }
 
 Vendor SffModule::getVendorInfo() {
-  Vendor vendor = Vendor();
-  *vendor.name_ref() = getQsfpString(SffField::VENDOR_NAME);
-  *vendor.oui_ref() = getQsfpString(SffField::VENDOR_OUI);
-  *vendor.partNumber_ref() = getQsfpString(SffField::PART_NUMBER);
-  *vendor.rev_ref() = getQsfpString(SffField::REVISION_NUMBER);
-  *vendor.serialNumber_ref() = getQsfpString(SffField::VENDOR_SERIAL_NUMBER);
-  *vendor.dateCode_ref() = getQsfpString(SffField::MFG_DATE);
+  Vendor vendor = SffPageDecoder::decodeVendor(getCachedPages());
+  validateVendorInfo(vendor);
   return vendor;
 }
 
@@ -251,47 +228,8 @@ Cable SffModule::getCableInfo() {
   return cable;
 }
 
-/*
- * Threhold values are stored just once;  they aren't per-channel,
- * so in all cases we simple assemble two-byte values and convert
- * them based on the type of the field.
- */
-ThresholdLevels SffModule::getThresholdValues(
-    SffField field,
-    double (*conversion)(uint16_t value)) {
-  int offset;
-  int length;
-  int dataAddress;
-  ThresholdLevels thresh;
-
-  CHECK(!flatMem_);
-
-  getQsfpFieldAddress(field, dataAddress, offset, length);
-  const uint8_t* data = getQsfpValuePtr(dataAddress, offset, length);
-
-  CHECK_GE(length, 8);
-  *thresh.alarm_ref()->high_ref() = conversion(data[0] << 8 | data[1]);
-  *thresh.alarm_ref()->low_ref() = conversion(data[2] << 8 | data[3]);
-  *thresh.warn_ref()->high_ref() = conversion(data[4] << 8 | data[5]);
-  *thresh.warn_ref()->low_ref() = conversion(data[6] << 8 | data[7]);
-
-  return thresh;
-}
-
 std::optional<AlarmThreshold> SffModule::getThresholdInfo() {
-  if (flatMem_) {
-    return {};
-  }
-  AlarmThreshold threshold = AlarmThreshold();
-  *threshold.temp_ref() =
-      getThresholdValues(SffField::TEMPERATURE_THRESH, SffFieldInfo::getTemp);
-  *threshold.vcc_ref() =
-      getThresholdValues(SffField::VCC_THRESH, SffFieldInfo::getVcc);
-  *threshold.rxPwr_ref() =
-      getThresholdValues(SffField::RX_PWR_THRESH, SffFieldInfo::getPwr);
-  *threshold.txBias_ref() =
-      getThresholdValues(SffField::TX_BIAS_THRESH, SffFieldInfo::getTxBias);
-  return threshold;
+  return SffPageDecoder::decodeThresholds(getCachedPages());
 }
 
 uint8_t SffModule::getSettingsValue(SffField field, uint8_t mask) {
@@ -397,121 +335,12 @@ PowerControlState SffModule::getPowerControlValue() {
   }
 }
 
-/*
- * Iterate through the four channels collecting appropriate data;
- * always assumes CHANNEL_COUNT channels is four.
- */
-
 bool SffModule::getSensorsPerChanInfo(std::vector<Channel>& channels) {
-  int offset;
-  int length;
-  int dataAddress;
-
-  /*
-   * Interestingly enough, the QSFP stores the four alarm flags
-   * (alarm high, alarm low, warning high, warning low) in two bytes by
-   * channel in order 2, 1, 4, 3;  by using this set of offsets, we
-   * should be able to read them in order, by reading the appriopriate
-   * bit offsets combined with a byte offset into the data.
-   *
-   * That is, read bits 4 through 7 of the first byte, then 0 through 3,
-   * then 4 through 7 of the second byte, and so on.  Ugh.
-   */
-  std::array<uint8_t, 4> bitOffset{{4, 0, 4, 0}};
-  std::array<uint8_t, 4> byteOffset{{0, 0, 1, 1}};
-
-  assert (channels.size() == CHANNEL_COUNT);
-
-  getQsfpFieldAddress(
-      SffField::CHANNEL_RX_PWR_ALARMS, dataAddress, offset, length);
-  const uint8_t* data = getQsfpValuePtr(dataAddress, offset, length);
-
-  for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
-    channels[channel].sensors_ref()->rxPwr_ref()->flags_ref() =
-        getQsfpFlags(data + byteOffset[channel], bitOffset[channel]);
-  }
-
-  getQsfpFieldAddress(
-      SffField::CHANNEL_TX_BIAS_ALARMS, dataAddress, offset, length);
-  data = getQsfpValuePtr(dataAddress, offset, length);
-
-  for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
-    channels[channel].sensors_ref()->txBias_ref()->flags_ref() =
-        getQsfpFlags(data + byteOffset[channel], bitOffset[channel]);
-  }
-
-  getQsfpFieldAddress(
-      SffField::CHANNEL_TX_PWR_ALARMS, dataAddress, offset, length);
-  data = getQsfpValuePtr(dataAddress, offset, length);
-
-  for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
-    channels[channel].sensors_ref()->txPwr_ref()->flags_ref() =
-        getQsfpFlags(data + byteOffset[channel], bitOffset[channel]);
-  }
-
-  getQsfpFieldAddress(SffField::CHANNEL_RX_PWR, dataAddress, offset, length);
-  data = getQsfpValuePtr(dataAddress, offset, length);
-
-  for (auto& channel : channels) {
-    uint16_t value = data[0] << 8 | data[1];
-    *channel.sensors_ref()->rxPwr_ref()->value_ref() =
-        SffFieldInfo::getPwr(value);
-    data += 2;
-    length--;
-  }
-  CHECK_GE(length, 0);
-
-  getQsfpFieldAddress(SffField::CHANNEL_TX_BIAS, dataAddress, offset, length);
-  data = getQsfpValuePtr(dataAddress, offset, length);
-  for (auto& channel : channels) {
-    uint16_t value = data[0] << 8 | data[1];
-    *channel.sensors_ref()->txBias_ref()->value_ref() =
-        SffFieldInfo::getTxBias(value);
-    data += 2;
-    length--;
-  }
-  CHECK_GE(length, 0);
-
-  getQsfpFieldAddress(SffField::CHANNEL_TX_PWR, dataAddress, offset, length);
-  data = getQsfpValuePtr(dataAddress, offset, length);
-
-  for (auto& channel : channels) {
-    uint16_t value = data[0] << 8 | data[1];
-    *channel.sensors_ref()->txPwr_ref()->value_ref() =
-        SffFieldInfo::getPwr(value);
-    data += 2;
-    length--;
-  }
-  CHECK_GE(length, 0);
-
+  assert(channels.size() == CHANNEL_COUNT);
+  SffPageDecoder::decodeChannels(getCachedPages(), channels);
   return true;
 }
 
-std::string SffModule::getQsfpString(SffField field) const {
-  int offset;
-  int length;
-  int dataAddress;
-
-  getQsfpFieldAddress(field, dataAddress, offset, length);
-  const uint8_t* data = getQsfpValuePtr(dataAddress, offset, length);
-
-  while (length > 0 && data[length - 1] == ' ') {
-    --length;
-  }
-
-  std::string value(reinterpret_cast<const char*>(data), length);
-  return validateQsfpString(value) ? value : "UNKNOWN";
-}
-
-double SffModule::getQsfpSensor(
-    SffField field,
-    double (*conversion)(uint16_t value)) {
-  auto info = SffFieldInfo::getSffFieldAddress(qsfpFields, field);
-  const uint8_t* data =
-      getQsfpValuePtr(info.dataAddress, info.offset, info.length);
-  return conversion(data[0] << 8 | data[1]);
-}
-
 /*
  * Cable length is report as a single byte;  each field has a
  * specific multiplier to use to get the true length.  For instance,
@@ -552,16 +381,7 @@ TransmitterTechnology SffModule::getQsfpTransmitterTechnology() const {
 }
 
 SignalFlags SffModule::getSignalFlagInfo() {
-  SignalFlags signalFlags = SignalFlags();
-
-  *signalFlags.txLos_ref() = getSettingsValue(SffField::LOS, TX_MASK);
-  *signalFlags.txLos_ref() >>= 4;
-  *signalFlags.rxLos_ref() = getSettingsValue(SffField::LOS, RX_MASK);
-  *signalFlags.txLol_ref() = getSettingsValue(SffField::LOL, TX_MASK);
-  *signalFlags.txLol_ref() >>= 4;
-  *signalFlags.rxLol_ref() = getSettingsValue(SffField::LOL, RX_MASK);
-
-  return signalFlags;
+  return SffPageDecoder::decodeSignalFlags(getCachedPages());
 }
 
 void SffModule::setQsfpFlatMem() {
@@ -614,6 +434,19 @@ SffModule::getQsfpValuePtr(int dataAddress, int offset, int length) const {
   }
 }
 
+SffPageDecoder::Pages SffModule::getCachedPages() const {
+  if (!cacheIsValid()) {
+    throw FbossError("Qsfp is either not present or the data is not read");
+  }
+  SffPageDecoder::Pages pages;
+  pages.lower = lowerPage_;
+  pages.page0 = page0_;
+  if (!flatMem_) {
+    pages.page3 = page3_;
+  }
+  return pages;
+}
+
 RawDOMData SffModule::getRawDOMData() {
   lock_guard<std::mutex> g(qsfpModuleMutex_);
   RawDOMData data;
@@ -6,12 +6,23 @@
 
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+#include "fboss/qsfp_service/module/sff/SffPageDecoder.h"
 
 namespace facebook {
 namespace fboss {
 
 enum class SffField;
 
+/*
+ * Looks up field in the qsfpFields map: the page it is on, and its offset and
+ * length as given in the spec
+ */
+void getQsfpFieldAddress(
+    SffField field,
+    int& dataAddress,
+    int& offset,
+    int& length);
+
 class SffModule : public QsfpModule {
  public:
   explicit SffModule(
@@ -87,6 +98,11 @@ class SffModule : public QsfpModule {
    */
   const uint8_t* getQsfpValuePtr(int dataAddress, int offset, int length)
       const override;
+  /*
+   * The cached pages, for SffPageDecoder to decode the DOM data from. Like
+   * getQsfpValuePtr this throws if the cache isn't valid.
+   */
+  SffPageDecoder::Pages getCachedPages() const;
   /*
    * Based on identifier, sets whether the upper memory of the module is flat or
    * paged.
@@ -113,10 +129,6 @@ class SffModule : public QsfpModule {
       cfg::PortSpeed speed,
       RateSelectState currentState,
       RateSelectSetting currentSetting) override;
-  /*
-   * returns individual sensor values after scaling
-   */
-  double getQsfpSensor(SffField field, double (*conversion)(uint16_t value));
   /*
    * returns cable length (negative for "longer than we can represent")
    */
@@ -126,22 +138,6 @@ class SffModule : public QsfpModule {
    * returns the freeside transceiver technology type
    */
   TransmitterTechnology getQsfpTransmitterTechnology() const override;
-  /*
-   * Extract sensor flag levels
-   */
-  FlagLevels getQsfpSensorFlags(SffField fieldName);
-  /*
-   * This function returns various strings from the QSFP EEPROM
-   * caller needs to check if DOM is supported or not
-   */
-  std::string getQsfpString(SffField flag) const;
-
-  /*
-   * Fills in values for alarm and warning thresholds based on field name
-   */
-  ThresholdLevels getThresholdValues(
-      SffField field,
-      double (*conversion)(uint16_t value));
   /*
    * Retreives all alarm and warning thresholds
    */
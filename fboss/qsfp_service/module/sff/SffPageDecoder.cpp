@@ -0,0 +1,210 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/qsfp_service/module/sff/SffPageDecoder.h"
+
+#include <algorithm>
+
+#include "fboss/qsfp_service/module/sff/SffFieldInfo.h"
+
+namespace facebook {
+namespace fboss {
+
+using page_layout::decodeFlags;
+using page_layout::decodeString;
+using page_layout::decodeThresholdLevels;
+using page_layout::readU16;
+
+namespace {
+
+// Numbered as the SffPages of the qsfpFields map
+enum SffPage {
+  LOWER,
+  PAGE0,
+  PAGE3,
+};
+
+// As per SFF-8636, matching the qsfpFields map in SffModule.cpp
+
+// Lower page
+constexpr auto kLos = PageField::lower(LOWER, 3, 1);
+constexpr auto kLol = PageField::lower(LOWER, 5, 1);
+constexpr auto kTemperatureAlarms = PageField::lower(LOWER, 6, 1);
+constexpr auto kVccAlarms = PageField::lower(LOWER, 7, 1);
+constexpr auto kChannelRxPwrAlarms = PageField::lower(LOWER, 9, 2);
+constexpr auto kChannelTxBiasAlarms = PageField::lower(LOWER, 11, 2);
+constexpr auto kChannelTxPwrAlarms = PageField::lower(LOWER, 13, 2);
+constexpr auto kTemperature = PageField::lower(LOWER, 22, 2);
+constexpr auto kVcc = PageField::lower(LOWER, 26, 2);
+constexpr auto kChannelRxPwr = PageField::lower(LOWER, 34, 8);
+constexpr auto kChannelTxBias = PageField::lower(LOWER, 42, 8);
+constexpr auto kChannelTxPwr = PageField::lower(LOWER, 50, 8);
+
+// Page 0
+constexpr auto kVendorName = PageField::upper(PAGE0, 148, 16);
+constexpr auto kVendorOui = PageField::upper(PAGE0, 165, 3);
+constexpr auto kPartNumber = PageField::upper(PAGE0, 168, 16);
+constexpr auto kRevisionNumber = PageField::upper(PAGE0, 184, 2);
+constexpr auto kVendorSerialNumber = PageField::upper(PAGE0, 196, 16);
+constexpr auto kMfgDate = PageField::upper(PAGE0, 212, 8);
+
+// Page 3
+constexpr auto kTemperatureThresh = PageField::upper(PAGE3, 128, 8);
+constexpr auto kVccThresh = PageField::upper(PAGE3, 144, 8);
+constexpr auto kRxPwrThresh = PageField::upper(PAGE3, 176, 8);
+constexpr auto kTxBiasThresh = PageField::upper(PAGE3, 184, 8);
+
+static_assert(kLos.fits() && kLol.fits());
+static_assert(kTemperatureAlarms.fits() && kVccAlarms.fits());
+static_assert(kTemperature.fits(2, 1) && kVcc.fits(2, 1));
+// The channel flags are a nibble per channel
+static_assert(kChannelRxPwrAlarms.fits(1, SffPageDecoder::CHANNEL_COUNT / 2));
+static_assert(kChannelTxBiasAlarms.fits(1, SffPageDecoder::CHANNEL_COUNT / 2));
+static_assert(kChannelTxPwrAlarms.fits(1, SffPageDecoder::CHANNEL_COUNT / 2));
+static_assert(kChannelRxPwr.fits(2, SffPageDecoder::CHANNEL_COUNT));
+static_assert(kChannelTxBias.fits(2, SffPageDecoder::CHANNEL_COUNT));
+static_assert(kChannelTxPwr.fits(2, SffPageDecoder::CHANNEL_COUNT));
+static_assert(kVendorName.fits() && kVendorOui.fits());
+static_assert(kPartNumber.fits() && kRevisionNumber.fits());
+static_assert(kVendorSerialNumber.fits() && kMfgDate.fits());
+static_assert(kTemperatureThresh.fits(2, 4) && kVccThresh.fits(2, 4));
+static_assert(kRxPwrThresh.fits(2, 4) && kTxBiasThresh.fits(2, 4));
+
+/*
+ * The QSFP stores the four flags of a sensor by channel in order 2, 1, 4,
+ * 3 in two bytes, i.e. channel 1 is in bits 4 through 7 of the first byte,
+ * channel 2 in bits 0 through 3, and so on.
+ */
+constexpr int kFlagByteOffset[] = {0, 0, 1, 1};
+constexpr int kFlagBitOffset[] = {4, 0, 4, 0};
+
+constexpr uint8_t kRxMask = 0x0f;
+constexpr uint8_t kTxMask = 0xf0;
+
+FlagLevels channelFlags(const uint8_t* page, const PageField& field, int i) {
+  return decodeFlags(
+      page[field.offset + kFlagByteOffset[i]], kFlagBitOffset[i]);
+}
+
+} // namespace
+
+GlobalSensors SffPageDecoder::decodeSensors(const Pages& pages) {
+  const uint8_t* lower = pages.lower;
+  GlobalSensors info;
+  *info.temp_ref()->value_ref() =
+      SffFieldInfo::getTemp(readU16(lower, kTemperature, 0));
+  info.temp_ref()->flags_ref() =
+      decodeFlags(lower[kTemperatureAlarms.offset], 4);
+  *info.vcc_ref()->value_ref() =
+      SffFieldInfo::getVcc(readU16(lower, kVcc, 0));
+  info.vcc_ref()->flags_ref() = decodeFlags(lower[kVccAlarms.offset], 4);
+  return info;
+}
+
+void SffPageDecoder::decodeChannels(
+    const Pages& pages,
+    std::vector<Channel>& channels) {
+  const uint8_t* lower = pages.lower;
+  int count = std::min<int>(channels.size(), CHANNEL_COUNT);
+  for (int i = 0; i < count; i++) {
+    auto& sensors = *channels[i].sensors_ref();
+    *sensors.rxPwr_ref()->value_ref() =
+        SffFieldInfo::getPwr(readU16(lower, kChannelRxPwr, i));
+    sensors.rxPwr_ref()->flags_ref() =
+        channelFlags(lower, kChannelRxPwrAlarms, i);
+    *sensors.txBias_ref()->value_ref() =
+        SffFieldInfo::getTxBias(readU16(lower, kChannelTxBias, i));
+    sensors.txBias_ref()->flags_ref() =
+        channelFlags(lower, kChannelTxBiasAlarms, i);
+    *sensors.txPwr_ref()->value_ref() =
+        SffFieldInfo::getPwr(readU16(lower, kChannelTxPwr, i));
+    sensors.txPwr_ref()->flags_ref() =
+        channelFlags(lower, kChannelTxPwrAlarms, i);
+  }
+}
+
+SignalFlags SffPageDecoder::decodeSignalFlags(const Pages& pages) {
+  uint8_t los = pages.lower[kLos.offset];
+  uint8_t lol = pages.lower[kLol.offset];
+  SignalFlags signalFlags;
+  *signalFlags.txLos_ref() = (los & kTxMask) >> 4;
+  *signalFlags.rxLos_ref() = los & kRxMask;
+  *signalFlags.txLol_ref() = (lol & kTxMask) >> 4;
+  *signalFlags.rxLol_ref() = lol & kRxMask;
+  return signalFlags;
+}
+
+Vendor SffPageDecoder::decodeVendor(const Pages& pages) {
+  const uint8_t* page0 = pages.page0;
+  Vendor vendor;
+  *vendor.name_ref() = decodeString(page0, kVendorName);
+  *vendor.oui_ref() = decodeString(page0, kVendorOui);
+  *vendor.partNumber_ref() = decodeString(page0, kPartNumber);
+  *vendor.rev_ref() = decodeString(page0, kRevisionNumber);
+  *vendor.serialNumber_ref() = decodeString(page0, kVendorSerialNumber);
+  *vendor.dateCode_ref() = decodeString(page0, kMfgDate);
+  return vendor;
+}
+
+std::optional<AlarmThreshold> SffPageDecoder::decodeThresholds(
+    const Pages& pages) {
+  const uint8_t* page3 = pages.page3;
+  if (!page3) {
+    return std::nullopt;
+  }
+  AlarmThreshold threshold;
+  *threshold.temp_ref() =
+      decodeThresholdLevels(page3, kTemperatureThresh, SffFieldInfo::getTemp);
+  *threshold.vcc_ref() =
+      decodeThresholdLevels(page3, kVccThresh, SffFieldInfo::getVcc);
+  *threshold.rxPwr_ref() =
+      decodeThresholdLevels(page3, kRxPwrThresh, SffFieldInfo::getPwr);
+  *threshold.txBias_ref() =
+      decodeThresholdLevels(page3, kTxBiasThresh, SffFieldInfo::getTxBias);
+  return threshold;
+}
+
+void SffPageDecoder::decode(const Pages& pages, TransceiverInfo& info) {
+  info.sensor_ref() = decodeSensors(pages);
+  info.vendor_ref() = decodeVendor(pages);
+  if (auto threshold = decodeThresholds(pages)) {
+    info.thresholds_ref() = *threshold;
+  }
+  if (info.channels_ref()->size() < CHANNEL_COUNT) {
+    info.channels_ref()->resize(CHANNEL_COUNT);
+    for (int i = 0; i < CHANNEL_COUNT; i++) {
+      *(*info.channels_ref())[i].channel_ref() = i;
+    }
+  }
+  decodeChannels(pages, *info.channels_ref());
+  info.signalFlag_ref() = decodeSignalFlags(pages);
+}
+
+std::map<SffField, PageField> SffPageDecoder::getFieldLayout() {
+  return {
+      {SffField::LOS, kLos},
+      {SffField::LOL, kLol},
+      {SffField::TEMPERATURE_ALARMS, kTemperatureAlarms},
+      {SffField::VCC_ALARMS, kVccAlarms},
+      {SffField::CHANNEL_RX_PWR_ALARMS, kChannelRxPwrAlarms},
+      {SffField::CHANNEL_TX_BIAS_ALARMS, kChannelTxBiasAlarms},
+      {SffField::CHANNEL_TX_PWR_ALARMS, kChannelTxPwrAlarms},
+      {SffField::TEMPERATURE, kTemperature},
+      {SffField::VCC, kVcc},
+      {SffField::CHANNEL_RX_PWR, kChannelRxPwr},
+      {SffField::CHANNEL_TX_BIAS, kChannelTxBias},
+      {SffField::CHANNEL_TX_PWR, kChannelTxPwr},
+      {SffField::VENDOR_NAME, kVendorName},
+      {SffField::VENDOR_OUI, kVendorOui},
+      {SffField::PART_NUMBER, kPartNumber},
+      {SffField::REVISION_NUMBER, kRevisionNumber},
+      {SffField::VENDOR_SERIAL_NUMBER, kVendorSerialNumber},
+      {SffField::MFG_DATE, kMfgDate},
+      {SffField::TEMPERATURE_THRESH, kTemperatureThresh},
+      {SffField::VCC_THRESH, kVccThresh},
+      {SffField::RX_PWR_THRESH, kRxPwrThresh},
+      {SffField::TX_BIAS_THRESH, kTxBiasThresh},
+  };
+}
+
+} // namespace fboss
+} // namespace facebook
@@ -0,0 +1,62 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+#include "fboss/qsfp_service/module/PageLayout.h"
+
+namespace facebook {
+namespace fboss {
+
+enum class SffField;
+
+/*
+ * Decodes the DOM data of an SFF-8636 module from its cached pages, using
+ * the compiled layout in SffPageDecoder.cpp instead of per-field lookups in
+ * the SffFieldInfo map.
+ *
+ * This only covers the fields that change, or that every refresh reports
+ * (sensors, per channel data, signal flags, vendor and thresholds). Cable
+ * and settings info have per-vendor quirks and stay in SffModule.
+ */
+class SffPageDecoder {
+ public:
+  enum : unsigned int {
+    CHANNEL_COUNT = 4,
+  };
+
+  struct Pages {
+    const uint8_t* lower{nullptr};
+    const uint8_t* page0{nullptr};
+    // Not available on flat memory modules
+    const uint8_t* page3{nullptr};
+  };
+
+  static GlobalSensors decodeSensors(const Pages& pages);
+  /* Fills in the sensors of the first CHANNEL_COUNT channels */
+  static void decodeChannels(
+      const Pages& pages,
+      std::vector<Channel>& channels);
+  static SignalFlags decodeSignalFlags(const Pages& pages);
+  /* Strings are trimmed, but not validated */
+  static Vendor decodeVendor(const Pages& pages);
+  /* Thresholds are on page 3, so this is empty for flat memory modules */
+  static std::optional<AlarmThreshold> decodeThresholds(const Pages& pages);
+
+  /* Decodes all of the above into info, in a single pass over the pages */
+  static void decode(const Pages& pages, TransceiverInfo& info);
+
+  /*
+   * Where the layout has each field it decodes, for tests to check against
+   * the qsfpFields map
+   */
+  static std::map<SffField, PageField> getFieldLayout();
+};
+
+} // namespace fboss
+} // namespace facebook
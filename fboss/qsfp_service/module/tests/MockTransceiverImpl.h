@@ -24,5 +24,6 @@ class MockTransceiverImpl : public TransceiverImpl {
   MOCK_METHOD0(detectTransceiver, bool());
   MOCK_METHOD0(getName, folly::StringPiece());
   MOCK_CONST_METHOD0(getNum, int());
+  MOCK_METHOD1(setVendorInfo, void(const Vendor&));
 };
 }} // namespace facebook::fboss
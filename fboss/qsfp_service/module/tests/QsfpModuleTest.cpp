@@ -381,6 +381,27 @@ TEST_F(QsfpModuleTest, refreshDirtyNoPorts) {
   qsfp_->refresh();
 }
 
+TEST_F(QsfpModuleTest, refreshDirtySetsVendorInfoBeforeCustomizing) {
+  // A module swapped for another is reset to the safe write settings when
+  // it goes away and when the new one shows up, then gets those of the new
+  // module before it is customized
+  {
+    InSequence s;
+    EXPECT_CALL(*transImpl_, setVendorInfo(_)).Times(3);
+    EXPECT_CALL(*qsfp_, setCdrIfSupported(_, _, _)).Times(1);
+    EXPECT_CALL(*transImpl_, setVendorInfo(_)).Times(1);
+  }
+  EXPECT_CALL(*transImpl_, detectTransceiver()).WillRepeatedly(Return(false));
+  qsfp_->detectPresence();
+  EXPECT_CALL(*transImpl_, detectTransceiver()).WillRepeatedly(Return(true));
+  qsfp_->transceiverPortsChanged({
+      {1, portStatus(true, false)},
+      {2, portStatus(true, false)},
+      {3, portStatus(true, false)},
+      {4, portStatus(true, false)},
+    });
+}
+
 TEST_F(QsfpModuleTest, updateQsfpDataPartial) {
   // Ensure that partial updates don't ever call writeTranscevier,
   // which needs to gain control of the bus and slows the call
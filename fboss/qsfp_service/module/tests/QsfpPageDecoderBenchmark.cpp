@@ -0,0 +1,116 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/qsfp_service/module/cmis/CmisPageDecoder.h"
+#include "fboss/qsfp_service/module/sff/SffPageDecoder.h"
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+
+// A fully populated Minipack
+constexpr size_t kNumModules = 128;
+constexpr size_t kPageSize = PageField::kPageSize;
+
+using Page = std::array<uint8_t, kPageSize>;
+
+Page makePage(size_t module, size_t page) {
+  Page data;
+  for (size_t i = 0; i < kPageSize; ++i) {
+    data[i] = (module * 31 + page * 7 + i) & 0xff;
+  }
+  return data;
+}
+
+void setString(Page& page, int specOffset, const char* value, size_t len) {
+  auto data = page.data() + specOffset - kPageSize;
+  std::memset(data, ' ', len);
+  std::memcpy(data, value, std::min(len, std::strlen(value)));
+}
+
+struct SffModulePages {
+  explicit SffModulePages(size_t module)
+      : lower(makePage(module, 0)),
+        page0(makePage(module, 1)),
+        page3(makePage(module, 2)) {
+    setString(page0, 148, "FACETEST", 16);
+    setString(page0, 168, "FTL410QE2C", 16);
+  }
+
+  SffPageDecoder::Pages pages() const {
+    SffPageDecoder::Pages pages;
+    pages.lower = lower.data();
+    pages.page0 = page0.data();
+    pages.page3 = page3.data();
+    return pages;
+  }
+
+  Page lower;
+  Page page0;
+  Page page3;
+};
+
+struct CmisModulePages {
+  explicit CmisModulePages(size_t module)
+      : lower(makePage(module, 0)),
+        page00(makePage(module, 1)),
+        page02(makePage(module, 2)),
+        page11(makePage(module, 3)) {
+    setString(page00, 129, "FACETEST", 16);
+    setString(page00, 148, "FTCC1112E1PLL-FB", 16);
+  }
+
+  CmisPageDecoder::Pages pages() const {
+    CmisPageDecoder::Pages pages;
+    pages.lower = lower.data();
+    pages.page00 = page00.data();
+    pages.page02 = page02.data();
+    pages.page11 = page11.data();
+    return pages;
+  }
+
+  Page lower;
+  Page page00;
+  Page page02;
+  Page page11;
+};
+
+template <typename ModulePages, typename Decoder>
+void decodeAll(size_t iters) {
+  std::vector<ModulePages> modules;
+  BENCHMARK_SUSPEND {
+    for (size_t i = 0; i < kNumModules; ++i) {
+      modules.emplace_back(i);
+    }
+  }
+  for (size_t iter = 0; iter < iters; ++iter) {
+    for (const auto& module : modules) {
+      TransceiverInfo info;
+      Decoder::decode(module.pages(), info);
+      folly::doNotOptimizeAway(info);
+    }
+  }
+}
+
+} // namespace
+
+BENCHMARK(SffDecode128Modules, iters) {
+  decodeAll<SffModulePages, SffPageDecoder>(iters);
+}
+
+BENCHMARK(CmisDecode128Modules, iters) {
+  decodeAll<CmisModulePages, CmisPageDecoder>(iters);
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,344 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/qsfp_service/module/cmis/CmisFieldInfo.h"
+#include "fboss/qsfp_service/module/cmis/CmisModule.h"
+#include "fboss/qsfp_service/module/cmis/CmisPageDecoder.h"
+#include "fboss/qsfp_service/module/sff/SffFieldInfo.h"
+#include "fboss/qsfp_service/module/sff/SffModule.h"
+#include "fboss/qsfp_service/module/sff/SffPageDecoder.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <initializer_list>
+#include <map>
+#include <string>
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr size_t kPageSize = PageField::kPageSize;
+// The lower page is the first page of both field maps
+constexpr int kLowerPage = 0;
+
+using Page = std::array<uint8_t, kPageSize>;
+
+/* Sets consecutive two-byte values, offset is into the cached page */
+void setU16(Page& page, int offset, std::initializer_list<uint16_t> values) {
+  for (auto value : values) {
+    page[offset++] = value >> 8;
+    page[offset++] = value & 0xff;
+  }
+}
+
+/* Sets a string padded with spaces, at an upper page offset of the spec */
+void setString(Page& page, int specOffset, const char* value, size_t len) {
+  auto data = page.data() + specOffset - kPageSize;
+  std::memset(data, ' ', len);
+  std::memcpy(data, value, std::min(len, std::strlen(value)));
+}
+
+template <typename Field>
+void checkFieldLayout(const std::map<Field, PageField>& layout) {
+  for (const auto& [field, pageField] : layout) {
+    int dataAddress, offset, length;
+    getQsfpFieldAddress(field, dataAddress, offset, length);
+    auto expected = dataAddress == kLowerPage
+        ? PageField::lower(dataAddress, offset, length)
+        : PageField::upper(dataAddress, offset, length);
+    SCOPED_TRACE(static_cast<int>(field));
+    EXPECT_EQ(expected.page, pageField.page);
+    EXPECT_EQ(expected.offset, pageField.offset);
+    EXPECT_EQ(expected.length, pageField.length);
+  }
+}
+
+void checkFlags(
+    const FlagLevels& flags,
+    bool alarmHigh,
+    bool alarmLow,
+    bool warnHigh,
+    bool warnLow) {
+  EXPECT_EQ(alarmHigh, *flags.alarm_ref()->high_ref());
+  EXPECT_EQ(alarmLow, *flags.alarm_ref()->low_ref());
+  EXPECT_EQ(warnHigh, *flags.warn_ref()->high_ref());
+  EXPECT_EQ(warnLow, *flags.warn_ref()->low_ref());
+}
+
+void checkThresholds(
+    const ThresholdLevels& thresh,
+    double alarmHigh,
+    double alarmLow,
+    double warnHigh,
+    double warnLow) {
+  EXPECT_DOUBLE_EQ(alarmHigh, *thresh.alarm_ref()->high_ref());
+  EXPECT_DOUBLE_EQ(alarmLow, *thresh.alarm_ref()->low_ref());
+  EXPECT_DOUBLE_EQ(warnHigh, *thresh.warn_ref()->high_ref());
+  EXPECT_DOUBLE_EQ(warnLow, *thresh.warn_ref()->low_ref());
+}
+
+void checkVendor(const Vendor& vendor, const char* partNumber) {
+  EXPECT_EQ("FACETEST", *vendor.name_ref());
+  EXPECT_EQ(std::string("\x00\x90\x65", 3), *vendor.oui_ref());
+  EXPECT_EQ(partNumber, *vendor.partNumber_ref());
+  EXPECT_EQ("A", *vendor.rev_ref());
+  EXPECT_EQ("MRE01B0", *vendor.serialNumber_ref());
+  EXPECT_EQ("140502", *vendor.dateCode_ref());
+}
+
+void setVendor(
+    Page& page,
+    int nameOffset,
+    int ouiOffset,
+    int partNumberOffset,
+    int revOffset,
+    int serialOffset,
+    int dateOffset,
+    const char* partNumber) {
+  setString(page, nameOffset, "FACETEST", 16);
+  std::memcpy(page.data() + ouiOffset - kPageSize, "\x00\x90\x65", 3);
+  setString(page, partNumberOffset, partNumber, 16);
+  setString(page, revOffset, "A", 2);
+  setString(page, serialOffset, "MRE01B0", 16);
+  setString(page, dateOffset, "140502", 8);
+}
+
+/*
+ * Pages of an SFF-8636 module, with the values checked in
+ * checkSffInfo()
+ */
+struct SffGoldenPages {
+  SffGoldenPages() {
+    // Tx LOS on channels 1 and 3, rx LOS on 2 and 4
+    lower[3] = 0x5a;
+    lower[5] = 0x31;
+    // Temperature high alarm, vcc high warning
+    lower[6] = 0x80;
+    lower[7] = 0x20;
+    // Channel flags are a nibble per channel, in order 2, 1, 4, 3
+    lower[9] = 0x10;
+    lower[10] = 0x08;
+    lower[12] = 0x20;
+    lower[13] = 0x04;
+    setU16(lower, 22, {0x1f80});
+    setU16(lower, 26, {33000});
+    setU16(lower, 34, {10000, 0, 0, 5000});
+    setU16(lower, 42, {0, 6000, 0, 0});
+    setU16(lower, 50, {0, 0, 4000, 0});
+
+    setVendor(page0, 148, 165, 168, 184, 196, 212, "FTL410QE2C");
+
+    setU16(page3, 128 - kPageSize, {0x4b00, 0xfb00, 0x4600, 0x0000});
+    setU16(page3, 144 - kPageSize, {38000, 28400, 34500, 31500});
+    setU16(page3, 176 - kPageSize, {20000, 100, 10000, 200});
+    setU16(page3, 184 - kPageSize, {5000, 1000, 4500, 1500});
+  }
+
+  SffPageDecoder::Pages pages(bool flatMem = false) const {
+    SffPageDecoder::Pages pages;
+    pages.lower = lower.data();
+    pages.page0 = page0.data();
+    if (!flatMem) {
+      pages.page3 = page3.data();
+    }
+    return pages;
+  }
+
+  Page lower{};
+  Page page0{};
+  Page page3{};
+};
+
+/*
+ * Pages of a CMIS module, with the values checked in checkCmisInfo()
+ */
+struct CmisGoldenPages {
+  CmisGoldenPages() {
+    // Temperature low warning, vcc high alarm
+    lower[9] = 0x81;
+    setU16(lower, 14, {0x1900});
+    setU16(lower, 16, {33000});
+
+    setVendor(page00, 129, 145, 148, 164, 166, 182, "FTCC1112E1PLL-FB");
+
+    setU16(page02, 128 - kPageSize, {0x4b00, 0xfb00, 0x4600, 0x0000});
+    setU16(page02, 136 - kPageSize, {38000, 28400, 34500, 31500});
+    setU16(page02, 184 - kPageSize, {5000, 1000, 4500, 1500});
+    setU16(page02, 192 - kPageSize, {20000, 100, 10000, 200});
+
+    // Signal flags are a bit per lane
+    page11[136 - kPageSize] = 0x01;
+    page11[137 - kPageSize] = 0x02;
+    page11[147 - kPageSize] = 0x04;
+    page11[148 - kPageSize] = 0x08;
+    // Lane flags are a byte per level: alarm high, alarm low, warning high
+    // and warning low
+    page11[139 - kPageSize] = 0x01;
+    page11[143 - kPageSize + 3] = 0x02;
+    page11[149 - kPageSize + 1] = 0x08;
+    setU16(page11, 154 - kPageSize, {10000, 0, 0, 0});
+    setU16(page11, 170 - kPageSize, {0, 6000, 0, 0});
+    setU16(page11, 186 - kPageSize, {0, 0, 0, 5000});
+  }
+
+  CmisPageDecoder::Pages pages(bool flatMem = false) const {
+    CmisPageDecoder::Pages pages;
+    pages.lower = lower.data();
+    pages.page00 = page00.data();
+    if (!flatMem) {
+      pages.page02 = page02.data();
+      pages.page11 = page11.data();
+    }
+    return pages;
+  }
+
+  Page lower{};
+  Page page00{};
+  Page page02{};
+  Page page11{};
+};
+
+const ChannelSensors& channelSensors(const TransceiverInfo& info, int i) {
+  return *(*info.channels_ref())[i].sensors_ref();
+}
+
+} // namespace
+
+TEST(QsfpPageDecoderTest, SffFieldLayoutMatchesFieldMap) {
+  checkFieldLayout(SffPageDecoder::getFieldLayout());
+}
+
+TEST(QsfpPageDecoderTest, CmisFieldLayoutMatchesFieldMap) {
+  checkFieldLayout(CmisPageDecoder::getFieldLayout());
+}
+
+TEST(QsfpPageDecoderTest, SffDecode) {
+  SffGoldenPages golden;
+  TransceiverInfo info;
+  SffPageDecoder::decode(golden.pages(), info);
+
+  const auto& sensor = *info.sensor_ref();
+  EXPECT_DOUBLE_EQ(31.5, *sensor.temp_ref()->value_ref());
+  checkFlags(*sensor.temp_ref()->flags_ref(), true, false, false, false);
+  EXPECT_DOUBLE_EQ(3.3, *sensor.vcc_ref()->value_ref());
+  checkFlags(*sensor.vcc_ref()->flags_ref(), false, false, true, false);
+
+  checkVendor(*info.vendor_ref(), "FTL410QE2C");
+
+  ASSERT_TRUE(info.thresholds_ref().has_value());
+  const auto& thresholds = *info.thresholds_ref();
+  checkThresholds(*thresholds.temp_ref(), 75, -5, 70, 0);
+  checkThresholds(*thresholds.vcc_ref(), 3.8, 2.84, 3.45, 3.15);
+  checkThresholds(*thresholds.rxPwr_ref(), 2.0, 0.01, 1.0, 0.02);
+  checkThresholds(*thresholds.txBias_ref(), 10.0, 2.0, 9.0, 3.0);
+
+  ASSERT_EQ(SffPageDecoder::CHANNEL_COUNT, info.channels_ref()->size());
+  for (int i = 0; i < SffPageDecoder::CHANNEL_COUNT; i++) {
+    EXPECT_EQ(i, *(*info.channels_ref())[i].channel_ref());
+  }
+  EXPECT_DOUBLE_EQ(1.0, *channelSensors(info, 0).rxPwr_ref()->value_ref());
+  checkFlags(
+      *channelSensors(info, 0).rxPwr_ref()->flags_ref(),
+      false,
+      false,
+      false,
+      true);
+  EXPECT_DOUBLE_EQ(0.5, *channelSensors(info, 3).rxPwr_ref()->value_ref());
+  checkFlags(
+      *channelSensors(info, 3).rxPwr_ref()->flags_ref(),
+      true,
+      false,
+      false,
+      false);
+  EXPECT_DOUBLE_EQ(12.0, *channelSensors(info, 1).txBias_ref()->value_ref());
+  checkFlags(
+      *channelSensors(info, 2).txBias_ref()->flags_ref(),
+      false,
+      false,
+      true,
+      false);
+  EXPECT_DOUBLE_EQ(0.4, *channelSensors(info, 2).txPwr_ref()->value_ref());
+  checkFlags(
+      *channelSensors(info, 1).txPwr_ref()->flags_ref(),
+      false,
+      true,
+      false,
+      false);
+
+  const auto& signalFlags = *info.signalFlag_ref();
+  EXPECT_EQ(0x5, *signalFlags.txLos_ref());
+  EXPECT_EQ(0xa, *signalFlags.rxLos_ref());
+  EXPECT_EQ(0x3, *signalFlags.txLol_ref());
+  EXPECT_EQ(0x1, *signalFlags.rxLol_ref());
+}
+
+TEST(QsfpPageDecoderTest, SffDecodeFlatMem) {
+  SffGoldenPages golden;
+  TransceiverInfo info;
+  SffPageDecoder::decode(golden.pages(true /* flatMem */), info);
+  EXPECT_FALSE(info.thresholds_ref().has_value());
+  EXPECT_DOUBLE_EQ(31.5, *info.sensor_ref()->temp_ref()->value_ref());
+}
+
+TEST(QsfpPageDecoderTest, CmisDecode) {
+  CmisGoldenPages golden;
+  TransceiverInfo info;
+  CmisPageDecoder::decode(golden.pages(), info);
+
+  const auto& sensor = *info.sensor_ref();
+  EXPECT_DOUBLE_EQ(25.0, *sensor.temp_ref()->value_ref());
+  checkFlags(*sensor.temp_ref()->flags_ref(), false, false, false, true);
+  EXPECT_DOUBLE_EQ(3.3, *sensor.vcc_ref()->value_ref());
+  checkFlags(*sensor.vcc_ref()->flags_ref(), true, false, false, false);
+
+  checkVendor(*info.vendor_ref(), "FTCC1112E1PLL-FB");
+
+  ASSERT_TRUE(info.thresholds_ref().has_value());
+  const auto& thresholds = *info.thresholds_ref();
+  checkThresholds(*thresholds.temp_ref(), 75, -5, 70, 0);
+  checkThresholds(*thresholds.vcc_ref(), 3.8, 2.84, 3.45, 3.15);
+  checkThresholds(*thresholds.rxPwr_ref(), 2.0, 0.01, 1.0, 0.02);
+  checkThresholds(*thresholds.txBias_ref(), 10.0, 2.0, 9.0, 3.0);
+
+  ASSERT_EQ(CmisPageDecoder::CHANNEL_COUNT, info.channels_ref()->size());
+  EXPECT_DOUBLE_EQ(1.0, *channelSensors(info, 0).txPwr_ref()->value_ref());
+  checkFlags(
+      *channelSensors(info, 0).txPwr_ref()->flags_ref(),
+      true,
+      false,
+      false,
+      false);
+  EXPECT_DOUBLE_EQ(12.0, *channelSensors(info, 1).txBias_ref()->value_ref());
+  checkFlags(
+      *channelSensors(info, 1).txBias_ref()->flags_ref(),
+      false,
+      false,
+      false,
+      true);
+  EXPECT_DOUBLE_EQ(0.5, *channelSensors(info, 3).rxPwr_ref()->value_ref());
+  checkFlags(
+      *channelSensors(info, 3).rxPwr_ref()->flags_ref(),
+      false,
+      true,
+      false,
+      false);
+
+  const auto& signalFlags = *info.signalFlag_ref();
+  EXPECT_EQ(0x1, *signalFlags.txLos_ref());
+  EXPECT_EQ(0x2, *signalFlags.txLol_ref());
+  EXPECT_EQ(0x4, *signalFlags.rxLos_ref());
+  EXPECT_EQ(0x8, *signalFlags.rxLol_ref());
+}
+
+TEST(QsfpPageDecoderTest, CmisDecodeFlatMem) {
+  CmisGoldenPages golden;
+  auto pages = golden.pages(true /* flatMem */);
+  EXPECT_FALSE(CmisPageDecoder::decodeThresholds(pages).has_value());
+  TransceiverInfo info;
+  // Flat memory modules don't have the lane pages
+  EXPECT_THROW(CmisPageDecoder::decode(pages, info), FbossError);
+}
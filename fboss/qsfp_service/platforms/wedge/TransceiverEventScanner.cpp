@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/qsfp_service/platforms/wedge/TransceiverEventScanner.h"
+
+#include <folly/logging/xlog.h>
+
+namespace facebook { namespace fboss {
+
+TransceiverEventScanner::TransceiverEventScanner(
+    TransceiverI2CApi* bus,
+    int numModules,
+    std::chrono::milliseconds interruptHoldoff,
+    NowFunc now)
+    : bus_(bus), interruptHoldoff_(interruptHoldoff), now_(std::move(now)) {
+  for (int32_t id = 0; id < numModules; ++id) {
+    modules_[id] = ModuleState();
+  }
+
+  std::map<int32_t, bool> interrupts;
+  for (const auto& module : modules_) {
+    interrupts[module.first] = false;
+  }
+  try {
+    supported_ = bus_->scanInterrupts(interrupts);
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Cannot read transceiver interrupts: " << ex.what();
+  }
+}
+
+std::vector<int32_t> TransceiverEventScanner::scan() {
+  std::map<int32_t, ModulePresence> presences;
+  std::map<int32_t, bool> interrupts;
+  for (const auto& module : modules_) {
+    presences[module.first] = ModulePresence::UNKNOWN;
+    interrupts[module.first] = false;
+  }
+  bus_->scanPresence(presences);
+  bus_->scanInterrupts(interrupts);
+
+  auto now = now_();
+  std::vector<int32_t> changed;
+  for (auto& [id, state] : modules_) {
+    auto presence = presences[id];
+    auto interrupt = interrupts[id];
+
+    bool trigger = false;
+    if (presence != ModulePresence::UNKNOWN && presence != state.presence) {
+      XLOG(DBG2) << "Transceiver " << id << " presence changed to "
+                 << (presence == ModulePresence::PRESENT ? "present"
+                                                         : "absent");
+      state.presence = presence;
+      trigger = true;
+    }
+    if (interrupt &&
+        (!state.interrupt || now - state.lastTriggered >= interruptHoldoff_)) {
+      XLOG(DBG2) << "Transceiver " << id << " raised an interrupt";
+      trigger = true;
+    }
+    state.interrupt = interrupt;
+
+    if (trigger) {
+      state.lastTriggered = now;
+      changed.push_back(id);
+    }
+  }
+  return changed;
+}
+
+}} // namespace facebook::fboss
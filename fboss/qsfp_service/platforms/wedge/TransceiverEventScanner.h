@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "fboss/lib/usb/TransceiverI2CApi.h"
+
+namespace facebook { namespace fboss {
+
+/*
+ * Watches the presence and IntL state of all transceivers on a bus, to find
+ * the transceivers that need a refresh without polling each of them.
+ *
+ * This only makes sense on platforms that have the state of all
+ * transceivers in a few registers, e.g. in the DOM FPGA, so it reports
+ * itself as unsupported when the bus can't read the interrupts.
+ *
+ * IntL stays asserted until the flags that raised it are read, so a
+ * transceiver that keeps asserting it is refreshed again only after a hold
+ * off time, in case we don't read the flag that raised it.
+ */
+class TransceiverEventScanner {
+ public:
+  using TimePoint = std::chrono::steady_clock::time_point;
+  // Where the hold off time is measured from, replaceable for tests
+  using NowFunc = std::function<TimePoint()>;
+
+  TransceiverEventScanner(
+      TransceiverI2CApi* bus,
+      int numModules,
+      std::chrono::milliseconds interruptHoldoff,
+      NowFunc now = std::chrono::steady_clock::now);
+
+  bool isSupported() const {
+    return supported_;
+  }
+
+  /*
+   * Reads the presence and interrupts of all transceivers, and returns the
+   * ids of those whose presence changed or which raised an interrupt
+   */
+  std::vector<int32_t> scan();
+
+ private:
+  struct ModuleState {
+    ModulePresence presence{ModulePresence::UNKNOWN};
+    bool interrupt{false};
+    TimePoint lastTriggered;
+  };
+
+  TransceiverI2CApi* bus_;
+  std::chrono::milliseconds interruptHoldoff_;
+  NowFunc now_;
+  bool supported_{false};
+  std::map<int32_t, ModuleState> modules_;
+};
+
+}} // namespace facebook::fboss
@@ -81,6 +81,11 @@ void WedgeI2CBusLock::scanPresence(
   wedgeI2CBus_->scanPresence(presence);
 }
 
+bool WedgeI2CBusLock::scanInterrupts(std::map<int32_t, bool>& interrupts) {
+  BusGuard g(this);
+  return wedgeI2CBus_->scanInterrupts(interrupts);
+}
+
 void WedgeI2CBusLock::ensureOutOfReset(unsigned int module) {
   BusGuard g(this);
   wedgeI2CBus_->ensureOutOfReset(module);
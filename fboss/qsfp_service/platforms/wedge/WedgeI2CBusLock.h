@@ -9,6 +9,7 @@
  */
 #pragma once
 
+#include "fboss/lib/i2c/I2cPhaseRecorder.h"
 #include "fboss/lib/usb/BaseWedgeI2CBus.h"
 
 #include <mutex>
@@ -35,6 +36,7 @@ class WedgeI2CBusLock : public TransceiverI2CApi {
   void verifyBus(bool autoReset) override;
   bool isPresent(unsigned int module) override;
   void scanPresence(std::map<int32_t, ModulePresence>& presence) override;
+  bool scanInterrupts(std::map<int32_t, bool>& interrupts) override;
   void ensureOutOfReset(unsigned int module) override;
 
   /* Platform function to count the i2c transactions in a platform. This
@@ -70,8 +72,12 @@ class WedgeI2CBusLock : public TransceiverI2CApi {
    public:
     explicit BusGuard(WedgeI2CBusLock* busLock) :
         busLock_(busLock),
-        lock_(busLock->busMutex_)
+        lock_(busLock->busMutex_, std::defer_lock)
       {
+        {
+          ScopedI2cPhase phase(I2cPhase::LOCK_WAIT);
+          lock_.lock();
+        }
         if (!busLock_->opened_) {
           busLock_->openLocked();
           performedOpen_ = true;
@@ -87,7 +93,7 @@ class WedgeI2CBusLock : public TransceiverI2CApi {
    private:
     WedgeI2CBusLock* busLock_{nullptr};
     bool performedOpen_{false};
-    std::lock_guard<std::mutex> lock_;
+    std::unique_lock<std::mutex> lock_;
   };
 };
 
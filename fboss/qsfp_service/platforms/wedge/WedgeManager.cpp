@@ -1,14 +1,35 @@
 #include "fboss/qsfp_service/platforms/wedge/WedgeManager.h"
 
+#include <chrono>
+
 #include <folly/gen/Base.h>
 
 #include <folly/logging/xlog.h>
 #include <fb303/ThreadCachedServiceData.h>
+#include "fboss/qsfp_service/RefreshProfiler.h"
 #include "fboss/qsfp_service/module/QsfpModule.h"
 #include "fboss/qsfp_service/module/cmis/CmisModule.h"
 #include "fboss/qsfp_service/module/sff/SffModule.h"
+#include "fboss/qsfp_service/platforms/wedge/TransceiverEventScanner.h"
 #include "fboss/qsfp_service/platforms/wedge/WedgeQsfp.h"
 
+DEFINE_bool(
+    publish_transceiver_shm,
+    false,
+    "Publish transceiver info to shared memory after every refresh, for "
+    "clients to read it without thrift calls, see qsfp_cache_use_shm");
+DEFINE_bool(
+    refresh_transceivers_on_events,
+    false,
+    "On platforms whose bus can read the presence and interrupt state of all "
+    "transceivers at once, refresh the transceivers that changed as soon as "
+    "a scan sees them, and run the full refresh every event_loop_interval");
+DEFINE_int32(
+    interrupt_holdoff_ms,
+    1000,
+    "Minimum time between two refreshes of a transceiver that keeps "
+    "asserting its interrupt");
+
 namespace facebook { namespace fboss {
 
 WedgeManager::WedgeManager(std::unique_ptr<TransceiverPlatformApi> api) :
@@ -65,6 +86,17 @@ void WedgeManager::initTransceiverMap() {
     }
   }
 
+  if (FLAGS_refresh_transceivers_on_events) {
+    auto scanner = std::make_unique<TransceiverEventScanner>(
+        wedgeI2cBus_.get(),
+        getNumQsfpModules(),
+        std::chrono::milliseconds(FLAGS_interrupt_holdoff_ms));
+    if (scanner->isSupported()) {
+      XLOG(INFO) << "Refreshing transceivers on presence and interrupt changes";
+      eventScanner_ = std::move(scanner);
+    }
+  }
+
   refreshTransceivers();
 }
 
@@ -156,15 +188,105 @@ void WedgeManager::refreshTransceivers() {
   }
 
   std::vector<folly::Future<folly::Unit>> futs;
+  std::vector<int32_t> ids;
   XLOG(INFO) << "Start refreshing all transceivers...";
+  auto start = std::chrono::steady_clock::now();
+  auto cycle = RefreshProfiler::get()->startCycle("full");
+
+  {
+    ScopedRefreshCycle participate(cycle);
+    for (const auto& transceiver : transceivers_) {
+      XLOG(DBG3) << "Fired to refresh transceiver " << transceiver->getID();
+      futs.push_back(transceiver->futureRefresh());
+      ids.push_back(static_cast<int32_t>(transceiver->getID()));
+    }
+  }
 
-  for (const auto& transceiver : transceivers_) {
-    XLOG(DBG3) << "Fired to refresh transceiver " << transceiver->getID();
-    futs.push_back(transceiver->futureRefresh());
+  // The refreshes run on the event bases the bus hands out, so they go in
+  // parallel across all the I2C controllers the bus has
+  folly::collectAllUnsafe(futs.begin(), futs.end()).wait();
+  publishRefreshedTransceivers(ids);
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  tcData().setCounter("qsfp.refresh_transceivers_ms", elapsed.count());
+  XLOG(INFO) << "Finished refreshing all transceivers in " << elapsed.count()
+             << "ms";
+}
+
+void WedgeManager::scanTransceiverEvents() {
+  if (!eventScanner_) {
+    return;
+  }
+
+  std::vector<int32_t> ids;
+  try {
+    ids = eventScanner_->scan();
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Error scanning transceiver events: " << ex.what();
+    return;
+  }
+  if (ids.empty()) {
+    // Nothing changed since we last published, so what readers have is
+    // still current. Say so, as full refreshes are rare in this mode and
+    // the data would otherwise age past what readers accept.
+    if (FLAGS_publish_transceiver_shm && shmWriter_) {
+      shmWriter_->heartbeat();
+    }
+    return;
   }
 
+  std::vector<folly::Future<folly::Unit>> futs;
+  std::vector<int32_t> refreshed;
+  auto cycle = RefreshProfiler::get()->startCycle("event");
+  ScopedRefreshCycle participate(cycle);
+  for (auto id : ids) {
+    if (!isValidTransceiver(id)) {
+      continue;
+    }
+    refreshed.push_back(id);
+    XLOG(DBG2) << "Fired to refresh transceiver " << id << " on an event";
+    auto& transceiver = transceivers_[TransceiverID(id)];
+    // Interrupts are for flags in the data that changes frequently
+    transceiver->markDataStale();
+    futs.push_back(transceiver->futureRefresh());
+  }
   folly::collectAllUnsafe(futs.begin(), futs.end()).wait();
-  XLOG(INFO) << "Finished refreshing all transceivers";
+  tcData().addStatValue("qsfp.event_refreshes", futs.size(), fb303::SUM);
+  publishRefreshedTransceivers(refreshed);
+}
+
+void WedgeManager::publishRefreshedTransceivers(
+    const std::vector<int32_t>& ids) {
+  auto start = std::chrono::steady_clock::now();
+  if (FLAGS_publish_transceiver_shm) {
+    publishTransceiversToShm(ids);
+  }
+  RefreshProfiler::get()->finishCycle(
+      std::chrono::steady_clock::now() - start);
+}
+
+void WedgeManager::publishTransceiversToShm(const std::vector<int32_t>& ids) {
+  if (!shmWriter_) {
+    try {
+      shmWriter_ = std::make_unique<TransceiverShmWriter>(
+          FLAGS_qsfp_shm_name, getNumQsfpModules());
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "Cannot publish transceivers to shared memory: "
+                << ex.what();
+      return;
+    }
+  }
+
+  for (auto id : ids) {
+    try {
+      shmWriter_->publish(
+          id, transceivers_[TransceiverID(id)]->getTransceiverInfo());
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "Transceiver " << id
+                << ": Error publishing to shared memory: " << ex.what();
+    }
+  }
+  shmWriter_->heartbeat();
 }
 
 int WedgeManager::scanTransceiverPresence(
@@ -8,6 +8,8 @@
 #include "fboss/qsfp_service/platforms/wedge/WedgeI2CBusLock.h"
 #include "fboss/qsfp_service/TransceiverManager.h"
 #include "fboss/lib/usb/TransceiverPlatformApi.h"
+#include "fboss/qsfp_service/lib/TransceiverShm.h"
+#include "fboss/qsfp_service/platforms/wedge/TransceiverEventScanner.h"
 
 namespace facebook { namespace fboss {
 class WedgeManager : public TransceiverManager {
@@ -59,6 +61,15 @@ class WedgeManager : public TransceiverManager {
    */
   void publishI2cTransactionStats() override;
 
+  bool supportsTransceiverEvents() const override {
+    return eventScanner_ != nullptr;
+  }
+
+  /* Refreshes the transceivers whose presence or interrupt changed since the
+   * last scan
+   */
+  void scanTransceiverEvents() override;
+
  protected:
   virtual std::unique_ptr<TransceiverI2CApi> getI2CBus();
   std::unique_ptr<TransceiverI2CApi>
@@ -74,8 +85,20 @@ class WedgeManager : public TransceiverManager {
   PortGroups portGroupMap_;
 
  private:
+  /* Publishes the info of the transceivers in ids to shared memory for
+   * QsfpCache, creating the region on first use.
+   */
+  void publishTransceiversToShm(const std::vector<int32_t>& ids);
+  /* Publishes the transceivers in ids, which were just refreshed, and closes
+   * the refresh cycle the RefreshProfiler has open.
+   */
+  void publishRefreshedTransceivers(const std::vector<int32_t>& ids);
+
   // Forbidden copy constructor and assignment operator
   WedgeManager(WedgeManager const &) = delete;
   WedgeManager& operator=(WedgeManager const &) = delete;
+
+  std::unique_ptr<TransceiverShmWriter> shmWriter_;
+  std::unique_ptr<TransceiverEventScanner> eventScanner_;
 };
 }} // facebook::fboss
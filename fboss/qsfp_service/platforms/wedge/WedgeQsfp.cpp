@@ -10,10 +10,17 @@
 
 #include "WedgeQsfp.h"
 #include <folly/Conv.h>
+#include <folly/Format.h>
 #include <folly/Memory.h>
 #include <folly/ScopeGuard.h>
+#include <folly/String.h>
+
+#include <algorithm>
+#include <cctype>
+#include <thread>
 
 #include <folly/logging/xlog.h>
+#include "fboss/qsfp_service/RefreshProfiler.h"
 #include "fboss/qsfp_service/StatsPublisher.h"
 
 using namespace facebook::fboss;
@@ -24,7 +31,34 @@ using std::unique_ptr;
 
 namespace {
 constexpr uint8_t kCMISIdentifier = 0x1e;
+// SFF-8636 modules take up to 4 bytes in one sequential write, and
+// sequential writes don't cross from the lower to the upper page
+constexpr int kMaxSequentialWrite = 4;
+constexpr int kPageSelectOffset = 127;
+
+struct ModuleWriteSettings {
+  const char* vendorPrefix;
+  // Empty matches all part numbers of the vendor
+  const char* partNumberPrefix;
+  std::chrono::milliseconds settleTime;
+  bool settleEveryWrite;
+  bool multiByteWrites;
+};
+
+// Modules that need special care on writes. Modules that aren't listed are
+// written to without a settle time.
+const ModuleWriteSettings kModuleWriteSettings[] = {
+    // Intel transceivers require some delay for every write
+    {"INTEL", "", std::chrono::milliseconds(20), true, false},
+};
+
+std::string normalize(folly::StringPiece str) {
+  auto normalized = folly::trimWhitespace(str).str();
+  std::transform(
+      normalized.begin(), normalized.end(), normalized.begin(), ::toupper);
+  return normalized;
 }
+} // namespace
 
 namespace facebook { namespace fboss {
 
@@ -49,9 +83,20 @@ void WedgeQsfp::ensureOutOfReset() {
 
 int WedgeQsfp::readTransceiver(int dataAddress, int offset,
                                int len, uint8_t* fieldValue) {
+  // The read may depend on queued writes, e.g. a page change
+  flushWrites();
+  auto profile = ScopedTransceiverRefresh::current();
+  auto start = std::chrono::steady_clock::now();
   try {
     SCOPE_EXIT {
       wedgeQsfpstats_.updateReadDownTime();
+      if (profile) {
+        profile->addPageRead(
+            offset <= kPageSelectOffset
+                ? "lower"
+                : folly::sformat("page{:02x}", selectedPage_),
+            std::chrono::steady_clock::now() - start);
+      }
     };
     SCOPE_FAIL {
       StatsPublisher::bumpReadFailure();
@@ -74,6 +119,46 @@ int WedgeQsfp::writeTransceiver(
     int offset,
     int len,
     uint8_t* fieldValue) {
+  if (!batching_) {
+    doWrite(dataAddress, offset, len, fieldValue);
+    settle();
+    return len;
+  }
+
+  if (!pendingWrites_.empty() &&
+      canMerge(pendingWrites_.back(), dataAddress, offset) &&
+      pendingWrites_.back().data.size() + len <= kMaxSequentialWrite) {
+    auto& data = pendingWrites_.back().data;
+    data.insert(data.end(), fieldValue, fieldValue + len);
+  } else {
+    pendingWrites_.push_back(PendingWrite{
+        dataAddress,
+        offset,
+        std::vector<uint8_t>(fieldValue, fieldValue + len)});
+  }
+  return len;
+}
+
+bool WedgeQsfp::canMerge(
+    const PendingWrite& write,
+    int dataAddress,
+    int offset) const {
+  if (!writeSettings_.multiByteWrites || write.dataAddress != dataAddress ||
+      write.offset + static_cast<int>(write.data.size()) != offset) {
+    return false;
+  }
+  // Page changes have to take effect on their own
+  if (write.offset <= kPageSelectOffset && offset >= kPageSelectOffset) {
+    return false;
+  }
+  return true;
+}
+
+void WedgeQsfp::doWrite(
+    int dataAddress,
+    int offset,
+    int len,
+    const uint8_t* fieldValue) {
   try {
     SCOPE_EXIT {
       wedgeQsfpstats_.updateWriteDownTime();
@@ -86,18 +171,85 @@ int WedgeQsfp::writeTransceiver(
     };
     threadSafeI2CBus_->moduleWrite(
         module_ + 1, dataAddress, offset, len, fieldValue);
-
-    // Intel transceiver require some delay for every write.
-    // So in the case of writing succeeded, we wait for 20ms.
-    // Also this works because we do not write more than 1 byte for now.
-    usleep(20000);
+    if (dataAddress == TransceiverI2CApi::ADDR_QSFP &&
+        offset <= kPageSelectOffset && kPageSelectOffset < offset + len) {
+      selectedPage_ = fieldValue[kPageSelectOffset - offset];
+    }
   } catch (const std::exception& ex) {
     XLOG(ERR) << "Write to transceiver " << module_ << " at offset " << offset
               << " with length " << len
               << " failed: " << folly::exceptionStr(ex);
     throw;
   }
-  return len;
+}
+
+void WedgeQsfp::settle() {
+  if (writeSettings_.settleTime.count() > 0) {
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(writeSettings_.settleTime);
+    if (auto profile = ScopedTransceiverRefresh::current()) {
+      profile->addSettle(std::chrono::steady_clock::now() - start);
+    }
+  }
+}
+
+void WedgeQsfp::flushWrites() {
+  if (pendingWrites_.empty()) {
+    return;
+  }
+  // Drop the queue even if a write fails, the caller redoes the
+  // customization on the next refresh anyway
+  auto writes = std::move(pendingWrites_);
+  pendingWrites_.clear();
+  for (size_t i = 0; i < writes.size(); ++i) {
+    const auto& write = writes[i];
+    doWrite(
+        write.dataAddress, write.offset, write.data.size(), write.data.data());
+    if (writeSettings_.settleEveryWrite || i == writes.size() - 1) {
+      settle();
+    }
+  }
+}
+
+void WedgeQsfp::beginWriteBatch() {
+  batching_ = true;
+}
+
+void WedgeQsfp::commitWriteBatch() {
+  batching_ = false;
+  flushWrites();
+}
+
+void WedgeQsfp::setVendorInfo(const Vendor& vendor) {
+  writeSettings_ =
+      getWriteSettings(*vendor.name_ref(), *vendor.partNumber_ref());
+}
+
+WedgeQsfp::WriteSettings WedgeQsfp::getWriteSettings(
+    const std::string& vendorName,
+    const std::string& partNumber) {
+  auto name = normalize(vendorName);
+  // QsfpModule reports vendor names it couldn't read as UNKNOWN
+  if (name.empty() || name == "UNKNOWN") {
+    // Nothing to go on, stay on the safe side
+    return WriteSettings();
+  }
+  auto part = normalize(partNumber);
+  for (const auto& entry : kModuleWriteSettings) {
+    if (folly::StringPiece(name).startsWith(entry.vendorPrefix) &&
+        folly::StringPiece(part).startsWith(entry.partNumberPrefix)) {
+      WriteSettings settings;
+      settings.settleTime = entry.settleTime;
+      settings.settleEveryWrite = entry.settleEveryWrite;
+      settings.multiByteWrites = entry.multiByteWrites;
+      return settings;
+    }
+  }
+  WriteSettings settings;
+  settings.settleTime = std::chrono::milliseconds(0);
+  settings.settleEveryWrite = false;
+  settings.multiByteWrites = true;
+  return settings;
 }
 
 folly::StringPiece WedgeQsfp::getName() {
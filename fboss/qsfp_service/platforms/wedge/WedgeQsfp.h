@@ -13,6 +13,8 @@
 #include <chrono>
 #include <cstdint>
 #include <mutex>
+#include <string>
+#include <vector>
 #include "fboss/qsfp_service/platforms/wedge/WedgeI2CBusLock.h"
 #include "fboss/qsfp_service/module/TransceiverImpl.h"
 
@@ -95,13 +97,62 @@ class WedgeQsfp : public TransceiverImpl {
 
   folly::EventBase* getI2cEventBase() override;
 
+  /* Writes in a batch are queued and sent out by commitWriteBatch() */
+  void beginWriteBatch() override;
+
+  void commitWriteBatch() override;
+
+  /* Picks the write settings for the module from its vendor info */
+  void setVendorInfo(const Vendor& vendor) override;
+
   TransceiverManagementInterface getTransceiverManagementInterface();
 
+  /*
+   * How a module wants to be written to. The defaults are for a module we
+   * don't know yet, and are safe for all of them.
+   */
+  struct WriteSettings {
+    // Time the module needs after a write before it is accessed again
+    std::chrono::milliseconds settleTime{20};
+    // Whether every write needs to settle, or only the last of a batch
+    bool settleEveryWrite{true};
+    // Whether consecutive bytes can be written in a single transaction
+    bool multiByteWrites{false};
+  };
+
+  static WriteSettings getWriteSettings(
+      const std::string& vendorName,
+      const std::string& partNumber);
+
+  const WriteSettings& getWriteSettings() const {
+    return writeSettings_;
+  }
+
  private:
+  struct PendingWrite {
+    int dataAddress;
+    int offset;
+    std::vector<uint8_t> data;
+  };
+
+  bool canMerge(const PendingWrite& write, int dataAddress, int offset) const;
+  void doWrite(int dataAddress, int offset, int len, const uint8_t* fieldValue);
+  void flushWrites();
+  void settle();
+
   int module_;
   std::string moduleName_;
   TransceiverI2CApi* threadSafeI2CBus_;
   WedgeQsfpStats wedgeQsfpstats_;
+
+  // Like the reads and writes, these are protected by the lock of the
+  // QsfpModule that owns this object
+  WriteSettings writeSettings_;
+  bool batching_{false};
+  std::vector<PendingWrite> pendingWrites_;
+  // Last page written to the page select byte, to name the page reads in
+  // refresh profiles
+  uint8_t selectedPage_{0};
 };
 
 }} // namespace facebook::fboss
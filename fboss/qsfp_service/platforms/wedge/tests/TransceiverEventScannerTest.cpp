@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/qsfp_service/platforms/wedge/TransceiverEventScanner.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+using namespace facebook::fboss;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr int kNumModules = 8;
+
+// Presence and interrupt registers of a bus, set by the tests
+class FakeI2CApi : public TransceiverI2CApi {
+ public:
+  explicit FakeI2CApi(bool hasInterrupts) : hasInterrupts_(hasInterrupts) {}
+
+  void open() override {}
+  void close() override {}
+  void moduleRead(unsigned int, uint8_t, int, int, uint8_t*) override {}
+  void moduleWrite(unsigned int, uint8_t, int, int, const uint8_t*) override {}
+  void verifyBus(bool /*autoReset*/) override {}
+  bool isPresent(unsigned int module) override {
+    return present[module - 1];
+  }
+  void scanPresence(std::map<int32_t, ModulePresence>& presences) override {
+    for (auto& presence : presences) {
+      presence.second = present[presence.first] ? ModulePresence::PRESENT
+                                                : ModulePresence::ABSENT;
+    }
+  }
+  bool scanInterrupts(std::map<int32_t, bool>& interrupts) override {
+    if (!hasInterrupts_) {
+      return false;
+    }
+    for (auto& interrupt : interrupts) {
+      interrupt.second = interrupted[interrupt.first];
+    }
+    return true;
+  }
+
+  std::array<bool, kNumModules> present{};
+  std::array<bool, kNumModules> interrupted{};
+
+ private:
+  bool hasInterrupts_;
+};
+
+} // namespace
+
+TEST(TransceiverEventScannerTest, Unsupported) {
+  FakeI2CApi bus(false);
+  TransceiverEventScanner scanner(&bus, kNumModules, 1s);
+  EXPECT_FALSE(scanner.isSupported());
+}
+
+TEST(TransceiverEventScannerTest, PresenceChanges) {
+  FakeI2CApi bus(true);
+  bus.present[1] = true;
+  bus.present[5] = true;
+  TransceiverEventScanner scanner(&bus, kNumModules, 1s);
+  ASSERT_TRUE(scanner.isSupported());
+
+  // Everything is new on the first scan
+  EXPECT_EQ(std::vector<int32_t>({0, 1, 2, 3, 4, 5, 6, 7}), scanner.scan());
+  EXPECT_TRUE(scanner.scan().empty());
+
+  bus.present[5] = false;
+  bus.present[6] = true;
+  EXPECT_EQ(std::vector<int32_t>({5, 6}), scanner.scan());
+  EXPECT_TRUE(scanner.scan().empty());
+}
+
+TEST(TransceiverEventScannerTest, Interrupts) {
+  FakeI2CApi bus(true);
+  bus.present.fill(true);
+  auto now = std::chrono::steady_clock::time_point();
+  TransceiverEventScanner scanner(
+      &bus, kNumModules, 50ms, [&now] { return now; });
+  scanner.scan();
+
+  bus.interrupted[3] = true;
+  EXPECT_EQ(std::vector<int32_t>({3}), scanner.scan());
+  // Still asserted, but within the hold off
+  now += 49ms;
+  EXPECT_TRUE(scanner.scan().empty());
+  now += 1ms;
+  EXPECT_EQ(std::vector<int32_t>({3}), scanner.scan());
+
+  // Cleared by the refresh, and raised again
+  bus.interrupted[3] = false;
+  EXPECT_TRUE(scanner.scan().empty());
+  bus.interrupted[3] = true;
+  EXPECT_EQ(std::vector<int32_t>({3}), scanner.scan());
+}
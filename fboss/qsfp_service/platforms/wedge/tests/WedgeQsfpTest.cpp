@@ -0,0 +1,206 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/qsfp_service/platforms/wedge/WedgeQsfp.h"
+#include "fboss/lib/i2c/I2cPhaseRecorder.h"
+#include "fboss/lib/usb/TransceiverI2CApi.h"
+#include "fboss/qsfp_service/RefreshProfiler.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Transaction {
+  bool isRead;
+  int offset;
+  std::vector<uint8_t> data;
+};
+
+// Records the transactions instead of talking to a module
+class RecordingI2CApi : public TransceiverI2CApi {
+ public:
+  void open() override {}
+  void close() override {}
+  void moduleRead(
+      unsigned int /*module*/,
+      uint8_t /*i2cAddress*/,
+      int offset,
+      int len,
+      uint8_t* buf) override {
+    ScopedI2cPhase phase(I2cPhase::TRANSFER, "i2c0");
+    std::fill(buf, buf + len, 0);
+    transactions.push_back(Transaction{true, offset, {}});
+  }
+  void moduleWrite(
+      unsigned int /*module*/,
+      uint8_t /*i2cAddress*/,
+      int offset,
+      int len,
+      const uint8_t* buf) override {
+    transactions.push_back(
+        Transaction{false, offset, std::vector<uint8_t>(buf, buf + len)});
+  }
+  void verifyBus(bool /*autoReset*/) override {}
+  bool isPresent(unsigned int /*module*/) override {
+    return true;
+  }
+  void scanPresence(std::map<int32_t, ModulePresence>& /*presences*/) override {
+  }
+
+  std::vector<Transaction> transactions;
+};
+
+Vendor makeVendor(const std::string& name, const std::string& partNumber) {
+  Vendor vendor;
+  *vendor.name_ref() = name;
+  *vendor.partNumber_ref() = partNumber;
+  return vendor;
+}
+
+void writeByte(WedgeQsfp& qsfp, int offset, uint8_t value) {
+  qsfp.writeTransceiver(TransceiverI2CApi::ADDR_QSFP, offset, 1, &value);
+}
+
+} // namespace
+
+TEST(WedgeQsfpTest, WriteSettings) {
+  auto unknown = WedgeQsfp::getWriteSettings("", "");
+  EXPECT_EQ(20ms, unknown.settleTime);
+  EXPECT_TRUE(unknown.settleEveryWrite);
+  EXPECT_FALSE(unknown.multiByteWrites);
+
+  // A vendor name that couldn't be read doesn't count as a known vendor
+  auto unreadable = WedgeQsfp::getWriteSettings("UNKNOWN", "UNKNOWN");
+  EXPECT_EQ(20ms, unreadable.settleTime);
+  EXPECT_TRUE(unreadable.settleEveryWrite);
+  EXPECT_FALSE(unreadable.multiByteWrites);
+
+  // Vendor names are space padded in the EEPROM
+  auto intel = WedgeQsfp::getWriteSettings("Intel Corp      ", "SPTSBP2CLCKS");
+  EXPECT_EQ(20ms, intel.settleTime);
+  EXPECT_TRUE(intel.settleEveryWrite);
+  EXPECT_FALSE(intel.multiByteWrites);
+
+  auto other = WedgeQsfp::getWriteSettings("FINISAR CORP.", "FTLC9555REPM");
+  EXPECT_EQ(0ms, other.settleTime);
+  EXPECT_FALSE(other.settleEveryWrite);
+  EXPECT_TRUE(other.multiByteWrites);
+}
+
+TEST(WedgeQsfpTest, BatchedWritesAreMerged) {
+  RecordingI2CApi i2c;
+  WedgeQsfp qsfp(0, &i2c);
+  qsfp.setVendorInfo(makeVendor("FINISAR CORP.", "FTLC9555REPM"));
+
+  qsfp.beginWriteBatch();
+  writeByte(qsfp, 93, 0x1);
+  // Page select goes on its own
+  writeByte(qsfp, 127, 0x3);
+  writeByte(qsfp, 236, 0x1);
+  writeByte(qsfp, 237, 0x2);
+  writeByte(qsfp, 238, 0x3);
+  writeByte(qsfp, 239, 0x4);
+  // Over the sequential write limit
+  writeByte(qsfp, 240, 0x5);
+  EXPECT_TRUE(i2c.transactions.empty());
+  qsfp.commitWriteBatch();
+
+  ASSERT_EQ(4, i2c.transactions.size());
+  EXPECT_EQ(93, i2c.transactions[0].offset);
+  EXPECT_EQ(127, i2c.transactions[1].offset);
+  EXPECT_EQ(236, i2c.transactions[2].offset);
+  EXPECT_EQ(
+      std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4}), i2c.transactions[2].data);
+  EXPECT_EQ(240, i2c.transactions[3].offset);
+}
+
+TEST(WedgeQsfpTest, ReadFlushesBatch) {
+  RecordingI2CApi i2c;
+  WedgeQsfp qsfp(0, &i2c);
+  qsfp.setVendorInfo(makeVendor("FINISAR CORP.", "FTLC9555REPM"));
+
+  qsfp.beginWriteBatch();
+  writeByte(qsfp, 127, 0x3);
+  uint8_t buf;
+  qsfp.readTransceiver(TransceiverI2CApi::ADDR_QSFP, 234, 1, &buf);
+  qsfp.commitWriteBatch();
+
+  ASSERT_EQ(2, i2c.transactions.size());
+  EXPECT_FALSE(i2c.transactions[0].isRead);
+  EXPECT_TRUE(i2c.transactions[1].isRead);
+}
+
+TEST(WedgeQsfpTest, UnknownModuleWritesSingleBytes) {
+  RecordingI2CApi i2c;
+  WedgeQsfp qsfp(0, &i2c);
+
+  qsfp.beginWriteBatch();
+  writeByte(qsfp, 86, 0x0);
+  writeByte(qsfp, 87, 0x0);
+  qsfp.commitWriteBatch();
+  EXPECT_EQ(2, i2c.transactions.size());
+
+  // Without a batch, writes go out right away
+  writeByte(qsfp, 93, 0x1);
+  EXPECT_EQ(3, i2c.transactions.size());
+}
+
+TEST(WedgeQsfpTest, ProfilesPageReads) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_enable_refresh_profiling = true;
+  RecordingI2CApi i2c;
+  WedgeQsfp qsfp(0, &i2c);
+  qsfp.setVendorInfo(makeVendor("FINISAR CORP.", "FTLC9555REPM"));
+
+  auto profiler = RefreshProfiler::get();
+  auto cycle = profiler->startCycle("test");
+  {
+    ScopedRefreshCycle participate(cycle);
+    ScopedTransceiverRefresh profile(0);
+    uint8_t buf[128];
+    qsfp.readTransceiver(TransceiverI2CApi::ADDR_QSFP, 0, sizeof(buf), buf);
+    writeByte(qsfp, 127, 0x3);
+    qsfp.readTransceiver(TransceiverI2CApi::ADDR_QSFP, 128, sizeof(buf), buf);
+  }
+  // Refreshes that aren't part of the cycle, e.g. from thrift calls, aren't
+  // counted in it even though it is open
+  std::thread([] {
+    ScopedTransceiverRefresh profile(1);
+    EXPECT_EQ(nullptr, ScopedTransceiverRefresh::current());
+  }).join();
+  profiler->finishCycle(0ms);
+
+  auto cycles = profiler->getCycles();
+  ASSERT_FALSE(cycles.empty());
+  EXPECT_EQ("test", *cycles.back().trigger_ref());
+  ASSERT_EQ(1, cycles.back().transceivers_ref()->size());
+  const auto& profile = cycles.back().transceivers_ref()->front();
+  EXPECT_EQ("i2c0", *profile.bus_ref());
+  EXPECT_EQ(2, *profile.transactions_ref());
+  EXPECT_FALSE(*profile.failed_ref());
+  EXPECT_EQ(1, profile.pageReadUs_ref()->count("lower"));
+  EXPECT_EQ(1, profile.pageReadUs_ref()->count("page03"));
+
+  // Without an open cycle nothing is recorded
+  {
+    ScopedRefreshCycle participate(cycle);
+    ScopedTransceiverRefresh profile(0);
+    EXPECT_EQ(nullptr, ScopedTransceiverRefresh::current());
+  }
+  EXPECT_EQ(cycles.size(), profiler->getCycles().size());
+}